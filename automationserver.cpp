@@ -0,0 +1,394 @@
+/**
+ * @file automationserver.cpp
+ * @brief 本地自动化接口实现文件
+ * @details 包含AutomationServer类的实现
+ */
+
+#include "automationserver.h"
+#include "loadbankmodel.h"
+#include "loadsolver.h"
+#include "voltagestatistics.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QDebug>
+
+constexpr int AutomationServer::MAX_LINE_LENGTH;
+constexpr qint64 AutomationServer::MAX_PENDING_BYTES;
+constexpr int AutomationServer::PROBE_TIMEOUT_MS;
+
+/**
+ * @brief 构造函数
+ * @param model 负载柜数据模型
+ * @param statistics 电压流式统计
+ * @param parent 父对象指针
+ */
+AutomationServer::AutomationServer(LoadBankModel *model, VoltageStatistics *statistics, QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+    , m_model(model)
+    , m_statistics(statistics)
+    , m_subscriberCount(0)
+    , m_lastVoltage(-1.0)
+    , m_lastTimestampMs(0)
+{
+    connect(m_server, &QLocalServer::newConnection, this, &AutomationServer::onNewConnection);
+    connect(m_model, &LoadBankModel::modelReset, this, &AutomationServer::onModelReset);
+}
+
+/**
+ * @brief 析构函数
+ */
+AutomationServer::~AutomationServer()
+{
+    const QList<QLocalSocket*> sockets = m_clients.keys();
+    m_clients.clear();
+    for (QLocalSocket *socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+    }
+    m_server->close();
+}
+
+/**
+ * @brief 开始监听
+ * @param name 服务器名称
+ * @param errorString 失败时的错误描述
+ * @return 是否开始监听
+ */
+bool AutomationServer::listen(const QString &name, QString *errorString)
+{
+    auto fail = [errorString, &name](const QString &message) {
+        if (errorString) *errorString = message;
+        qWarning() << "自动化接口监听失败:" << name << message;
+        return false;
+    };
+
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(name)) {
+        if (m_server->serverError() != QAbstractSocket::AddressInUseError) {
+            return fail(m_server->errorString());
+        }
+
+        // 只有确认没有实例在监听时才移除，否则会断开另一个实例的全部客户端
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(PROBE_TIMEOUT_MS)) {
+            probe.abort();
+            return fail(QString("名称 %1 已被另一个实例使用").arg(name));
+        }
+        qDebug() << "移除残留的自动化接口套接字:" << name;
+        QLocalServer::removeServer(name);
+        if (!m_server->listen(name)) {
+            return fail(m_server->errorString());
+        }
+    }
+    qDebug() << "自动化接口已启动:" << m_server->fullServerName();
+    return true;
+}
+
+/**
+ * @brief 设置写入检查
+ * @param guard 写入检查函数
+ */
+void AutomationServer::setWriteGuard(std::function<QString()> guard)
+{
+    m_writeGuard = guard;
+}
+
+/**
+ * @brief 当前连接数
+ * @return 客户端连接数
+ */
+int AutomationServer::clientCount() const
+{
+    return m_clients.size();
+}
+
+/**
+ * @brief 推送一个电压样本给全部订阅者
+ * @param voltage 电压（V）
+ * @param timestampMs 单调时间戳（毫秒）
+ * @details 事件只序列化一次；某个订阅者积压过多时只丢弃发给它的样本，不影响其他订阅者
+ */
+void AutomationServer::publishVoltage(double voltage, qint64 timestampMs)
+{
+    m_lastVoltage = voltage;
+    m_lastTimestampMs = timestampMs;
+    if (m_subscriberCount == 0) return;
+
+    QJsonObject event;
+    event["event"] = "voltage";
+    event["t"] = timestampMs;
+    event["v"] = voltage;
+    const QByteArray line = QJsonDocument(event).toJson(QJsonDocument::Compact) + '\n';
+
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (!it.value().subscribed) continue;
+        QLocalSocket *socket = it.key();
+        if (socket->bytesToWrite() > MAX_PENDING_BYTES) {
+            if (it.value().droppedEvents++ == 0) {
+                qWarning() << "自动化接口订阅者积压过多，开始丢弃推送";
+            }
+            continue;
+        }
+        socket->write(line);
+    }
+}
+
+/**
+ * @brief 新连接的处理函数
+ */
+void AutomationServer::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        m_clients.insert(socket, Client());
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            auto it = m_clients.find(socket);
+            if (it != m_clients.end()) {
+                if (it.value().subscribed) --m_subscriberCount;
+                m_clients.erase(it);
+            }
+            socket->deleteLater();
+        });
+        qDebug() << "自动化接口新连接，当前连接数:" << m_clients.size();
+    }
+}
+
+/**
+ * @brief 读取并处理客户端的全部完整请求
+ * @param socket 客户端连接
+ */
+void AutomationServer::readRequests(QLocalSocket *socket)
+{
+    while (socket->canReadLine()) {
+        auto it = m_clients.find(socket);
+        if (it == m_clients.end()) return;
+
+        const QByteArray line = socket->readLine(MAX_LINE_LENGTH + 1).trimmed();
+        if (line.isEmpty()) continue;
+
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+        QJsonObject response;
+        if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+            response["ok"] = false;
+            response["error"] = QString("invalid json: %1").arg(parseError.errorString());
+        } else {
+            const bool wasSubscribed = it.value().subscribed;
+            response = handleRequest(it.value(), document.object());
+            m_subscriberCount += int(it.value().subscribed) - int(wasSubscribed);
+        }
+        writeLine(socket, response);
+    }
+
+    // 没有换行的超长数据视为协议错误
+    if (socket->bytesAvailable() > MAX_LINE_LENGTH) {
+        qWarning() << "自动化接口请求过长，断开连接";
+        socket->abort();
+    }
+}
+
+/**
+ * @brief 处理一个请求
+ * @param client 客户端状态
+ * @param request 请求对象
+ * @return 应答对象
+ */
+QJsonObject AutomationServer::handleRequest(Client &client, const QJsonObject &request)
+{
+    QJsonObject response;
+    if (request.contains("id")) {
+        response["id"] = request.value("id");
+    }
+    auto fail = [&response](const QString &message) {
+        response["ok"] = false;
+        response["error"] = message;
+        return response;
+    };
+
+    const QString command = request.value("cmd").toString();
+
+    if (command == "set" || command == "stage") {
+        const int row = resolveRow(request.value("row"));
+        if (row < 0 || !request.value("value").isDouble()) return fail("invalid row or value");
+        const double value = request.value("value").toDouble();
+
+        if (command == "stage") {
+            client.stagedTargets[row] = value;
+            response["staged"] = client.stagedTargets.size();
+        } else {
+            QString errorString;
+            if (!commitTargets({{row, value}}, &errorString)) return fail(errorString);
+            response["rows"] = rowsSnapshot();
+        }
+    } else if (command == "commit") {
+        QMap<int, double> targets = client.stagedTargets;
+        for (const QJsonValue &item : request.value("rows").toArray()) {
+            const QJsonObject target = item.toObject();
+            const int row = resolveRow(target.value("row"));
+            if (row < 0 || !target.value("value").isDouble()) return fail("invalid row or value in rows");
+            targets[row] = target.value("value").toDouble();
+        }
+        if (targets.isEmpty()) return fail("nothing to commit");
+
+        QString errorString;
+        if (!commitTargets(targets, &errorString)) return fail(errorString);
+        client.stagedTargets.clear();
+        response["rows"] = rowsSnapshot();
+    } else if (command == "rows") {
+        response["rows"] = rowsSnapshot();
+    } else if (command == "voltage") {
+        if (m_lastVoltage < 0) return fail("no voltage sample yet");
+        response["t"] = m_lastTimestampMs;
+        response["v"] = m_lastVoltage;
+    } else if (command == "statistics") {
+        auto toJson = [](const StatisticsSummary &s) {
+            QJsonObject object;
+            object["windowMs"] = s.windowMs;
+            object["count"] = s.count;
+            object["mean"] = s.mean;
+            object["rms"] = s.rms;
+            object["stdDev"] = s.stdDev;
+            object["min"] = s.min;
+            object["max"] = s.max;
+            object["p5"] = s.p5;
+            object["p50"] = s.p50;
+            object["p95"] = s.p95;
+            return object;
+        };
+        QJsonArray windows;
+        for (const StatisticsSummary &summary : m_statistics->summaries()) {
+            windows.append(toJson(summary));
+        }
+        response["windows"] = windows;
+        response["lifetime"] = toJson(m_statistics->lifetimeSummary());
+    } else if (command == "subscribe") {
+        client.subscribed = true;
+        client.droppedEvents = 0;
+    } else if (command == "unsubscribe") {
+        client.subscribed = false;
+        response["dropped"] = client.droppedEvents;
+    } else {
+        return fail(QString("unknown cmd: %1").arg(command));
+    }
+
+    response["ok"] = true;
+    return response;
+}
+
+/**
+ * @brief 模型重新加载配置的处理函数
+ * @details 行数和档位定义可能已变化，各客户端按旧配置暂存的目标值全部作废
+ */
+void AutomationServer::onModelReset()
+{
+    int dropped = 0;
+    for (Client &client : m_clients) {
+        dropped += client.stagedTargets.size();
+        client.stagedTargets.clear();
+    }
+    if (dropped > 0) {
+        qDebug() << "负载柜配置已变更，丢弃客户端暂存的目标值:" << dropped;
+    }
+}
+
+/**
+ * @brief 把各行目标值合并为一次批量写入
+ * @param targets 行索引 -> 目标值
+ * @param errorString 失败时的错误描述
+ * @return 是否全部可达并已提交
+ * @details 先求解全部行，任何一行不可达则整批拒绝，不产生部分写入
+ */
+bool AutomationServer::commitTargets(const QMap<int, double> &targets, QString *errorString)
+{
+    if (m_writeGuard) {
+        const QString reason = m_writeGuard();
+        if (!reason.isEmpty()) {
+            *errorString = reason;
+            return false;
+        }
+    }
+
+    QVector<RowCommit> commits;
+    for (auto it = targets.constBegin(); it != targets.constEnd(); ++it) {
+        const int row = it.key();
+        if (row < 0 || row >= m_model->rowCount()) {
+            *errorString = QString("row %1 out of range").arg(row);
+            return false;
+        }
+        const quint64 current = m_model->rowState(row)->bits();
+        LoadSolver::MinStepTable solver(m_model->config().row(row).stepUnits());
+        quint64 mask = 0;
+        if (!solver.solve(LoadSolver::MinStepTable::MinimumToggles, LoadSolver::toUnits(it.value()), current, &mask)) {
+            *errorString = QString("row %1 cannot reach %2").arg(row).arg(it.value());
+            return false;
+        }
+        if (mask == current) continue;
+
+        RowCommit commit;
+        commit.row = row;
+        commit.mask = mask;
+        commit.changedMask = mask ^ current;
+        commits.append(commit);
+    }
+
+    for (const RowCommit &commit : commits) {
+        emit rowCommitted(commit.row);
+    }
+    if (!commits.isEmpty()) {
+        m_model->commitRows(commits);
+    }
+    return true;
+}
+
+/**
+ * @brief 解析行引用
+ * @param value 行索引或行名称
+ * @return 行索引，无法解析时返回-1
+ */
+int AutomationServer::resolveRow(const QJsonValue &value) const
+{
+    if (value.isDouble()) {
+        const int row = value.toInt(-1);
+        return (row >= 0 && row < m_model->rowCount()) ? row : -1;
+    }
+    if (value.isString()) {
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            if (m_model->config().row(row).name.compare(value.toString(), Qt::CaseInsensitive) == 0) {
+                return row;
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 生成各行当前负载
+ * @return 行数组，每项包含row、name、value和mask
+ */
+QJsonArray AutomationServer::rowsSnapshot() const
+{
+    QJsonArray rows;
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        QJsonObject object;
+        object["row"] = row;
+        object["name"] = m_model->config().row(row).name;
+        object["value"] = static_cast<double>(m_model->rowUnits(row)) / LoadSolver::UNITS_PER_VALUE;
+        object["mask"] = QString::number(m_model->rowState(row)->bits(), 16);
+        rows.append(object);
+    }
+    return rows;
+}
+
+/**
+ * @brief 写一行JSON到客户端
+ * @param socket 客户端连接
+ * @param object JSON对象
+ */
+void AutomationServer::writeLine(QLocalSocket *socket, const QJsonObject &object)
+{
+    socket->write(QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n');
+}
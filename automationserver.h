@@ -0,0 +1,179 @@
+/**
+ * @file automationserver.h
+ * @brief 本地自动化接口定义文件
+ * @details 包含AutomationServer的声明。基于QLocalServer（Unix域套接字/Windows命名管道），
+ *          协议为JSON Lines：每个请求、应答和推送事件各占一行UTF-8编码的JSON对象
+ *
+ * 请求（id可选，原样带回应答）：
+ * @code
+ * {"id": 1, "cmd": "set", "row": 0, "value": 2.5}              // 立即设置一行
+ * {"id": 2, "cmd": "stage", "row": 3, "value": 1.0}            // 暂存一行目标值
+ * {"id": 3, "cmd": "commit"}                                   // 暂存的目标合并为一次批量写入
+ * {"id": 4, "cmd": "commit", "rows": [{"row": 0, "value": 2}, {"row": "L1", "value": 1}]}
+ * {"id": 5, "cmd": "rows"}                                     // 各行当前负载
+ * {"id": 6, "cmd": "voltage"}                                  // 最近一次电压
+ * {"id": 7, "cmd": "statistics"}                               // 各窗口与全程统计
+ * {"id": 8, "cmd": "subscribe"} / {"cmd": "unsubscribe"}       // 订阅/取消订阅电压流
+ * @endcode
+ * 应答：{"id": 1, "ok": true, ...} 或 {"id": 1, "ok": false, "error": "..."}；
+ * 推送：{"event": "voltage", "t": 单调时间戳毫秒, "v": 电压}
+ */
+
+#ifndef AUTOMATIONSERVER_H
+#define AUTOMATIONSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <functional>
+
+class QLocalServer;
+class QLocalSocket;
+class LoadBankModel;
+class VoltageStatistics;
+
+/**
+ * @class AutomationServer
+ * @brief 本地自动化接口服务器
+ * @details 服务器本身不访问总线：电压由现有的采集定时器通过publishVoltage推送，
+ *          每个样本只序列化一次后写给全部订阅者，订阅者数量不增加总线流量
+ */
+class AutomationServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char *DEFAULT_SERVER_NAME = "loadbank-automation";
+    static constexpr int MAX_LINE_LENGTH = 64 * 1024;           // 单个请求最大长度，超过时断开连接
+    static constexpr qint64 MAX_PENDING_BYTES = 256 * 1024;     // 订阅者未发出的数据超过该值时丢弃推送
+    static constexpr int PROBE_TIMEOUT_MS = 500;                // 名称被占用时探测已有实例的超时
+
+    /**
+     * @brief 构造函数
+     * @param model 负载柜数据模型
+     * @param statistics 电压流式统计
+     * @param parent 父对象指针
+     */
+    AutomationServer(LoadBankModel *model, VoltageStatistics *statistics, QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，关闭全部连接
+     */
+    ~AutomationServer();
+
+    /**
+     * @brief 开始监听
+     * @param name 服务器名称（Unix下为套接字文件名，Windows下为命名管道名）
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否开始监听
+     * @details 名称被占用时先尝试连接：能连上说明另一个实例正在使用，返回失败而不接管其连接；
+     *          连不上才视为上次异常退出残留的套接字文件，移除后重试
+     */
+    bool listen(const QString &name = QString(DEFAULT_SERVER_NAME), QString *errorString = nullptr);
+
+    /**
+     * @brief 设置写入检查
+     * @param guard 返回非空字符串时拒绝写入请求并作为错误原因（例如负载曲线或闭环稳压正在运行）
+     */
+    void setWriteGuard(std::function<QString()> guard);
+
+    /**
+     * @brief 当前连接数
+     * @return 客户端连接数
+     */
+    int clientCount() const;
+
+public slots:
+    /**
+     * @brief 推送一个电压样本给全部订阅者
+     * @param voltage 电压（V）
+     * @param timestampMs 单调时间戳（毫秒）
+     */
+    void publishVoltage(double voltage, qint64 timestampMs);
+
+signals:
+    /**
+     * @brief 某行的状态已由自动化接口写入
+     * @param row 行索引
+     */
+    void rowCommitted(int row);
+
+private slots:
+    /**
+     * @brief 新连接的处理函数
+     */
+    void onNewConnection();
+
+    /**
+     * @brief 模型重新加载配置的处理函数
+     */
+    void onModelReset();
+
+private:
+    /**
+     * @struct Client
+     * @brief 客户端连接状态
+     */
+    struct Client
+    {
+        bool subscribed = false;            // 是否订阅电压流
+        QMap<int, double> stagedTargets;    // 暂存的各行目标值
+        qint64 droppedEvents = 0;           // 因积压丢弃的推送数
+    };
+
+    /**
+     * @brief 读取并处理客户端的全部完整请求
+     * @param socket 客户端连接
+     */
+    void readRequests(QLocalSocket *socket);
+
+    /**
+     * @brief 处理一个请求
+     * @param client 客户端状态
+     * @param request 请求对象
+     * @return 应答对象
+     */
+    QJsonObject handleRequest(Client &client, const QJsonObject &request);
+
+    /**
+     * @brief 把各行目标值合并为一次批量写入
+     * @param targets 行索引 -> 目标值
+     * @param errorString 失败时的错误描述
+     * @return 是否全部可达并已提交
+     */
+    bool commitTargets(const QMap<int, double> &targets, QString *errorString);
+
+    /**
+     * @brief 解析行引用
+     * @param value 行索引或行名称
+     * @return 行索引，无法解析时返回-1
+     */
+    int resolveRow(const QJsonValue &value) const;
+
+    /**
+     * @brief 生成各行当前负载
+     * @return 行数组
+     */
+    QJsonArray rowsSnapshot() const;
+
+    /**
+     * @brief 写一行JSON到客户端
+     * @param socket 客户端连接
+     * @param object JSON对象
+     */
+    static void writeLine(QLocalSocket *socket, const QJsonObject &object);
+
+    QLocalServer *m_server;                         // 本地服务器
+    LoadBankModel *m_model;                         // 负载柜数据模型
+    VoltageStatistics *m_statistics;                // 电压流式统计
+    std::function<QString()> m_writeGuard;          // 写入检查
+    QHash<QLocalSocket*, Client> m_clients;         // 客户端连接状态
+    int m_subscriberCount;                          // 订阅电压流的客户端数
+    double m_lastVoltage;                           // 最近一次电压，尚无读数为-1
+    qint64 m_lastTimestampMs;                       // 最近一次电压的时间戳
+};
+
+#endif // AUTOMATIONSERVER_H
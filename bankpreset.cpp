@@ -0,0 +1,183 @@
+/**
+ * @file bankpreset.cpp
+ * @brief 负载柜预设实现文件
+ * @details 包含BankPresetStore类的实现
+ */
+
+#include "bankpreset.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QSaveFile>
+
+/**
+ * @brief 从文件加载预设
+ * @param path 文件路径
+ * @param errorString 失败时的错误描述
+ * @return 是否加载成功
+ */
+bool BankPresetStore::loadFromFile(const QString &path, QString *errorString)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) *errorString = message;
+        return false;
+    };
+
+    QFile file(path);
+    if (!file.exists()) {
+        m_path = path;
+        m_presets.clear();
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("无法打开文件 %1: %2").arg(path, file.errorString()));
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return fail(QString("JSON解析错误（偏移%1）: %2").arg(parseError.offset).arg(parseError.errorString()));
+    }
+
+    QVector<BankPreset> presets;
+    const QJsonArray items = document.object().value("presets").toArray();
+    for (int i = 0; i < items.size(); ++i) {
+        const QJsonObject item = items[i].toObject();
+        BankPreset preset;
+        preset.name = item.value("name").toString().trimmed();
+        if (preset.name.isEmpty()) {
+            return fail(QString("第%1个预设缺少名称").arg(i + 1));
+        }
+
+        for (const QJsonValue &row : item.value("rows").toArray()) {
+            bool ok = false;
+            preset.snapshot.rowBits.append(row.toString().toULongLong(&ok, 16));
+            if (!ok) return fail(QString("预设 %1 的行位掩码无效").arg(preset.name));
+        }
+
+        const QJsonObject registers = item.value("registers").toObject();
+        for (auto it = registers.constBegin(); it != registers.constEnd(); ++it) {
+            bool ok = false;
+            const int address = it.key().toInt(&ok);
+            const int value = it.value().toInt(-1);
+            if (!ok || address < 0 || value < 0 || value > 0xFFFF) {
+                return fail(QString("预设 %1 的寄存器 %2 无效").arg(preset.name, it.key()));
+            }
+            preset.snapshot.registers.insert(address, static_cast<quint16>(value));
+        }
+        presets.append(preset);
+    }
+
+    m_path = path;
+    m_presets = presets;
+    return true;
+}
+
+/**
+ * @brief 保存到加载时的文件
+ * @param errorString 失败时的错误描述
+ * @return 是否保存成功
+ */
+bool BankPresetStore::save(QString *errorString) const
+{
+    QJsonArray items;
+    for (const BankPreset &preset : m_presets) {
+        QJsonArray rows;
+        for (quint64 bits : preset.snapshot.rowBits) {
+            rows.append(QString::number(bits, 16));
+        }
+        QJsonObject registers;
+        for (auto it = preset.snapshot.registers.constBegin(); it != preset.snapshot.registers.constEnd(); ++it) {
+            registers.insert(QString::number(it.key()), int(it.value()));
+        }
+
+        QJsonObject item;
+        item.insert("name", preset.name);
+        item.insert("rows", rows);
+        item.insert("registers", registers);
+        items.append(item);
+    }
+    QJsonObject root;
+    root.insert("presets", items);
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString) *errorString = QString("无法打开文件 %1: %2").arg(m_path, file.errorString());
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        if (errorString) *errorString = QString("写入失败 %1: %2").arg(m_path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 获取全部预设名称
+ * @return 名称列表
+ */
+QStringList BankPresetStore::names() const
+{
+    QStringList result;
+    for (const BankPreset &preset : m_presets) {
+        result.append(preset.name);
+    }
+    return result;
+}
+
+/**
+ * @brief 按名称查找预设
+ * @param name 预设名称
+ * @param preset 输出预设
+ * @return 是否找到
+ */
+bool BankPresetStore::find(const QString &name, BankPreset *preset) const
+{
+    const int index = indexOf(name);
+    if (index < 0) return false;
+    if (preset) *preset = m_presets[index];
+    return true;
+}
+
+/**
+ * @brief 添加预设
+ * @param preset 预设
+ */
+void BankPresetStore::insert(const BankPreset &preset)
+{
+    const int index = indexOf(preset.name);
+    if (index >= 0) {
+        m_presets[index] = preset;
+    } else {
+        m_presets.append(preset);
+    }
+}
+
+/**
+ * @brief 删除预设
+ * @param name 预设名称
+ * @return 是否删除了预设
+ */
+bool BankPresetStore::remove(const QString &name)
+{
+    const int index = indexOf(name);
+    if (index < 0) return false;
+    m_presets.remove(index);
+    return true;
+}
+
+/**
+ * @brief 按名称查找预设下标
+ * @param name 预设名称
+ * @return 下标，未找到时返回-1
+ */
+int BankPresetStore::indexOf(const QString &name) const
+{
+    for (int i = 0; i < m_presets.size(); ++i) {
+        if (m_presets[i].name.compare(name, Qt::CaseInsensitive) == 0) return i;
+    }
+    return -1;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file bankpreset.h
+ * @brief 负载柜预设定义文件
+ * @details 包含BankPresetStore的声明。预设是命名的整柜快照（见LoadBankModel::captureSnapshot），
+ *          调用时由LoadBankModel::commitSnapshot以最少的写事务一次性切换全部行
+ *
+ * 预设文件格式示例（两行的负载柜；寄存器值为完整16位值，低字节一并保存，行位掩码为十六进制）：
+ * @code
+ * {
+ *     "presets": [
+ *         {
+ *             "name": "满载",
+ *             "rows": ["ff", "ff"],
+ *             "registers": { "0": 65280, "1": 65281 }
+ *         }
+ *     ]
+ * }
+ * @endcode
+ */
+
+#ifndef BANKPRESET_H
+#define BANKPRESET_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "loadbankmodel.h"
+
+/**
+ * @struct BankPreset
+ * @brief 命名的整柜快照
+ */
+struct BankPreset
+{
+    QString name;               // 预设名称
+    BankSnapshot snapshot;      // 整柜快照
+};
+
+/**
+ * @class BankPresetStore
+ * @brief 预设集合，保存在JSON文件中
+ */
+class BankPresetStore
+{
+public:
+    /**
+     * @brief 从文件加载预设
+     * @param path 文件路径，之后的保存也写入该文件
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否加载成功；文件不存在视为没有预设，失败时原有预设保持不变
+     */
+    bool loadFromFile(const QString &path, QString *errorString = nullptr);
+
+    /**
+     * @brief 保存到加载时的文件
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否保存成功
+     * @details 通过QSaveFile先写临时文件再替换，写入中断不会损坏原文件
+     */
+    bool save(QString *errorString = nullptr) const;
+
+    /**
+     * @brief 获取全部预设名称
+     * @return 按添加顺序的名称
+     */
+    QStringList names() const;
+
+    /**
+     * @brief 按名称查找预设
+     * @param name 预设名称（不区分大小写）
+     * @param preset 输出预设
+     * @return 是否找到
+     */
+    bool find(const QString &name, BankPreset *preset) const;
+
+    /**
+     * @brief 添加预设，同名预设被替换
+     * @param preset 预设
+     */
+    void insert(const BankPreset &preset);
+
+    /**
+     * @brief 删除预设
+     * @param name 预设名称（不区分大小写）
+     * @return 是否删除了预设
+     */
+    bool remove(const QString &name);
+
+private:
+    /**
+     * @brief 按名称查找预设下标
+     * @param name 预设名称
+     * @return 下标，未找到时返回-1
+     */
+    int indexOf(const QString &name) const;
+
+    QString m_path;                 // 预设文件路径
+    QVector<BankPreset> m_presets;  // 预设，按添加顺序
+};
+
+#endif // BANKPRESET_H
@@ -0,0 +1,523 @@
+/**
+ * @file banksolver.cpp
+ * @brief 整柜负载分配求解实现文件
+ * @details 包含BankSolveResult、BankSolver、BankSolverWorker和BankDistributor类的实现
+ */
+
+#include "banksolver.h"
+#include <QElapsedTimer>
+#include <QDebug>
+#include <array>
+#include <limits>
+
+constexpr int BankDistributor::DEFAULT_PHASE_TOLERANCE_UNITS;
+
+namespace
+{
+    constexpr qint64 UNREACHABLE = std::numeric_limits<qint64>::max();
+    constexpr qint64 COST_WEIGHT = 1 << 16;     // 主代价的权重，大于整柜档位总数，保证字典序
+
+    /**
+     * @struct RowOptions
+     * @brief 一行每个可达值的最小代价和对应位掩码
+     */
+    struct RowOptions
+    {
+        QVector<qint64> costs;      // 以取值（0.1为单位）为下标，不可达为UNREACHABLE
+        QVector<quint64> masks;
+    };
+
+    /**
+     * @struct GroupTable
+     * @brief 一组行（同一相或不分相）按行动态规划的结果
+     */
+    struct GroupTable
+    {
+        QVector<int> members;               // 组内的行（请求中的下标）
+        QVector<qint64> costs;              // 各组内之和的最小代价
+        QVector<QVector<int>> choices;      // choices[k][t]：前k+1行之和为t时第k行的取值
+    };
+
+    /**
+     * @struct SolutionKey
+     * @brief 组合的比较键：代价优先，其次三相之和的互差
+     */
+    struct SolutionKey
+    {
+        qint64 cost = UNREACHABLE;
+        int imbalance = 0;
+
+        bool operator<(const SolutionKey &other) const
+        {
+            return cost < other.cost || (cost == other.cost && imbalance < other.imbalance);
+        }
+    };
+
+    /**
+     * @brief 求出一行每个可达值的最小代价
+     * @param row 参与分配的行
+     * @param mode 代价优先级
+     * @return 各取值的代价和位掩码
+     * @details 与MinStepTable::solveMinToggles相同的0/1背包：先假定全部档位断开，
+     *          每个档位的闭合带来 ±切换权重 + 档位权重 的代价增量；一次动态规划得到全部取值
+     */
+    RowOptions rowOptions(const BankSolverRow &row, LoadSolver::MinStepTable::Mode mode)
+    {
+        const int stepCount = qMin(int(row.stepUnits.size()), LoadBankConfig::MAX_STEPS_PER_ROW);
+        const quint64 validBits = stepCount >= 64 ? ~Q_UINT64_C(0) : (Q_UINT64_C(1) << stepCount) - 1;
+        const quint64 current = row.currentMask & validBits;
+
+        int total = 0;
+        int currentUnits = 0;
+        for (int i = 0; i < stepCount; ++i) {
+            const int units = qMax(0, row.stepUnits[i]);
+            total += units;
+            if (current & (Q_UINT64_C(1) << i)) currentUnits += units;
+        }
+
+        RowOptions options;
+        if (row.locked) {
+            options.costs.fill(UNREACHABLE, currentUnits + 1);
+            options.masks.fill(0, currentUnits + 1);
+            options.costs[currentUnits] = 0;
+            options.masks[currentUnits] = current;
+            return options;
+        }
+
+        const bool toggleFirst = mode == LoadSolver::MinStepTable::MinimumToggles;
+        const qint64 toggleWeight = toggleFirst ? COST_WEIGHT : 1;
+        const qint64 stepWeight = toggleFirst ? 1 : COST_WEIGHT;
+
+        options.costs.fill(UNREACHABLE, total + 1);
+        options.masks.fill(0, total + 1);
+        options.costs[0] = qPopulationCount(current) * toggleWeight;
+        for (int i = 0; i < stepCount; ++i) {
+            const int units = row.stepUnits[i];
+            if (units <= 0) continue;
+
+            const quint64 stepBit = Q_UINT64_C(1) << i;
+            const qint64 delta = stepWeight + ((current & stepBit) ? -toggleWeight : toggleWeight);
+            for (int target = total; target >= units; --target) {
+                const qint64 previous = options.costs[target - units];
+                if (previous != UNREACHABLE && previous + delta < options.costs[target]) {
+                    options.costs[target] = previous + delta;
+                    options.masks[target] = options.masks[target - units] | stepBit;
+                }
+            }
+        }
+
+        const int limit = row.maxUnits < 0 ? total : qMin(total, row.maxUnits);
+        options.costs.resize(limit + 1);
+        options.masks.resize(limit + 1);
+        return options;
+    }
+
+    /**
+     * @brief 对一组行按行做min-plus卷积
+     * @param members 组内的行
+     * @param options 各行的取值代价
+     * @param cancelled 返回true时放弃
+     * @param group 输出组表
+     * @return 是否完成（未被放弃）
+     */
+    bool buildGroup(const QVector<int> &members, const QVector<RowOptions> &options,
+                    const std::function<bool()> &cancelled, GroupTable *group)
+    {
+        group->members = members;
+        group->costs = {0};
+        group->choices.clear();
+        for (int member : members) {
+            if (cancelled()) return false;
+
+            const QVector<qint64> &rowCosts = options[member].costs;
+            QVector<qint64> next(group->costs.size() + rowCosts.size() - 1, UNREACHABLE);
+            QVector<int> choice(next.size(), -1);
+            for (int t = 0; t < group->costs.size(); ++t) {
+                const qint64 base = group->costs[t];
+                if (base == UNREACHABLE) continue;
+                for (int u = 0; u < rowCosts.size(); ++u) {
+                    if (rowCosts[u] == UNREACHABLE) continue;
+                    const qint64 cost = base + rowCosts[u];
+                    if (cost < next[t + u]) {
+                        next[t + u] = cost;
+                        choice[t + u] = u;
+                    }
+                }
+            }
+            group->costs.swap(next);
+            group->choices.append(choice);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 由组表回溯组内各行的取值
+     * @param group 组表
+     * @param total 组内之和
+     * @param rowUnits 输出各行取值（按请求中的下标）
+     */
+    void backtrack(const GroupTable &group, int total, QVector<int> *rowUnits)
+    {
+        for (int k = group.members.size() - 1; k >= 0; --k) {
+            const int units = group.choices[k][total];
+            (*rowUnits)[group.members[k]] = units;
+            total -= units;
+        }
+    }
+
+    /**
+     * @brief 选择最接近目标的可达值
+     * @param reachable 返回该值是否可达
+     * @param size 可选值的个数（0至size-1）
+     * @param target 目标值
+     * @return 可达值，全部不可达时返回-1
+     */
+    int nearestReachable(const std::function<bool(int)> &reachable, int size, int target)
+    {
+        for (int distance = 0; distance < size + qAbs(target); ++distance) {
+            if (target - distance >= 0 && target - distance < size && reachable(target - distance)) {
+                return target - distance;
+            }
+            if (target + distance >= 0 && target + distance < size && reachable(target + distance)) {
+                return target + distance;
+            }
+        }
+        return -1;
+    }
+}
+
+/**
+ * @brief 生成提交各行的目标状态
+ * @param model 负载柜数据模型
+ * @return 状态有变化的行
+ */
+QVector<RowCommit> BankSolveResult::commits(const LoadBankModel *model) const
+{
+    QVector<RowCommit> result;
+    for (int i = 0; i < rows.size(); ++i) {
+        if (rows[i] < 0 || rows[i] >= model->rowCount()) continue;
+        const quint64 current = model->rowState(rows[i])->bits();
+        if (masks[i] == current) continue;
+        RowCommit commit;
+        commit.row = rows[i];
+        commit.mask = masks[i];
+        commit.changedMask = masks[i] ^ current;
+        result.append(commit);
+    }
+    return result;
+}
+
+/**
+ * @brief 生成结果描述文本
+ * @return 描述文本
+ */
+QString BankSolveResult::description() const
+{
+    if (!ok) {
+        return QString("目标 %1 无法分配：%2")
+                .arg(static_cast<double>(targetUnits) / LoadSolver::UNITS_PER_VALUE).arg(errorString);
+    }
+    return QString("目标 %1，分配 %2（各相 %3/%4/%5），切换 %6 次，耗时 %7 ms")
+            .arg(static_cast<double>(targetUnits) / LoadSolver::UNITS_PER_VALUE)
+            .arg(static_cast<double>(achievedUnits) / LoadSolver::UNITS_PER_VALUE)
+            .arg(static_cast<double>(phaseUnits[0]) / LoadSolver::UNITS_PER_VALUE)
+            .arg(static_cast<double>(phaseUnits[1]) / LoadSolver::UNITS_PER_VALUE)
+            .arg(static_cast<double>(phaseUnits[2]) / LoadSolver::UNITS_PER_VALUE)
+            .arg(toggles)
+            .arg(elapsedUs / 1000.0, 0, 'f', 2);
+}
+
+/**
+ * @brief 由模型当前状态生成分配请求
+ * @param model 负载柜数据模型
+ * @param targetUnits 总目标值
+ * @param unit 参与分配的行的单位
+ * @param phaseToleranceUnits 各相之和的最大互差
+ * @return 分配请求
+ */
+BankSolveRequest BankSolver::requestFromModel(const LoadBankModel *model, int targetUnits, const QString &unit,
+                                              int phaseToleranceUnits)
+{
+    BankSolveRequest request;
+    request.targetUnits = targetUnits;
+    request.phaseToleranceUnits = phaseToleranceUnits;
+    for (int r = 0; r < model->rowCount(); ++r) {
+        const LoadBankRow &rowConfig = model->config().row(r);
+        if (rowConfig.unit.compare(unit, Qt::CaseInsensitive) != 0) continue;
+
+        BankSolverRow row;
+        row.row = r;
+        row.stepUnits = rowConfig.stepUnits();
+        row.currentMask = model->rowState(r)->bits();
+        row.maxUnits = rowConfig.maxUnits;
+        row.phase = rowConfig.phase;
+        row.locked = rowConfig.locked;
+        request.rows.append(row);
+    }
+    return request;
+}
+
+/**
+ * @brief 求解
+ * @param request 分配请求
+ * @param cancelled 返回true时放弃求解
+ * @return 分配结果
+ */
+BankSolveResult BankSolver::solve(const BankSolveRequest &request, std::function<bool()> cancelled)
+{
+    QElapsedTimer clock;
+    clock.start();
+
+    BankSolveResult result;
+    result.generation = request.generation;
+    result.targetUnits = request.targetUnits;
+    auto isCancelled = [&result, &cancelled]() {
+        if (!result.cancelled && cancelled && cancelled()) {
+            result.cancelled = true;
+        }
+        return result.cancelled;
+    };
+    auto fail = [&result, &clock](const QString &message) {
+        result.errorString = message;
+        result.elapsedUs = clock.nsecsElapsed() / 1000;
+        return result;
+    };
+
+    if (request.rows.isEmpty()) {
+        return fail("没有参与分配的行");
+    }
+    if (isCancelled()) {
+        return fail("已放弃");
+    }
+
+    const int rowCount = request.rows.size();
+    QVector<RowOptions> options;
+    options.reserve(rowCount);
+    for (const BankSolverRow &row : request.rows) {
+        options.append(rowOptions(row, request.mode));
+    }
+
+    // 分组：要求平衡且至少两相有行时按相分组，否则全部行为一组
+    QVector<int> phaseMembers[3];
+    QVector<int> freeMembers;
+    for (int i = 0; i < rowCount; ++i) {
+        const int phase = request.rows[i].phase;
+        if (phase >= 0 && phase < 3) {
+            phaseMembers[phase].append(i);
+        } else {
+            freeMembers.append(i);
+        }
+    }
+    QVector<int> phases;
+    int maxPhaseRange = 0;
+    for (int phase = 0; phase < 3; ++phase) {
+        if (phaseMembers[phase].isEmpty()) continue;
+        phases.append(phase);
+        int range = 0;
+        for (int member : phaseMembers[phase]) range += options[member].costs.size() - 1;
+        maxPhaseRange = qMax(maxPhaseRange, range);
+    }
+    // 容差不小于任一相的取值范围时约束不起作用，按一组求解（枚举量与容差的平方成正比）
+    const int tolerance = request.phaseToleranceUnits;
+    const bool balance = tolerance >= 0 && tolerance < maxPhaseRange && phases.size() >= 2;
+
+    QVector<int> rowUnits(rowCount, 0);
+    if (!balance) {
+        QVector<int> members;
+        for (int i = 0; i < rowCount; ++i) members.append(i);
+        GroupTable group;
+        if (!buildGroup(members, options, isCancelled, &group)) {
+            return fail("已放弃");
+        }
+        const int total = nearestReachable([&group](int t) { return group.costs[t] != UNREACHABLE; },
+                                           group.costs.size(), request.targetUnits);
+        if (total < 0) {
+            return fail("没有可达的分配");
+        }
+        backtrack(group, total, &rowUnits);
+    } else {
+        GroupTable phaseGroups[3];
+        GroupTable freeGroup;
+        for (int phase : phases) {
+            if (!buildGroup(phaseMembers[phase], options, isCancelled, &phaseGroups[phase])) {
+                return fail("已放弃");
+            }
+        }
+        if (!buildGroup(freeMembers, options, isCancelled, &freeGroup)) {
+            return fail("已放弃");
+        }
+
+        // 枚举互差不超过容差的各相之和，按三相总和记录最优组合
+        int phaseSumSize = 1;
+        for (int phase : phases) phaseSumSize += phaseGroups[phase].costs.size() - 1;
+        QVector<SolutionKey> phaseBest(phaseSumSize);
+        QVector<std::array<int, 3>> phaseArg(phaseSumSize);
+
+        std::array<int, 3> totals = {0, 0, 0};
+        std::function<void(int, qint64, int, int)> enumerate = [&](int index, qint64 cost, int low, int high) {
+            if (index == phases.size()) {
+                const int sum = totals[0] + totals[1] + totals[2];
+                const SolutionKey key{cost, high - low};
+                if (key < phaseBest[sum]) {
+                    phaseBest[sum] = key;
+                    phaseArg[sum] = totals;
+                }
+                return;
+            }
+            const QVector<qint64> &costs = phaseGroups[phases[index]].costs;
+            const int from = index == 0 ? 0 : qMax(0, high - tolerance);
+            const int to = index == 0 ? costs.size() - 1 : qMin(int(costs.size()) - 1, low + tolerance);
+            for (int t = from; t <= to; ++t) {
+                if (costs[t] == UNREACHABLE) continue;
+                if (index + 1 < phases.size() && isCancelled()) return;
+                totals[phases[index]] = t;
+                enumerate(index + 1, cost + costs[t], index == 0 ? t : qMin(low, t), index == 0 ? t : qMax(high, t));
+            }
+            totals[phases[index]] = 0;
+        };
+        enumerate(0, 0, 0, 0);
+        if (isCancelled()) {
+            return fail("已放弃");
+        }
+
+        // 与不分相的行合并
+        const QVector<qint64> &freeCosts = freeGroup.costs;
+        QVector<SolutionKey> best(phaseSumSize + freeCosts.size() - 1);
+        QVector<int> bestPhaseSum(best.size(), -1);
+        for (int sum = 0; sum < phaseSumSize; ++sum) {
+            if (phaseBest[sum].cost == UNREACHABLE) continue;
+            for (int t = 0; t < freeCosts.size(); ++t) {
+                if (freeCosts[t] == UNREACHABLE) continue;
+                const SolutionKey key{phaseBest[sum].cost + freeCosts[t], phaseBest[sum].imbalance};
+                if (key < best[sum + t]) {
+                    best[sum + t] = key;
+                    bestPhaseSum[sum + t] = sum;
+                }
+            }
+        }
+
+        const int total = nearestReachable([&best](int t) { return best[t].cost != UNREACHABLE; },
+                                           best.size(), request.targetUnits);
+        if (total < 0) {
+            return fail(QString("各相之和无法在容差%1以内")
+                        .arg(static_cast<double>(tolerance) / LoadSolver::UNITS_PER_VALUE));
+        }
+        const int phaseSum = bestPhaseSum[total];
+        for (int phase : phases) {
+            backtrack(phaseGroups[phase], phaseArg[phaseSum][phase], &rowUnits);
+        }
+        backtrack(freeGroup, total - phaseSum, &rowUnits);
+    }
+
+    result.ok = true;
+    for (int i = 0; i < rowCount; ++i) {
+        const BankSolverRow &row = request.rows[i];
+        const quint64 mask = options[i].masks[rowUnits[i]];
+        result.rows.append(row.row);
+        result.masks.append(mask);
+        result.rowUnits.append(rowUnits[i]);
+        result.achievedUnits += rowUnits[i];
+        if (row.phase >= 0 && row.phase < 3) {
+            result.phaseUnits[row.phase] += rowUnits[i];
+        }
+        result.toggles += qPopulationCount(mask ^ row.currentMask);
+        result.steps += qPopulationCount(mask);
+    }
+    result.elapsedUs = clock.nsecsElapsed() / 1000;
+    return result;
+}
+
+/**
+ * @brief 构造函数
+ * @param latestGeneration 最新请求代号
+ */
+BankSolverWorker::BankSolverWorker(std::shared_ptr<std::atomic<quint64>> latestGeneration)
+    : QObject(nullptr)
+    , m_latestGeneration(latestGeneration)
+{
+}
+
+/**
+ * @brief 求解一个请求
+ * @param request 分配请求
+ * @details 代号在求解的各检查点与最新代号比较，不一致即放弃
+ */
+void BankSolverWorker::solve(const BankSolveRequest &request)
+{
+    const quint64 generation = request.generation;
+    std::shared_ptr<std::atomic<quint64>> latest = m_latestGeneration;
+    emit finished(BankSolver::solve(request, [latest, generation]() {
+        return latest->load(std::memory_order_relaxed) != generation;
+    }));
+}
+
+/**
+ * @brief 构造函数，启动求解线程
+ * @param parent 父对象指针
+ */
+BankDistributor::BankDistributor(QObject *parent)
+    : QObject(parent)
+    , m_worker(nullptr)
+    , m_latestGeneration(std::make_shared<std::atomic<quint64>>(0))
+    , m_deliveredGeneration(0)
+{
+    qRegisterMetaType<BankSolveResult>();
+
+    m_worker = new BankSolverWorker(m_latestGeneration);
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &BankSolverWorker::finished, this, [this](const BankSolveResult &result) {
+        // 结果排队送达期间可能已有更新的请求
+        if (result.cancelled || result.generation != m_latestGeneration->load()) {
+            return;
+        }
+        m_deliveredGeneration = result.generation;
+        if (result.ok) {
+            qDebug() << "整柜分配 -" << result.description();
+        }
+        emit solved(result);
+    });
+
+    m_thread.setObjectName("BankSolver");
+    m_thread.start();
+}
+
+/**
+ * @brief 析构函数，放弃进行中的求解并停止线程
+ */
+BankDistributor::~BankDistributor()
+{
+    cancel();
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/**
+ * @brief 提交分配请求
+ * @param request 分配请求
+ * @return 请求代号
+ */
+quint64 BankDistributor::submit(BankSolveRequest request)
+{
+    request.generation = ++(*m_latestGeneration);
+    BankSolverWorker *worker = m_worker;
+    QMetaObject::invokeMethod(m_worker, [worker, request]() { worker->solve(request); }, Qt::QueuedConnection);
+    return request.generation;
+}
+
+/**
+ * @brief 放弃进行中和排队中的请求
+ */
+void BankDistributor::cancel()
+{
+    m_deliveredGeneration = ++(*m_latestGeneration);
+}
+
+/**
+ * @brief 是否有尚未送达结果的请求
+ * @return 最新请求是否仍在求解
+ */
+bool BankDistributor::isBusy() const
+{
+    return m_deliveredGeneration != m_latestGeneration->load();
+}
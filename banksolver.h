@@ -0,0 +1,211 @@
+/**
+ * @file banksolver.h
+ * @brief 整柜负载分配求解定义文件
+ * @details 包含BankSolveRequest、BankSolveResult、BankSolver和BankDistributor的声明。
+ *          单行的lineEditSum只在本行的档位内求解；整柜分配把一个总目标值分配到同一单位的全部行，
+ *          同时满足各行上限、锁定行和三相平衡约束，并使相对当前状态切换的继电器最少
+ *
+ * 求解方法：
+ * 1. 每行用0/1背包动态规划一次求出该行每个可达值的最小代价（切换次数优先，其次档位数），O(档位数 × 档位总和)；
+ * 2. 同一相的行按行做min-plus卷积（按行动态规划并记录每行的取值，用于回溯）；
+ * 3. 不要求平衡时全部行视为一组；要求平衡时枚举各相之和互差不超过容差的组合（枚举量与容差的平方成正比），
+ *    再与不分相的行合并；
+ * 4. 总目标不可达时取最接近的可达值（距离相同取较小者）。
+ * 默认配置（同一单位3行、每行8档）求解不到1 ms，9行72档全部参与且按1.0的容差平衡时约2 ms；
+ * 后台线程求解时新目标到达即放弃旧的求解
+ */
+
+#ifndef BANKSOLVER_H
+#define BANKSOLVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QString>
+#include <QMetaType>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "loadsolver.h"
+#include "loadbankmodel.h"
+
+/**
+ * @struct BankSolverRow
+ * @brief 参与分配的一行
+ */
+struct BankSolverRow
+{
+    int row = 0;                // 模型中的行索引
+    QVector<int> stepUnits;     // 各档位值（0.1为单位）
+    quint64 currentMask = 0;    // 当前继电器位掩码
+    int maxUnits = -1;          // 负载上限（0.1为单位），-1为不限制
+    int phase = -1;             // 所接的相（0-2），-1为不分相
+    bool locked = false;        // 是否保持当前状态
+};
+
+/**
+ * @struct BankSolveRequest
+ * @brief 一次整柜分配请求
+ */
+struct BankSolveRequest
+{
+    quint64 generation = 0;                 // 请求代号，由BankDistributor分配
+    int targetUnits = 0;                    // 总目标值（0.1为单位）
+    QVector<BankSolverRow> rows;            // 参与分配的行
+    int phaseToleranceUnits = -1;           // 各相之和的最大互差（0.1为单位），-1为不要求平衡
+    LoadSolver::MinStepTable::Mode mode = LoadSolver::MinStepTable::MinimumToggles;    // 代价优先级
+};
+
+/**
+ * @struct BankSolveResult
+ * @brief 整柜分配结果
+ */
+struct BankSolveResult
+{
+    quint64 generation = 0;         // 对应的请求代号
+    bool ok = false;                // 是否找到分配
+    bool cancelled = false;         // 是否因新请求而放弃
+    QString errorString;            // 未找到分配时的原因
+    int targetUnits = 0;            // 总目标值（0.1为单位）
+    int achievedUnits = 0;          // 实际分配的总值（0.1为单位）
+    QVector<int> rows;              // 各行在模型中的行索引，与请求中的行顺序相同
+    QVector<quint64> masks;         // 各行目标位掩码
+    QVector<int> rowUnits;          // 各行分配值（0.1为单位）
+    int phaseUnits[3] = {0, 0, 0};  // 各相之和（0.1为单位）
+    int toggles = 0;                // 相对当前状态切换的继电器数
+    int steps = 0;                  // 闭合的档位数
+    qint64 elapsedUs = 0;           // 求解耗时（微秒）
+
+    /**
+     * @brief 生成提交各行的目标状态
+     * @param model 负载柜数据模型，变化档位相对其当前状态计算
+     * @return 状态有变化的行
+     */
+    QVector<RowCommit> commits(const LoadBankModel *model) const;
+
+    /**
+     * @brief 生成结果描述文本
+     * @return 目标、实际值、切换次数和耗时
+     */
+    QString description() const;
+};
+
+Q_DECLARE_METATYPE(BankSolveResult)
+
+/**
+ * @class BankSolver
+ * @brief 整柜负载分配求解器
+ */
+class BankSolver
+{
+public:
+    /**
+     * @brief 由模型当前状态生成分配请求
+     * @param model 负载柜数据模型
+     * @param targetUnits 总目标值（0.1为单位）
+     * @param unit 参与分配的行的单位（KW/Kvar，不区分大小写）
+     * @param phaseToleranceUnits 各相之和的最大互差，-1为不要求平衡
+     * @return 分配请求，各行上限、相序和是否锁定取自配置
+     */
+    static BankSolveRequest requestFromModel(const LoadBankModel *model, int targetUnits, const QString &unit,
+                                             int phaseToleranceUnits);
+
+    /**
+     * @brief 求解
+     * @param request 分配请求
+     * @param cancelled 返回true时放弃求解，可为空
+     * @return 分配结果
+     */
+    static BankSolveResult solve(const BankSolveRequest &request, std::function<bool()> cancelled = nullptr);
+};
+
+/**
+ * @class BankSolverWorker
+ * @brief 后台线程中的求解执行者
+ */
+class BankSolverWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param latestGeneration 最新请求代号，与BankDistributor共享
+     */
+    explicit BankSolverWorker(std::shared_ptr<std::atomic<quint64>> latestGeneration);
+
+    /**
+     * @brief 求解一个请求，代号已过期时立即放弃
+     * @param request 分配请求
+     */
+    void solve(const BankSolveRequest &request);
+
+signals:
+    /**
+     * @brief 求解结束（包括放弃）
+     * @param result 分配结果
+     */
+    void finished(const BankSolveResult &result);
+
+private:
+    std::shared_ptr<std::atomic<quint64>> m_latestGeneration;
+};
+
+/**
+ * @class BankDistributor
+ * @brief 整柜分配的后台求解
+ * @details 在GUI线程使用：请求排队送到求解线程，每个新请求使代号加一，
+ *          正在进行和排队中的旧请求在下一个检查点发现代号过期后放弃；只有最新请求的结果通过solved送达
+ */
+class BankDistributor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_PHASE_TOLERANCE_UNITS = 10;    // 默认三相之和最大互差（1.0）
+
+    /**
+     * @brief 构造函数，启动求解线程
+     * @param parent 父对象指针
+     */
+    explicit BankDistributor(QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，放弃进行中的求解并停止线程
+     */
+    ~BankDistributor();
+
+    /**
+     * @brief 提交分配请求（异步，立即返回）
+     * @param request 分配请求，代号由本函数分配
+     * @return 请求代号
+     */
+    quint64 submit(BankSolveRequest request);
+
+    /**
+     * @brief 放弃进行中和排队中的请求
+     */
+    void cancel();
+
+    /**
+     * @brief 是否有尚未送达结果的请求
+     * @return 最新请求是否仍在求解
+     */
+    bool isBusy() const;
+
+signals:
+    /**
+     * @brief 最新请求求解完成
+     * @param result 分配结果
+     */
+    void solved(const BankSolveResult &result);
+
+private:
+    QThread m_thread;                                           // 求解线程
+    BankSolverWorker *m_worker;                                 // 求解执行者（位于求解线程）
+    std::shared_ptr<std::atomic<quint64>> m_latestGeneration;   // 最新请求代号
+    quint64 m_deliveredGeneration;                              // 最近送达结果的代号
+};
+
+#endif // BANKSOLVER_H
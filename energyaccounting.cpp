@@ -0,0 +1,431 @@
+/**
+ * @file energyaccounting.cpp
+ * @brief 电能与继电器动作统计实现文件
+ * @details 包含EnergyAccounting类的实现：梯形积分、继电器动作与接通时间统计以及JSON检查点的读写
+ */
+
+#include "energyaccounting.h"
+#include "loadbankmodel.h"
+#include "loadsolver.h"
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QSaveFile>
+#include <QDebug>
+
+constexpr int EnergyAccounting::CHECKPOINT_INTERVAL_MS;
+constexpr qint64 EnergyAccounting::MAX_GAP_MS;
+constexpr double EnergyAccounting::DEFAULT_NOMINAL_VOLTAGE;
+
+namespace {
+constexpr double MS_PER_HOUR = 3600000.0;
+constexpr int CHECKPOINT_VERSION = 1;
+}
+
+/**
+ * @brief 构造函数
+ * @param model 负载柜数据模型
+ * @param clock 已启动的单调时钟
+ * @param parent 父对象指针
+ */
+EnergyAccounting::EnergyAccounting(LoadBankModel *model, QElapsedTimer clock, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_clock(clock)
+    , m_nominalVoltage(DEFAULT_NOMINAL_VOLTAGE)
+    , m_voltage(-1.0)
+    , m_lastNodeMs(-1)
+    , m_synchronized(false)
+    , m_dirty(false)
+{
+    rebuildRows();
+
+    connect(m_model, &LoadBankModel::rowStateChanged, this, &EnergyAccounting::onRowStateChanged);
+    connect(m_model, &LoadBankModel::modelReset, this, &EnergyAccounting::onModelReset);
+    connect(m_model, &LoadBankModel::refreshFinished, this, &EnergyAccounting::onRefreshFinished);
+
+    m_checkpointTimer.setInterval(CHECKPOINT_INTERVAL_MS);
+    connect(&m_checkpointTimer, &QTimer::timeout, this, [this]() {
+        QString error;
+        if (!checkpoint(&error)) {
+            qWarning() << "电能检查点保存失败:" << error;
+        }
+    });
+}
+
+/**
+ * @brief 析构函数，保存最后一次检查点
+ * @details 不访问模型：模型可能先于本对象销毁
+ */
+EnergyAccounting::~EnergyAccounting()
+{
+    QString error;
+    if (!checkpoint(&error)) {
+        qWarning() << "电能检查点保存失败:" << error;
+    }
+}
+
+/**
+ * @brief 设置检查点文件：读取已有计数并开始定期保存
+ * @param path 检查点文件路径
+ * @param errorString 失败时的错误描述
+ * @return 文件不存在或读取成功时返回true
+ * @details 文件中的计数按行名称累加到当前计数上；档位数或单位与当前配置不符的行无法对应到同一组继电器，予以丢弃。
+ *          读取失败时仍使用该路径定期保存（覆盖无法解析的文件）
+ */
+bool EnergyAccounting::setCheckpointPath(const QString &path, QString *errorString)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) *errorString = message;
+        qWarning() << "电能检查点读取失败:" << message;
+        return false;
+    };
+
+    m_checkpointPath = path;
+    m_checkpointTimer.start();
+
+    QFile file(path);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("无法打开文件 %1: %2").arg(path, file.errorString()));
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return fail(QString("JSON解析错误（偏移%1）: %2").arg(parseError.offset).arg(parseError.errorString()));
+    }
+    const QJsonObject root = document.object();
+    if (root.value("version").toInt() != CHECKPOINT_VERSION) {
+        return fail(QString("不支持的版本: %1").arg(root.value("version").toInt()));
+    }
+
+    const QJsonArray rowArray = root.value("rows").toArray();
+    for (const QJsonValue &rowValue : rowArray) {
+        const QJsonObject rowObject = rowValue.toObject();
+        const QString name = rowObject.value("name").toString();
+        const QJsonArray stepArray = rowObject.value("steps").toArray();
+
+        RowTracker *tracker = nullptr;
+        for (RowTracker &candidate : m_rows) {
+            if (candidate.account.name == name) {
+                tracker = &candidate;
+                break;
+            }
+        }
+        if (!tracker || tracker->account.unit != rowObject.value("unit").toString()
+            || tracker->account.steps.size() != stepArray.size()) {
+            qWarning() << "电能检查点中的行" << name << "与当前配置不符，已丢弃";
+            continue;
+        }
+
+        tracker->account.energy += rowObject.value("energy").toDouble();
+        for (int step = 0; step < stepArray.size(); ++step) {
+            const QJsonObject stepObject = stepArray[step].toObject();
+            StepCounters &counters = tracker->account.steps[step];
+            counters.operations += quint64(stepObject.value("operations").toDouble());
+            counters.onTimeMs += qint64(stepObject.value("onTimeMs").toDouble());
+        }
+    }
+
+    qDebug() << "电能检查点已读取:" << path << formatSummary();
+    return true;
+}
+
+/**
+ * @brief 设置额定电压
+ * @param voltage 档位功率对应的电压（V）
+ */
+void EnergyAccounting::setNominalVoltage(double voltage)
+{
+    if (voltage > 0.0) {
+        m_nominalVoltage = voltage;
+    }
+}
+
+/**
+ * @brief 加入一个电压样本
+ * @param voltage 电压（V）
+ * @param timestampMs 单调时间戳（毫秒）
+ * @details 先更新电压再推进，使本节点的功率按新电压计算
+ */
+void EnergyAccounting::addVoltageSample(double voltage, qint64 timestampMs)
+{
+    m_voltage = voltage;
+    advance(timestampMs);
+}
+
+/**
+ * @brief 获取各行累计值
+ * @return 各行电能与档位计数
+ */
+QVector<RowAccount> EnergyAccounting::accounts() const
+{
+    const qint64 nowMs = m_clock.elapsed();
+    QVector<RowAccount> result;
+    result.reserve(m_rows.size());
+    for (const RowTracker &tracker : m_rows) {
+        RowAccount account = tracker.account;
+        for (int step = 0; step < account.steps.size(); ++step) {
+            if (tracker.onSinceMs[step] >= 0) {
+                account.steps[step].onTimeMs += nowMs - tracker.onSinceMs[step];
+            }
+        }
+        result.append(account);
+    }
+    return result;
+}
+
+/**
+ * @brief 按单位汇总的电能
+ * @return 功率单位 -> 累计电能
+ */
+QMap<QString, double> EnergyAccounting::totals() const
+{
+    QMap<QString, double> result;
+    for (const RowTracker &tracker : m_rows) {
+        result[tracker.account.unit] += tracker.account.energy;
+    }
+    return result;
+}
+
+/**
+ * @brief 生成电能摘要
+ * @return 各单位电能与继电器动作总次数
+ */
+QString EnergyAccounting::formatSummary() const
+{
+    QStringList parts;
+    const QMap<QString, double> sums = totals();
+    for (auto it = sums.constBegin(); it != sums.constEnd(); ++it) {
+        parts << QString("%1h=%2").arg(it.key()).arg(it.value(), 0, 'f', 3);
+    }
+    quint64 operations = 0;
+    for (const RowTracker &tracker : m_rows) {
+        for (const StepCounters &counters : tracker.account.steps) {
+            operations += counters.operations;
+        }
+    }
+    parts << QString("ops=%1").arg(operations);
+    return parts.join(' ');
+}
+
+/**
+ * @brief 立即保存检查点
+ * @param errorString 失败时的错误描述
+ * @return 是否保存成功
+ * @details 计数没有变化且没有接通的档位时跳过写入；通过QSaveFile先写临时文件再替换，写入中断不会损坏上一个检查点
+ */
+bool EnergyAccounting::checkpoint(QString *errorString)
+{
+    if (m_checkpointPath.isEmpty()) {
+        return true;
+    }
+    bool anyOn = false;
+    for (const RowTracker &tracker : m_rows) {
+        anyOn = anyOn || tracker.bits != 0;
+    }
+    if (!m_dirty && !anyOn) {
+        return true;
+    }
+
+    QJsonArray rowArray;
+    for (const RowAccount &account : accounts()) {
+        QJsonArray stepArray;
+        for (const StepCounters &counters : account.steps) {
+            QJsonObject stepObject;
+            stepObject["operations"] = double(counters.operations);
+            stepObject["onTimeMs"] = double(counters.onTimeMs);
+            stepArray.append(stepObject);
+        }
+        QJsonObject rowObject;
+        rowObject["name"] = account.name;
+        rowObject["unit"] = account.unit;
+        rowObject["energy"] = account.energy;
+        rowObject["steps"] = stepArray;
+        rowArray.append(rowObject);
+    }
+    QJsonObject root;
+    root["version"] = CHECKPOINT_VERSION;
+    root["savedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    root["rows"] = rowArray;
+
+    QSaveFile file(m_checkpointPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString) *errorString = QString("无法打开文件 %1: %2").arg(m_checkpointPath, file.errorString());
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        if (errorString) *errorString = QString("写入失败 %1: %2").arg(m_checkpointPath, file.errorString());
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+/**
+ * @brief 清零全部计数
+ * @details 当前接通的档位从此刻重新计时
+ */
+void EnergyAccounting::reset()
+{
+    const qint64 nowMs = m_clock.elapsed();
+    for (RowTracker &tracker : m_rows) {
+        tracker.account.energy = 0.0;
+        for (int step = 0; step < tracker.account.steps.size(); ++step) {
+            tracker.account.steps[step] = StepCounters();
+            if (tracker.onSinceMs[step] >= 0) {
+                tracker.onSinceMs[step] = nowMs;
+            }
+        }
+    }
+    m_dirty = true;
+}
+
+/**
+ * @brief 行状态变化的处理函数
+ * @param row 行索引
+ * @details 先以变化前的功率积分到当前时刻，再按变化的位统计动作次数和接通时间，最后以新功率作为积分起点
+ */
+void EnergyAccounting::onRowStateChanged(int row)
+{
+    if (row < 0 || row >= m_rows.size()) {
+        return;
+    }
+    const qint64 nowMs = m_clock.elapsed();
+    advance(nowMs);
+
+    RowTracker &tracker = m_rows[row];
+    const quint64 bits = m_model->rowState(row)->bits();
+    const quint64 changed = bits ^ tracker.bits;
+    for (int step = 0; step < tracker.account.steps.size(); ++step) {
+        if (!((changed >> step) & 0x01)) {
+            continue;
+        }
+        if (m_synchronized) {
+            ++tracker.account.steps[step].operations;
+        }
+        if ((bits >> step) & 0x01) {
+            tracker.onSinceMs[step] = nowMs;
+        } else if (tracker.onSinceMs[step] >= 0) {
+            tracker.account.steps[step].onTimeMs += nowMs - tracker.onSinceMs[step];
+            tracker.onSinceMs[step] = -1;
+        }
+    }
+    tracker.bits = bits;
+    tracker.ratedPower = m_model->rowUnits(row) / double(LoadSolver::UNITS_PER_VALUE);
+    tracker.lastPower = tracker.ratedPower * voltageFactor();
+    m_dirty = true;
+}
+
+/**
+ * @brief 配置重新加载的处理函数
+ * @details 模型重置时各行状态清零，下一次刷新读回的状态只作为起点，不计入继电器动作
+ */
+void EnergyAccounting::onModelReset()
+{
+    advance(m_clock.elapsed());
+    rebuildRows();
+    m_synchronized = false;
+}
+
+/**
+ * @brief 批量刷新完成的处理函数
+ * @param ok 是否全部成功
+ */
+void EnergyAccounting::onRefreshFinished(bool ok)
+{
+    if (ok && !m_synchronized) {
+        m_synchronized = true;
+        qDebug() << "继电器状态已同步，开始统计继电器动作";
+    }
+}
+
+/**
+ * @brief 按模型配置重建各行
+ * @details 名称、单位和档位数都不变的行沿用原计数，其仍接通的档位结算到当前时刻后重新计时
+ */
+void EnergyAccounting::rebuildRows()
+{
+    const qint64 nowMs = m_clock.elapsed();
+    const LoadBankConfig &config = m_model->config();
+    const int rowCount = m_model->rowCount();
+
+    QVector<RowTracker> rows;
+    rows.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        const LoadBankRow &definition = config.row(row);
+        RowTracker tracker;
+        tracker.account.name = definition.name;
+        tracker.account.unit = definition.unit;
+        tracker.account.steps.resize(definition.steps.size());
+
+        for (const RowTracker &previous : m_rows) {
+            if (previous.account.name == definition.name && previous.account.unit == definition.unit
+                && previous.account.steps.size() == definition.steps.size()) {
+                tracker.account = previous.account;
+                for (int step = 0; step < previous.onSinceMs.size(); ++step) {
+                    if (previous.onSinceMs[step] >= 0) {
+                        tracker.account.steps[step].onTimeMs += nowMs - previous.onSinceMs[step];
+                    }
+                }
+                break;
+            }
+        }
+
+        tracker.bits = m_model->rowState(row)->bits();
+        tracker.ratedPower = m_model->rowUnits(row) / double(LoadSolver::UNITS_PER_VALUE);
+        tracker.lastPower = tracker.ratedPower * voltageFactor();
+        tracker.onSinceMs.fill(-1, definition.steps.size());
+        for (int step = 0; step < definition.steps.size(); ++step) {
+            if ((tracker.bits >> step) & 0x01) {
+                tracker.onSinceMs[step] = nowMs;
+            }
+        }
+        rows.append(tracker);
+    }
+    m_rows.swap(rows);
+}
+
+/**
+ * @brief 按梯形积分推进到指定时刻
+ * @param timestampMs 单调时间戳
+ * @details 早于上一节点的时间戳（乱序到达）被忽略；间隔超过MAX_GAP_MS时只把该时刻作为新的积分起点
+ */
+void EnergyAccounting::advance(qint64 timestampMs)
+{
+    if (m_lastNodeMs >= 0 && timestampMs < m_lastNodeMs) {
+        return;
+    }
+    const double factor = voltageFactor();
+    const qint64 dtMs = m_lastNodeMs >= 0 ? timestampMs - m_lastNodeMs : 0;
+    const bool integrate = dtMs > 0 && dtMs <= MAX_GAP_MS;
+    for (RowTracker &tracker : m_rows) {
+        const double power = tracker.ratedPower * factor;
+        if (integrate && (tracker.lastPower != 0.0 || power != 0.0)) {
+            tracker.account.energy += (tracker.lastPower + power) * 0.5 * dtMs / MS_PER_HOUR;
+            m_dirty = true;
+        }
+        tracker.lastPower = power;
+    }
+    m_lastNodeMs = timestampMs;
+}
+
+/**
+ * @brief 当前电压下的功率系数
+ * @return (电压/额定电压)²
+ */
+double EnergyAccounting::voltageFactor() const
+{
+    if (m_voltage < 0.0) {
+        return 1.0;
+    }
+    const double ratio = m_voltage / m_nominalVoltage;
+    return ratio * ratio;
+}
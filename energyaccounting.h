@@ -0,0 +1,185 @@
+/**
+ * @file energyaccounting.h
+ * @brief 电能与继电器动作统计定义文件
+ * @details 包含StepCounters、RowAccount和EnergyAccounting的声明。
+ *          按单调时间戳对各行功率做梯形积分得到各行及按单位汇总的电能，
+ *          统计每个档位继电器的动作次数和累计接通时间，供维护计划使用；计数定期保存到检查点文件
+ */
+
+#ifndef ENERGYACCOUNTING_H
+#define ENERGYACCOUNTING_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include <QMap>
+#include <QString>
+
+class LoadBankModel;
+
+/**
+ * @struct StepCounters
+ * @brief 一个档位继电器的累计计数
+ */
+struct StepCounters
+{
+    quint64 operations = 0;     // 动作次数（接通与断开各计一次）
+    qint64 onTimeMs = 0;        // 累计接通时间（毫秒）
+};
+
+/**
+ * @struct RowAccount
+ * @brief 一行的累计电能与继电器计数
+ */
+struct RowAccount
+{
+    QString name;                   // 行名称
+    QString unit;                   // 功率单位（KW/Kvar），电能单位为其后加h
+    double energy = 0.0;            // 累计电能（单位·小时）
+    QVector<StepCounters> steps;    // 各档位计数
+};
+
+/**
+ * @class EnergyAccounting
+ * @brief 电能与继电器动作统计
+ * @details 各行实际功率取额定功率（档位之和）乘以(电压/额定电压)²；每个电压样本和每次状态变化都是一个积分节点，
+ *          节点之间按梯形积分。状态变化时先用变化前的功率积分到变化时刻，再以新功率继续，阶跃不被梯形平滑。
+ *          相邻节点间隔超过MAX_GAP_MS（如总线断开）时该段不计入。
+ *          首次成功刷新之前的状态变化只是读回既有状态，不计为继电器动作
+ */
+class EnergyAccounting : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CHECKPOINT_INTERVAL_MS = 60000;   // 检查点保存周期
+    static constexpr qint64 MAX_GAP_MS = 10000;            // 积分节点最大间隔，超过视为数据缺失
+    static constexpr double DEFAULT_NOMINAL_VOLTAGE = 230.0;
+
+    /**
+     * @brief 构造函数
+     * @param model 负载柜数据模型
+     * @param clock 已启动的单调时钟，与电压样本的时间戳同源
+     * @param parent 父对象指针
+     */
+    EnergyAccounting(LoadBankModel *model, QElapsedTimer clock, QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，保存最后一次检查点
+     */
+    ~EnergyAccounting();
+
+    /**
+     * @brief 设置检查点文件：读取已有计数并开始定期保存
+     * @param path 检查点文件路径
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 文件不存在或读取成功时返回true
+     */
+    bool setCheckpointPath(const QString &path, QString *errorString = nullptr);
+
+    /**
+     * @brief 设置额定电压
+     * @param voltage 档位功率对应的电压（V）
+     */
+    void setNominalVoltage(double voltage);
+
+    /**
+     * @brief 加入一个电压样本
+     * @param voltage 电压（V）
+     * @param timestampMs 单调时间戳（毫秒），与构造时传入的时钟同源
+     */
+    void addVoltageSample(double voltage, qint64 timestampMs);
+
+    /**
+     * @brief 获取各行累计值
+     * @return 各行电能与档位计数，接通时间含当前仍接通的部分
+     */
+    QVector<RowAccount> accounts() const;
+
+    /**
+     * @brief 按单位汇总的电能
+     * @return 功率单位 -> 累计电能（单位·小时）
+     */
+    QMap<QString, double> totals() const;
+
+    /**
+     * @brief 生成电能摘要
+     * @return 如"KWh=12.345 Kvarh=3.210 ops=128"
+     */
+    QString formatSummary() const;
+
+    /**
+     * @brief 立即保存检查点
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否保存成功（未设置检查点文件时返回true）
+     */
+    bool checkpoint(QString *errorString = nullptr);
+
+    /**
+     * @brief 清零全部计数
+     */
+    void reset();
+
+private slots:
+    /**
+     * @brief 行状态变化的处理函数：积分到当前时刻，统计继电器动作
+     * @param row 行索引
+     */
+    void onRowStateChanged(int row);
+
+    /**
+     * @brief 配置重新加载的处理函数：按新配置重建各行，保留档位数不变的行的计数
+     */
+    void onModelReset();
+
+    /**
+     * @brief 批量刷新完成的处理函数：首次成功后开始统计继电器动作
+     * @param ok 是否全部成功
+     */
+    void onRefreshFinished(bool ok);
+
+private:
+    /**
+     * @struct RowTracker
+     * @brief 一行的积分与计数状态
+     */
+    struct RowTracker
+    {
+        RowAccount account;             // 累计值
+        quint64 bits = 0;               // 当前继电器位掩码
+        double ratedPower = 0.0;        // 当前档位之和（额定电压下的功率）
+        double lastPower = 0.0;         // 上一积分节点的实际功率
+        QVector<qint64> onSinceMs;      // 各档位本次接通的时刻，断开为-1
+    };
+
+    /**
+     * @brief 按模型配置重建各行
+     */
+    void rebuildRows();
+
+    /**
+     * @brief 按梯形积分推进到指定时刻
+     * @param timestampMs 单调时间戳
+     */
+    void advance(qint64 timestampMs);
+
+    /**
+     * @brief 当前电压下的功率系数
+     * @return (电压/额定电压)²，尚无电压读数时为1
+     */
+    double voltageFactor() const;
+
+    LoadBankModel *m_model;             // 负载柜数据模型
+    QElapsedTimer m_clock;              // 单调时钟
+    QVector<RowTracker> m_rows;         // 各行状态
+    double m_nominalVoltage;            // 额定电压
+    double m_voltage;                   // 最近一次电压，尚无读数为-1
+    qint64 m_lastNodeMs;                // 上一积分节点时刻，尚无节点为-1
+    bool m_synchronized;                // 当前配置下是否已完成首次成功刷新
+    bool m_dirty;                       // 上次检查点之后是否有变化
+    QString m_checkpointPath;           // 检查点文件路径
+    QTimer m_checkpointTimer;           // 检查点定时器
+};
+
+#endif // ENERGYACCOUNTING_H
@@ -0,0 +1,820 @@
+/**
+ * @file headlessservice.cpp
+ * @brief 无界面采集与控制服务实现文件
+ * @details 包含HeadlessConfig、StdinReader和HeadlessService的实现
+ */
+
+#include "headlessservice.h"
+#include "loadbankmodel.h"
+#include "loadsequencer.h"
+#include "loadsolver.h"
+#include "modbusmanager.h"
+#include "voltagestatistics.h"
+#include "triggercapture.h"
+#include "automationserver.h"
+#include "energyaccounting.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QDebug>
+
+constexpr int HeadlessService::COMMAND_FILE_POLL_MS;
+constexpr int HeadlessService::ROW_HOLD_MS;
+
+/**
+ * @brief 从JSON文件加载配置
+ * @param path 文件路径
+ * @param errorString 失败时的错误描述
+ * @return 是否加载成功
+ */
+bool HeadlessConfig::loadFromFile(const QString &path, QString *errorString)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) *errorString = message;
+        return false;
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("无法打开文件 %1: %2").arg(path, file.errorString()));
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return fail(QString("JSON解析错误（偏移%1）: %2").arg(parseError.offset).arg(parseError.errorString()));
+    }
+
+    const QJsonObject root = document.object();
+    const QDir baseDir = QFileInfo(path).absoluteDir();
+    auto resolvePath = [&baseDir](const QJsonValue &value) {
+        const QString text = value.toString();
+        return text.isEmpty() ? QString() : baseDir.absoluteFilePath(text);
+    };
+
+    HeadlessConfig config;
+    config.portName = root.value("port").toString();
+    if (config.portName.isEmpty()) {
+        return fail("未指定串口（port）");
+    }
+    config.baudRate = root.value("baudRate").toInt(config.baudRate);
+    config.loadBankPath = resolvePath(root.value("loadBank"));
+    if (root.contains("refreshIntervalMs")) {
+        config.refreshIntervalMs = qMax(100, root.value("refreshIntervalMs").toInt());
+    }
+    if (root.contains("voltageIntervalMs")) {
+        config.voltageIntervalMs = qMax(50, root.value("voltageIntervalMs").toInt());
+    }
+    config.statusIntervalMs = qMax(0, root.value("statusIntervalMs").toInt(config.statusIntervalMs));
+    config.recordPath = resolvePath(root.value("record"));
+    config.archivePath = resolvePath(root.value("archive"));
+    config.energyPath = resolvePath(root.value("energy"));
+    config.presetsPath = resolvePath(root.value("presets"));
+    if (root.contains("phaseTolerance")) {
+        const double tolerance = root.value("phaseTolerance").toDouble();
+        config.phaseToleranceUnits = tolerance < 0.0 ? -1 : LoadSolver::toUnits(tolerance);
+    }
+
+    config.voltageFilter = root.value("filter").toString(config.voltageFilter);
+    QString filterError;
+    if (!FilterPipeline().setSpec(config.voltageFilter, &filterError)) {
+        return fail(filterError);
+    }
+
+    const QJsonObject powerQuality = root.value("powerQuality").toObject();
+    PowerQualityConfig &pq = config.powerQuality;
+    pq.nominal = powerQuality.value("nominal").toDouble(pq.nominal);
+    pq.sagThreshold = powerQuality.value("sag").toDouble(pq.sagThreshold);
+    pq.swellThreshold = powerQuality.value("swell").toDouble(pq.swellThreshold);
+    pq.interruptionThreshold = powerQuality.value("interruption").toDouble(pq.interruptionThreshold);
+    pq.hysteresis = powerQuality.value("hysteresis").toDouble(pq.hysteresis);
+    pq.minDurationMs = powerQuality.value("minDurationMs").toInt(pq.minDurationMs);
+    if (pq.nominal <= 0.0 || pq.interruptionThreshold >= pq.sagThreshold || pq.sagThreshold >= 1.0
+        || pq.swellThreshold <= 1.0) {
+        return fail("powerQuality门限无效：须满足 interruption < sag < 1 < swell");
+    }
+    config.commandFilePath = resolvePath(root.value("commandFile"));
+    config.profilePath = resolvePath(root.value("profile"));
+    config.automationSocket = root.value("automationSocket").toString();
+    config.sampleRingKey = root.value("sampleRing").toString(config.sampleRingKey);
+
+    if (root.contains("regulator")) {
+        const QJsonObject regulator = root.value("regulator").toObject();
+        RegulatorConfig &r = config.regulator;
+        config.regulatorEnabled = true;
+        r.setpoint = regulator.value("setpoint").toDouble(r.setpoint);
+        r.kp = regulator.value("kp").toDouble(r.kp);
+        r.ki = regulator.value("ki").toDouble(r.ki);
+        r.kd = regulator.value("kd").toDouble(r.kd);
+        r.periodMs = regulator.value("periodMs").toInt(r.periodMs);
+        r.deadband = regulator.value("deadband").toDouble(r.deadband);
+        r.hysteresisUnits = regulator.value("hysteresisUnits").toInt(r.hysteresisUnits);
+        r.minSwitchIntervalMs = regulator.value("minSwitchIntervalMs").toInt(r.minSwitchIntervalMs);
+        r.maxUnitsPerCycle = regulator.value("maxUnitsPerCycle").toInt(r.maxUnitsPerCycle);
+        r.settleBand = regulator.value("settleBand").toDouble(r.settleBand);
+        r.settleHoldMs = regulator.value("settleHoldMs").toInt(r.settleHoldMs);
+        for (const QJsonValue &row : regulator.value("rows").toArray()) {
+            r.rows.append(row.toInt());
+        }
+    }
+
+    if (config.regulatorEnabled && !config.profilePath.isEmpty()) {
+        return fail("profile和regulator不能同时启用");
+    }
+
+    *this = config;
+    return true;
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+StdinReader::StdinReader(QObject *parent)
+    : QThread(parent)
+{
+}
+
+/**
+ * @brief 线程函数：逐行读取标准输入直到关闭
+ */
+void StdinReader::run()
+{
+    QTextStream input(stdin);
+    while (!isInterruptionRequested()) {
+        QString line = input.readLine();
+        if (line.isNull()) break;
+        emit lineRead(line);
+    }
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+HeadlessService::HeadlessService(QObject *parent)
+    : QObject(parent)
+    , m_model(nullptr)
+    , m_sequencer(nullptr)
+    , m_regulator(nullptr)
+    , m_statistics(nullptr)
+    , m_energy(nullptr)
+    , m_powerQuality(nullptr)
+    , m_triggerCapture(nullptr)
+    , m_stdinReader(nullptr)
+    , m_automationServer(nullptr)
+    , m_distributor(nullptr)
+    , m_lastVoltage(-1.0)
+    , m_lastFilteredVoltage(-1.0)
+    , m_archiveVoltageChannel(-1)
+    , m_stdout(stdout)
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+HeadlessService::~HeadlessService()
+{
+    if (m_sequencer) m_sequencer->stop();
+    if (m_regulator) m_regulator->stop();
+    stopRecording();
+
+    // 阻塞在readLine中的线程可能持有stdio锁，强制结束不安全：断开信号后放手，由进程退出回收
+    if (m_stdinReader) {
+        m_stdinReader->disconnect(this);
+        m_stdinReader->requestInterruption();
+        if (!m_stdinReader->isRunning()) {
+            delete m_stdinReader;
+        }
+    }
+}
+
+/**
+ * @brief 按配置启动服务
+ * @param config 服务配置
+ * @param errorString 失败时的错误描述
+ * @return 是否启动成功
+ */
+bool HeadlessService::start(const HeadlessConfig &config, QString *errorString)
+{
+    m_config = config;
+    m_sampleClock.start();
+
+    if (!ModbusManager::instance()->initModbus(m_config.portName, m_config.baudRate)) {
+        if (errorString) *errorString = QString("无法打开串口 %1").arg(m_config.portName);
+        return false;
+    }
+
+    // 负载柜模型：写入后的短时间内保留本地状态，避免刷新读到写入前的旧值
+    m_loadBankPath = m_config.loadBankPath.isEmpty()
+            ? QCoreApplication::applicationDirPath() + "/loadbank.json" : m_config.loadBankPath;
+    const LoadBankConfig loadBankConfig = LoadBankConfig::applicationConfig(m_loadBankPath, 1);
+    m_model = new LoadBankModel(this);
+    m_model->setConfig(loadBankConfig);
+    m_model->setUpdateFilter([this](int row, int) {
+        return m_sampleClock.elapsed() >= m_rowHoldUntil.value(row, 0);
+    });
+    connect(&m_refreshTimer, &QTimer::timeout, m_model, &LoadBankModel::refresh);
+    applyBusMap(loadBankConfig.bus());
+
+    // 串口意外断开时自动重连，恢复后批量读取重建状态并重新下发未确认的写入
+    ModbusManager *modbus = ModbusManager::instance();
+    connect(modbus, &ModbusManager::connectionLost, this, [this]() {
+        reply(QString("bus lost, reconnecting %1").arg(m_config.portName));
+    });
+    connect(modbus, &ModbusManager::connectionRestored, this, [this]() {
+        reply("bus restored");
+        m_voltageFilter.reset();
+        m_model->resynchronize();
+    });
+    connect(m_model, &LoadBankModel::resynchronized, this, [this](bool ok, int reappliedRows) {
+        reply(ok ? QString("resync ok, reapplied %1 rows").arg(reappliedRows)
+                 : QString("resync read failed, retrying on next refresh"));
+    });
+    m_refreshTimer.start();
+
+    // 负载柜配置文件变化时热加载寄存器映射，不重新连接总线
+    m_configReloadTimer.setSingleShot(true);
+    m_configReloadTimer.setInterval(CONFIG_RELOAD_DELAY_MS);
+    connect(&m_configReloadTimer, &QTimer::timeout, this, &HeadlessService::reloadLoadBankConfig);
+    if (QFile::exists(m_loadBankPath)) {
+        m_configWatcher.addPath(m_loadBankPath);
+    }
+    connect(&m_configWatcher, &QFileSystemWatcher::fileChanged, &m_configReloadTimer, qOverload<>(&QTimer::start));
+
+    // 电压采集、统计与触发捕获（与界面版本相同的默认配置）
+    m_statistics = new VoltageStatistics(this);
+    m_triggerCapture = new TriggerCapture(this);
+    m_triggerCapture->arm();
+    connect(m_triggerCapture, &TriggerCapture::eventCaptured, this, [this](const CapturedEvent &event) {
+        reply(QString("event %1").arg(event.description()));
+    });
+    connect(&m_voltageTimer, &QTimer::timeout, this, &HeadlessService::sampleVoltage);
+    m_voltageTimer.start();
+
+    // 电压滤波只影响状态输出中的filtered，统计、触发和事件检测使用原始值
+    m_voltageFilter.setSpec(m_config.voltageFilter);
+
+    // 电能质量事件检测
+    m_powerQuality = new PowerQualityDetector(this);
+    m_powerQuality->setConfig(m_config.powerQuality);
+    connect(m_powerQuality, &PowerQualityDetector::eventFinished, this, [this](const PowerQualityEvent &event) {
+        reply(QString("pq %1").arg(event.description()));
+    });
+
+    // 各行电能与继电器动作统计，计数定期保存到检查点文件
+    m_energy = new EnergyAccounting(m_model, m_sampleClock, this);
+    if (!m_config.energyPath.isEmpty()) {
+        m_energy->setCheckpointPath(m_config.energyPath);
+    }
+
+    if (!m_config.presetsPath.isEmpty() && !m_presets.loadFromFile(m_config.presetsPath, errorString)) {
+        return false;
+    }
+
+    // 整柜分配在后台线程求解，只有最新的distribute命令在求解完成后下发
+    m_distributor = new BankDistributor(this);
+    connect(m_distributor, &BankDistributor::solved, this, [this](const BankSolveResult &result) {
+        if (!result.ok) {
+            reply(QString("distribute failed: %1").arg(result.description()));
+            return;
+        }
+        if (m_sequencer->isRunning() || m_regulator->isRunning()) {
+            reply("distribute dropped: profile or regulator running");
+            return;
+        }
+        const QVector<RowCommit> commits = result.commits(m_model);
+        for (const RowCommit &commit : commits) {
+            holdRow(commit.row);
+        }
+        m_model->commitRows(commits, ModbusManager::ControlPriority);
+        reply(QString("distribute %1").arg(result.description()));
+    });
+
+    if (!m_config.recordPath.isEmpty() && !startRecording(m_config.recordPath, errorString)) {
+        return false;
+    }
+
+    // 多分辨率汇总归档：电压和各行负载（通道voltage、row0-row8）
+    if (!m_config.archivePath.isEmpty()) {
+        if (!m_archive.open(m_config.archivePath, RollupArchive::defaultTiers(), errorString)) {
+            return false;
+        }
+        m_archiveVoltageChannel = m_archive.channel("voltage", errorString);
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            m_archiveRowChannels.append(m_archive.channel(QString("row%1").arg(row)));
+        }
+    }
+
+    m_sequencer = new LoadSequencer(m_model, this);
+    connect(m_sequencer, &LoadSequencer::rowCommitted, this, &HeadlessService::holdRow);
+    connect(m_sequencer, &LoadSequencer::finished, this, [this](bool completed) {
+        reply(QString("profile %1").arg(completed ? "completed" : "stopped"));
+    });
+
+    m_regulator = new VoltageRegulator(m_model, this);
+    m_regulator->setConfig(m_config.regulator);
+    connect(m_regulator, &VoltageRegulator::rowCommitted, this, &HeadlessService::holdRow);
+    connect(m_regulator, &VoltageRegulator::settled, this, [this](qint64 settlingTimeMs) {
+        reply(QString("regulator settled %1 ms").arg(settlingTimeMs));
+    });
+
+    // 本地自动化接口：与命令行共用同一份电压采集，负载曲线或闭环稳压运行时拒绝外部写入
+    if (!m_config.automationSocket.isEmpty()) {
+        m_automationServer = new AutomationServer(m_model, m_statistics, this);
+        m_automationServer->setWriteGuard([this]() {
+            if (m_sequencer->isRunning()) return QString("load profile is running");
+            if (m_regulator->isRunning()) return QString("regulator is running");
+            return QString();
+        });
+        connect(m_automationServer, &AutomationServer::rowCommitted, this, &HeadlessService::holdRow);
+        if (!m_automationServer->listen(m_config.automationSocket, errorString)) {
+            return false;
+        }
+    }
+
+    // 电压样本发布到共享内存环形缓冲区，与图形界面相同；创建失败时只记录警告，不影响采集
+    if (!m_config.sampleRingKey.isEmpty()) {
+        m_sampleRing.create(m_config.sampleRingKey, SampleRingWriter::DEFAULT_CAPACITY,
+                            QDateTime::currentMSecsSinceEpoch() - m_sampleClock.elapsed());
+    }
+
+    if (m_config.statusIntervalMs > 0) {
+        connect(&m_statusTimer, &QTimer::timeout, this, [this]() { reply(statusText()); });
+        m_statusTimer.start(m_config.statusIntervalMs);
+    }
+
+    // 控制命令：标准输入与命令文件
+    m_stdinReader = new StdinReader;    // 不设父对象，见析构函数
+    connect(m_stdinReader, &StdinReader::lineRead, this, &HeadlessService::onStdinLine);
+    connect(m_stdinReader, &QThread::finished, this, &HeadlessService::onStdinFinished);
+    m_stdinReader->start();
+
+    if (!m_config.commandFilePath.isEmpty()) {
+        connect(&m_commandFileTimer, &QTimer::timeout, this, &HeadlessService::pollCommandFile);
+        m_commandFileTimer.start(COMMAND_FILE_POLL_MS);
+    }
+
+    // 启动后立即执行的曲线或稳压，等第一次刷新完成后以读到的状态为起点
+    if (!m_config.profilePath.isEmpty() || m_config.regulatorEnabled) {
+        QMetaObject::Connection *once = new QMetaObject::Connection;
+        *once = connect(m_model, &LoadBankModel::refreshFinished, this, [this, once](bool) {
+            disconnect(*once);
+            delete once;
+            if (!m_config.profilePath.isEmpty()) {
+                reply(executeCommand(QString("profile %1").arg(m_config.profilePath)));
+            } else {
+                reply(executeCommand(QString("regulate %1").arg(m_config.regulator.setpoint)));
+            }
+        });
+    }
+
+    qDebug() << "无界面服务已启动 - 端口:" << m_config.portName << "行数:" << m_model->rowCount();
+    return true;
+}
+
+/**
+ * @brief 执行一条命令
+ * @param line 命令行
+ * @return 命令结果文本
+ */
+QString HeadlessService::executeCommand(const QString &line)
+{
+    const QStringList args = line.simplified().split(' ', Qt::SkipEmptyParts);
+    if (args.isEmpty()) return QString();
+    const QString command = args[0].toLower();
+
+    auto parseRow = [this](const QString &text, int *row) {
+        bool ok = false;
+        *row = text.toInt(&ok);
+        if (ok) return *row >= 0 && *row < m_model->rowCount();
+        for (int r = 0; r < m_model->rowCount(); ++r) {
+            if (m_model->config().row(r).name.compare(text, Qt::CaseInsensitive) == 0) {
+                *row = r;
+                return true;
+            }
+        }
+        return false;
+    };
+    auto busy = [this]() {
+        return m_sequencer->isRunning() || m_regulator->isRunning();
+    };
+
+    if (command == "status") {
+        return statusText();
+    }
+
+    if (command == "set" && args.size() == 3) {
+        int row = 0;
+        bool ok = false;
+        double value = args[2].toDouble(&ok);
+        if (!parseRow(args[1], &row) || !ok) return "error invalid row or value";
+        if (busy()) return "error profile or regulator running";
+
+        const quint64 current = m_model->rowState(row)->bits();
+        quint64 mask = 0;
+        LoadSolver::MinStepTable solver(m_model->config().row(row).stepUnits());
+        if (!solver.solve(LoadSolver::MinStepTable::MinimumToggles, LoadSolver::toUnits(value), current, &mask)) {
+            return QString("error row %1 cannot reach %2").arg(row).arg(value);
+        }
+        RowCommit commit;
+        commit.row = row;
+        commit.mask = mask;
+        commit.changedMask = mask ^ current;
+        holdRow(row);
+        m_model->commitRows({commit});
+        return QString("ok row %1 = %2").arg(row).arg(static_cast<double>(m_model->rowUnits(row)) / LoadSolver::UNITS_PER_VALUE);
+    }
+
+    if (command == "clear" && args.size() == 2) {
+        const bool all = args[1].toLower() == "all";
+        int target = -1;
+        if (!all && !parseRow(args[1], &target)) return "error invalid row";
+        if (busy()) return "error profile or regulator running";
+        QVector<RowCommit> commits;
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            if (!all && row != target) continue;
+            RowCommit commit;
+            commit.row = row;
+            commit.mask = 0;
+            commit.changedMask = m_model->rowState(row)->bits();
+            if (commit.changedMask == 0) continue;
+            holdRow(row);
+            commits.append(commit);
+        }
+        m_model->commitRows(commits);
+        return QString("ok cleared %1 rows").arg(commits.size());
+    }
+
+    if (command == "profile" && args.size() >= 2) {
+        if (args[1].toLower() == "stop") {
+            m_sequencer->stop();
+            return "ok";
+        }
+        if (m_regulator->isRunning()) return "error regulator running";
+        QString errorString;
+        const QString path = line.simplified().section(' ', 1);
+        if (!m_sequencer->loadProfile(path, &errorString) || !m_sequencer->start(&errorString)) {
+            return QString("error %1").arg(errorString);
+        }
+        return QString("ok profile %1 started").arg(m_sequencer->profile().name());
+    }
+
+    if (command == "regulate" && args.size() == 2) {
+        if (args[1].toLower() == "off") {
+            m_regulator->stop();
+            return "ok";
+        }
+        bool ok = false;
+        double setpoint = args[1].toDouble(&ok);
+        if (!ok) return "error invalid setpoint";
+        if (m_regulator->isRunning()) {
+            m_regulator->setSetpoint(setpoint);
+            return QString("ok setpoint %1").arg(setpoint);
+        }
+        if (m_sequencer->isRunning()) return "error profile running";
+        RegulatorConfig regulatorConfig = m_regulator->config();
+        regulatorConfig.setpoint = setpoint;
+        m_regulator->setConfig(regulatorConfig);
+        QString errorString;
+        if (!m_regulator->start(&errorString)) return QString("error %1").arg(errorString);
+        return QString("ok regulating to %1 V").arg(setpoint);
+    }
+
+    if (command == "record" && args.size() >= 2) {
+        stopRecording();
+        if (args[1].toLower() == "off") return "ok";
+        QString errorString;
+        if (!startRecording(line.simplified().section(' ', 1), &errorString)) return QString("error %1").arg(errorString);
+        return "ok";
+    }
+
+    if (command == "history" && (args.size() == 3 || args.size() == 4)) {
+        if (!m_archive.isOpen()) return "error archive not enabled";
+        bool secondsOk = false;
+        bool resolutionOk = true;
+        const qint64 seconds = args[2].toLongLong(&secondsOk);
+        const qint64 resolutionMs = args.size() == 4 ? qint64(args[3].toDouble(&resolutionOk) * 1000) : 0;
+        if (!secondsOk || seconds <= 0 || !resolutionOk || resolutionMs < 0) return "error invalid period or resolution";
+        const int channel = m_archive.findChannel(args[1]);
+        if (channel < 0) return QString("error unknown channel %1").arg(args[1]);
+
+        // 未指定分辨率时按约500个点选择
+        const qint64 toMs = QDateTime::currentMSecsSinceEpoch() + 1;
+        const qint64 fromMs = toMs - seconds * 1000;
+        int tierIndex = 0;
+        const QVector<RollupRecord> records = m_archive.query(channel, fromMs, toMs,
+                resolutionMs > 0 ? resolutionMs : seconds * 1000 / 500, &tierIndex);
+
+        QStringList lines;
+        lines.append(QString("ok history %1 tier %2 records %3")
+                     .arg(args[1], m_archive.tiers()[tierIndex].name).arg(records.size()));
+        for (const RollupRecord &record : records) {
+            lines.append(QString("%1 min=%2 max=%3 mean=%4 n=%5")
+                         .arg(QDateTime::fromMSecsSinceEpoch(record.startMs).toString(Qt::ISODateWithMs))
+                         .arg(record.min).arg(record.max).arg(record.mean, 0, 'f', 3).arg(record.count));
+        }
+        return lines.join('\n');
+    }
+
+    if (command == "energy" && args.size() <= 2) {
+        if (args.size() == 2) {
+            if (args[1].toLower() != "reset") return "error usage: energy [reset]";
+            m_energy->reset();
+            return "ok";
+        }
+        QStringList lines;
+        lines.append(QString("ok energy %1").arg(m_energy->formatSummary()));
+        for (const RowAccount &account : m_energy->accounts()) {
+            QStringList steps;
+            for (const StepCounters &counters : account.steps) {
+                steps.append(QString("%1/%2").arg(counters.operations).arg(counters.onTimeMs / 1000.0, 0, 'f', 0));
+            }
+            lines.append(QString("%1 %2h=%3 ops/on_s=%4")
+                         .arg(account.name, account.unit).arg(account.energy, 0, 'f', 3).arg(steps.join(',')));
+        }
+        return lines.join('\n');
+    }
+
+    if (command == "events" && args.size() <= 2) {
+        bool ok = true;
+        const int count = args.size() == 2 ? args[1].toInt(&ok) : 10;
+        if (!ok || count <= 0) return "error invalid count";
+        const QVector<PowerQualityEvent> &events = m_powerQuality->events();
+        QStringList lines;
+        lines.append(QString("ok events sag=%1 swell=%2 interruption=%3")
+                     .arg(m_powerQuality->eventCount(PowerQualityEvent::Sag))
+                     .arg(m_powerQuality->eventCount(PowerQualityEvent::Swell))
+                     .arg(m_powerQuality->eventCount(PowerQualityEvent::Interruption)));
+        for (int i = qMax(0, events.size() - count); i < events.size(); ++i) {
+            lines.append(events[i].description());
+        }
+        PowerQualityEvent active;
+        if (m_powerQuality->activeEvent(&active)) {
+            lines.append(QString("%1 (进行中)").arg(active.description()));
+        }
+        return lines.join('\n');
+    }
+
+    if (command == "preset" && args.size() >= 2) {
+        if (m_config.presetsPath.isEmpty()) return "error presets not enabled";
+        const QString action = args[1].toLower();
+        const QString name = line.simplified().section(' ', 2);
+        if (action == "list" && args.size() == 2) {
+            return QString("ok presets %1").arg(m_presets.names().join(", "));
+        }
+        if (name.isEmpty()) return "error usage: preset list|save <name>|recall <name>|delete <name>";
+
+        QString errorString;
+        if (action == "save") {
+            BankPreset preset;
+            preset.name = name;
+            if (!m_model->captureSnapshot(&preset.snapshot, &errorString)) return QString("error %1").arg(errorString);
+            m_presets.insert(preset);
+            if (!m_presets.save(&errorString)) return QString("error %1").arg(errorString);
+            return QString("ok preset %1 saved").arg(name);
+        }
+        if (action == "delete") {
+            if (!m_presets.remove(name)) return QString("error unknown preset %1").arg(name);
+            if (!m_presets.save(&errorString)) return QString("error %1").arg(errorString);
+            return "ok";
+        }
+        if (action == "recall") {
+            BankPreset preset;
+            if (!m_presets.find(name, &preset)) return QString("error unknown preset %1").arg(name);
+            if (busy()) return "error profile or regulator running";
+            for (int row = 0; row < m_model->rowCount(); ++row) {
+                if (m_model->rowState(row)->bits() != preset.snapshot.rowBits.value(row)) holdRow(row);
+            }
+            if (!m_model->commitSnapshot(preset.snapshot, ModbusManager::ControlPriority, [this, name](bool ok) {
+                    if (!ok) reply(QString("preset %1 write failed, pending until bus recovers").arg(name));
+                }, &errorString)) {
+                return QString("error %1").arg(errorString);
+            }
+            return QString("ok preset %1 recalled").arg(preset.name);
+        }
+        return "error usage: preset list|save <name>|recall <name>|delete <name>";
+    }
+
+    if (command == "distribute" && (args.size() == 2 || args.size() == 3)) {
+        bool ok = false;
+        const double value = args[1].toDouble(&ok);
+        if (!ok || value < 0.0) return "error invalid value";
+        if (busy()) return "error profile or regulator running";
+        const QString unit = args.size() == 3 ? args[2] : QString("KW");
+        const BankSolveRequest request = BankSolver::requestFromModel(m_model, LoadSolver::toUnits(value), unit,
+                                                                      m_config.phaseToleranceUnits);
+        if (request.rows.isEmpty()) return QString("error no %1 rows").arg(unit);
+        const quint64 generation = m_distributor->submit(request);
+        return QString("ok distribute %1 %2 submitted #%3").arg(value).arg(unit).arg(generation);
+    }
+
+    if (command == "quit") {
+        emit quitRequested();
+        return "ok";
+    }
+
+    return QString("error unknown command: %1").arg(line.trimmed());
+}
+
+/**
+ * @brief 采集一次电压
+ */
+void HeadlessService::sampleVoltage()
+{
+    ModbusManager::instance()->readSlave3Register7([this](int value) {
+        if (value == -1) return;
+
+        const double voltage = value * ModbusManager::instance()->busMap().voltageScale;
+        const qint64 timestampMs = m_sampleClock.elapsed();
+        m_lastVoltage = voltage;
+        m_lastFilteredVoltage = m_voltageFilter.process(voltage);
+        m_statistics->addSample(voltage, timestampMs);
+        m_triggerCapture->addSample(voltage, timestampMs);
+        m_powerQuality->addSample(voltage, timestampMs);
+        m_energy->addVoltageSample(voltage, timestampMs);
+        m_sampleRing.publish(voltage, timestampMs);
+        if (m_automationServer) m_automationServer->publishVoltage(voltage, timestampMs);
+
+        if (m_recordFile.isOpen()) {
+            m_recordStream << QDateTime::currentDateTime().toString(Qt::ISODateWithMs) << ','
+                           << timestampMs << ',' << QString::number(voltage, 'f', 1) << '\n';
+            m_recordStream.flush();
+        }
+
+        if (m_archive.isOpen()) {
+            const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+            m_archive.addSample(m_archiveVoltageChannel, voltage, nowMs);
+            for (int row = 0; row < m_archiveRowChannels.size() && row < m_model->rowCount(); ++row) {
+                m_archive.addSample(m_archiveRowChannels[row],
+                                    static_cast<double>(m_model->rowUnits(row)) / LoadSolver::UNITS_PER_VALUE, nowMs);
+            }
+        }
+    });
+}
+
+/**
+ * @brief 应用总线映射
+ * @param bus 总线映射
+ */
+void HeadlessService::applyBusMap(const BusMap &bus)
+{
+    ModbusManager::instance()->setBusMap(bus);
+    m_refreshTimer.setInterval(m_config.refreshIntervalMs > 0 ? m_config.refreshIntervalMs : bus.stateIntervalMs);
+    m_voltageTimer.setInterval(m_config.voltageIntervalMs > 0 ? m_config.voltageIntervalMs : bus.voltageIntervalMs);
+}
+
+/**
+ * @brief 重新加载负载柜配置
+ */
+void HeadlessService::reloadLoadBankConfig()
+{
+    // 以替换方式保存的文件会从监视列表中移除，重新加入
+    if (QFile::exists(m_loadBankPath) && !m_configWatcher.files().contains(m_loadBankPath)) {
+        m_configWatcher.addPath(m_loadBankPath);
+    }
+
+    // 曲线和调节器持有按旧配置生成的求解表
+    if (m_sequencer->isRunning() || m_regulator->isRunning()) {
+        reply("config reload ignored: profile or regulator is running");
+        return;
+    }
+
+    LoadBankConfig config;
+    QString errorString;
+    if (!config.loadFromFile(m_loadBankPath, &errorString)) {
+        reply(QString("config reload failed: %1").arg(errorString));
+        return;
+    }
+
+    m_model->setConfig(config);
+    m_rowHoldUntil.clear();
+    applyBusMap(config.bus());
+    m_model->refresh();
+    reply(QString("config reloaded: %1 rows").arg(config.rowCount()));
+}
+
+/**
+ * @brief 检查并执行命令文件
+ * @details 先把命令文件改名再读取，避免与正在写入命令的进程竞争；执行后删除
+ */
+void HeadlessService::pollCommandFile()
+{
+    if (!QFile::exists(m_config.commandFilePath)) return;
+
+    const QString processingPath = m_config.commandFilePath + ".processing";
+    QFile::remove(processingPath);
+    if (!QFile::rename(m_config.commandFilePath, processingPath)) return;
+
+    QFile file(processingPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return;
+    const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    file.close();
+    file.remove();
+
+    for (const QString &line : lines) {
+        if (line.trimmed().isEmpty()) continue;
+        reply(executeCommand(line));
+    }
+}
+
+/**
+ * @brief 处理标准输入的一行
+ * @param line 行内容
+ */
+void HeadlessService::onStdinLine(const QString &line)
+{
+    if (line.trimmed().isEmpty()) return;
+    reply(executeCommand(line));
+}
+
+/**
+ * @brief 标准输入关闭的处理函数
+ * @details 作为后台进程运行时标准输入通常立即关闭，服务继续运行，只能通过命令文件控制
+ */
+void HeadlessService::onStdinFinished()
+{
+    qDebug() << "标准输入已关闭" << (m_config.commandFilePath.isEmpty() ? QString("，无命令文件，服务将持续运行")
+                                                                        : QString("，继续监视命令文件"));
+}
+
+/**
+ * @brief 开始记录电压
+ * @param path CSV文件路径
+ * @param errorString 失败时的错误描述
+ * @return 是否开始记录
+ */
+bool HeadlessService::startRecording(const QString &path, QString *errorString)
+{
+    m_recordFile.setFileName(path);
+    const bool exists = m_recordFile.exists() && m_recordFile.size() > 0;
+    if (!m_recordFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        if (errorString) *errorString = QString("无法打开记录文件 %1: %2").arg(path, m_recordFile.errorString());
+        return false;
+    }
+    m_recordStream.setDevice(&m_recordFile);
+    if (!exists) {
+        m_recordStream << "time,elapsed_ms,voltage\n";
+    }
+    qDebug() << "电压记录到" << path;
+    return true;
+}
+
+/**
+ * @brief 停止记录电压
+ */
+void HeadlessService::stopRecording()
+{
+    if (!m_recordFile.isOpen()) return;
+    m_recordStream.flush();
+    m_recordStream.setDevice(nullptr);
+    m_recordFile.close();
+}
+
+/**
+ * @brief 生成状态文本
+ * @return 状态文本
+ */
+QString HeadlessService::statusText() const
+{
+    QStringList rows;
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        rows.append(QString("%1=%2").arg(m_model->config().row(row).name)
+                    .arg(static_cast<double>(m_model->rowUnits(row)) / LoadSolver::UNITS_PER_VALUE));
+    }
+    const StatisticsSummary lifetime = m_statistics->lifetimeSummary();
+    return QString("status voltage=%1 filtered=%2 mean=%3 rows=%4 profile=%5 regulator=%6 record=%7 energy=%8")
+            .arg(m_lastVoltage < 0 ? QString("-") : QString::number(m_lastVoltage, 'f', 1))
+            .arg(m_lastFilteredVoltage < 0 ? QString("-") : QString::number(m_lastFilteredVoltage, 'f', 1))
+            .arg(lifetime.mean, 0, 'f', 2)
+            .arg(rows.join(','))
+            .arg(m_sequencer->isRunning() ? "running" : "idle")
+            .arg(m_regulator->isRunning() ? "running" : "idle")
+            .arg(m_recordFile.isOpen() ? m_recordFile.fileName() : QString("off"))
+            .arg(m_energy->formatSummary().replace(' ', ','));
+}
+
+/**
+ * @brief 短时间保留某行的本地状态
+ * @param row 行索引
+ */
+void HeadlessService::holdRow(int row)
+{
+    m_rowHoldUntil[row] = m_sampleClock.elapsed() + ROW_HOLD_MS;
+}
+
+/**
+ * @brief 输出命令结果到标准输出
+ * @param text 结果文本
+ */
+void HeadlessService::reply(const QString &text)
+{
+    if (text.isEmpty()) return;
+    m_stdout << text << Qt::endl;
+}
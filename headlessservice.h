@@ -0,0 +1,283 @@
+/**
+ * @file headlessservice.h
+ * @brief 无界面采集与控制服务定义文件
+ * @details 包含HeadlessConfig、StdinReader和HeadlessService的声明。HeadlessService在QCoreApplication下运行，
+ *          不创建任何窗口部件，负责周期刷新负载柜状态、采集电压并记录到CSV文件，执行负载曲线和闭环稳压，
+ *          通过标准输入或命令文件接收控制命令
+ *
+ * 配置文件格式示例：
+ * @code
+ * {
+ *     "port": "COM3",
+ *     "baudRate": 9600,
+ *     "loadBank": "loadbank.json",
+ *     "refreshIntervalMs": 1000,
+ *     "voltageIntervalMs": 1000,
+ *     "statusIntervalMs": 60000,
+ *     "record": "voltage.csv",
+ *     "archive": "archive",
+ *     "energy": "energy.json",
+ *     "presets": "presets.json",
+ *     "phaseTolerance": 1.0,
+ *     "filter": "median:3,ema:0.5",
+ *     "powerQuality": { "nominal": 230, "sag": 0.9, "swell": 1.1, "interruption": 0.1, "hysteresis": 0.02, "minDurationMs": 100 },
+ *     "commandFile": "commands.txt",
+ *     "profile": "step.json",
+ *     "automationSocket": "loadbank-automation",
+ *     "sampleRing": "loadbank-voltage-samples",
+ *     "regulator": { "setpoint": 230, "kp": 0.2, "ki": 0.5, "periodMs": 100, "rows": [0, 3, 6] }
+ * }
+ * @endcode
+ * refreshIntervalMs/voltageIntervalMs省略时使用负载柜配置中bus.poll的周期；负载柜配置文件变化时自动热加载。
+ * 相对路径相对于配置文件所在目录。profile和regulator存在时启动后立即执行，二者只能选其一。
+ * automationSocket存在时在该名称上开启本地自动化接口（见automationserver.h）。
+ * sampleRing为电压样本共享内存环形缓冲区的键（见samplering.h），省略时与图形界面相同，为空字符串时不发布。
+ * archive存在时把电压和各行负载写入该目录下的多分辨率汇总归档（见rolluparchive.h）。
+ * filter为电压滤波链（见signalfilter.h），省略时使用默认滤波；滤波值只用于状态输出，其余使用原始值。
+ * powerQuality省略的项使用默认门限（见powerquality.h），检测到的暂降、暂升和中断在结束时输出。
+ * energy存在时各行电能与继电器动作计数每分钟保存到该文件，启动时从中恢复（见energyaccounting.h）。
+ * presets为整柜预设文件（见bankpreset.h），省略时preset命令不可用。
+ * phaseTolerance为distribute命令的三相之和最大互差（见banksolver.h），负值为不要求平衡。
+ *
+ * 命令（每行一条）：
+ * status | set <行> <值> | clear <行>|all | profile <文件>|stop | regulate <电压>|off | record <文件>|off
+ * | history <通道> <秒数> [分辨率秒数] | energy [reset] | events [条数]
+ * | preset list|save <名称>|recall <名称>|delete <名称> | distribute <值> [单位] | quit
+ */
+
+#ifndef HEADLESSSERVICE_H
+#define HEADLESSSERVICE_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+#include <QString>
+
+#include "voltageregulator.h"
+#include "powerquality.h"
+#include "signalfilter.h"
+#include "rolluparchive.h"
+#include "bankpreset.h"
+#include "banksolver.h"
+#include "samplering.h"
+
+class LoadBankModel;
+class LoadSequencer;
+class VoltageStatistics;
+class TriggerCapture;
+class AutomationServer;
+class EnergyAccounting;
+
+/**
+ * @struct HeadlessConfig
+ * @brief 无界面服务配置
+ */
+struct HeadlessConfig
+{
+    QString portName;                   // 串口名称
+    int baudRate = 9600;                // 波特率
+    QString loadBankPath;               // 负载柜档位配置文件，为空时使用程序目录下的loadbank.json
+    int refreshIntervalMs = 0;          // 负载柜状态刷新周期，0为使用负载柜配置中的状态轮询周期
+    int voltageIntervalMs = 0;          // 电压采集周期，0为使用负载柜配置中的电压轮询周期
+    int statusIntervalMs = 0;           // 状态输出周期，0为不输出
+    QString recordPath;                 // 电压记录CSV文件，为空时不记录
+    QString archivePath;                // 汇总归档目录，为空时不归档
+    QString energyPath;                 // 电能检查点文件，为空时计数不保存
+    QString presetsPath;                // 整柜预设文件，为空时不使用预设
+    int phaseToleranceUnits = BankDistributor::DEFAULT_PHASE_TOLERANCE_UNITS;    // 整柜分配的三相之和最大互差，-1为不要求平衡
+    PowerQualityConfig powerQuality;    // 电能质量事件检测门限
+    QString voltageFilter = FilterPipeline::DEFAULT_VOLTAGE_SPEC;    // 电压滤波链描述
+    QString commandFilePath;            // 命令文件，为空时只从标准输入接收命令
+    QString profilePath;                // 启动后执行的负载曲线
+    QString automationSocket;           // 本地自动化接口名称，为空时不开启
+    QString sampleRingKey = SampleRingLayout::DEFAULT_KEY;     // 电压样本共享内存键，为空时不发布
+    bool regulatorEnabled = false;      // 启动后是否开始闭环稳压
+    RegulatorConfig regulator;          // 闭环稳压参数
+
+    /**
+     * @brief 从JSON文件加载配置
+     * @param path 文件路径
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否加载成功
+     */
+    bool loadFromFile(const QString &path, QString *errorString = nullptr);
+};
+
+/**
+ * @class StdinReader
+ * @brief 标准输入读取线程
+ * @details 在独立线程中阻塞读取标准输入，每读到一行发出lineRead；标准输入关闭时线程结束。
+ *          阻塞中的读取无法可移植地中断，也不能强制结束（线程可能持有stdio锁），
+ *          服务退出时若线程仍在读取则断开信号后放手，不释放
+ */
+class StdinReader : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit StdinReader(QObject *parent = nullptr);
+
+signals:
+    /**
+     * @brief 读到一行
+     * @param line 行内容（不含换行符）
+     */
+    void lineRead(const QString &line);
+
+protected:
+    void run() override;
+};
+
+/**
+ * @class HeadlessService
+ * @brief 无界面采集与控制服务
+ */
+class HeadlessService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int COMMAND_FILE_POLL_MS = 500;    // 命令文件轮询周期
+    static constexpr int ROW_HOLD_MS = 2000;            // 写入后该时间内刷新不覆盖该行的本地状态
+    static constexpr int CONFIG_RELOAD_DELAY_MS = 300;  // 负载柜配置文件变化后延迟加载，合并保存时的多次变化
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit HeadlessService(QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，关闭记录文件
+     */
+    ~HeadlessService();
+
+    /**
+     * @brief 按配置启动服务
+     * @param config 服务配置
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否启动成功
+     */
+    bool start(const HeadlessConfig &config, QString *errorString = nullptr);
+
+    /**
+     * @brief 执行一条命令
+     * @param line 命令行
+     * @return 命令结果文本
+     */
+    QString executeCommand(const QString &line);
+
+signals:
+    /**
+     * @brief 收到quit命令
+     */
+    void quitRequested();
+
+private slots:
+    /**
+     * @brief 采集一次电压
+     */
+    void sampleVoltage();
+
+    /**
+     * @brief 检查并执行命令文件
+     */
+    void pollCommandFile();
+
+    /**
+     * @brief 处理标准输入的一行
+     * @param line 行内容
+     */
+    void onStdinLine(const QString &line);
+
+    /**
+     * @brief 标准输入关闭的处理函数
+     */
+    void onStdinFinished();
+
+    /**
+     * @brief 重新加载负载柜配置（寄存器映射），不重新连接总线
+     */
+    void reloadLoadBankConfig();
+
+private:
+    /**
+     * @brief 开始记录电压
+     * @param path CSV文件路径
+     * @param errorString 失败时的错误描述
+     * @return 是否开始记录
+     */
+    bool startRecording(const QString &path, QString *errorString);
+
+    /**
+     * @brief 停止记录电压
+     */
+    void stopRecording();
+
+    /**
+     * @brief 应用总线映射：从站地址、电压寄存器和轮询周期（服务配置中指定的周期优先）
+     * @param bus 总线映射
+     */
+    void applyBusMap(const BusMap &bus);
+
+    /**
+     * @brief 生成状态文本
+     * @return 电压、各行负载和执行状态
+     */
+    QString statusText() const;
+
+    /**
+     * @brief 短时间保留某行的本地状态
+     * @param row 行索引
+     */
+    void holdRow(int row);
+
+    /**
+     * @brief 输出命令结果到标准输出
+     * @param text 结果文本
+     */
+    void reply(const QString &text);
+
+    HeadlessConfig m_config;                    // 服务配置
+    LoadBankModel *m_model;                     // 负载柜数据模型
+    LoadSequencer *m_sequencer;                 // 负载曲线执行器
+    VoltageRegulator *m_regulator;              // 闭环稳压调节器
+    VoltageStatistics *m_statistics;            // 电压流式统计
+    EnergyAccounting *m_energy;                 // 电能与继电器动作统计
+    PowerQualityDetector *m_powerQuality;       // 电能质量事件检测
+    TriggerCapture *m_triggerCapture;           // 电压触发捕获
+    StdinReader *m_stdinReader;                 // 标准输入读取线程
+    AutomationServer *m_automationServer;       // 本地自动化接口，未开启为nullptr
+    SampleRingWriter m_sampleRing;              // 共享内存电压样本环形缓冲区，未创建时发布为空操作
+    QTimer m_refreshTimer;                      // 负载柜状态刷新定时器
+    QTimer m_voltageTimer;                      // 电压采集定时器
+    QTimer m_statusTimer;                       // 状态输出定时器
+    QTimer m_commandFileTimer;                  // 命令文件轮询定时器
+    QString m_loadBankPath;                     // 负载柜配置文件路径
+    QFileSystemWatcher m_configWatcher;         // 负载柜配置文件监视器
+    QTimer m_configReloadTimer;                 // 配置重新加载延迟定时器
+    QElapsedTimer m_sampleClock;                // 采样单调时钟
+    QHash<int, qint64> m_rowHoldUntil;          // 行索引 -> 保留本地状态的截止时刻
+    double m_lastVoltage;                       // 最近一次电压，尚无读数为-1
+    FilterPipeline m_voltageFilter;             // 电压滤波链
+    double m_lastFilteredVoltage;               // 最近一次滤波电压，尚无读数为-1
+    QFile m_recordFile;                         // 电压记录文件
+    QTextStream m_recordStream;                 // 电压记录输出流
+    RollupArchive m_archive;                    // 电压与负载汇总归档
+    int m_archiveVoltageChannel;                // 电压归档通道
+    QVector<int> m_archiveRowChannels;          // 各行负载归档通道
+    BankPresetStore m_presets;                  // 整柜预设
+    BankDistributor *m_distributor;             // 整柜分配后台求解
+    QTextStream m_stdout;                       // 命令结果输出流
+};
+
+#endif // HEADLESSSERVICE_H
@@ -0,0 +1,337 @@
+/**
+ * @file loadbankconfig.cpp
+ * @brief 负载柜档位配置实现文件
+ * @details 包含LoadBankRow与LoadBankConfig的实现，负责档位与寄存器位字段之间的编解码以及JSON配置解析
+ */
+
+#include "loadbankconfig.h"
+#include "loadsolver.h"
+#include "relaystate.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QDebug>
+
+constexpr int LoadBankConfig::MAX_STEPS_PER_ROW;
+
+namespace
+{
+    /**
+     * @brief 获取从某档位开始、位于同一寄存器且位号连续的档位数
+     * @param steps 档位列表
+     * @param first 起始档位序号
+     * @return 连续档位数（至少为1）
+     */
+    int fieldWidth(const QVector<LoadStep> &steps, int first)
+    {
+        int width = 1;
+        while (first + width < steps.size()
+               && steps[first + width].registerAddress == steps[first].registerAddress
+               && steps[first + width].bit == steps[first].bit + width) {
+            ++width;
+        }
+        return width;
+    }
+}
+
+/**
+ * @brief 获取各档位的整数单位值
+ * @return 整数单位值数组（0.1为单位）
+ */
+QVector<int> LoadBankRow::stepUnits() const
+{
+    QVector<int> units;
+    units.reserve(steps.size());
+    for (const LoadStep &step : steps) {
+        units.append(LoadSolver::toUnits(step.value));
+    }
+    return units;
+}
+
+/**
+ * @brief 获取本行涉及的寄存器地址
+ * @return 寄存器地址数组
+ */
+QVector<int> LoadBankRow::registerAddresses() const
+{
+    QVector<int> addresses;
+    for (const LoadStep &step : steps) {
+        if (!addresses.contains(step.registerAddress)) {
+            addresses.append(step.registerAddress);
+        }
+    }
+    return addresses;
+}
+
+/**
+ * @brief 将档位位掩码编码为各寄存器的位字段
+ * @param stepMask 档位位掩码
+ * @return 各寄存器的位字段，顺序与registerAddresses()一致
+ */
+QVector<RegisterField> LoadBankRow::encode(quint64 stepMask) const
+{
+    const RelayState state(stepMask);
+    QVector<RegisterField> fields;
+    for (int i = 0; i < steps.size();) {
+        const LoadStep &step = steps[i];
+        const int width = fieldWidth(steps, i);
+
+        int fieldIndex = -1;
+        for (int j = 0; j < fields.size(); ++j) {
+            if (fields[j].address == step.registerAddress) {
+                fieldIndex = j;
+                break;
+            }
+        }
+        if (fieldIndex == -1) {
+            RegisterField field;
+            field.address = step.registerAddress;
+            fields.append(field);
+            fieldIndex = fields.size() - 1;
+        }
+
+        // 连续档位整段编码，默认布局每行一次
+        fields[fieldIndex].fieldMask |= static_cast<quint16>(((1u << width) - 1) << step.bit);
+        fields[fieldIndex].value = state.encodeField(fields[fieldIndex].value, i, step.bit, width);
+        i += width;
+    }
+    return fields;
+}
+
+/**
+ * @brief 用一个寄存器的读数更新档位位掩码
+ * @param address 寄存器地址
+ * @param registerValue 寄存器值
+ * @param stepMask 原档位位掩码
+ * @return 更新后的档位位掩码
+ */
+quint64 LoadBankRow::decode(int address, quint16 registerValue, quint64 stepMask) const
+{
+    RelayState state(stepMask);
+    for (int i = 0; i < steps.size();) {
+        const int width = fieldWidth(steps, i);
+        if (steps[i].registerAddress == address) {
+            state = state.decodeField(registerValue, i, steps[i].bit, width);
+        }
+        i += width;
+    }
+    return state.bits();
+}
+
+/**
+ * @brief 获取内置的默认配置
+ * @param rowAddresses 各行寄存器地址
+ * @return 默认配置
+ */
+LoadBankConfig LoadBankConfig::defaultConfig(const QVector<int> &rowAddresses)
+{
+    static const char *const rowNames[] = {"R", "L", "C"};
+    static const char *const rowUnits[] = {"KW", "Kvar", "Kvar"};
+
+    LoadBankConfig config;
+    for (int r = 0; r < rowAddresses.size(); ++r) {
+        LoadBankRow row;
+        row.name = QString("%1%2").arg(rowNames[r % 3]).arg(r / 3 + 1);
+        row.unit = rowUnits[r % 3];
+        row.phase = (r / 3) % 3;
+        for (int i = 0; i < LoadSolver::STEP_COUNT; ++i) {
+            LoadStep step;
+            step.value = static_cast<double>(LoadSolver::STEP_UNITS[i]) / LoadSolver::UNITS_PER_VALUE;
+            step.registerAddress = rowAddresses[r];
+            step.bit = 8 + i;   // 按钮0对应第8位，按钮7对应第15位
+            row.steps.append(step);
+        }
+        config.m_rows.append(row);
+    }
+    return config;
+}
+
+/**
+ * @brief 获取程序使用的配置
+ * @param path 配置文件路径
+ * @param minRows 最少行数
+ * @return 文件配置或内置配置
+ */
+LoadBankConfig LoadBankConfig::applicationConfig(const QString &path, int minRows)
+{
+    LoadBankConfig config = defaultConfig({REGISTER_ADDRESS_ROW0, REGISTER_ADDRESS_ROW1, REGISTER_ADDRESS_ROW2,
+                                           REGISTER_ADDRESS_ROW3, REGISTER_ADDRESS_ROW4, REGISTER_ADDRESS_ROW5,
+                                           REGISTER_ADDRESS_ROW6, REGISTER_ADDRESS_ROW7, REGISTER_ADDRESS_ROW8});
+    if (QFile::exists(path)) {
+        LoadBankConfig fileConfig = config;
+        if (fileConfig.loadFromFile(path) && fileConfig.rowCount() >= minRows) {
+            config = fileConfig;
+        } else {
+            qDebug() << "负载柜配置文件无效或行数不足" << minRows << "行，使用内置配置";
+        }
+    }
+    return config;
+}
+
+/**
+ * @brief 从JSON文件加载配置
+ * @param path 文件路径
+ * @param errorString 失败时的错误描述
+ * @return 是否加载成功
+ */
+bool LoadBankConfig::loadFromFile(const QString &path, QString *errorString)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) *errorString = message;
+        qWarning() << "负载柜配置加载失败:" << message;
+        return false;
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("无法打开文件 %1: %2").arg(path, file.errorString()));
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return fail(QString("JSON解析错误（偏移%1）: %2").arg(parseError.offset).arg(parseError.errorString()));
+    }
+
+    QJsonArray rowArray = document.object().value("rows").toArray();
+    if (rowArray.isEmpty()) {
+        return fail("配置中没有定义任何行");
+    }
+
+    // 总线映射：省略的项使用内置值
+    BusMap bus;
+    const QJsonObject busObject = document.object().value("bus").toObject();
+    const QJsonObject voltageObject = busObject.value("voltage").toObject();
+    const QJsonObject pollObject = busObject.value("poll").toObject();
+    bus.controlSlave = busObject.value("slave").toInt(bus.controlSlave);
+    bus.voltageSlave = voltageObject.value("slave").toInt(bus.voltageSlave);
+    bus.voltageAddress = voltageObject.value("register").toInt(bus.voltageAddress);
+    bus.voltageScale = voltageObject.value("scale").toDouble(bus.voltageScale);
+    bus.stateIntervalMs = pollObject.value("state").toInt(bus.stateIntervalMs);
+    bus.voltageIntervalMs = pollObject.value("voltage").toInt(bus.voltageIntervalMs);
+    bus.readGap = busObject.value("readGap").toInt(bus.readGap);
+    if (bus.controlSlave < 1 || bus.controlSlave > 247 || bus.voltageSlave < 1 || bus.voltageSlave > 247) {
+        return fail(QString("从站地址无效: %1/%2").arg(bus.controlSlave).arg(bus.voltageSlave));
+    }
+    if (bus.voltageAddress < 0 || bus.voltageAddress > 65535 || bus.voltageScale <= 0.0) {
+        return fail(QString("电压寄存器无效: 地址%1 比例%2").arg(bus.voltageAddress).arg(bus.voltageScale));
+    }
+    if (bus.stateIntervalMs < 100 || bus.voltageIntervalMs < 50) {
+        return fail(QString("轮询周期过短: 状态%1 ms 电压%2 ms").arg(bus.stateIntervalMs).arg(bus.voltageIntervalMs));
+    }
+    if (bus.readGap < 0 || bus.readGap > 100) {
+        return fail(QString("读取合并间隔无效: %1").arg(bus.readGap));
+    }
+
+    QVector<LoadBankRow> rows;
+    for (int r = 0; r < rowArray.size(); ++r) {
+        QJsonObject rowObject = rowArray[r].toObject();
+
+        LoadBankRow row;
+        row.name = rowObject.value("name").toString(QString("行%1").arg(r));
+        row.unit = rowObject.value("unit").toString("KW");
+        if (rowObject.contains("phase")) {
+            row.phase = rowObject.value("phase").toInt() - 1;
+            if (row.phase < 0 || row.phase > 2) {
+                return fail(QString("行%1的相序无效（应为1-3）").arg(r));
+            }
+        }
+        if (rowObject.contains("maxValue")) {
+            row.maxUnits = LoadSolver::toUnits(rowObject.value("maxValue").toDouble(-1.0));
+            if (row.maxUnits < 0) {
+                return fail(QString("行%1的负载上限无效").arg(r));
+            }
+        }
+
+        row.locked = rowObject.value("locked").toBool(false);
+
+        QJsonArray registerArray = rowObject.value("registers").toArray();
+        int firstBit = rowObject.value("firstBit").toInt(8);
+        int lastBit = rowObject.value("lastBit").toInt(15);
+        if (firstBit < 0 || lastBit > 15 || firstBit > lastBit) {
+            return fail(QString("行%1的位范围无效: %2-%3").arg(r).arg(firstBit).arg(lastBit));
+        }
+
+        // 顺序分配位置：依次填满每个寄存器的firstBit..lastBit
+        int registerIndex = 0;
+        int nextBit = firstBit;
+
+        QJsonArray stepArray = rowObject.value("steps").toArray();
+        if (stepArray.size() > MAX_STEPS_PER_ROW) {
+            return fail(QString("行%1的档位数%2超过上限%3").arg(r).arg(stepArray.size()).arg(MAX_STEPS_PER_ROW));
+        }
+
+        for (const QJsonValue &stepValue : stepArray) {
+            LoadStep step;
+            QJsonObject stepObject = stepValue.toObject();
+            bool explicitPosition = stepValue.isObject() && stepObject.contains("register");
+
+            step.value = stepValue.isObject() ? stepObject.value("value").toDouble() : stepValue.toDouble();
+            if (LoadSolver::toUnits(step.value) <= 0) {
+                return fail(QString("行%1存在无效的档位数值: %2").arg(r).arg(step.value));
+            }
+
+            if (explicitPosition) {
+                step.registerAddress = stepObject.value("register").toInt();
+                step.bit = stepObject.value("bit").toInt(-1);
+            } else {
+                if (registerIndex >= registerArray.size()) {
+                    return fail(QString("行%1的寄存器不足以容纳全部档位").arg(r));
+                }
+                step.registerAddress = registerArray[registerIndex].toInt();
+                step.bit = nextBit;
+                if (++nextBit > lastBit) {
+                    registerIndex++;
+                    nextBit = firstBit;
+                }
+            }
+
+            if (step.bit < 0 || step.bit > 15 || step.registerAddress < 0 || step.registerAddress > 65535) {
+                return fail(QString("行%1的档位位置无效: 寄存器%2 位%3").arg(r).arg(step.registerAddress).arg(step.bit));
+            }
+            for (const LoadStep &existing : row.steps) {
+                if (existing.registerAddress == step.registerAddress && existing.bit == step.bit) {
+                    return fail(QString("行%1的档位位置重复: 寄存器%2 位%3").arg(r).arg(step.registerAddress).arg(step.bit));
+                }
+            }
+            row.steps.append(step);
+        }
+
+        rows.append(row);
+    }
+
+    m_rows = rows;
+    m_bus = bus;
+    qDebug() << "负载柜配置已加载:" << path << "行数:" << m_rows.size();
+    return true;
+}
+
+/**
+ * @brief 获取行数
+ * @return 行数
+ */
+int LoadBankConfig::rowCount() const
+{
+    return m_rows.size();
+}
+
+/**
+ * @brief 获取指定行的定义
+ * @param index 行索引
+ * @return 行定义
+ */
+const LoadBankRow &LoadBankConfig::row(int index) const
+{
+    return m_rows.at(index);
+}
+
+/**
+ * @brief 获取总线映射
+ * @return 总线映射
+ */
+const BusMap &LoadBankConfig::bus() const
+{
+    return m_bus;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file loadbankconfig.h
+ * @brief 负载柜档位配置定义文件
+ * @details 包含LoadStep、LoadBankRow和LoadBankConfig的声明，描述每行的档位数值及其在寄存器中的位置，
+ *          支持从JSON文件加载任意档位数（最多64档）、跨多个寄存器的负载柜
+ *
+ * 配置文件格式示例：
+ * @code
+ * {
+ *     "bus": { "slave": 1, "readGap": 0,
+ *              "voltage": { "slave": 3, "register": 7, "scale": 0.1 },
+ *              "poll": { "state": 1000, "voltage": 1000 } },
+ *     "rows": [
+ *         { "name": "R1", "unit": "KW", "phase": 1, "maxValue": 8.0, "locked": false, "registers": [50], "firstBit": 8, "lastBit": 15,
+ *           "steps": [0.1, 0.2, 0.2, 0.5, 1, 2, 2, 5] },
+ *         { "name": "R2", "unit": "KW", "registers": [20, 21, 22],
+ *           "steps": [0.5, 0.5, 1, 1, 2, 2, 5, 5, 10, 10, { "value": 20, "register": 23, "bit": 0 }] }
+ *     ]
+ * }
+ * @endcode
+ * 档位按顺序依次占用 registers 中各寄存器的 firstBit..lastBit 位（默认8-15位），
+ * 也可以在单个档位中用 register/bit 显式指定位置。
+ * phase 为该行所接的相（1-3），整柜分配时用于三相平衡，省略时不参与平衡；
+ * maxValue 为整柜分配时该行的负载上限，省略时不限制（单行直接设置不受此限）；
+ * locked 为true时整柜分配保持该行当前状态，只分配其余各行。
+ * bus 描述继电器所在从站、电压寄存器及其比例系数、两类轮询（状态、电压）的周期，省略的项使用内置值；
+ * readGap 为批量读取时允许跨越的未映射寄存器数，默认0（只合并连续地址），
+ * 从站对未映射地址不返回ILLEGAL DATA ADDRESS时可调大以减少读取事务
+ */
+
+#ifndef LOADBANKCONFIG_H
+#define LOADBANKCONFIG_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief 寄存器地址常量定义
+ * @details 定义各行列对应的Modbus寄存器地址
+ */
+constexpr int REGISTER_ADDRESS_ROW0 = 50;  // 第0行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW1 = 1;   // 第1行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW2 = 2;   // 第2行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW3 = 3;   // 第3行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW4 = 4;   // 第4行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW5 = 5;   // 第5行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW6 = 6;   // 第6行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW7 = 7;   // 第7行对应的寄存器地址
+constexpr int REGISTER_ADDRESS_ROW8 = 8;   // 第8行对应的寄存器地址
+
+/**
+ * @struct LoadStep
+ * @brief 单个负载档位
+ */
+struct LoadStep
+{
+    double value = 0.0;         // 档位数值
+    int registerAddress = 0;    // 所在寄存器地址
+    int bit = 0;                // 所在位（0-15）
+};
+
+/**
+ * @struct RegisterField
+ * @brief 单个寄存器中属于某行档位的位字段
+ */
+struct RegisterField
+{
+    int address = 0;            // 寄存器地址
+    quint16 fieldMask = 0;      // 属于档位的位
+    quint16 value = 0;          // 档位位的取值
+};
+
+/**
+ * @struct BusMap
+ * @brief 总线映射：从站地址、电压寄存器和轮询周期
+ */
+struct BusMap
+{
+    int controlSlave = 1;           // 继电器寄存器所在从站
+    int voltageSlave = 3;           // 电压寄存器所在从站
+    int voltageAddress = 7;         // 电压寄存器地址
+    double voltageScale = 0.1;      // 电压 = 寄存器值 × voltageScale
+    int stateIntervalMs = 1000;     // 状态轮询周期（批量刷新各行寄存器）
+    int voltageIntervalMs = 1000;   // 电压轮询周期
+    int readGap = 0;                // 批量读取时允许跨越的未映射寄存器数（从站可能拒绝读取未映射地址）
+};
+
+/**
+ * @struct LoadBankRow
+ * @brief 负载柜的一行档位定义
+ */
+struct LoadBankRow
+{
+    QString name;               // 行名称
+    QString unit;               // 单位（KW/Kvar）
+    QVector<LoadStep> steps;    // 档位列表，下标即位掩码中的位序号
+    int phase = -1;             // 所接的相（0-2），-1为不分相
+    int maxUnits = -1;          // 整柜分配时的负载上限（0.1为单位），-1为不限制
+    bool locked = false;        // 整柜分配时是否保持当前状态
+
+    /**
+     * @brief 获取各档位的整数单位值（0.1为单位）
+     * @return 整数单位值数组
+     */
+    QVector<int> stepUnits() const;
+
+    /**
+     * @brief 获取本行涉及的寄存器地址（按首次出现顺序）
+     * @return 寄存器地址数组
+     */
+    QVector<int> registerAddresses() const;
+
+    /**
+     * @brief 将档位位掩码编码为各寄存器的位字段
+     * @param stepMask 档位位掩码
+     * @return 各寄存器的位字段
+     */
+    QVector<RegisterField> encode(quint64 stepMask) const;
+
+    /**
+     * @brief 用一个寄存器的读数更新档位位掩码
+     * @param address 寄存器地址
+     * @param registerValue 寄存器值
+     * @param stepMask 原档位位掩码
+     * @return 更新后的档位位掩码（其他寄存器上的档位保持不变）
+     */
+    quint64 decode(int address, quint16 registerValue, quint64 stepMask) const;
+};
+
+/**
+ * @class LoadBankConfig
+ * @brief 负载柜档位配置
+ */
+class LoadBankConfig
+{
+public:
+    static constexpr int MAX_STEPS_PER_ROW = 64;    // 每行最多档位数（位掩码宽度）
+
+    /**
+     * @brief 获取内置的默认配置
+     * @param rowAddresses 各行寄存器地址
+     * @return 每行8档（0.1、0.2、0.2、0.5、1、2、2、5），占用各行寄存器的8-15位；
+     *         行名称序号即相序（R1/L1/C1接第1相）
+     */
+    static LoadBankConfig defaultConfig(const QVector<int> &rowAddresses);
+
+    /**
+     * @brief 获取程序使用的配置
+     * @param path 配置文件路径，文件存在且至少有minRows行时使用文件配置
+     * @param minRows 最少行数
+     * @return 文件配置或以REGISTER_ADDRESS_ROW0-8为寄存器地址的内置9行配置
+     */
+    static LoadBankConfig applicationConfig(const QString &path, int minRows);
+
+    /**
+     * @brief 从JSON文件加载配置
+     * @param path 文件路径
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否加载成功，失败时当前配置保持不变
+     */
+    bool loadFromFile(const QString &path, QString *errorString = nullptr);
+
+    /**
+     * @brief 获取行数
+     * @return 行数
+     */
+    int rowCount() const;
+
+    /**
+     * @brief 获取指定行的定义
+     * @param index 行索引
+     * @return 行定义
+     */
+    const LoadBankRow &row(int index) const;
+
+    /**
+     * @brief 获取总线映射
+     * @return 总线映射
+     */
+    const BusMap &bus() const;
+
+private:
+    QVector<LoadBankRow> m_rows;
+    BusMap m_bus;
+};
+
+#endif // LOADBANKCONFIG_H
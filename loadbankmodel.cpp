@@ -0,0 +1,745 @@
+/**
+ * @file loadbankmodel.cpp
+ * @brief 负载柜数据模型实现文件
+ * @details 包含LoadBankModel类的实现
+ */
+
+#include "loadbankmodel.h"
+#include "loadsolver.h"
+#include <QDebug>
+#include <QMap>
+#include <algorithm>
+#include <memory>
+
+static_assert(RELAY_ROW_COUNT <= 16, "MappedRegister::rowMask为16位");
+
+constexpr int LoadBankModel::STALE_REFRESH_MS;
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+LoadBankModel::LoadBankModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_rowCount(0)
+    , m_maxStepCount(0)
+    , m_pendingBlocks(0)
+    , m_refreshOk(true)
+    , m_refreshGeneration(0)
+    , m_commitSerial(0)
+    , m_registerWriteSerial(0)
+    , m_pendingIntentRows(0)
+    , m_resyncRequested(false)
+{
+}
+
+/**
+ * @brief 设置档位配置
+ * @param config 负载柜配置
+ */
+void LoadBankModel::setConfig(const LoadBankConfig &config)
+{
+    beginResetModel();
+
+    m_config = config;
+    m_rowCount = qMin(config.rowCount(), RELAY_ROW_COUNT);
+    m_maxStepCount = 0;
+    m_states.fill(RelayState());
+    m_sumTables.clear();
+    m_registers.clear();
+
+    // 丢弃旧配置下尚未返回的刷新和未确认的写入
+    m_pendingBlocks = 0;
+    ++m_refreshGeneration;
+    m_rowCommitSerial.fill(0, m_rowCount);
+    m_pendingIntentRows = 0;
+    m_resyncRequested = false;
+
+    QMap<int, quint16> rowMasks;
+    for (int row = 0; row < m_rowCount; ++row) {
+        const LoadBankRow &rowConfig = m_config.row(row);
+        m_maxStepCount = qMax(m_maxStepCount, rowConfig.steps.size());
+        m_sumTables.append(RelaySumTable(rowConfig.stepUnits()));
+        for (int address : rowConfig.registerAddresses()) {
+            rowMasks[address] |= quint16(1u << row);
+        }
+    }
+
+    // 编译为按地址升序的连续数组
+    m_registers.reserve(rowMasks.size());
+    for (auto it = rowMasks.constBegin(); it != rowMasks.constEnd(); ++it) {
+        MappedRegister entry;
+        entry.address = it.key();
+        entry.rowMask = it.value();
+        m_registers.append(entry);
+    }
+
+    // 默认只合并连续地址：读取未映射地址时部分从站返回ILLEGAL DATA ADDRESS，整块及其覆盖的行都会失败
+    m_readPlan = planReadBlocks(rowMasks.keys().toVector(), m_config.bus().readGap + 1, ModbusManager::MAX_READ_COUNT);
+
+    endResetModel();
+
+    qDebug() << "负载柜模型已加载 - 行数:" << m_rowCount << "寄存器数:" << m_registers.size()
+             << "每次刷新读取块数:" << m_readPlan.size();
+}
+
+/**
+ * @brief 获取档位配置
+ * @return 负载柜配置
+ */
+const LoadBankConfig &LoadBankModel::config() const
+{
+    return m_config;
+}
+
+/**
+ * @brief 获取行数
+ * @param parent 父索引
+ * @return 负载柜行数
+ */
+int LoadBankModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+/**
+ * @brief 获取列数
+ * @param parent 父索引
+ * @return 最多档位数加一列档位之和
+ */
+int LoadBankModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_maxStepCount + 1;
+}
+
+/**
+ * @brief 获取单元格数据
+ * @param index 单元格索引
+ * @param role 数据角色
+ * @return 档位列：DisplayRole为档位值，CheckStateRole为通断；末列：DisplayRole为档位之和
+ */
+QVariant LoadBankModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount) return QVariant();
+
+    const int row = index.row();
+    const int column = index.column();
+    const LoadBankRow &rowConfig = m_config.row(row);
+
+    if (column == m_maxStepCount) {
+        if (role == Qt::DisplayRole) {
+            return static_cast<double>(rowUnits(row)) / LoadSolver::UNITS_PER_VALUE;
+        }
+        return QVariant();
+    }
+
+    if (column >= rowConfig.steps.size()) return QVariant();
+
+    switch (role) {
+        case Qt::DisplayRole:
+            return rowConfig.steps[column].value;
+        case Qt::CheckStateRole:
+            return m_states[row].test(column) ? Qt::Checked : Qt::Unchecked;
+        default:
+            return QVariant();
+    }
+}
+
+/**
+ * @brief 获取表头数据
+ * @param section 行或列序号
+ * @param orientation 方向
+ * @param role 数据角色
+ * @return 行表头为行名称和单位，列表头为档位序号或"合计"
+ */
+QVariant LoadBankModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+
+    if (orientation == Qt::Vertical) {
+        if (section < 0 || section >= m_rowCount) return QVariant();
+        const LoadBankRow &rowConfig = m_config.row(section);
+        return QString("%1 (%2)").arg(rowConfig.name, rowConfig.unit);
+    }
+
+    if (section == m_maxStepCount) return QString("合计");
+    return QString("档位%1").arg(section + 1);
+}
+
+/**
+ * @brief 获取单元格标志
+ * @param index 单元格索引
+ * @return 档位单元格可勾选
+ */
+Qt::ItemFlags LoadBankModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.row() >= m_rowCount) return Qt::NoItemFlags;
+    if (index.column() >= m_config.row(index.row()).steps.size()) return Qt::ItemIsEnabled;
+    return Qt::ItemIsEnabled | Qt::ItemIsUserCheckable;
+}
+
+/**
+ * @brief 设置单元格数据
+ * @param index 单元格索引
+ * @param value 新值
+ * @param role 数据角色，仅支持CheckStateRole
+ * @return 是否设置成功
+ */
+bool LoadBankModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::CheckStateRole || !(flags(index) & Qt::ItemIsUserCheckable)) return false;
+
+    RelayState state = m_states[index.row()];
+    state.set(index.column(), value.toInt() == Qt::Checked);
+    setRowState(index.row(), state);
+    return true;
+}
+
+/**
+ * @brief 获取某行的继电器状态
+ * @param row 行索引
+ * @return 状态指针
+ */
+const RelayState *LoadBankModel::rowState(int row) const
+{
+    return &m_states[row];
+}
+
+/**
+ * @brief 设置某行的继电器状态
+ * @param row 行索引
+ * @param state 新状态
+ */
+void LoadBankModel::setRowState(int row, RelayState state)
+{
+    if (row < 0 || row >= m_rowCount || m_states[row] == state) return;
+
+    m_states[row] = state;
+    emit dataChanged(index(row, 0), index(row, m_maxStepCount), {Qt::DisplayRole, Qt::CheckStateRole});
+    emit rowStateChanged(row);
+}
+
+/**
+ * @brief 获取某行当前的档位之和
+ * @param row 行索引
+ * @return 档位之和（0.1为单位）
+ */
+int LoadBankModel::rowUnits(int row) const
+{
+    return m_sumTables[row].units(m_states[row]);
+}
+
+/**
+ * @brief 设置刷新过滤器
+ * @param filter 过滤器
+ */
+void LoadBankModel::setUpdateFilter(std::function<bool(int row, int address)> filter)
+{
+    m_updateFilter = filter;
+}
+
+/**
+ * @brief 批量刷新全部行
+ * @details 每个读取块一次事务，返回后把块内属于负载柜的寄存器分发到对应的行；
+ *          默认配置（寄存器50和1-8）每次刷新只需两次事务
+ */
+void LoadBankModel::refresh()
+{
+    if (m_pendingBlocks > 0) {
+        if (m_refreshClock.elapsed() < STALE_REFRESH_MS) {
+            qDebug() << "上一次批量刷新尚未完成，跳过本次刷新";
+            return;
+        }
+        qDebug() << "上一次批量刷新超时未完成，丢弃其结果";
+    }
+    if (m_readPlan.isEmpty()) return;
+
+    const quint64 generation = ++m_refreshGeneration;
+    const quint64 issuedWriteSerial = m_registerWriteSerial;
+    m_pendingBlocks = m_readPlan.size();
+    m_refreshOk = true;
+    m_refreshClock.start();
+
+    for (const RegisterBlock &block : m_readPlan) {
+        ModbusManager::instance()->readRegisters(block.startAddress, block.count,
+                                                 [this, block, generation, issuedWriteSerial](QVector<int> values) {
+            if (generation != m_refreshGeneration) return;
+
+            if (values.size() == block.count) {
+                for (int i = 0; i < values.size(); ++i) {
+                    const int index = findRegister(block.startAddress + i);
+                    // 读取发出后本地又写入过的寄存器，读数可能早于写入，保留缓存中的写入值
+                    if (index >= 0 && m_registers[index].writeSerial <= issuedWriteSerial) {
+                        m_registers[index].hasValue = true;
+                        m_registers[index].confirmed = true;
+                        m_registers[index].value = values[i];
+                        applyRegisterValue(block.startAddress + i, values[i]);
+                    }
+                }
+            } else {
+                m_refreshOk = false;
+            }
+
+            if (--m_pendingBlocks == 0) {
+                emit refreshFinished(m_refreshOk);
+                if (m_resyncRequested) {
+                    const int reappliedRows = m_refreshOk ? reapplyIntents() : 0;
+                    m_resyncRequested = !m_refreshOk;
+                    emit resynchronized(m_refreshOk, reappliedRows);
+                }
+            }
+        });
+    }
+}
+
+/**
+ * @brief 用一个寄存器的读数更新所有映射到该寄存器的行
+ * @param address 寄存器地址
+ * @param value 寄存器值
+ */
+void LoadBankModel::applyRegisterValue(int address, int value)
+{
+    const int index = findRegister(address);
+    if (index < 0) return;
+
+    const quint16 rowMask = m_registers[index].rowMask;
+    for (int row = 0; row < m_rowCount; ++row) {
+        if (!(rowMask & (1u << row))) {
+            continue;
+        }
+        if (m_pendingIntentRows & (1u << row)) {
+            continue;
+        }
+        if (m_updateFilter && !m_updateFilter(row, address)) {
+            continue;
+        }
+        quint64 bits = m_config.row(row).decode(address, static_cast<quint16>(value), m_states[row].bits());
+        setRowState(row, RelayState(bits));
+    }
+}
+
+/**
+ * @brief 获取寄存器最近一次的原始值
+ * @param address 寄存器地址
+ * @param value 输出寄存器值
+ * @return 是否已有读数
+ */
+bool LoadBankModel::registerValue(int address, int *value) const
+{
+    const int index = findRegister(address);
+    if (index < 0 || !m_registers[index].hasValue) return false;
+    if (value) *value = m_registers[index].value;
+    return true;
+}
+
+/**
+ * @brief 记录本地写入的寄存器值
+ * @param address 寄存器地址
+ * @param value 写入的值
+ */
+void LoadBankModel::noteRegisterWritten(int address, int value)
+{
+    const int index = findRegister(address);
+    if (index < 0) return;
+    m_registers[index].hasValue = true;
+    m_registers[index].value = value;
+    m_registers[index].writeSerial = ++m_registerWriteSerial;
+    m_registers[index].confirmed = false;
+}
+
+/**
+ * @brief 查找寄存器映射项
+ * @param address 寄存器地址
+ * @return 映射项下标，未映射时返回-1
+ */
+int LoadBankModel::findRegister(int address) const
+{
+    auto it = std::lower_bound(m_registers.constBegin(), m_registers.constEnd(), address,
+                               [](const MappedRegister &entry, int key) { return entry.address < key; });
+    if (it == m_registers.constEnd() || it->address != address) return -1;
+    return int(it - m_registers.constBegin());
+}
+
+/**
+ * @brief 提交若干行的目标状态
+ * @param commits 各行目标状态
+ * @param priority 总线请求优先级
+ * @param callback 全部写请求应答后调用，可为空
+ */
+void LoadBankModel::commitRows(const QVector<RowCommit> &commits, ModbusManager::RequestPriority priority,
+                               std::function<void(bool)> callback)
+{
+    // 合并涉及的寄存器位字段（按地址排序）
+    const quint64 serial = ++m_commitSerial;
+    quint16 committedRows = 0;
+    QMap<int, RegisterField> fields;
+    for (const RowCommit &commit : commits) {
+        if (commit.row < 0 || commit.row >= m_rowCount) continue;
+        const LoadBankRow &rowConfig = m_config.row(commit.row);
+        const QVector<RegisterField> target = rowConfig.encode(commit.mask);
+        const QVector<RegisterField> changed = rowConfig.encode(commit.changedMask);
+        for (int i = 0; i < target.size(); ++i) {
+            if (changed[i].value == 0) continue;
+            RegisterField &merged = fields[target[i].address];
+            merged.address = target[i].address;
+            merged.fieldMask |= target[i].fieldMask;
+            merged.value = static_cast<quint16>((merged.value & ~target[i].fieldMask) | target[i].value);
+        }
+        setRowState(commit.row, RelayState(commit.mask));
+        m_rowCommitSerial[commit.row] = serial;
+        committedRows |= quint16(1u << commit.row);
+    }
+
+    // 初始计数1防止同步失败的回调提前归零
+    auto pending = std::make_shared<int>(1);
+    std::function<void(bool)> onWritten = commitTracker(serial, committedRows, pending, callback);
+
+    ModbusManager *modbus = ModbusManager::instance();
+    int runStart = -1;
+    QVector<int> runValues;
+    auto flush = [&]() {
+        if (runValues.isEmpty()) return;
+        ++(*pending);
+        modbus->writeRegisters(runStart, runValues, writeGuard(runStart, runValues.size(), onWritten), priority);
+        runValues.clear();
+    };
+
+    for (auto it = fields.constBegin(); it != fields.constEnd(); ++it) {
+        const RegisterField field = it.value();
+
+        int current = 0;
+        if (!registerValue(field.address, &current)) {
+            qDebug() << "寄存器" << field.address << "尚无读数，退化为读-改-写";
+            flush();
+            ++(*pending);
+            modbus->readRegister(field.address, [this, modbus, field, onWritten, priority](int value) {
+                if (value == -1) {
+                    onWritten(false);
+                    return;
+                }
+                int newValue = (value & ~field.fieldMask) | field.value;
+                noteRegisterWritten(field.address, newValue);
+                modbus->writeRegisters(field.address, {newValue}, writeGuard(field.address, 1, onWritten), priority);
+            }, priority);
+            continue;
+        }
+
+        int newValue = (current & ~field.fieldMask) | field.value;
+        noteRegisterWritten(field.address, newValue);
+
+        if (runValues.isEmpty() || field.address != runStart + runValues.size()
+                || runValues.size() >= ModbusManager::MAX_WRITE_COUNT) {
+            flush();
+            runStart = field.address;
+        }
+        runValues.append(newValue);
+    }
+    flush();
+
+    onWritten(true);
+}
+
+/**
+ * @brief 生成一次提交的写应答处理函数
+ * @param serial 提交序号
+ * @param committedRows 本次提交的行
+ * @param pending 尚未应答的写请求数
+ * @param callback 全部应答后调用，可为空
+ * @return 写应答处理函数
+ */
+std::function<void(bool)> LoadBankModel::commitTracker(quint64 serial, quint16 committedRows,
+                                                       std::shared_ptr<int> pending,
+                                                       std::function<void(bool)> callback)
+{
+    auto allOk = std::make_shared<bool>(true);
+    return [this, pending, allOk, callback, serial, committedRows](bool ok) {
+        *allOk = *allOk && ok;
+        if (--(*pending) != 0) return;
+
+        // 只处理之后没有被再次提交的行：成功则意图已确认，失败则保留为待下发意图
+        for (int row = 0; row < m_rowCount; ++row) {
+            if (!(committedRows & (1u << row)) || m_rowCommitSerial[row] != serial) continue;
+            if (*allOk) {
+                m_pendingIntentRows &= quint16(~(1u << row));
+            } else {
+                m_pendingIntentRows |= quint16(1u << row);
+            }
+        }
+        if (callback) {
+            callback(*allOk);
+        }
+    };
+}
+
+/**
+ * @brief 生成一次写请求的应答处理函数
+ * @param startAddress 起始地址
+ * @param count 寄存器数量
+ * @param onWritten 应答后调用
+ * @return 写应答处理函数
+ * @details 写入前已把目标值记入缓存但尚未确认；写入成功后缓存值即硬件值，
+ *          写入失败时寄存器仍为旧值，缓存失效后下一次提交先读取再写入。
+ *          之后又被写入的寄存器以后一次写入为准，不受本次应答影响
+ */
+std::function<void(bool)> LoadBankModel::writeGuard(int startAddress, int count, std::function<void(bool)> onWritten)
+{
+    QVector<quint64> serials;
+    serials.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int index = findRegister(startAddress + i);
+        serials.append(index >= 0 ? m_registers[index].writeSerial : 0);
+    }
+
+    return [this, startAddress, serials, onWritten](bool ok) {
+        for (int i = 0; i < serials.size(); ++i) {
+            const int index = findRegister(startAddress + i);
+            if (index >= 0 && serials[i] != 0 && m_registers[index].writeSerial == serials[i]) {
+                m_registers[index].hasValue = ok;
+                m_registers[index].confirmed = ok;
+            }
+        }
+        onWritten(ok);
+    };
+}
+
+/**
+ * @brief 捕获整个负载柜的快照
+ * @param snapshot 输出快照
+ * @param errorString 失败时的错误描述
+ * @return 是否成功
+ */
+bool LoadBankModel::captureSnapshot(BankSnapshot *snapshot, QString *errorString) const
+{
+    BankSnapshot captured;
+    for (const MappedRegister &entry : m_registers) {
+        if (!entry.hasValue) {
+            if (errorString) *errorString = QString("寄存器%1尚无读数，请等待刷新完成").arg(entry.address);
+            return false;
+        }
+        captured.registers.insert(entry.address, static_cast<quint16>(entry.value));
+    }
+    for (int row = 0; row < m_rowCount; ++row) {
+        quint64 bits = 0;
+        cachedRowBits(row, &bits);
+        captured.rowBits.append(bits);
+    }
+    *snapshot = captured;
+    return true;
+}
+
+/**
+ * @brief 检查快照是否适用于当前配置
+ * @param snapshot 快照
+ * @param errorString 失败时的错误描述
+ * @return 是否适用
+ */
+bool LoadBankModel::checkSnapshot(const BankSnapshot &snapshot, QString *errorString) const
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) *errorString = message;
+        return false;
+    };
+
+    if (snapshot.rowBits.size() != m_rowCount) {
+        return fail(QString("快照有%1行，当前配置有%2行").arg(snapshot.rowBits.size()).arg(m_rowCount));
+    }
+    if (snapshot.registers.size() != m_registers.size()) {
+        return fail(QString("快照有%1个寄存器，当前配置映射%2个").arg(snapshot.registers.size()).arg(m_registers.size()));
+    }
+    for (const MappedRegister &entry : m_registers) {
+        if (!snapshot.registers.contains(entry.address)) {
+            return fail(QString("快照缺少寄存器%1").arg(entry.address));
+        }
+    }
+    for (int row = 0; row < m_rowCount; ++row) {
+        const LoadBankRow &rowConfig = m_config.row(row);
+        quint64 decoded = 0;
+        for (int address : rowConfig.registerAddresses()) {
+            decoded = rowConfig.decode(address, snapshot.registers.value(address), decoded);
+        }
+        if (decoded != snapshot.rowBits[row]) {
+            return fail(QString("第%1行的继电器状态与快照中的寄存器值不一致").arg(row));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 一次性切换到快照状态
+ * @param snapshot 目标快照
+ * @param priority 总线请求优先级
+ * @param callback 全部写请求应答后调用，可为空
+ * @param errorString 快照不适用时的错误描述
+ * @return 快照是否适用
+ */
+bool LoadBankModel::commitSnapshot(const BankSnapshot &snapshot, ModbusManager::RequestPriority priority,
+                                   std::function<void(bool)> callback, QString *errorString)
+{
+    if (!checkSnapshot(snapshot, errorString)) {
+        return false;
+    }
+
+    // 暂存：映射项按地址升序，与目标值逐个比较得到最小写入集合；
+    // 只跳过已由读数或写应答确认的寄存器，写入尚未应答的寄存器可能与缓存不一致
+    QVector<int> addresses;
+    QVector<int> values;
+    quint16 committedRows = 0;
+    for (const MappedRegister &entry : m_registers) {
+        const int target = snapshot.registers.value(entry.address);
+        const bool trusted = entry.hasValue && entry.confirmed && !(entry.rowMask & m_pendingIntentRows);
+        if (trusted && entry.value == target) continue;
+        addresses.append(entry.address);
+        values.append(target);
+        committedRows |= entry.rowMask;
+    }
+
+    const quint64 serial = ++m_commitSerial;
+    for (int row = 0; row < m_rowCount; ++row) {
+        setRowState(row, RelayState(snapshot.rowBits[row]));
+        if (committedRows & (1u << row)) {
+            m_rowCommitSerial[row] = serial;
+        }
+    }
+
+    // 提交：连续地址合并为一次写事务，全部请求在同一时刻入队
+    auto pending = std::make_shared<int>(1);
+    std::function<void(bool)> onWritten = commitTracker(serial, committedRows, pending, callback);
+    ModbusManager *modbus = ModbusManager::instance();
+    int transactions = 0;
+    for (int i = 0; i < addresses.size();) {
+        int end = i + 1;
+        while (end < addresses.size() && addresses[end] == addresses[end - 1] + 1
+               && end - i < ModbusManager::MAX_WRITE_COUNT) {
+            ++end;
+        }
+        for (int j = i; j < end; ++j) {
+            noteRegisterWritten(addresses[j], values[j]);
+        }
+        ++(*pending);
+        ++transactions;
+        modbus->writeRegisters(addresses[i], values.mid(i, end - i), writeGuard(addresses[i], end - i, onWritten),
+                               priority);
+        i = end;
+    }
+    qDebug() << "切换到快照 - 写入寄存器:" << addresses.size() << "/" << m_registers.size()
+             << "写事务:" << transactions;
+
+    onWritten(true);
+    return true;
+}
+
+/**
+ * @brief 重新同步
+ * @details 放弃尚未返回的刷新（断开前发出的请求已全部以失败回调），立即发出一次完整的批量读取
+ */
+void LoadBankModel::resynchronize()
+{
+    qDebug() << "负载柜模型重新同步 - 待下发意图行数:" << pendingIntentCount();
+    m_resyncRequested = true;
+    m_pendingBlocks = 0;
+    refresh();
+}
+
+/**
+ * @brief 是否有写入未确认的行
+ * @return 待下发意图的行数
+ */
+int LoadBankModel::pendingIntentCount() const
+{
+    int count = 0;
+    for (int row = 0; row < m_rowCount; ++row) {
+        if (m_pendingIntentRows & (1u << row)) ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief 由寄存器缓存解码某行的硬件状态
+ * @param row 行索引
+ * @param bits 输出继电器位掩码
+ * @return 该行的寄存器是否都已有读数
+ */
+bool LoadBankModel::cachedRowBits(int row, quint64 *bits) const
+{
+    const LoadBankRow &rowConfig = m_config.row(row);
+    quint64 decoded = 0;
+    for (int address : rowConfig.registerAddresses()) {
+        int value = 0;
+        if (!registerValue(address, &value)) return false;
+        decoded = rowConfig.decode(address, static_cast<quint16>(value), decoded);
+    }
+    *bits = decoded;
+    return true;
+}
+
+/**
+ * @brief 重新下发待下发意图
+ * @return 重新下发的行数
+ * @details 刚读到的寄存器值即硬件状态：与意图一致的行直接确认，其余行只写入变化的档位
+ */
+int LoadBankModel::reapplyIntents()
+{
+    QVector<RowCommit> commits;
+    for (int row = 0; row < m_rowCount; ++row) {
+        if (!(m_pendingIntentRows & (1u << row))) continue;
+
+        const quint64 intent = m_states[row].bits();
+        quint64 hardware = 0;
+        if (!cachedRowBits(row, &hardware)) continue;
+        if (hardware == intent) {
+            m_pendingIntentRows &= quint16(~(1u << row));
+            continue;
+        }
+
+        RowCommit commit;
+        commit.row = row;
+        commit.mask = intent;
+        commit.changedMask = intent ^ hardware;
+        commits.append(commit);
+    }
+
+    if (!commits.isEmpty()) {
+        qDebug() << "重新下发未确认的操作意图 - 行数:" << commits.size();
+        commitRows(commits, ModbusManager::ControlPriority);
+    }
+    return commits.size();
+}
+
+/**
+ * @brief 获取当前的批量读取计划
+ * @return 连续寄存器块
+ */
+QVector<RegisterBlock> LoadBankModel::readPlan() const
+{
+    return m_readPlan;
+}
+
+/**
+ * @brief 把寄存器地址合并为连续读取块
+ * @param addresses 寄存器地址
+ * @param maxGap 允许合并的最大地址间隔
+ * @param maxCount 单块最多寄存器数
+ * @return 读取块
+ */
+QVector<RegisterBlock> LoadBankModel::planReadBlocks(QVector<int> addresses, int maxGap, int maxCount)
+{
+    std::sort(addresses.begin(), addresses.end());
+    addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+
+    QVector<RegisterBlock> blocks;
+    for (int address : addresses) {
+        if (!blocks.isEmpty()) {
+            RegisterBlock &last = blocks.last();
+            int lastAddress = last.startAddress + last.count - 1;
+            if (address - lastAddress <= maxGap && address - last.startAddress + 1 <= maxCount) {
+                last.count = address - last.startAddress + 1;
+                continue;
+            }
+        }
+        RegisterBlock block;
+        block.startAddress = address;
+        block.count = 1;
+        blocks.append(block);
+    }
+    return blocks;
+}
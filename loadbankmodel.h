@@ -0,0 +1,317 @@
+/**
+ * @file loadbankmodel.h
+ * @brief 负载柜数据模型定义文件
+ * @details 包含LoadBankModel类的声明。模型持有全部行的继电器状态和寄存器映射，
+ *          一次刷新把全部行涉及的寄存器合并为尽量少的连续块批量读取，
+ *          状态变化通过dataChanged与rowStateChanged通知界面
+ */
+
+#ifndef LOADBANKMODEL_H
+#define LOADBANKMODEL_H
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QMap>
+#include <functional>
+#include <memory>
+
+#include "loadbankconfig.h"
+#include "modbusmanager.h"
+#include "relaystate.h"
+
+/**
+ * @struct RegisterBlock
+ * @brief 一次批量读取的连续寄存器范围
+ */
+struct RegisterBlock
+{
+    int startAddress = 0;       // 起始地址
+    int count = 0;              // 寄存器数量
+};
+
+/**
+ * @struct MappedRegister
+ * @brief 配置加载时编译出的寄存器映射项
+ * @details 全部映射项按地址升序存放在连续数组中，按地址二分查找，替代逐次哈希查找
+ */
+struct MappedRegister
+{
+    int address = 0;            // 寄存器地址
+    quint16 rowMask = 0;        // 使用该寄存器的行（第r位对应第r行）
+    bool hasValue = false;      // 是否已有读数
+    int value = 0;              // 最近一次的原始值
+    quint64 writeSerial = 0;    // 最近一次本地写入的序号，0表示未写入过
+    bool confirmed = false;     // 缓存值是否已由读数或写应答确认
+};
+
+/**
+ * @struct RowCommit
+ * @brief 一次提交中某行的目标状态
+ */
+struct RowCommit
+{
+    int row = 0;
+    quint64 mask = 0;           // 目标继电器位掩码
+    quint64 changedMask = 0;    // 相对当前状态变化的档位，只写入包含这些档位的寄存器
+};
+
+/**
+ * @struct BankSnapshot
+ * @brief 整个负载柜的状态快照
+ * @details 保存全部映射寄存器的完整16位值（包括不属于档位的低字节）和由其解码的各行继电器位掩码
+ */
+struct BankSnapshot
+{
+    QVector<quint64> rowBits;           // 各行继电器位掩码
+    QMap<int, quint16> registers;       // 寄存器地址 -> 完整寄存器值
+};
+
+/**
+ * @class LoadBankModel
+ * @brief 负载柜数据模型
+ * @details 行对应负载柜的行，前若干列对应各档位（CheckStateRole为通断），最后一列为档位之和
+ */
+class LoadBankModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int STALE_REFRESH_MS = 5000;   // 批量刷新超过该时间未完成视为丢失
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit LoadBankModel(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置档位配置
+     * @param config 负载柜配置，只使用前RELAY_ROW_COUNT行
+     * @details 重建寄存器映射和批量读取计划，所有状态清零
+     */
+    void setConfig(const LoadBankConfig &config);
+
+    /**
+     * @brief 获取档位配置
+     * @return 负载柜配置
+     */
+    const LoadBankConfig &config() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+    /**
+     * @brief 获取某行的继电器状态
+     * @param row 行索引
+     * @return 指向该行状态的指针，随模型存在
+     */
+    const RelayState *rowState(int row) const;
+
+    /**
+     * @brief 设置某行的继电器状态
+     * @param row 行索引
+     * @param state 新状态
+     * @details 状态变化时发出dataChanged和rowStateChanged
+     */
+    void setRowState(int row, RelayState state);
+
+    /**
+     * @brief 获取某行当前的档位之和
+     * @param row 行索引
+     * @return 档位之和（0.1为单位）
+     */
+    int rowUnits(int row) const;
+
+    /**
+     * @brief 设置刷新过滤器
+     * @param filter 返回false时该行不接受该寄存器的读数（例如正在编辑或刚写入）
+     */
+    void setUpdateFilter(std::function<bool(int row, int address)> filter);
+
+    /**
+     * @brief 批量刷新全部行
+     * @details 按读取计划依次发出批量读请求；上一次刷新尚未完成时直接返回，避免请求堆积
+     */
+    void refresh();
+
+    /**
+     * @brief 用一个寄存器的读数更新所有映射到该寄存器的行
+     * @param address 寄存器地址
+     * @param value 寄存器值
+     */
+    void applyRegisterValue(int address, int value);
+
+    /**
+     * @brief 获取寄存器最近一次的原始值
+     * @param address 寄存器地址
+     * @param value 输出寄存器值
+     * @return 是否已有该寄存器的读数（刷新读到或本地写入过）
+     */
+    bool registerValue(int address, int *value) const;
+
+    /**
+     * @brief 记录本地写入的寄存器值
+     * @param address 寄存器地址
+     * @param value 写入的值
+     * @details 使后续基于缓存的读-改-写无需再读取寄存器；写入之前发出的刷新读数不再覆盖该值
+     */
+    void noteRegisterWritten(int address, int value);
+
+    /**
+     * @brief 提交若干行的目标状态
+     * @param commits 各行目标状态
+     * @param priority 总线请求优先级
+     * @param callback 全部写请求应答后调用，参数为是否全部成功，可为空
+     * @details 立即更新模型状态；涉及的寄存器位字段合并后按地址连续的段批量写入，
+     *          寄存器值取自缓存，尚无读数或上次写入失败的寄存器退化为读-改-写
+     */
+    void commitRows(const QVector<RowCommit> &commits,
+                    ModbusManager::RequestPriority priority = ModbusManager::NormalPriority,
+                    std::function<void(bool)> callback = nullptr);
+
+    /**
+     * @brief 捕获整个负载柜的快照
+     * @param snapshot 输出快照
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否成功，有寄存器尚无读数时失败
+     * @details 寄存器值取自缓存（包括本地写入过的值），各行位掩码由寄存器值解码，二者始终一致
+     */
+    bool captureSnapshot(BankSnapshot *snapshot, QString *errorString = nullptr) const;
+
+    /**
+     * @brief 检查快照是否适用于当前配置
+     * @param snapshot 快照
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 快照的行数、寄存器集合与当前配置一致且各行位掩码与寄存器值一致时返回true
+     */
+    bool checkSnapshot(const BankSnapshot &snapshot, QString *errorString = nullptr) const;
+
+    /**
+     * @brief 一次性切换到快照状态
+     * @param snapshot 目标快照
+     * @param priority 总线请求优先级
+     * @param callback 全部写请求应答后调用，参数为是否全部成功，可为空
+     * @param errorString 快照不适用时的错误描述，可为nullptr
+     * @return 快照是否适用（不适用时不写入任何寄存器，也不调用callback）
+     * @details 先算出全部目标寄存器值，跳过已确认的缓存值等于目标的寄存器（写入尚未应答或属于待下发意图行的不跳过），
+     *          其余按地址连续的段合并，在同一时刻全部入队批量写入；随后立即更新全部行的状态
+     */
+    bool commitSnapshot(const BankSnapshot &snapshot,
+                        ModbusManager::RequestPriority priority = ModbusManager::ControlPriority,
+                        std::function<void(bool)> callback = nullptr, QString *errorString = nullptr);
+
+    /**
+     * @brief 重新同步：一次批量读取全部映射寄存器，重建寄存器缓存后重新下发未确认的操作意图
+     * @details 总线恢复后调用。写入未成功应答的行保留目标状态作为待下发意图，刷新不覆盖这些行；
+     *          读取成功后按读到的硬件状态计算变化档位，以控制优先级合并写入，结果由resynchronized通知
+     */
+    void resynchronize();
+
+    /**
+     * @brief 是否有写入未确认的行
+     * @return 有待下发意图的行数
+     */
+    int pendingIntentCount() const;
+
+    /**
+     * @brief 获取当前的批量读取计划
+     * @return 连续寄存器块
+     */
+    QVector<RegisterBlock> readPlan() const;
+
+    /**
+     * @brief 把寄存器地址合并为连续读取块
+     * @param addresses 寄存器地址（可无序、可重复）
+     * @param maxGap 允许合并的最大地址间隔
+     * @param maxCount 单块最多寄存器数
+     * @return 按地址升序的读取块
+     */
+    static QVector<RegisterBlock> planReadBlocks(QVector<int> addresses, int maxGap, int maxCount);
+
+signals:
+    /**
+     * @brief 某行状态发生变化
+     * @param row 行索引
+     */
+    void rowStateChanged(int row);
+
+    /**
+     * @brief 一次批量刷新完成
+     * @param ok 全部读取块是否成功
+     */
+    void refreshFinished(bool ok);
+
+    /**
+     * @brief 重新同步完成
+     * @param ok 批量读取是否成功（失败时在下一次刷新成功后继续）
+     * @param reappliedRows 重新下发的行数
+     */
+    void resynchronized(bool ok, int reappliedRows);
+
+private:
+    /**
+     * @brief 查找寄存器映射项
+     * @param address 寄存器地址
+     * @return 映射项下标，未映射时返回-1
+     */
+    int findRegister(int address) const;
+
+    /**
+     * @brief 由寄存器缓存解码某行的硬件状态
+     * @param row 行索引
+     * @param bits 输出继电器位掩码
+     * @return 该行的寄存器是否都已有读数
+     */
+    bool cachedRowBits(int row, quint64 *bits) const;
+
+    /**
+     * @brief 重新下发待下发意图
+     * @return 重新下发的行数
+     */
+    int reapplyIntents();
+
+    /**
+     * @brief 生成一次提交的写应答处理函数
+     * @param serial 提交序号
+     * @param committedRows 本次提交的行（第r位对应第r行）
+     * @param pending 尚未应答的写请求数，初始为1，提交方发完请求后再以成功调用一次
+     * @param callback 全部应答后调用，可为空
+     * @return 写应答处理函数，全部应答后更新待下发意图并调用callback
+     */
+    std::function<void(bool)> commitTracker(quint64 serial, quint16 committedRows, std::shared_ptr<int> pending,
+                                            std::function<void(bool)> callback);
+
+    /**
+     * @brief 生成一次写请求的应答处理函数
+     * @param startAddress 起始地址
+     * @param count 寄存器数量，各寄存器已通过noteRegisterWritten记录写入值
+     * @param onWritten 应答后调用
+     * @return 写应答处理函数，对之后未再写入的寄存器：成功时确认缓存值，失败时使缓存失效，再调用onWritten
+     */
+    std::function<void(bool)> writeGuard(int startAddress, int count, std::function<void(bool)> onWritten);
+
+    LoadBankConfig m_config;                        // 负载柜配置
+    int m_rowCount;                                 // 使用的行数
+    int m_maxStepCount;                             // 各行中最多的档位数
+    RelayStateBank m_states;                        // 全部行的继电器状态，连续存放
+    QVector<RelaySumTable> m_sumTables;             // 各行档位之和表
+    QVector<MappedRegister> m_registers;            // 寄存器映射，按地址升序
+    QVector<RegisterBlock> m_readPlan;              // 批量读取计划
+    int m_pendingBlocks;                            // 本次刷新尚未返回的读取块数
+    bool m_refreshOk;                               // 本次刷新是否全部成功
+    quint64 m_refreshGeneration;                    // 刷新代号，用于丢弃过期的应答
+    QElapsedTimer m_refreshClock;                   // 本次刷新开始计时
+    std::function<bool(int, int)> m_updateFilter;   // 刷新过滤器
+    QVector<quint64> m_rowCommitSerial;             // 各行最近一次提交的序号
+    quint64 m_commitSerial;                         // 提交序号
+    quint64 m_registerWriteSerial;                  // 寄存器本地写入序号
+    quint16 m_pendingIntentRows;                    // 写入未确认的行（第r位对应第r行），其目标状态即当前状态
+    bool m_resyncRequested;                         // 是否等待下一次成功刷新后重新下发意图
+};
+
+#endif // LOADBANKMODEL_H
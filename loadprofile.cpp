@@ -0,0 +1,202 @@
+/**
+ * @file loadprofile.cpp
+ * @brief 负载曲线实现文件
+ * @details 包含LoadProfile类的实现
+ */
+
+#include "loadprofile.h"
+#include "loadsolver.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QDebug>
+
+/**
+ * @brief 解析行引用
+ * @param value 行索引或行名称
+ * @param config 负载柜配置
+ * @return 行索引，无法解析时返回-1
+ */
+static int resolveRow(const QJsonValue &value, const LoadBankConfig &config)
+{
+    if (value.isDouble()) {
+        int row = value.toInt(-1);
+        return (row >= 0 && row < config.rowCount()) ? row : -1;
+    }
+    if (value.isString()) {
+        for (int row = 0; row < config.rowCount(); ++row) {
+            if (config.row(row).name.compare(value.toString(), Qt::CaseInsensitive) == 0) {
+                return row;
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 将秒转换为毫秒
+ * @param seconds 秒
+ * @return 毫秒（四舍五入）
+ */
+static qint64 secondsToMs(double seconds)
+{
+    return qRound64(seconds * 1000.0);
+}
+
+/**
+ * @brief 从JSON文件加载曲线
+ * @param path 文件路径
+ * @param config 负载柜配置
+ * @param errorString 失败时的错误描述
+ * @return 是否加载成功
+ */
+bool LoadProfile::loadFromFile(const QString &path, const LoadBankConfig &config, QString *errorString)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) *errorString = message;
+        qWarning() << "负载曲线加载失败:" << message;
+        return false;
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("无法打开文件 %1: %2").arg(path, file.errorString()));
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return fail(QString("JSON解析错误（偏移%1）: %2").arg(parseError.offset).arg(parseError.errorString()));
+    }
+
+    QJsonObject root = document.object();
+    QJsonArray stepArray = root.value("steps").toArray();
+    if (stepArray.isEmpty()) {
+        return fail("曲线中没有定义任何步骤");
+    }
+
+    int defaultRow = root.contains("row") ? resolveRow(root.value("row"), config) : 0;
+    if (defaultRow < 0) {
+        return fail(QString("无效的行: %1").arg(root.value("row").toVariant().toString()));
+    }
+
+    int repeat = qMax(1, root.value("repeat").toInt(1));
+
+    // 各行的最大负载，用于检查目标值
+    QVector<int> maxUnits;
+    for (int row = 0; row < config.rowCount(); ++row) {
+        int total = 0;
+        for (int units : config.row(row).stepUnits()) total += units;
+        maxUnits.append(total);
+    }
+
+    QVector<ProfileSetpoint> setpoints;
+    QVector<double> lastValues(config.rowCount(), 0.0);
+    qint64 offsetMs = 0;
+
+    auto addSetpoint = [&](int row, double value) -> bool {
+        int units = LoadSolver::toUnits(value);
+        if (units < 0 || units > maxUnits[row]) return false;
+        ProfileSetpoint setpoint;
+        setpoint.offsetMs = offsetMs;
+        setpoint.row = row;
+        setpoint.value = value;
+        setpoints.append(setpoint);
+        lastValues[row] = value;
+        return true;
+    };
+
+    for (int pass = 0; pass < repeat; ++pass) {
+        for (int i = 0; i < stepArray.size(); ++i) {
+            QJsonObject step = stepArray[i].toObject();
+
+            int row = step.contains("row") ? resolveRow(step.value("row"), config) : defaultRow;
+            if (row < 0) {
+                return fail(QString("步骤%1的行无效").arg(i + 1));
+            }
+
+            if (step.contains("ramp")) {
+                QJsonObject ramp = step.value("ramp").toObject();
+                double from = ramp.value("from").toDouble(lastValues[row]);
+                double to = ramp.value("to").toDouble(from);
+                double increment = qAbs(ramp.value("step").toDouble(0.0));
+                qint64 intervalMs = secondsToMs(ramp.value("interval").toDouble(0.0));
+                if (LoadSolver::toUnits(increment) <= 0 || intervalMs <= 0) {
+                    return fail(QString("步骤%1的斜坡步长或间隔无效").arg(i + 1));
+                }
+
+                // 以0.1为单位累加，避免浮点误差产生多余的台阶
+                const int fromUnits = LoadSolver::toUnits(from);
+                const int toUnits = LoadSolver::toUnits(to);
+                const int stepUnits = (toUnits >= fromUnits ? 1 : -1) * LoadSolver::toUnits(increment);
+                int units = fromUnits;
+                while (units != toUnits) {
+                    units = (stepUnits > 0) ? qMin(units + stepUnits, toUnits) : qMax(units + stepUnits, toUnits);
+                    if (!addSetpoint(row, static_cast<double>(units) / LoadSolver::UNITS_PER_VALUE)) {
+                        return fail(QString("步骤%1的斜坡超出行%2的范围").arg(i + 1).arg(row));
+                    }
+                    offsetMs += intervalMs;
+                }
+            } else if (step.contains("value")) {
+                if (!addSetpoint(row, step.value("value").toDouble())) {
+                    return fail(QString("步骤%1的目标值%2超出行%3的范围").arg(i + 1).arg(step.value("value").toDouble()).arg(row));
+                }
+            }
+
+            double hold = step.value("hold").toDouble(0.0);
+            if (hold < 0) {
+                return fail(QString("步骤%1的保持时间为负").arg(i + 1));
+            }
+            offsetMs += secondsToMs(hold);
+        }
+    }
+
+    if (setpoints.isEmpty()) {
+        return fail("曲线中没有任何设定值");
+    }
+
+    m_name = root.value("name").toString(path);
+    m_setpoints = setpoints;
+    m_durationMs = offsetMs;
+
+    qDebug() << "负载曲线已加载:" << m_name << "设定点:" << m_setpoints.size() << "总时长:" << m_durationMs / 1000.0 << "秒";
+    return true;
+}
+
+/**
+ * @brief 获取曲线名称
+ * @return 曲线名称
+ */
+QString LoadProfile::name() const
+{
+    return m_name;
+}
+
+/**
+ * @brief 获取按时间排序的设定点
+ * @return 设定点数组
+ */
+const QVector<ProfileSetpoint> &LoadProfile::setpoints() const
+{
+    return m_setpoints;
+}
+
+/**
+ * @brief 获取曲线总时长
+ * @return 总时长（毫秒）
+ */
+qint64 LoadProfile::durationMs() const
+{
+    return m_durationMs;
+}
+
+/**
+ * @brief 曲线是否为空
+ * @return 是否为空
+ */
+bool LoadProfile::isEmpty() const
+{
+    return m_setpoints.isEmpty();
+}
@@ -0,0 +1,91 @@
+/**
+ * @file loadprofile.h
+ * @brief 负载曲线定义文件
+ * @details 包含ProfileSetpoint和LoadProfile的声明，负责从JSON文件读取负载曲线并展开为按时间排列的设定点
+ *
+ * 曲线文件格式示例（2.0 kW保持30秒，然后每5秒增加0.5 kW直到7.5 kW，保持60秒后卸载）：
+ * @code
+ * {
+ *     "name": "阶跃响应",
+ *     "row": "R1",
+ *     "repeat": 1,
+ *     "steps": [
+ *         { "value": 2.0, "hold": 30 },
+ *         { "ramp": { "to": 7.5, "step": 0.5, "interval": 5 } },
+ *         { "hold": 60 },
+ *         { "row": 3, "value": 1.0, "hold": 0 },
+ *         { "value": 0, "hold": 10 }
+ *     ]
+ * }
+ * @endcode
+ * row可以是行索引或行名称，步骤中的row覆盖曲线级的row；时间单位为秒。
+ * 斜坡的起点默认为该行上一设定值（也可用from指定），第一个台阶在斜坡开始时刻生效
+ */
+
+#ifndef LOADPROFILE_H
+#define LOADPROFILE_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include "loadbankconfig.h"
+
+/**
+ * @struct ProfileSetpoint
+ * @brief 负载曲线中的一个设定点
+ */
+struct ProfileSetpoint
+{
+    qint64 offsetMs = 0;        // 相对曲线开始的时刻（毫秒）
+    int row = 0;                // 行索引
+    double value = 0.0;         // 目标负载值
+};
+
+/**
+ * @class LoadProfile
+ * @brief 负载曲线
+ */
+class LoadProfile
+{
+public:
+    /**
+     * @brief 从JSON文件加载曲线
+     * @param path 文件路径
+     * @param config 负载柜配置，用于解析行名称和检查目标值范围
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否加载成功，失败时当前曲线保持不变
+     */
+    bool loadFromFile(const QString &path, const LoadBankConfig &config, QString *errorString = nullptr);
+
+    /**
+     * @brief 获取曲线名称
+     * @return 曲线名称
+     */
+    QString name() const;
+
+    /**
+     * @brief 获取按时间排序的设定点
+     * @return 设定点数组
+     */
+    const QVector<ProfileSetpoint> &setpoints() const;
+
+    /**
+     * @brief 获取曲线总时长
+     * @return 总时长（毫秒），最后一个步骤的保持时间结束时曲线结束
+     */
+    qint64 durationMs() const;
+
+    /**
+     * @brief 曲线是否为空
+     * @return 没有任何设定点时返回true
+     */
+    bool isEmpty() const;
+
+private:
+    QString m_name;
+    QVector<ProfileSetpoint> m_setpoints;
+    qint64 m_durationMs = 0;
+};
+
+#endif // LOADPROFILE_H
@@ -0,0 +1,357 @@
+/**
+ * @file loadsequencer.cpp
+ * @brief 负载曲线执行器实现文件
+ * @details 包含SequencerClock和LoadSequencer类的实现
+ */
+
+#include "loadsequencer.h"
+#include "loadbankmodel.h"
+#include "modbusmanager.h"
+#include <QDebug>
+
+constexpr qint64 SequencerClock::SPIN_THRESHOLD_NS;
+constexpr qint64 SequencerClock::MAX_SLEEP_MS;
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+SequencerClock::SequencerClock(QObject *parent)
+    : QObject(parent)
+    , m_cancelled(0)
+{
+}
+
+/**
+ * @brief 依次等待各截止时刻
+ * @param deadlinesMs 各截止时刻（毫秒）
+ * @param clock 曲线开始时启动的单调时钟
+ */
+void SequencerClock::run(const QVector<qint64> &deadlinesMs, QElapsedTimer clock)
+{
+    m_cancelled.storeRelaxed(0);
+
+    for (int i = 0; i < deadlinesMs.size(); ++i) {
+        const qint64 deadlineNs = deadlinesMs[i] * 1000000;
+
+        // 距截止时刻较远时分段休眠
+        qint64 remainingNs;
+        while ((remainingNs = deadlineNs - clock.nsecsElapsed()) > SPIN_THRESHOLD_NS) {
+            if (m_cancelled.loadRelaxed()) {
+                emit finished(true);
+                return;
+            }
+            qint64 sleepMs = qMin((remainingNs - SPIN_THRESHOLD_NS) / 1000000, MAX_SLEEP_MS);
+            if (sleepMs > 0) {
+                QThread::msleep(static_cast<unsigned long>(sleepMs));
+            } else {
+                QThread::yieldCurrentThread();
+            }
+        }
+
+        // 最后一段自旋等待
+        while (clock.nsecsElapsed() < deadlineNs) {
+            QThread::yieldCurrentThread();
+        }
+
+        emit deadlineReached(i, clock.nsecsElapsed());
+    }
+
+    emit finished(false);
+}
+
+/**
+ * @brief 请求取消
+ */
+void SequencerClock::cancel()
+{
+    m_cancelled.storeRelaxed(1);
+}
+
+/**
+ * @brief 构造函数
+ * @param model 负载柜数据模型
+ * @param parent 父对象指针
+ * @details 创建定时器并移动到以最高优先级运行的定时线程
+ */
+LoadSequencer::LoadSequencer(LoadBankModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_clock(new SequencerClock())
+    , m_running(false)
+    , m_runId(0)
+{
+    m_clock->moveToThread(&m_thread);
+    connect(m_clock, &SequencerClock::deadlineReached, this, &LoadSequencer::onDeadlineReached);
+    connect(m_clock, &SequencerClock::finished, this, &LoadSequencer::onClockFinished);
+    m_thread.setObjectName("LoadSequencerClock");
+    m_thread.start(QThread::TimeCriticalPriority);
+}
+
+/**
+ * @brief 析构函数
+ */
+LoadSequencer::~LoadSequencer()
+{
+    m_clock->cancel();
+    m_thread.quit();
+    m_thread.wait();
+    delete m_clock;
+}
+
+/**
+ * @brief 加载负载曲线
+ * @param path 曲线文件路径
+ * @param errorString 失败时的错误描述
+ * @return 是否加载成功
+ */
+bool LoadSequencer::loadProfile(const QString &path, QString *errorString)
+{
+    if (m_running) {
+        if (errorString) *errorString = "曲线正在执行，无法加载新曲线";
+        return false;
+    }
+    return m_profile.loadFromFile(path, m_model->config(), errorString);
+}
+
+/**
+ * @brief 获取当前曲线
+ * @return 负载曲线
+ */
+const LoadProfile &LoadSequencer::profile() const
+{
+    return m_profile;
+}
+
+/**
+ * @brief 预先求解全部步骤
+ * @param errorString 失败时的错误描述
+ * @return 是否全部可达
+ * @details 以模型中的当前状态为起点，每个设定点相对该行上一状态按最少切换求解，
+ *          同一时刻的设定点合并为一个步骤
+ */
+bool LoadSequencer::buildPlan(QString *errorString)
+{
+    const LoadBankConfig &config = m_model->config();
+    const int rowCount = m_model->rowCount();
+
+    QVector<LoadSolver::MinStepTable> solvers;
+    QVector<quint64> masks;
+    for (int row = 0; row < rowCount; ++row) {
+        solvers.append(LoadSolver::MinStepTable(config.row(row).stepUnits()));
+        masks.append(m_model->rowState(row)->bits());
+    }
+
+    m_plan.clear();
+    for (const ProfileSetpoint &setpoint : m_profile.setpoints()) {
+        if (setpoint.row >= rowCount) {
+            if (errorString) *errorString = QString("曲线引用了不存在的行%1").arg(setpoint.row);
+            return false;
+        }
+
+        quint64 mask = 0;
+        if (!solvers[setpoint.row].solve(LoadSolver::MinStepTable::MinimumToggles, LoadSolver::toUnits(setpoint.value),
+                                         masks[setpoint.row], &mask)) {
+            if (errorString) *errorString = QString("行%1无法组合出%2").arg(setpoint.row).arg(setpoint.value);
+            return false;
+        }
+
+        if (m_plan.isEmpty() || m_plan.last().offsetMs != setpoint.offsetMs) {
+            PlannedStep step;
+            step.offsetMs = setpoint.offsetMs;
+            m_plan.append(step);
+        }
+
+        // 同一步骤中同一行出现多次时以最后一次为准
+        QVector<RowCommit> &changes = m_plan.last().changes;
+        RowCommit *change = nullptr;
+        for (RowCommit &existing : changes) {
+            if (existing.row == setpoint.row) change = &existing;
+        }
+        if (!change) {
+            changes.append(RowCommit());
+            change = &changes.last();
+            change->row = setpoint.row;
+        }
+        change->changedMask |= mask ^ masks[setpoint.row];
+        change->mask = mask;
+        masks[setpoint.row] = mask;
+    }
+    return true;
+}
+
+/**
+ * @brief 开始执行曲线
+ * @param errorString 失败时的错误描述
+ * @return 是否开始执行
+ */
+bool LoadSequencer::start(QString *errorString)
+{
+    if (m_running) {
+        if (errorString) *errorString = "曲线已在执行";
+        return false;
+    }
+    if (m_profile.isEmpty()) {
+        if (errorString) *errorString = "尚未加载曲线";
+        return false;
+    }
+    if (!buildPlan(errorString)) {
+        qWarning() << "负载曲线预求解失败:" << (errorString ? *errorString : QString());
+        return false;
+    }
+
+    QVector<qint64> deadlinesMs;
+    for (const PlannedStep &step : m_plan) {
+        deadlinesMs.append(step.offsetMs);
+    }
+    deadlinesMs.append(qMax(m_profile.durationMs(), m_plan.last().offsetMs));   // 结束时刻
+
+    m_timings.fill(SequencerStepTiming(), m_plan.size());
+    m_running = true;
+    m_runId++;
+
+    qDebug() << "负载曲线开始执行:" << m_profile.name() << "步骤数:" << m_plan.size()
+             << "总时长:" << deadlinesMs.last() / 1000.0 << "秒";
+
+    m_runClock.start();
+    QElapsedTimer clock = m_runClock;
+    SequencerClock *sequencerClock = m_clock;
+    QMetaObject::invokeMethod(m_clock, [sequencerClock, deadlinesMs, clock]() {
+        sequencerClock->run(deadlinesMs, clock);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
+/**
+ * @brief 停止执行
+ */
+void LoadSequencer::stop()
+{
+    if (m_running) {
+        qDebug() << "请求停止负载曲线";
+        m_clock->cancel();
+    }
+}
+
+/**
+ * @brief 是否正在执行
+ * @return 是否正在执行
+ */
+bool LoadSequencer::isRunning() const
+{
+    return m_running;
+}
+
+/**
+ * @brief 获取已执行步骤的时刻记录
+ * @return 时刻记录
+ */
+const QVector<SequencerStepTiming> &LoadSequencer::timings() const
+{
+    return m_timings;
+}
+
+/**
+ * @brief 截止时刻到达的处理函数
+ * @param index 截止时刻序号（等于步骤数时为曲线结束时刻）
+ * @param wokeNs 唤醒时刻
+ */
+void LoadSequencer::onDeadlineReached(int index, qint64 wokeNs)
+{
+    if (!m_running || index >= m_plan.size()) return;
+
+    SequencerStepTiming &timing = m_timings[index];
+    timing.scheduledNs = m_plan[index].offsetMs * 1000000;
+    timing.wokeNs = wokeNs;
+
+    commitStep(index);
+
+    timing.committedNs = m_runClock.nsecsElapsed();
+    qint64 latenessNs = timing.committedNs - timing.scheduledNs;
+
+    qDebug().nospace() << "负载曲线步骤 " << index + 1 << "/" << m_plan.size()
+                       << " 计划 " << timing.scheduledNs / 1e6 << " ms"
+                       << " 唤醒 +" << (timing.wokeNs - timing.scheduledNs) / 1e3 << " us"
+                       << " 提交 +" << latenessNs / 1e3 << " us";
+
+    emit stepCommitted(index, m_plan.size(), latenessNs);
+}
+
+/**
+ * @brief 提交一个步骤
+ * @param index 步骤序号
+ * @details 有缓存读数的寄存器直接在缓存值上替换档位位，按地址连续的寄存器合并为一次功能码16写入；
+ *          尚无读数的寄存器退化为读-改-写
+ */
+void LoadSequencer::commitStep(int index)
+{
+    const PlannedStep &step = m_plan[index];
+    for (const RowCommit &change : step.changes) {
+        emit rowCommitted(change.row);
+    }
+
+    const quint64 runId = m_runId;
+    m_model->commitRows(step.changes, ModbusManager::NormalPriority, [this, runId, index](bool ok) {
+        if (!ok) {
+            qWarning() << "负载曲线步骤" << index + 1 << "写入失败";
+        }
+        if (runId == m_runId && index < m_timings.size()) {
+            m_timings[index].acknowledgedNs = m_runClock.nsecsElapsed();
+        }
+    });
+}
+
+/**
+ * @brief 定时线程运行结束的处理函数
+ * @param cancelled 是否被取消
+ */
+void LoadSequencer::onClockFinished(bool cancelled)
+{
+    if (!m_running) return;
+
+    m_running = false;
+    qDebug() << "负载曲线" << (cancelled ? "已停止" : "执行完成") << "-" << m_profile.name();
+    logTimingSummary();
+    emit finished(!cancelled);
+}
+
+/**
+ * @brief 输出时刻偏差统计
+ * @details 统计已执行步骤的唤醒偏差和提交偏差的平均值与最大值，以及写入应答延迟
+ */
+void LoadSequencer::logTimingSummary() const
+{
+    int executed = 0;
+    int acknowledged = 0;
+    double wakeSum = 0.0, commitSum = 0.0, ackSum = 0.0;
+    qint64 wakeMax = 0, commitMax = 0, ackMax = 0;
+
+    for (const SequencerStepTiming &timing : m_timings) {
+        if (timing.committedNs == 0) continue;
+        executed++;
+
+        qint64 wake = timing.wokeNs - timing.scheduledNs;
+        qint64 commit = timing.committedNs - timing.scheduledNs;
+        wakeSum += wake;
+        commitSum += commit;
+        wakeMax = qMax(wakeMax, wake);
+        commitMax = qMax(commitMax, commit);
+
+        if (timing.acknowledgedNs >= 0) {
+            qint64 ack = timing.acknowledgedNs - timing.scheduledNs;
+            acknowledged++;
+            ackSum += ack;
+            ackMax = qMax(ackMax, ack);
+        }
+    }
+
+    if (executed == 0) return;
+
+    qDebug().nospace() << "负载曲线时刻偏差统计 - 已执行 " << executed << "/" << m_timings.size() << " 步"
+                       << " 唤醒: 平均 " << wakeSum / executed / 1e3 << " us 最大 " << wakeMax / 1e3 << " us"
+                       << " 提交: 平均 " << commitSum / executed / 1e3 << " us 最大 " << commitMax / 1e3 << " us";
+    if (acknowledged > 0) {
+        qDebug().nospace() << "负载曲线写入应答 - " << acknowledged << " 步"
+                           << " 平均 " << ackSum / acknowledged / 1e6 << " ms 最大 " << ackMax / 1e6 << " ms";
+    }
+}
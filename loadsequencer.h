@@ -0,0 +1,218 @@
+/**
+ * @file loadsequencer.h
+ * @brief 负载曲线执行器定义文件
+ * @details 包含SequencerClock和LoadSequencer类的声明。SequencerClock在独立线程中按单调时钟等待各步骤的截止时刻，
+ *          LoadSequencer在启动前预先求出每个步骤的继电器组合，截止时刻到达后在主线程中把该步骤合并为一次批量写入，
+ *          并记录计划时刻与实际时刻的偏差
+ */
+
+#ifndef LOADSEQUENCER_H
+#define LOADSEQUENCER_H
+
+#include <QObject>
+#include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QVector>
+
+#include "loadbankmodel.h"
+#include "loadprofile.h"
+#include "loadsolver.h"
+
+/**
+ * @struct SequencerStepTiming
+ * @brief 单个步骤的计划与实际时刻（均相对曲线开始，纳秒）
+ */
+struct SequencerStepTiming
+{
+    qint64 scheduledNs = 0;     // 计划时刻
+    qint64 wokeNs = 0;          // 定时线程唤醒时刻
+    qint64 committedNs = 0;     // 主线程发出写请求的时刻
+    qint64 acknowledgedNs = -1; // 全部写请求得到应答的时刻，未应答为-1
+};
+
+/**
+ * @class SequencerClock
+ * @brief 负载曲线定时器（运行在独立线程中）
+ * @details 距截止时刻较远时分段休眠，最后SPIN_THRESHOLD_NS内让出CPU自旋等待，以获得亚毫秒级的唤醒精度
+ */
+class SequencerClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 SPIN_THRESHOLD_NS = 2000000;   // 最后2毫秒改为自旋等待
+    static constexpr qint64 MAX_SLEEP_MS = 50;             // 单次休眠上限，保证取消请求能及时响应
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit SequencerClock(QObject *parent = nullptr);
+
+    /**
+     * @brief 依次等待各截止时刻（阻塞，在定时线程中调用）
+     * @param deadlinesMs 各截止时刻（相对clock起点，毫秒，升序）
+     * @param clock 曲线开始时启动的单调时钟
+     */
+    void run(const QVector<qint64> &deadlinesMs, QElapsedTimer clock);
+
+    /**
+     * @brief 请求取消（可在任意线程调用）
+     */
+    void cancel();
+
+signals:
+    /**
+     * @brief 截止时刻到达
+     * @param index 截止时刻序号
+     * @param wokeNs 唤醒时刻（相对clock起点，纳秒）
+     */
+    void deadlineReached(int index, qint64 wokeNs);
+
+    /**
+     * @brief 运行结束
+     * @param cancelled 是否被取消
+     */
+    void finished(bool cancelled);
+
+private:
+    QAtomicInt m_cancelled;     // 取消标志
+};
+
+/**
+ * @class LoadSequencer
+ * @brief 负载曲线执行器
+ */
+class LoadSequencer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param model 负载柜数据模型
+     * @param parent 父对象指针
+     */
+    explicit LoadSequencer(LoadBankModel *model, QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，停止定时线程
+     */
+    ~LoadSequencer();
+
+    /**
+     * @brief 加载负载曲线
+     * @param path 曲线文件路径
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否加载成功
+     */
+    bool loadProfile(const QString &path, QString *errorString = nullptr);
+
+    /**
+     * @brief 获取当前曲线
+     * @return 负载曲线
+     */
+    const LoadProfile &profile() const;
+
+    /**
+     * @brief 开始执行曲线
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否开始执行
+     * @details 以模型中的当前状态为起点，按最少切换预先求出全部步骤的继电器组合
+     */
+    bool start(QString *errorString = nullptr);
+
+    /**
+     * @brief 停止执行，已生效的负载保持不变
+     */
+    void stop();
+
+    /**
+     * @brief 是否正在执行
+     * @return 是否正在执行
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 获取已执行步骤的时刻记录
+     * @return 时刻记录
+     */
+    const QVector<SequencerStepTiming> &timings() const;
+
+signals:
+    /**
+     * @brief 某行的状态已由曲线写入
+     * @param row 行索引
+     */
+    void rowCommitted(int row);
+
+    /**
+     * @brief 一个步骤已提交
+     * @param index 步骤序号
+     * @param stepCount 步骤总数
+     * @param latenessNs 提交时刻相对计划时刻的偏差（纳秒）
+     */
+    void stepCommitted(int index, int stepCount, qint64 latenessNs);
+
+    /**
+     * @brief 曲线执行结束
+     * @param completed 是否完整执行（被停止时为false）
+     */
+    void finished(bool completed);
+
+private slots:
+    /**
+     * @brief 截止时刻到达的处理函数
+     * @param index 截止时刻序号
+     * @param wokeNs 唤醒时刻
+     */
+    void onDeadlineReached(int index, qint64 wokeNs);
+
+    /**
+     * @brief 定时线程运行结束的处理函数
+     * @param cancelled 是否被取消
+     */
+    void onClockFinished(bool cancelled);
+
+private:
+    /**
+     * @struct PlannedStep
+     * @brief 预先求解好的步骤（同一时刻的设定点合并为一个步骤）
+     */
+    struct PlannedStep
+    {
+        qint64 offsetMs = 0;
+        QVector<RowCommit> changes;
+    };
+
+    /**
+     * @brief 预先求解全部步骤
+     * @param errorString 失败时的错误描述
+     * @return 是否全部可达
+     */
+    bool buildPlan(QString *errorString);
+
+    /**
+     * @brief 提交一个步骤：合并为按地址连续的批量写入
+     * @param index 步骤序号
+     */
+    void commitStep(int index);
+
+    /**
+     * @brief 输出时刻偏差统计
+     */
+    void logTimingSummary() const;
+
+    LoadBankModel *m_model;                     // 负载柜数据模型
+    LoadProfile m_profile;                      // 当前曲线
+    QVector<PlannedStep> m_plan;                // 预先求解的步骤
+    QThread m_thread;                           // 定时线程
+    SequencerClock *m_clock;                    // 定时器（位于定时线程）
+    QElapsedTimer m_runClock;                   // 曲线开始时启动的单调时钟
+    QVector<SequencerStepTiming> m_timings;     // 各步骤时刻记录
+    bool m_running;                             // 是否正在执行
+    quint64 m_runId;                            // 执行序号，用于丢弃上一次执行的迟到应答
+};
+
+#endif // LOADSEQUENCER_H
@@ -0,0 +1,192 @@
+/**
+ * @file loadsolver.cpp
+ * @brief 负载档位求解实现文件
+ * @details 包含LoadSolver::MinStepTable的实现
+ */
+
+#include "loadsolver.h"
+#include <limits.h>
+
+namespace LoadSolver
+{
+    constexpr quint8 MinStepTable::UNREACHABLE;
+
+    /**
+     * @brief 构造默认8档的查找表
+     * @details 直接展开编译期生成的MIN_STEP_TABLE
+     */
+    MinStepTable::MinStepTable()
+        : m_stepCount(STEP_COUNT)
+        , m_isDefault(true)
+    {
+        for (int units : STEP_UNITS) {
+            m_stepUnits.append(units);
+        }
+        m_masks.fill(0, MAX_TARGET_UNITS + 1);
+        m_counts.fill(UNREACHABLE, MAX_TARGET_UNITS + 1);
+        for (int target = 0; target <= MAX_TARGET_UNITS; ++target) {
+            int mask = MIN_STEP_TABLE[target];
+            if (mask != NO_SOLUTION) {
+                m_masks[target] = static_cast<quint64>(mask);
+                m_counts[target] = static_cast<quint8>(maskStepCount(mask));
+            }
+        }
+    }
+
+    /**
+     * @brief 构造指定档位的查找表
+     * @param stepUnits 各档位值（0.1为单位）
+     * @details 0/1背包：按档位逐个加入，目标值从大到小更新，保证每个档位至多使用一次；
+     *          位掩码随最优档位数一起传递，因此无需额外的回溯表
+     */
+    MinStepTable::MinStepTable(const QVector<int> &stepUnits)
+        : m_stepCount(qMin(stepUnits.size(), 64))
+        , m_isDefault(false)
+        , m_stepUnits(stepUnits.mid(0, qMin(stepUnits.size(), 64)))
+    {
+        if (stepUnits.size() == STEP_COUNT) {
+            bool isDefault = true;
+            for (int i = 0; i < STEP_COUNT; ++i) {
+                if (stepUnits[i] != STEP_UNITS[i]) {
+                    isDefault = false;
+                    break;
+                }
+            }
+            if (isDefault) {
+                *this = MinStepTable();
+                return;
+            }
+        }
+
+        int total = 0;
+        for (int i = 0; i < m_stepCount; ++i) {
+            total += qMax(0, stepUnits[i]);
+        }
+
+        m_masks.fill(0, total + 1);
+        m_counts.fill(UNREACHABLE, total + 1);
+        m_counts[0] = 0;
+
+        for (int i = 0; i < m_stepCount; ++i) {
+            const int weight = stepUnits[i];
+            if (weight <= 0) continue;
+
+            const quint64 stepBit = Q_UINT64_C(1) << i;
+            for (int target = total; target >= weight; --target) {
+                quint8 previous = m_counts[target - weight];
+                if (previous != UNREACHABLE && previous + 1 < m_counts[target]) {
+                    m_counts[target] = static_cast<quint8>(previous + 1);
+                    m_masks[target] = m_masks[target - weight] | stepBit;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 查找达到目标值所需的最少档位组合
+     * @param targetUnits 目标值（0.1为单位）
+     * @param mask 输出继电器位掩码
+     * @return 目标值是否可达
+     */
+    bool MinStepTable::solve(int targetUnits, quint64 *mask) const
+    {
+        if (targetUnits < 0 || targetUnits >= m_counts.size() || m_counts[targetUnits] == UNREACHABLE) {
+            return false;
+        }
+        if (mask) *mask = m_masks[targetUnits];
+        return true;
+    }
+
+    /**
+     * @brief 查找达到目标值且继电器切换次数最少的档位组合
+     * @param targetUnits 目标值（0.1为单位）
+     * @param currentMask 当前继电器位掩码
+     * @param mask 输出继电器位掩码
+     * @return 目标值是否可达
+     * @details 以 (切换次数, 档位数) 的字典序为代价。动态规划时先假定全部档位断开
+     *          （切换次数为当前闭合档位数），再让每个档位的闭合带来 ±1 次切换和 +1 个档位的代价增量
+     */
+    bool MinStepTable::solveMinToggles(int targetUnits, quint64 currentMask, quint64 *mask) const
+    {
+        if (targetUnits < 0 || targetUnits >= m_counts.size() || m_counts[targetUnits] == UNREACHABLE) {
+            return false;
+        }
+
+        if (m_isDefault) {
+            int bestMask = NO_SOLUTION;
+            int bestToggles = INT_MAX;
+            int bestSteps = INT_MAX;
+            for (int candidate = 0; candidate < (1 << STEP_COUNT); ++candidate) {
+                if (SUBSET_UNITS[candidate] != targetUnits) continue;
+                int toggles = qPopulationCount(static_cast<quint32>(candidate ^ static_cast<int>(currentMask & 0xFF)));
+                int steps = qPopulationCount(static_cast<quint32>(candidate));
+                if (toggles < bestToggles || (toggles == bestToggles && steps < bestSteps)) {
+                    bestMask = candidate;
+                    bestToggles = toggles;
+                    bestSteps = steps;
+                }
+            }
+            if (mask) *mask = static_cast<quint64>(bestMask);
+            return true;
+        }
+
+        // 代价编码为 切换次数 * (档位数 + 1) + 档位数，保证切换次数优先
+        const int weight = m_stepCount + 1;
+        QVector<int> costs(targetUnits + 1, INT_MAX);
+        QVector<quint64> masks(targetUnits + 1, 0);
+        costs[0] = 0;
+
+        for (int i = 0; i < m_stepCount; ++i) {
+            const int units = m_stepUnits[i];
+            if (units <= 0 || units > targetUnits) continue;
+
+            const quint64 stepBit = Q_UINT64_C(1) << i;
+            const int delta = ((currentMask & stepBit) ? -weight : weight) + 1;
+            for (int target = targetUnits; target >= units; --target) {
+                int previous = costs[target - units];
+                if (previous != INT_MAX && previous + delta < costs[target]) {
+                    costs[target] = previous + delta;
+                    masks[target] = masks[target - units] | stepBit;
+                }
+            }
+        }
+
+        if (costs[targetUnits] == INT_MAX) return false;
+        if (mask) *mask = masks[targetUnits];
+        return true;
+    }
+
+    /**
+     * @brief 按指定模式求解
+     * @param mode 求解模式
+     * @param targetUnits 目标值（0.1为单位）
+     * @param currentMask 当前继电器位掩码
+     * @param mask 输出继电器位掩码
+     * @return 目标值是否可达
+     */
+    bool MinStepTable::solve(Mode mode, int targetUnits, quint64 currentMask, quint64 *mask) const
+    {
+        if (mode == MinimumToggles) {
+            return solveMinToggles(targetUnits, currentMask, mask);
+        }
+        return solve(targetUnits, mask);
+    }
+
+    /**
+     * @brief 获取可达的最大目标值
+     * @return 全部档位之和（0.1为单位）
+     */
+    int MinStepTable::maxUnits() const
+    {
+        return m_counts.size() - 1;
+    }
+
+    /**
+     * @brief 获取档位数
+     * @return 档位数
+     */
+    int MinStepTable::stepCount() const
+    {
+        return m_stepCount;
+    }
+}
@@ -0,0 +1,233 @@
+/**
+ * @file loadsolver.h
+ * @brief 负载档位求解查找表定义文件
+ * @details 对固定的8档负载（0.1、0.2、0.2、0.5、1、2、2、5）在编译期枚举全部2^8种组合，
+ *          生成从目标值（0.1为单位）到最少档位继电器位掩码的查找表，运行时求解只需一次数组访问；
+ *          对配置文件定义的任意档位（最多64档），在加载时用0/1背包动态规划生成同样的查找表
+ */
+
+#ifndef LOADSOLVER_H
+#define LOADSOLVER_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <array>
+
+/**
+ * @namespace LoadSolver
+ * @brief 负载档位求解命名空间
+ */
+namespace LoadSolver
+{
+    constexpr int STEP_COUNT = 8;                                       // 每行档位数
+    constexpr std::array<int, STEP_COUNT> STEP_UNITS = {1, 2, 2, 5, 10, 20, 20, 50};  // 各档位值（0.1为单位）
+    constexpr int UNITS_PER_VALUE = 10;                                 // 1.0对应的单位数
+
+    /**
+     * @brief 计算全部档位之和
+     * @return 档位之和（0.1为单位）
+     */
+    constexpr int totalUnits()
+    {
+        int total = 0;
+        for (int units : STEP_UNITS) {
+            total += units;
+        }
+        return total;
+    }
+
+    constexpr int MAX_TARGET_UNITS = totalUnits();                     // 可达的最大目标值（0.1为单位）
+    constexpr int NO_SOLUTION = -1;                                     // 目标值不可达
+
+    /**
+     * @brief 计算位掩码对应的档位之和
+     * @param mask 继电器位掩码，第i位对应第i档
+     * @return 档位之和（0.1为单位）
+     */
+    constexpr int maskUnits(int mask)
+    {
+        int sum = 0;
+        for (int i = 0; i < STEP_COUNT; ++i) {
+            if (mask & (1 << i)) sum += STEP_UNITS[i];
+        }
+        return sum;
+    }
+
+    /**
+     * @brief 计算位掩码中置位的档位数
+     * @param mask 继电器位掩码
+     * @return 置位数
+     */
+    constexpr int maskStepCount(int mask)
+    {
+        int count = 0;
+        for (int i = 0; i < STEP_COUNT; ++i) {
+            if (mask & (1 << i)) count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief 计算档位优先级键
+     * @param mask 继电器位掩码
+     * @return 将第0档视为最高位的键值
+     * @details 档位数相同时取键值最大的组合，与原递归回溯（先选低序号档位）的结果一致
+     */
+    constexpr int maskPriority(int mask)
+    {
+        int key = 0;
+        for (int i = 0; i < STEP_COUNT; ++i) {
+            if (mask & (1 << i)) key |= 1 << (STEP_COUNT - 1 - i);
+        }
+        return key;
+    }
+
+    /**
+     * @brief 在编译期生成最少档位查找表
+     * @return 以目标值（0.1为单位）为下标的位掩码表，不可达的目标值为NO_SOLUTION
+     */
+    constexpr std::array<int, MAX_TARGET_UNITS + 1> buildMinStepTable()
+    {
+        std::array<int, MAX_TARGET_UNITS + 1> table{};
+        for (int target = 0; target <= MAX_TARGET_UNITS; ++target) {
+            table[target] = NO_SOLUTION;
+        }
+
+        for (int mask = 0; mask < (1 << STEP_COUNT); ++mask) {
+            int target = maskUnits(mask);
+            int best = table[target];
+            if (best == NO_SOLUTION
+                    || maskStepCount(mask) < maskStepCount(best)
+                    || (maskStepCount(mask) == maskStepCount(best) && maskPriority(mask) > maskPriority(best))) {
+                table[target] = mask;
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<int, MAX_TARGET_UNITS + 1> MIN_STEP_TABLE = buildMinStepTable();  // 最少档位查找表
+
+    /**
+     * @brief 在编译期生成全部组合的档位之和表
+     * @return 以位掩码为下标的档位之和表（0.1为单位）
+     */
+    constexpr std::array<int, (1 << STEP_COUNT)> buildSubsetUnitsTable()
+    {
+        std::array<int, (1 << STEP_COUNT)> table{};
+        for (int mask = 0; mask < (1 << STEP_COUNT); ++mask) {
+            table[mask] = maskUnits(mask);
+        }
+        return table;
+    }
+
+    constexpr std::array<int, (1 << STEP_COUNT)> SUBSET_UNITS = buildSubsetUnitsTable();  // 组合档位之和表
+
+    static_assert(MAX_TARGET_UNITS == 110, "档位之和应为11.0");
+    static_assert(MIN_STEP_TABLE[0] == 0, "目标0应不选任何档位");
+    static_assert(MIN_STEP_TABLE[MAX_TARGET_UNITS] == 0xFF, "目标11.0应选中全部档位");
+    static_assert(MIN_STEP_TABLE[40] == 0x60, "目标4.0应由两个2档组成");
+
+    /**
+     * @brief 将数值转换为目标单位
+     * @param value 目标值
+     * @return 四舍五入后的目标值（0.1为单位）
+     */
+    inline int toUnits(double value)
+    {
+        return qRound(value * UNITS_PER_VALUE);
+    }
+
+    /**
+     * @brief 查找达到目标值所需的最少档位组合
+     * @param targetUnits 目标值（0.1为单位）
+     * @return 继电器位掩码，不可达时返回NO_SOLUTION
+     */
+    inline int solveMinSteps(int targetUnits)
+    {
+        if (targetUnits < 0 || targetUnits > MAX_TARGET_UNITS) {
+            return NO_SOLUTION;
+        }
+        return MIN_STEP_TABLE[targetUnits];
+    }
+
+    /**
+     * @class MinStepTable
+     * @brief 任意档位配置的最少档位查找表
+     * @details 以0/1背包动态规划在 O(档位数 × 档位总和) 时间内为每个目标值求出最少档位组合，
+     *          构造完成后每次求解为一次数组访问。档位与默认8档一致时直接复用编译期查找表
+     */
+    class MinStepTable
+    {
+    public:
+        /**
+         * @brief 求解模式
+         */
+        enum Mode {
+            MinimumSteps,       // 档位数最少
+            MinimumToggles      // 相对当前状态切换的继电器最少，其次档位数最少
+        };
+
+        /**
+         * @brief 构造默认8档的查找表
+         */
+        MinStepTable();
+
+        /**
+         * @brief 构造指定档位的查找表
+         * @param stepUnits 各档位值（0.1为单位），最多64档
+         */
+        explicit MinStepTable(const QVector<int> &stepUnits);
+
+        /**
+         * @brief 查找达到目标值所需的最少档位组合
+         * @param targetUnits 目标值（0.1为单位）
+         * @param mask 输出继电器位掩码
+         * @return 目标值是否可达
+         */
+        bool solve(int targetUnits, quint64 *mask) const;
+
+        /**
+         * @brief 查找达到目标值且继电器切换次数最少的档位组合
+         * @param targetUnits 目标值（0.1为单位）
+         * @param currentMask 当前继电器位掩码
+         * @param mask 输出继电器位掩码
+         * @return 目标值是否可达
+         * @details 在所有满足目标值的组合中取与当前状态汉明距离最小者，距离相同时取档位数最少者。
+         *          默认8档直接枚举256种组合，其他配置使用 O(档位数 × 档位总和) 的动态规划
+         */
+        bool solveMinToggles(int targetUnits, quint64 currentMask, quint64 *mask) const;
+
+        /**
+         * @brief 按指定模式求解
+         * @param mode 求解模式
+         * @param targetUnits 目标值（0.1为单位）
+         * @param currentMask 当前继电器位掩码（仅MinimumToggles模式使用）
+         * @param mask 输出继电器位掩码
+         * @return 目标值是否可达
+         */
+        bool solve(Mode mode, int targetUnits, quint64 currentMask, quint64 *mask) const;
+
+        /**
+         * @brief 获取可达的最大目标值
+         * @return 全部档位之和（0.1为单位）
+         */
+        int maxUnits() const;
+
+        /**
+         * @brief 获取档位数
+         * @return 档位数
+         */
+        int stepCount() const;
+
+    private:
+        static constexpr quint8 UNREACHABLE = 0xFF;
+
+        int m_stepCount;
+        bool m_isDefault;           // 是否为默认8档
+        QVector<int> m_stepUnits;   // 各档位值（0.1为单位）
+        QVector<quint64> m_masks;   // 各目标值的最少档位位掩码
+        QVector<quint8> m_counts;   // 各目标值的最少档位数，不可达为UNREACHABLE
+    };
+}
+
+#endif // LOADSOLVER_H
@@ -1,11 +1,47 @@
 /**
  * @file main.cpp
  * @brief 应用程序入口文件
- * @details 包含应用程序的主函数，负责初始化Qt应用并显示主窗口
+ * @details 包含应用程序的主函数，负责初始化Qt应用并显示主窗口；
+ *          以 --headless <配置文件> 启动时只创建QCoreApplication和无界面服务，不创建任何窗口部件
  */
 
 #include "mainwindow.h"
+#include "headlessservice.h"
 #include <QApplication>
+#include <QCoreApplication>
+#include <QDebug>
+#include <cstring>
+
+/**
+ * @brief 以无界面模式运行
+ * @param argc 命令行参数数量
+ * @param argv 命令行参数数组
+ * @param configPath 配置文件路径，为空时使用程序目录下的headless.json
+ * @return 应用程序退出码
+ */
+static int runHeadless(int argc, char *argv[], QString configPath)
+{
+    QCoreApplication app(argc, argv);
+    if (configPath.isEmpty()) {
+        configPath = QCoreApplication::applicationDirPath() + "/headless.json";
+    }
+
+    HeadlessConfig config;
+    QString errorString;
+    if (!config.loadFromFile(configPath, &errorString)) {
+        qCritical() << "无界面模式配置无效:" << errorString;
+        return 1;
+    }
+
+    HeadlessService service;
+    QObject::connect(&service, &HeadlessService::quitRequested, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    if (!service.start(config, &errorString)) {
+        qCritical() << "无界面服务启动失败:" << errorString;
+        return 1;
+    }
+
+    return app.exec();
+}
 
 /**
  * @brief 应用程序主函数
@@ -16,15 +52,23 @@
  */
 int main(int argc, char *argv[])
 {
+    // 无界面模式必须在创建QApplication之前识别
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            QString configPath = (i + 1 < argc) ? QString::fromLocal8Bit(argv[i + 1]) : QString();
+            return runHeadless(argc, argv, configPath);
+        }
+    }
+
     // 创建Qt应用程序对象
     QApplication a(argc, argv);
-    
+
     // 创建主窗口对象
     MainWindow w;
-    
+
     // 显示主窗口
     w.show();
-    
+
     // 进入Qt事件循环，等待用户交互
     return a.exec();
 }
@@ -10,10 +10,28 @@
 #include "styles.h"
 #include "modbusmanager.h"
 #include "waveformchart.h"
+#include "voltagestatistics.h"
+#include "triggercapture.h"
+#include "powerquality.h"
+#include "loadbankmodel.h"
+#include "loadsequencer.h"
+#include "voltageregulator.h"
+#include "automationserver.h"
+#include "samplering.h"
+#include "rolluparchive.h"
+#include "energyaccounting.h"
+#include "serialportwatcher.h"
 #include <limits.h>
+#include <limits>
 #include <QDebug>
 #include <QTimer>
 #include <QListView>
+#include <QCoreApplication>
+#include <QFileDialog>
+#include <QFile>
+#include <QInputDialog>
+#include <QDateTime>
+#include <QSettings>
 
 bool MainWindow::m_serialPortOpen = false;
 
@@ -31,7 +49,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     // 设置窗口背景为对角渐变
     this->setStyleSheet(Styles::WINDOW_BACKGROUND_STYLE);
-    ui->centralwidget->setStyleSheet(Styles::CENTRAL_WIDGET_STYLE);
+    // 档位按钮样式随中央部件样式表一次性加载，之后只切换动态属性
+    ui->centralwidget->setStyleSheet(Styles::CENTRAL_WIDGET_STYLE + Styles::STEP_BUTTON_STYLE);
 
     // Modbus通信由ModbusManager管理
 
@@ -54,32 +73,124 @@ MainWindow::MainWindow(QWidget *parent)
     // 初始化串口下拉框为启用状态
     ui->comboBox_available_COM->setEnabled(true);
 
-    // 初始化第0行（第一行）
-    row0.initialize(ui->btn_0_1, ui->btn_0_2, ui->btn_0_2_2, ui->btn_0_5, ui->btn_1, ui->btn_2, ui->btn_2_2, ui->btn_5, ui->lineEditSum, this, 0, REGISTER_ADDRESS_ROW0);
-
-    // 初始化第1行
-    row1.initialize(ui->btn1_0_1, ui->btn1_0_2, ui->btn1_0_2_2, ui->btn1_0_5, ui->btn1_1, ui->btn1_2, ui->btn1_2_2, ui->btn1_5, ui->lineEditSum1, this, 1, REGISTER_ADDRESS_ROW1);
-
-    // 初始化第2行
-    row2.initialize(ui->btn2_0_1, ui->btn2_0_2, ui->btn2_0_2_2, ui->btn2_0_5, ui->btn2_1, ui->btn2_2, ui->btn2_2_2, ui->btn2_5, ui->lineEditSum2, this, 2, REGISTER_ADDRESS_ROW2);
+    // 加载负载柜档位配置：程序目录下存在loadbank.json时使用文件配置，否则使用内置的每行8档配置
+    m_loadBankConfigPath = QCoreApplication::applicationDirPath() + "/loadbank.json";
+    LoadBankConfig loadBankConfig = LoadBankConfig::applicationConfig(m_loadBankConfigPath, RELAY_ROW_COUNT);
+
+    // 负载柜数据模型：持有全部行的状态，定时刷新时一次批量读取全部行的寄存器
+    m_loadBankModel = new LoadBankModel(this);
+    m_loadBankModel->setConfig(loadBankConfig);
+    applyBusMap(loadBankConfig.bus());
+
+    // 配置文件变化时热加载寄存器映射，不重新连接总线
+    m_configReloadTimer = new QTimer(this);
+    m_configReloadTimer->setSingleShot(true);
+    m_configReloadTimer->setInterval(CONFIG_RELOAD_DELAY_MS);
+    connect(m_configReloadTimer, &QTimer::timeout, this, &MainWindow::reloadLoadBankConfig);
+    m_configWatcher = new QFileSystemWatcher(this);
+    if (QFile::exists(m_loadBankConfigPath)) {
+        m_configWatcher->addPath(m_loadBankConfigPath);
+    }
+    connect(m_configWatcher, &QFileSystemWatcher::fileChanged, m_configReloadTimer, qOverload<>(&QTimer::start));
+    // 串口意外断开时自动重连；恢复后一次批量读取全部寄存器重建状态，并重新下发断开期间未确认的操作
+    ModbusManager *modbus = ModbusManager::instance();
+    connect(modbus, &ModbusManager::connectionLost, this, [this]() {
+        ui->radioButton_checkOpen->setChecked(false);
+        ui->textBrowser->setText("串口断开，正在重连…");
+    });
+    connect(modbus, &ModbusManager::connectionRestored, this, [this]() {
+        ui->radioButton_checkOpen->setChecked(true);
+        m_voltageFilter.reset();
+        m_loadBankModel->resynchronize();
+    });
+    connect(m_loadBankModel, &LoadBankModel::resynchronized, this, [](bool ok, int reappliedRows) {
+        qDebug() << "串口恢复后重新同步" << (ok ? "完成" : "读取失败，等待下一次刷新") << "- 重新下发行数:" << reappliedRows;
+    });
+    m_loadBankModel->setUpdateFilter([this](int row, int address) {
+        const RowButtonGroup &group = m_rowGroups[row];
+        // 正在编辑的行和刚写入的寄存器保留本地状态
+        return !group.isEditing && !group.recentlyChangedRegisters.contains(address);
+    });
 
-    // 初始化第3行
-    row3.initialize(ui->btn3_0_1, ui->btn3_0_2, ui->btn3_0_2_2, ui->btn3_0_5, ui->btn3_1, ui->btn3_2, ui->btn3_2_2, ui->btn3_5, ui->lineEditSum3, this, 3, REGISTER_ADDRESS_ROW3);
+    // 按对象名初始化各行：第0行按钮为btn_0_1...，第r行为btn{r}_0_1...；卸载按钮为pushButton_2和pushButton_11-18
+    static const char *const stepButtonSuffixes[] = {"_0_1", "_0_2", "_0_2_2", "_0_5", "_1", "_2", "_2_2", "_5"};
+    static const char *const clearButtonNames[RELAY_ROW_COUNT] = {
+        "pushButton_2", "pushButton_11", "pushButton_12", "pushButton_13", "pushButton_14",
+        "pushButton_15", "pushButton_16", "pushButton_17", "pushButton_18"
+    };
+    for (int r = 0; r < RELAY_ROW_COUNT; ++r) {
+        QString buttonPrefix = r == 0 ? QString("btn") : QString("btn%1").arg(r);
+        QVector<QPushButton*> buttons;
+        for (const char *suffix : stepButtonSuffixes) {
+            QPushButton *button = findChild<QPushButton*>(buttonPrefix + suffix);
+            if (button) buttons.append(button);
+        }
+        QLineEdit *lineEdit = findChild<QLineEdit*>(r == 0 ? QString("lineEditSum") : QString("lineEditSum%1").arg(r));
+        if (!lineEdit || buttons.isEmpty()) {
+            qWarning() << "行" << r << "的界面控件缺失，跳过初始化";
+            continue;
+        }
 
-    // 初始化第4行
-    row4.initialize(ui->btn4_0_1, ui->btn4_0_2, ui->btn4_0_2_2, ui->btn4_0_5, ui->btn4_1, ui->btn4_2, ui->btn4_2_2, ui->btn4_5, ui->lineEditSum4, this, 4, REGISTER_ADDRESS_ROW4);
+        m_rowGroups[r].initialize(buttons, lineEdit, this, r, m_loadBankModel);
+        // 使用最少切换求解，减少继电器动作和总线写入
+        m_rowGroups[r].setSolverMode(LoadSolver::MinStepTable::MinimumToggles);
 
-    // 初始化第5行
-    row5.initialize(ui->btn5_0_1, ui->btn5_0_2, ui->btn5_0_2_2, ui->btn5_0_5, ui->btn5_1, ui->btn5_2, ui->btn5_2_2, ui->btn5_5, ui->lineEditSum5, this, 5, REGISTER_ADDRESS_ROW5);
+        if (QPushButton *clearButton = findChild<QPushButton*>(clearButtonNames[r])) {
+            connect(clearButton, &QPushButton::clicked, this, [this, r]() { clearRow(r); });
+        }
+    }
 
-    // 初始化第6行
-    row6.initialize(ui->btn6_0_1, ui->btn6_0_2, ui->btn6_0_2_2, ui->btn6_0_5, ui->btn6_1, ui->btn6_2, ui->btn6_2_2, ui->btn6_5, ui->lineEditSum6, this, 6, REGISTER_ADDRESS_ROW6);
+    // 负载曲线执行器：按钮选择曲线文件并执行，执行中再次点击则停止
+    m_loadSequencer = new LoadSequencer(m_loadBankModel, this);
+    ui->btnLoadProfile->setStyleSheet(Styles::SERIAL_BUTTON_STYLE);
+    connect(ui->btnLoadProfile, &QPushButton::clicked, this, &MainWindow::toggleLoadProfile);
+    connect(m_loadSequencer, &LoadSequencer::rowCommitted, this, &MainWindow::holdRowRegisters);
+    connect(m_loadSequencer, &LoadSequencer::stepCommitted, this, [this](int index, int stepCount, qint64 latenessNs) {
+        ui->labelProfileStatus->setText(QString("%1\n步骤 %2/%3，提交偏差 %4 ms")
+                                        .arg(m_loadSequencer->profile().name())
+                                        .arg(index + 1).arg(stepCount)
+                                        .arg(latenessNs / 1e6, 0, 'f', 3));
+    });
+    connect(m_loadSequencer, &LoadSequencer::finished, this, [this](bool completed) {
+        ui->btnLoadProfile->setText("运行负载曲线");
+        ui->labelProfileStatus->setText(QString("%1\n%2").arg(m_loadSequencer->profile().name(),
+                                                               completed ? "执行完成" : "已停止"));
+    });
 
-    // 初始化第7行
-    row7.initialize(ui->btn7_0_1, ui->btn7_0_2, ui->btn7_0_2_2, ui->btn7_0_5, ui->btn7_1, ui->btn7_2, ui->btn7_2_2, ui->btn7_5, ui->lineEditSum7, this, 7, REGISTER_ADDRESS_ROW7);
+    // 闭环稳压调节器：测量和输出使用总线的控制优先级
+    m_voltageRegulator = new VoltageRegulator(m_loadBankModel, this);
+    ui->btnRegulator->setStyleSheet(Styles::SERIAL_BUTTON_STYLE);
+    connect(ui->btnRegulator, &QPushButton::clicked, this, &MainWindow::toggleRegulator);
+    connect(m_voltageRegulator, &VoltageRegulator::rowCommitted, this, &MainWindow::holdRowRegisters);
+    connect(m_voltageRegulator, &VoltageRegulator::cycleCompleted, this, [this](double voltage, double outputValue) {
+        const RegulatorStatistics stats = m_voltageRegulator->statistics();
+        QString settling = stats.settlingTimeMs < 0 ? QString("调节中") : QString("调节时间 %1 s").arg(stats.settlingTimeMs / 1000.0, 0, 'f', 1);
+        ui->labelRegulatorStatus->setText(QString("设定 %1 V，实测 %2 V，负载 %3\n%4，周期抖动 %5 ms")
+                                          .arg(m_voltageRegulator->config().setpoint, 0, 'f', 1)
+                                          .arg(voltage, 0, 'f', 1)
+                                          .arg(outputValue, 0, 'f', 1)
+                                          .arg(settling)
+                                          .arg(stats.periodJitterStdDevMs, 0, 'f', 2));
+    });
+    connect(m_voltageRegulator, &VoltageRegulator::stopped, this, [this]() {
+        const RegulatorStatistics stats = m_voltageRegulator->statistics();
+        ui->btnRegulator->setText("闭环稳压");
+        ui->labelRegulatorStatus->setText(QString("闭环稳压已停止\n周期 %1，超限 %2，继电器动作 %3")
+                                          .arg(stats.cycles).arg(stats.overruns).arg(stats.relayOperations));
+    });
 
-    // 初始化第8行（第九行）
-    row8.initialize(ui->btn8_0_1, ui->btn8_0_2, ui->btn8_0_2_2, ui->btn8_0_5, ui->btn8_1, ui->btn8_2, ui->btn8_2_2, ui->btn8_5, ui->lineEditSum8, this, 8, REGISTER_ADDRESS_ROW8);
+    // 整柜预设：保存在程序目录下的presets.json，调用时全部行一次性切换
+    QString presetError;
+    if (!m_presets.loadFromFile(QCoreApplication::applicationDirPath() + "/presets.json", &presetError)) {
+        qWarning() << "预设文件无法加载:" << presetError;
+        ui->labelPresetStatus->setText(QString("预设文件无法加载：%1").arg(presetError));
+    }
+    ui->comboPresets->setStyleSheet(Styles::COMBO_BOX_STYLE);
+    ui->btnSavePreset->setStyleSheet(Styles::SERIAL_BUTTON_STYLE);
+    ui->btnRecallPreset->setStyleSheet(Styles::SERIAL_BUTTON_STYLE);
+    connect(ui->btnSavePreset, &QPushButton::clicked, this, &MainWindow::savePreset);
+    connect(ui->btnRecallPreset, &QPushButton::clicked, this, &MainWindow::recallPreset);
+    refreshPresetCombo();
 
     // 为所有"载入"和"卸载"按钮应用样式
     QList<QPushButton*> pushButtons = this->findChildren<QPushButton*>();
@@ -114,17 +225,49 @@ MainWindow::MainWindow(QWidget *parent)
     view->setStyleSheet(Styles::COMBO_BOX_STYLE);
     ui->comboBox_available_COM->setView(view);
     
-    // 连接卸载按钮点击事件
-    connect(ui->pushButton_2, &QPushButton::clicked, this, [this]() { clearRow(0); });
-    connect(ui->pushButton_11, &QPushButton::clicked, this, [this]() { clearRow(1); });
-    connect(ui->pushButton_12, &QPushButton::clicked, this, [this]() { clearRow(2); });
-    connect(ui->pushButton_13, &QPushButton::clicked, this, [this]() { clearRow(3); });
-    connect(ui->pushButton_14, &QPushButton::clicked, this, [this]() { clearRow(4); });
-    connect(ui->pushButton_15, &QPushButton::clicked, this, [this]() { clearRow(5); });
-    connect(ui->pushButton_16, &QPushButton::clicked, this, [this]() { clearRow(6); });
-    connect(ui->pushButton_17, &QPushButton::clicked, this, [this]() { clearRow(7); });
-    connect(ui->pushButton_18, &QPushButton::clicked, this, [this]() { clearRow(8); });
-
+    // 串口在后台线程枚举，热插拔时增量更新下拉框；上次使用的适配器按USB串行号自动选中
+    QSettings settings(QCoreApplication::applicationDirPath() + "/loadbank.ini", QSettings::IniFormat);
+    m_preferredSerialNumber = settings.value("serial/serialNumber").toString();
+    m_preferredPortName = settings.value("serial/portName").toString();
+    
+    // 电压滤波链（loadbank.ini中filter/voltage，格式见signalfilter.h）：
+    // 波形图和数值显示使用滤波值，统计、触发、事件检测、电能和归档使用原始值
+    QString filterError;
+    if (!m_voltageFilter.setSpec(settings.value("filter/voltage", FilterPipeline::DEFAULT_VOLTAGE_SPEC).toString(), &filterError)) {
+        qWarning() << "电压滤波配置无效，使用默认滤波:" << filterError;
+        m_voltageFilter.setSpec(FilterPipeline::DEFAULT_VOLTAGE_SPEC);
+    }
+    qDebug() << "电压滤波:" << m_voltageFilter.spec();
+    
+    // 整柜分配：输入时预览，回车或点击按钮后下发；三相容差取loadbank.ini中distribution/phaseTolerance（负值为不要求平衡）
+    m_distributor = new BankDistributor(this);
+    m_distributionCommitGeneration = 0;
+    const double tolerance = settings.value("distribution/phaseTolerance",
+            static_cast<double>(BankDistributor::DEFAULT_PHASE_TOLERANCE_UNITS) / LoadSolver::UNITS_PER_VALUE).toDouble();
+    m_distributionToleranceUnits = tolerance < 0.0 ? -1 : LoadSolver::toUnits(tolerance);
+    ui->btnDistribute->setStyleSheet(Styles::SERIAL_BUTTON_STYLE);
+    connect(ui->lineEditBankTotal, &QLineEdit::textEdited, this, [this]() { requestDistribution(false); });
+    connect(ui->lineEditBankTotal, &QLineEdit::returnPressed, this, [this]() { requestDistribution(true); });
+    connect(ui->btnDistribute, &QPushButton::clicked, this, [this]() { requestDistribution(true); });
+    connect(m_distributor, &BankDistributor::solved, this, [this](const BankSolveResult &result) {
+        ui->labelDistributeStatus->setText(result.description());
+        if (!result.ok || result.generation != m_distributionCommitGeneration) return;
+        
+        m_distributionCommitGeneration = 0;
+        if (m_loadSequencer->isRunning() || m_voltageRegulator->isRunning()) {
+            ui->labelDistributeStatus->setText("负载曲线或闭环稳压运行中，请先停止");
+            return;
+        }
+        const QVector<RowCommit> commits = result.commits(m_loadBankModel);
+        for (const RowCommit &commit : commits) {
+            holdRowRegisters(commit.row);
+        }
+        m_loadBankModel->commitRows(commits, ModbusManager::ControlPriority);
+    });
+    m_portWatcher = new SerialPortWatcher(this);
+    connect(m_portWatcher, &SerialPortWatcher::portAdded, this, &MainWindow::onSerialPortAdded);
+    connect(m_portWatcher, &SerialPortWatcher::portRemoved, this, &MainWindow::onSerialPortRemoved);
+    
     // 连接textBrowser文本变化事件
     connect(ui->textBrowser, &QTextBrowser::textChanged, this, &MainWindow::on_textBrowser_textChanged);
 
@@ -139,6 +282,88 @@ MainWindow::MainWindow(QWidget *parent)
     m_waveformChart = new WaveformChart(this);
     m_waveformChart->initVoltageWaveform(ui->chartContainer, ui->voltageWaveformPage);
     
+    // 初始化电压流式统计（10秒、1分钟、15分钟窗口），结果显示在波形图右侧
+    m_voltageStatistics = new VoltageStatistics(this);
+    m_sampleClock.start();
+    connect(m_voltageStatistics, &VoltageStatistics::statisticsUpdated, this, [this]() {
+        ui->labelVoltageStats->setText(m_voltageStatistics->formatSummaries());
+        ui->labelVoltageStats->setToolTip(m_energyAccounting->formatSummary());
+    });
+    
+    // 电压样本同时发布到共享内存环形缓冲区，供本地分析进程直接映射读取
+    m_sampleRing = new SampleRingWriter;
+    m_sampleRing->create(SampleRingLayout::DEFAULT_KEY, SampleRingWriter::DEFAULT_CAPACITY,
+                         QDateTime::currentMSecsSinceEpoch() - m_sampleClock.elapsed());
+    
+    // 电压与各行负载写入程序目录下archive/中的多分辨率汇总归档（通道voltage、row0-row8），保存数月历史
+    m_archive = new RollupArchive;
+    m_archiveVoltageChannel = -1;
+    if (m_archive->open(QCoreApplication::applicationDirPath() + "/archive")) {
+        m_archiveVoltageChannel = m_archive->channel("voltage");
+        for (int row = 0; row < RELAY_ROW_COUNT; ++row) {
+            m_archiveRowChannels.append(m_archive->channel(QString("row%1").arg(row)));
+        }
+    }
+    
+    // 各行电能与继电器动作统计，计数每分钟保存到程序目录下的energy.json
+    m_energyAccounting = new EnergyAccounting(m_loadBankModel, m_sampleClock, this);
+    m_energyAccounting->setCheckpointPath(QCoreApplication::applicationDirPath() + "/energy.json");
+    
+    // 初始化触发捕获（默认：离开额定电压±10%窗口时触发），捕获的快照可在下拉框中选择查看
+    m_triggerCapture = new TriggerCapture(this);
+    m_triggerCapture->arm();
+    ui->comboCaptures->setStyleSheet(Styles::COMBO_BOX_STYLE);
+    connect(m_triggerCapture, &TriggerCapture::eventCaptured, this, [this](const CapturedEvent &event) {
+        ui->comboCaptures->addItem(event.description(), event.id);
+        // 快照数量超过上限时最旧的快照已被丢弃，同步移除下拉项（第0项为实时波形）
+        while (ui->comboCaptures->count() - 1 > m_triggerCapture->capturedEvents().size()) {
+            ui->comboCaptures->removeItem(1);
+        }
+    });
+    connect(ui->comboCaptures, qOverload<int>(&QComboBox::currentIndexChanged), this, [this](int index) {
+        if (index <= 0) {
+            m_waveformChart->showLiveWaveform();
+            return;
+        }
+        int eventId = ui->comboCaptures->itemData(index).toInt();
+        for (const CapturedEvent &event : m_triggerCapture->capturedEvents()) {
+            if (event.id == eventId) {
+                m_waveformChart->showSnapshot(event.points, event.description());
+                return;
+            }
+        }
+    });
+    
+    // 电能质量事件检测（暂降、暂升、中断），事件范围内的样本在实时波形上以红点标记。
+    // 检测器与波形图逐样本同步输入，检测器样本序号与波形图序号只差一个固定偏移
+    m_powerQuality = new PowerQualityDetector(this);
+    auto chartSequence = [this](quint64 sample) {
+        return m_waveformChart->nextSequence() - (m_powerQuality->sampleCount() - sample);
+    };
+    connect(m_powerQuality, &PowerQualityDetector::eventStarted, this, [this, chartSequence](const PowerQualityEvent &event) {
+        m_waveformChart->setEventMarker(event.id, chartSequence(event.firstSample), std::numeric_limits<quint64>::max());
+    });
+    connect(m_powerQuality, &PowerQualityDetector::eventFinished, this, [this, chartSequence](const PowerQualityEvent &event) {
+        m_waveformChart->setEventMarker(event.id, chartSequence(event.firstSample), chartSequence(event.lastSample));
+    });
+    
+    // 本地自动化接口：与界面共用同一份电压采集，负载曲线或闭环稳压运行时拒绝外部写入
+    m_automationServer = new AutomationServer(m_loadBankModel, m_voltageStatistics, this);
+    m_automationServer->setWriteGuard([this]() {
+        if (m_loadSequencer->isRunning()) return QString("load profile is running");
+        if (m_voltageRegulator->isRunning()) return QString("regulator is running");
+        return QString();
+    });
+    connect(m_automationServer, &AutomationServer::rowCommitted, this, &MainWindow::holdRowRegisters);
+    m_automationServer->listen();
+    
+    // 主界面和波形图为堆叠窗口的两页；监视两页的绘制事件以测量切换延迟
+    m_pageSwitchTarget = nullptr;
+    ui->mainPage->installEventFilter(this);
+    ui->voltageWaveformPage->installEventFilter(this);
+    ui->pageStack->setCurrentWidget(ui->mainPage);
+    m_waveformChart->stopWaveformUpdate();
+    
     // 连接波形图按钮点击事件
     connect(ui->btnVoltageWaveform, &QPushButton::clicked, this, &MainWindow::switchToWaveformPage);
     connect(ui->btnBackToMain, &QPushButton::clicked, this, &MainWindow::switchToMainPage);
@@ -150,7 +375,7 @@ MainWindow::MainWindow(QWidget *parent)
 /**
  * @brief 处理窗口大小变化事件
  * @param event 大小变化事件
- * @details 当窗口大小变化时，调整topBar和blurTransition的宽度以适应窗口宽度
+ * @details 当窗口大小变化时，调整topBar、页面堆叠窗口和blurTransition的宽度以适应窗口宽度
  */
 void MainWindow::resizeEvent(QResizeEvent *event)
 {
@@ -160,6 +385,9 @@ void MainWindow::resizeEvent(QResizeEvent *event)
     int newWidth = this->width();
     ui->topBar->setGeometry(0, 0, newWidth, ui->topBar->height());
     
+    // 页面堆叠窗口随窗口加宽，高度不小于设计高度
+    ui->pageStack->setGeometry(0, 0, newWidth, qMax(ui->pageStack->height(), ui->centralwidget->height()));
+    
     // 调整blurTransition宽度以适应窗口宽度
     ui->blurTransition->setGeometry(0, ui->blurTransition->y(), newWidth, ui->blurTransition->height());
 }
@@ -229,94 +457,212 @@ void MainWindow::refreshAllRows()
         return;
     }
     
-    refreshRow(0);
+    m_loadBankModel->refresh();
 }
 
 /**
- * @brief 刷新指定行的状态
+ * @brief 清除指定行的按钮状态和文本框内容
  * @param rowIndex 行索引（0-8）
  */
-void MainWindow::refreshRow(int rowIndex)
+void MainWindow::clearRow(int rowIndex)
 {
-    if (rowIndex != 0) return;
+    if (rowIndex < 0 || rowIndex >= RELAY_ROW_COUNT) return;
     
-    RowButtonGroup *row = &row0;
+    RowButtonGroup *row = &m_rowGroups[rowIndex];
+    if (!row->lineEdit) return;
     
-    if (row->isEditing) {
-        qDebug() << "行" << rowIndex << "正在编辑中，跳过自动更新";
-        return;
+    // 清除所有档位，模型通知行按钮组更新按钮样式和文本框
+    m_loadBankModel->setRowState(rowIndex, RelayState());
+    
+    // 将寄存器加入状态变更缓冲区
+    for (int registerAddress : row->registerAddresses) {
+        row->recentlyChangedRegisters.insert(registerAddress);
     }
     
-    // 读取寄存器（包含8个按钮的高8位状态）
-    ModbusManager::instance()->readRegister(row->registerAddress, [row](int value) {
-        if (value != -1) {
-            int registerAddress = row->registerAddress;
-            
-            if (row->isEditing) {
-                qDebug() << "行正在编辑中，跳过寄存器" << registerAddress << "的更新";
-                return;
-            }
-            
-            if (row->recentlyChangedRegisters.contains(registerAddress)) {
-                qDebug() << "寄存器" << registerAddress << "在缓冲区中，保留本地状态";
-            } else {
-                // 从寄存器的高8位提取8个按钮的状态
-                row->m_isUpdating = true;
-                for (int i = 0; i < 8; ++i) {
-                    int bitPosition = 8 + i;  // 按钮0对应第8位，按钮7对应第15位
-                    row->states[i] = (value >> bitPosition) & 0x0001;
-                }
-                row->applyButtonStatesToUI();
-                row->updateSumDisplay();
-                row->m_isUpdating = false;
-                qDebug() << "寄存器" << registerAddress << "不在缓冲区中，使用Modbus值:" << value;
-            }
-        }
+    // 读取寄存器，将档位位置0，其余位保持不变
+    row->writeStatesToRegisters(nullptr);
+    
+    // 延迟清理缓冲区（2秒后），避免长时间影响后续读取
+    QTimer::singleShot(2000, row, [row]() {
+        row->recentlyChangedRegisters.clear();
     });
 }
 
+
 /**
- * @brief 清除指定行的按钮状态和文本框内容
- * @param rowIndex 行索引（0-8）
+ * @brief 运行或停止负载曲线
+ * @details 未执行时选择曲线文件并开始执行；执行中则停止，已生效的负载保持不变
  */
-void MainWindow::clearRow(int rowIndex)
+void MainWindow::toggleLoadProfile()
 {
-    // 只处理第一行（行0）
-    if (rowIndex != 0) return;
+    if (m_loadSequencer->isRunning()) {
+        m_loadSequencer->stop();
+        return;
+    }
+    if (m_voltageRegulator->isRunning()) {
+        ui->labelProfileStatus->setText("闭环稳压运行中，请先停止闭环稳压");
+        return;
+    }
+    
     
-    // 获取第一行的RowButtonGroup实例
-    RowButtonGroup *row = &row0;
+    QString path = QFileDialog::getOpenFileName(this, "选择负载曲线", QCoreApplication::applicationDirPath(),
+                                                "负载曲线 (*.json)");
+    if (path.isEmpty()) return;
     
-    // 清除所有按钮选中状态
-    for (int i = 0; i < 8; ++i) {
-        row->states[i] = false;
+    QString errorString;
+    if (!m_loadSequencer->loadProfile(path, &errorString) || !m_loadSequencer->start(&errorString)) {
+        ui->labelProfileStatus->setText(QString("负载曲线无法执行：%1").arg(errorString));
+        return;
     }
     
-    // 更新按钮UI样式为未选中状态
-    row->applyButtonStatesToUI();
+    ui->btnLoadProfile->setText("停止负载曲线");
+    ui->labelProfileStatus->setText(QString("%1\n开始执行").arg(m_loadSequencer->profile().name()));
+}
+
+/**
+ * @brief 启动或停止闭环稳压
+ * @details 未运行时输入目标电压后启动；运行中则停止，已投入的负载保持不变
+ */
+void MainWindow::toggleRegulator()
+{
+    if (m_voltageRegulator->isRunning()) {
+        m_voltageRegulator->stop();
+        return;
+    }
+    if (m_loadSequencer->isRunning()) {
+        ui->labelRegulatorStatus->setText("负载曲线执行中，请先停止负载曲线");
+        return;
+    }
     
-    // 清空文本框内容，重置为初始值0.0
-    row->lineEdit->setText("0.0");
+    bool ok = false;
+    double setpoint = QInputDialog::getDouble(this, "闭环稳压", "目标电压 (V):",
+                                              m_voltageRegulator->config().setpoint, 0.0, 1000.0, 1, &ok);
+    if (!ok) return;
     
-    // 将寄存器加入状态变更缓冲区
-    row->recentlyChangedRegisters.insert(row->registerAddress);
+    RegulatorConfig config = m_voltageRegulator->config();
+    config.setpoint = setpoint;
+    m_voltageRegulator->setConfig(config);
     
-    // 读取寄存器的低8位（保持不变），将高8位置0
-    ModbusManager::instance()->readRegister(row->registerAddress, [row](int lowValue) {
-        if (lowValue != -1) {
-            // 保留低8位，高8位置0
-            int newValue = (lowValue & 0x00FF) | 0x0000;
-            
-            ModbusManager::instance()->writeRegister(row->registerAddress, newValue);
+    QString errorString;
+    if (!m_voltageRegulator->start(&errorString)) {
+        ui->labelRegulatorStatus->setText(QString("闭环稳压无法启动：%1").arg(errorString));
+        return;
+    }
+    
+    ui->btnRegulator->setText("停止稳压");
+    ui->labelRegulatorStatus->setText(QString("闭环稳压启动，设定 %1 V").arg(setpoint, 0, 'f', 1));
+}
+
+/**
+ * @brief 把当前整柜状态保存为预设
+ */
+void MainWindow::savePreset()
+{
+    BankPreset preset;
+    QString errorString;
+    if (!m_loadBankModel->captureSnapshot(&preset.snapshot, &errorString)) {
+        ui->labelPresetStatus->setText(QString("无法保存预设：%1").arg(errorString));
+        return;
+    }
+    
+    bool ok = false;
+    preset.name = QInputDialog::getText(this, "保存预设", "预设名称:", QLineEdit::Normal,
+                                        ui->comboPresets->currentText(), &ok).trimmed();
+    if (!ok || preset.name.isEmpty()) return;
+    
+    m_presets.insert(preset);
+    if (!m_presets.save(&errorString)) {
+        ui->labelPresetStatus->setText(QString("预设文件写入失败：%1").arg(errorString));
+        return;
+    }
+    refreshPresetCombo(preset.name);
+    ui->labelPresetStatus->setText(QString("已保存预设 %1").arg(preset.name));
+}
+
+/**
+ * @brief 把整柜切换到下拉框中选择的预设
+ * @details 与负载曲线、闭环稳压互斥；写入的行短时间保留本地状态，避免刷新读到切换前的旧值
+ */
+void MainWindow::recallPreset()
+{
+    if (m_loadSequencer->isRunning() || m_voltageRegulator->isRunning()) {
+        ui->labelPresetStatus->setText("负载曲线或闭环稳压运行中，请先停止");
+        return;
+    }
+    
+    BankPreset preset;
+    if (!m_presets.find(ui->comboPresets->currentText(), &preset)) {
+        ui->labelPresetStatus->setText("请先选择预设");
+        return;
+    }
+    
+    for (int row = 0; row < m_loadBankModel->rowCount(); ++row) {
+        if (m_loadBankModel->rowState(row)->bits() != preset.snapshot.rowBits.value(row)) {
+            holdRowRegisters(row);
         }
-    });
+    }
+    const QString name = preset.name;
+    QString errorString;
+    if (!m_loadBankModel->commitSnapshot(preset.snapshot, ModbusManager::ControlPriority, [this, name](bool ok) {
+            ui->labelPresetStatus->setText(ok ? QString("已切换到预设 %1").arg(name)
+                                              : QString("预设 %1 写入失败，总线恢复后重新下发").arg(name));
+        }, &errorString)) {
+        ui->labelPresetStatus->setText(QString("预设 %1 不适用于当前配置：%2").arg(name, errorString));
+    }
+}
+
+/**
+ * @brief 按预设集合重建预设下拉框
+ * @param current 重建后选中的预设名称
+ */
+void MainWindow::refreshPresetCombo(const QString &current)
+{
+    ui->comboPresets->clear();
+    ui->comboPresets->addItems(m_presets.names());
+    const int index = ui->comboPresets->findText(current);
+    if (index >= 0) {
+        ui->comboPresets->setCurrentIndex(index);
+    }
+    ui->btnRecallPreset->setEnabled(ui->comboPresets->count() > 0);
+}
+
+/**
+ * @brief 提交整柜分配求解
+ * @param commit 求解完成后是否下发
+ */
+void MainWindow::requestDistribution(bool commit)
+{
+    bool ok = false;
+    const double value = ui->lineEditBankTotal->text().toDouble(&ok);
+    if (!ok || value < 0.0) {
+        m_distributor->cancel();
+        m_distributionCommitGeneration = 0;
+        ui->labelDistributeStatus->setText("请输入整柜目标负载");
+        return;
+    }
     
-    // 延迟清理缓冲区（2秒后），避免长时间影响后续读取
-    QTimer::singleShot(2000, row, [row]() {
-        row->recentlyChangedRegisters.clear();
-    });
+    const BankSolveRequest request = BankSolver::requestFromModel(m_loadBankModel, LoadSolver::toUnits(value),
+                                                                  "KW", m_distributionToleranceUnits);
+    const quint64 generation = m_distributor->submit(request);
+    m_distributionCommitGeneration = commit ? generation : 0;
 }
 
+/**
+ * @brief 短时间保留某行寄存器的本地状态
+ * @param rowIndex 行索引
+ */
+void MainWindow::holdRowRegisters(int rowIndex)
+{
+    if (rowIndex < 0 || rowIndex >= RELAY_ROW_COUNT) return;
+    
+    RowButtonGroup *group = &m_rowGroups[rowIndex];
+    for (int address : group->registerAddresses) {
+        group->recentlyChangedRegisters.insert(address);
+    }
+    QTimer::singleShot(2000, group, [group]() {
+        group->recentlyChangedRegisters.clear();
+    });
+}
 
 /**
  * @brief MainWindow类析构函数
@@ -324,6 +670,8 @@ void MainWindow::clearRow(int rowIndex)
  */
 MainWindow::~MainWindow()
 {
+    delete m_sampleRing;
+    delete m_archive;
     delete ui;
 }
 
@@ -331,23 +679,72 @@ MainWindow::~MainWindow()
 
 /**
  * @brief 刷新串口按钮点击事件处理函数
- * @details 扫描系统中所有可用的串口，并将其添加到下拉框中
+ * @details 请求后台重新扫描串口，结果以增量事件更新下拉框，不阻塞界面
  */
 void MainWindow::on_key_Refresh_COM_clicked()
 {
-    // 清空下拉框
-    ui->comboBox_available_COM->clear();
+    m_portWatcher->rescan();
     
-    // 获取所有可用的串口信息
-    QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
+    // 输出调试信息
+    qDebug() << "刷新串口 - 已请求后台扫描";
+}
+
+/**
+ * @brief 发现新串口的处理函数
+ * @param entry 串口信息
+ * @details 下拉框按端口名称排序插入，项数据保存串行号；串口未打开时自动选中上次使用的适配器：
+ *          有串行号时按串行号匹配（换USB口后端口名称会变），否则按端口名称匹配
+ */
+void MainWindow::onSerialPortAdded(const SerialPortEntry &entry)
+{
+    QComboBox *combo = ui->comboBox_available_COM;
+    int index = combo->findText(entry.portName);
+    if (index < 0) {
+        index = 0;
+        while (index < combo->count() && combo->itemText(index) < entry.portName) {
+            ++index;
+        }
+        combo->insertItem(index, entry.portName, entry.serialNumber);
+    } else {
+        combo->setItemData(index, entry.serialNumber);
+    }
+    combo->setItemData(index, entry.toolTip(), Qt::ToolTipRole);
+    
+    // 断开重连期间上次使用的适配器重新出现（端口名称可能已变化）时立即重连，不等退避
+    ModbusManager *modbus = ModbusManager::instance();
+    if (MainWindow::m_serialPortOpen && modbus->isReconnecting()
+            && !m_preferredSerialNumber.isEmpty() && entry.serialNumber == m_preferredSerialNumber) {
+        combo->setCurrentIndex(index);
+        modbus->reconnectNow(entry.portName);
+    }
     
-    // 将串口名称添加到下拉框
-    foreach (const QSerialPortInfo &portInfo, ports) {
-        ui->comboBox_available_COM->addItem(portInfo.portName());
+    if (!MainWindow::m_serialPortOpen) {
+        const bool preferred = !m_preferredSerialNumber.isEmpty()
+            ? entry.serialNumber == m_preferredSerialNumber
+            : !m_preferredPortName.isEmpty() && entry.portName == m_preferredPortName;
+        if (preferred) {
+            combo->setCurrentIndex(index);
+            qDebug() << "自动选中上次使用的串口:" << entry.portName << entry.toolTip();
+        }
     }
+}
+
+/**
+ * @brief 串口被移除的处理函数
+ * @param portName 端口名称
+ * @details 已打开的串口被拔出时保留下拉项，关闭串口后再移除
+ */
+void MainWindow::onSerialPortRemoved(const QString &portName)
+{
+    QComboBox *combo = ui->comboBox_available_COM;
+    const int index = combo->findText(portName);
+    if (index < 0) return;
     
-    // 输出调试信息
-    qDebug() << "刷新串口 - 找到" << ports.size() << "个可用串口";
+    if (MainWindow::m_serialPortOpen && index == combo->currentIndex()) {
+        qWarning() << "已打开的串口被移除:" << portName;
+        return;
+    }
+    combo->removeItem(index);
 }
 
 /**
@@ -371,8 +768,12 @@ void MainWindow::on_key_OpenOrClose_COM_clicked()
         // 更新radioButton状态
         ui->radioButton_checkOpen->setChecked(false);
         
-        // 启用串口下拉框选择
+        // 启用串口下拉框选择，打开期间被拔出的串口此时移除
         ui->comboBox_available_COM->setEnabled(true);
+        const QString closedPort = ui->comboBox_available_COM->currentText();
+        if (!closedPort.isEmpty() && !m_portWatcher->ports().contains(closedPort)) {
+            ui->comboBox_available_COM->removeItem(ui->comboBox_available_COM->currentIndex());
+        }
         
         // 更新按钮文字
         ui->key_OpenOrClose_COM->setText("启动串口");
@@ -401,6 +802,13 @@ void MainWindow::on_key_OpenOrClose_COM_clicked()
             // 禁用串口下拉框选择
             ui->comboBox_available_COM->setEnabled(false);
             
+            // 记住本次使用的适配器，下次启动或重新插入时自动选中
+            m_preferredSerialNumber = ui->comboBox_available_COM->currentData().toString();
+            m_preferredPortName = portName;
+            QSettings settings(QCoreApplication::applicationDirPath() + "/loadbank.ini", QSettings::IniFormat);
+            settings.setValue("serial/serialNumber", m_preferredSerialNumber);
+            settings.setValue("serial/portName", m_preferredPortName);
+            
             // 更新按钮文字
             ui->key_OpenOrClose_COM->setText("关闭串口");
             
@@ -418,17 +826,54 @@ void MainWindow::readSlave3Register7()
 {
     ModbusManager::instance()->readSlave3Register7([this](int value) {
         if (value != -1) {
-            double voltage = value * 0.1;
+            double voltage = value * ModbusManager::instance()->busMap().voltageScale;
+            const double filteredVoltage = m_voltageFilter.process(voltage);
             
-            QString displayStr = QString("电压: %1 V").arg(voltage, 0, 'f', 1);
+            QString displayStr = QString("电压: %1 V").arg(filteredVoltage, 0, 'f', 1);
             ui->textBrowser->setText(displayStr);
             
-            // 更新波形图数据
-            m_waveformChart->updateWaveformData(voltage);
+            // 更新波形图数据（曲线为滤波值，自适应Y轴不随量化噪声跳动；
+            // 电能质量检测使用原始值，事件标记也画在原始值处，否则被中值滤波抹平的单样本暂降会标在230 V附近）
+            m_waveformChart->updateWaveformData(filteredVoltage, voltage);
+            
+            // 更新流式统计与触发捕获
+            qint64 timestampMs = m_sampleClock.elapsed();
+            m_voltageStatistics->addSample(voltage, timestampMs);
+            m_triggerCapture->addSample(voltage, timestampMs);
+            m_powerQuality->addSample(voltage, timestampMs);
+            m_sampleRing->publish(voltage, timestampMs);
+            m_automationServer->publishVoltage(voltage, timestampMs);
+            m_energyAccounting->addVoltageSample(voltage, timestampMs);
+            
+            // 汇总归档按UTC时间对齐
+            const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+            m_archive->addSample(m_archiveVoltageChannel, voltage, nowMs);
+            for (int row = 0; row < m_archiveRowChannels.size() && row < m_loadBankModel->rowCount(); ++row) {
+                m_archive->addSample(m_archiveRowChannels[row],
+                                     static_cast<double>(m_loadBankModel->rowUnits(row)) / LoadSolver::UNITS_PER_VALUE, nowMs);
+            }
         }
     });
 }
 
+/**
+ * @brief 获取电压流式统计引擎
+ * @return 统计引擎指针
+ */
+VoltageStatistics *MainWindow::voltageStatistics() const
+{
+    return m_voltageStatistics;
+}
+
+/**
+ * @brief 获取电压触发捕获引擎
+ * @return 触发捕获引擎指针
+ */
+TriggerCapture *MainWindow::triggerCapture() const
+{
+    return m_triggerCapture;
+}
+
 /**
  * @brief 暂停定时刷新定时器
  * @details 用于在写入操作前暂停自动刷新，避免竞争条件
@@ -441,6 +886,50 @@ void MainWindow::pauseRefreshTimer()
     }
 }
 
+/**
+ * @brief 应用总线映射
+ * @param bus 总线映射
+ */
+void MainWindow::applyBusMap(const BusMap &bus)
+{
+    ModbusManager::instance()->setBusMap(bus);
+    refreshTimer->setInterval(bus.stateIntervalMs);
+    slave3Timer->setInterval(bus.voltageIntervalMs);
+}
+
+/**
+ * @brief 重新加载负载柜配置
+ */
+void MainWindow::reloadLoadBankConfig()
+{
+    // 以替换方式保存的文件会从监视列表中移除，重新加入
+    if (QFile::exists(m_loadBankConfigPath) && !m_configWatcher->files().contains(m_loadBankConfigPath)) {
+        m_configWatcher->addPath(m_loadBankConfigPath);
+    }
+
+    // 曲线和调节器持有按旧配置生成的求解表
+    if (m_loadSequencer->isRunning() || m_voltageRegulator->isRunning()) {
+        qWarning() << "负载曲线或闭环稳压运行中，忽略本次配置变化";
+        return;
+    }
+
+    LoadBankConfig config;
+    QString errorString;
+    if (!config.loadFromFile(m_loadBankConfigPath, &errorString)) {
+        qWarning() << "负载柜配置重新加载失败，继续使用当前配置:" << errorString;
+        return;
+    }
+    if (config.rowCount() < RELAY_ROW_COUNT) {
+        qWarning() << "负载柜配置行数不足" << RELAY_ROW_COUNT << "行，继续使用当前配置";
+        return;
+    }
+
+    m_loadBankModel->setConfig(config);
+    applyBusMap(config.bus());
+    refreshAllRows();
+    qDebug() << "负载柜配置已热加载:" << m_loadBankConfigPath;
+}
+
 /**
  * @brief 恢复定时刷新定时器
  * @details 用于在写入操作后恢复自动刷新
@@ -448,54 +937,19 @@ void MainWindow::pauseRefreshTimer()
 void MainWindow::resumeRefreshTimer()
 {
     if (refreshTimer && !refreshTimer->isActive()) {
-        refreshTimer->start(1000);
+        refreshTimer->start();
         qDebug() << "定时刷新已恢复";
     }
 }
 
-/**
- * @brief 初始化电压波形图
- */
 /**
  * @brief 切换到波形图页面
  */
 void MainWindow::switchToWaveformPage()
 {
-    // 隐藏blurTransition，但保留topBar可见（因为raiseEffect在topBar中）
-    ui->centralwidget->findChild<QWidget*>("blurTransition")->setVisible(false);
-    
-    // 隐藏所有按钮，除了返回主界面的按钮
-    QList<QPushButton*> buttons = ui->centralwidget->findChildren<QPushButton*>();
-    for (QPushButton* btn : buttons) {
-        if (btn != ui->btnBackToMain) {
-            btn->setVisible(false);
-        }
-    }
-    
-    QList<QLineEdit*> lineEdits = ui->centralwidget->findChildren<QLineEdit*>();
-    for (QLineEdit* edit : lineEdits) {
-        edit->setVisible(false);
-    }
-    
-    QList<QLabel*> labels = ui->centralwidget->findChildren<QLabel*>();
-    for (QLabel* label : labels) {
-        label->setVisible(false);
-    }
-    
-    QList<QComboBox*> comboboxes = ui->centralwidget->findChildren<QComboBox*>();
-    for (QComboBox* box : comboboxes) {
-        box->setVisible(false);
-    }
+    switchToPage(ui->voltageWaveformPage);
     
-    QList<QRadioButton*> radioButtons = ui->centralwidget->findChildren<QRadioButton*>();
-    for (QRadioButton* radio : radioButtons) {
-        radio->setVisible(false);
-    }
-    
-    // 显示波形图页面
-    ui->voltageWaveformPage->setVisible(true);
-    
-    // 启动波形图更新定时器
+    // 恢复波形图刷新：暂停期间缓存的数据一次性刷新到图表
     m_waveformChart->startWaveformUpdate();
     
     qDebug() << "已切换到波形图页面";
@@ -506,46 +960,46 @@ void MainWindow::switchToWaveformPage()
  */
 void MainWindow::switchToMainPage()
 {
-    // 停止波形图更新定时器
+    // 暂停波形图刷新，页面不可见期间只缓存数据
     m_waveformChart->stopWaveformUpdate();
     
-    // 隐藏波形图页面
-    ui->voltageWaveformPage->setVisible(false);
-    
-    // 显示centralwidget中的所有子组件
-    ui->centralwidget->findChild<QWidget*>("topBar")->setVisible(true);
-    ui->centralwidget->findChild<QWidget*>("blurTransition")->setVisible(true);
-    
-    // 显示所有按钮和输入框
-    QList<QPushButton*> buttons = ui->centralwidget->findChildren<QPushButton*>();
-    for (QPushButton* btn : buttons) {
-        btn->setVisible(true);
-    }
-    
-    QList<QLineEdit*> lineEdits = ui->centralwidget->findChildren<QLineEdit*>();
-    for (QLineEdit* edit : lineEdits) {
-        edit->setVisible(true);
-    }
-    
-    QList<QLabel*> labels = ui->centralwidget->findChildren<QLabel*>();
-    for (QLabel* label : labels) {
-        label->setVisible(true);
-    }
+    switchToPage(ui->mainPage);
     
-    QList<QComboBox*> comboboxes = ui->centralwidget->findChildren<QComboBox*>();
-    for (QComboBox* box : comboboxes) {
-        box->setVisible(true);
-    }
+    qDebug() << "已切换到主界面";
+}
+
+/**
+ * @brief 切换到指定页面并开始计时
+ * @param page 目标页面
+ * @details 只改变堆叠窗口的当前页，不逐个改变子控件的可见性；新页面首次绘制时在eventFilter中记录延迟
+ */
+void MainWindow::switchToPage(QWidget *page)
+{
+    if (ui->pageStack->currentWidget() == page) return;
     
-    QList<QRadioButton*> radioButtons = ui->centralwidget->findChildren<QRadioButton*>();
-    for (QRadioButton* radio : radioButtons) {
-        radio->setVisible(true);
+    m_pageSwitchTarget = page;
+    m_pageSwitchClock.start();
+    ui->pageStack->setCurrentWidget(page);
+}
+
+/**
+ * @brief 事件过滤器
+ * @param watched 被监视的对象
+ * @param event 事件
+ * @return 始终返回false，不拦截事件
+ */
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Paint && watched == m_pageSwitchTarget) {
+        m_pageSwitchTarget = nullptr;
+        double latencyMs = m_pageSwitchClock.nsecsElapsed() / 1e6;
+        if (latencyMs > PAGE_SWITCH_TARGET_MS) {
+            qWarning() << "页面切换延迟" << latencyMs << "ms，超过目标" << PAGE_SWITCH_TARGET_MS << "ms";
+        } else {
+            qDebug() << "页面切换延迟" << latencyMs << "ms";
+        }
     }
-    
-    // 确保textBrowser可见
-    ui->textBrowser->setVisible(true);
-    
-    qDebug() << "已切换到主界面";
+    return QMainWindow::eventFilter(watched, event);
 }
 
 /**
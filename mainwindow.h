@@ -18,10 +18,28 @@
 #include <QRadioButton>
 #include <QTimer>
 #include <QResizeEvent>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
 #include <functional>
+#include <array>
 
 #include "rowbuttongroup.h"
+#include "loadbankconfig.h"
+#include "loadbankmodel.h"
+#include "loadsequencer.h"
+#include "voltageregulator.h"
 #include "waveformchart.h"
+#include "voltagestatistics.h"
+#include "triggercapture.h"
+#include "powerquality.h"
+#include "signalfilter.h"
+#include "automationserver.h"
+#include "samplering.h"
+#include "rolluparchive.h"
+#include "energyaccounting.h"
+#include "bankpreset.h"
+#include "banksolver.h"
+#include "serialportwatcher.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -31,20 +49,6 @@ QT_END_NAMESPACE
 
 class MainWindow;
 
-/**
- * @brief 寄存器地址常量定义
- * @details 定义各行列对应的Modbus寄存器地址
- */
-constexpr int REGISTER_ADDRESS_ROW0 = 50;  // 第0行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW1 = 1;   // 第1行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW2 = 2;   // 第2行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW3 = 3;   // 第3行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW4 = 4;   // 第4行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW5 = 5;   // 第5行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW6 = 6;   // 第6行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW7 = 7;   // 第7行对应的寄存器地址
-constexpr int REGISTER_ADDRESS_ROW8 = 8;   // 第8行对应的寄存器地址
-
 /**
  * @class MainWindow
  * @brief 主窗口类
@@ -61,7 +65,18 @@ protected:
      */
     void resizeEvent(QResizeEvent *event) override;
 
+    /**
+     * @brief 事件过滤器，记录切换页面后新页面首次绘制的时刻
+     * @param watched 被监视的对象
+     * @param event 事件
+     * @return 是否拦截事件（始终不拦截）
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 public:
+    static constexpr qint64 PAGE_SWITCH_TARGET_MS = 16;    // 页面切换到首次绘制的目标延迟（一帧）
+    static constexpr int CONFIG_RELOAD_DELAY_MS = 300;     // 配置文件变化后延迟加载，合并保存时的多次变化
+
     /**
      * @brief 构造函数
      * @param parent 父窗口指针
@@ -89,13 +104,57 @@ private slots:
      */
     void on_textBrowser_textChanged();
 
+    /**
+     * @brief 发现新串口的处理函数，增量更新下拉框并自动选中上次使用的适配器
+     * @param entry 串口信息
+     */
+    void onSerialPortAdded(const SerialPortEntry &entry);
+
+    /**
+     * @brief 串口被移除的处理函数
+     * @param portName 端口名称
+     */
+    void onSerialPortRemoved(const QString &portName);
+
 private:
+    /**
+     * @brief 应用总线映射：从站地址、电压寄存器和轮询周期
+     * @param bus 总线映射
+     */
+    void applyBusMap(const BusMap &bus);
+
     Ui::MainWindow *ui;                  // UI界面指针
-    RowButtonGroup row0, row1, row2, row3, row4, row5, row6, row7, row8;  // 行按钮组对象
+    std::array<RowButtonGroup, RELAY_ROW_COUNT> m_rowGroups;  // 行按钮组对象
+    LoadBankModel *m_loadBankModel;      // 负载柜数据模型（全部行的状态与寄存器映射）
+    LoadSequencer *m_loadSequencer;      // 负载曲线执行器
+    VoltageRegulator *m_voltageRegulator;  // 闭环稳压调节器
     static bool m_serialPortOpen;        // 串口状态标志
     QTimer *refreshTimer;                // 刷新定时器
     QTimer *slave3Timer;                 // 从机3定时器
     WaveformChart *m_waveformChart;
+    VoltageStatistics *m_voltageStatistics;  // 电压流式统计引擎
+    TriggerCapture *m_triggerCapture;        // 电压触发捕获引擎
+    PowerQualityDetector *m_powerQuality;    // 电能质量事件检测
+    FilterPipeline m_voltageFilter;          // 电压滤波链，波形图与数值显示使用滤波值
+    AutomationServer *m_automationServer;    // 本地自动化接口
+    SampleRingWriter *m_sampleRing;          // 共享内存电压样本环形缓冲区
+    RollupArchive *m_archive;                // 电压与负载多分辨率汇总归档
+    int m_archiveVoltageChannel;             // 电压归档通道
+    QVector<int> m_archiveRowChannels;       // 各行负载归档通道
+    EnergyAccounting *m_energyAccounting;    // 各行电能与继电器动作统计
+    BankPresetStore m_presets;               // 整柜预设
+    BankDistributor *m_distributor;          // 整柜分配后台求解
+    int m_distributionToleranceUnits;        // 整柜分配的三相之和最大互差，-1为不要求平衡
+    quint64 m_distributionCommitGeneration;  // 求解完成后需要下发的请求代号，0为无
+    SerialPortWatcher *m_portWatcher;        // 串口后台发现
+    QString m_preferredSerialNumber;         // 上次使用的适配器USB串行号
+    QString m_preferredPortName;             // 上次使用的端口名称（适配器没有串行号时使用）
+    QString m_loadBankConfigPath;            // 负载柜配置文件路径
+    QFileSystemWatcher *m_configWatcher;     // 负载柜配置文件监视器
+    QTimer *m_configReloadTimer;             // 配置重新加载延迟定时器
+    QElapsedTimer m_sampleClock;             // 采样单调时钟
+    QElapsedTimer m_pageSwitchClock;         // 页面切换计时
+    QWidget *m_pageSwitchTarget;             // 正在等待首次绘制的页面，无则为nullptr
 
 public:
     /**
@@ -104,15 +163,21 @@ public:
     void refreshAllRows();
     
     /**
-     * @brief 刷新指定行的数据
-     * @param rowIndex 行索引
+     * @brief 读取从机3的寄存器7
      */
-    void refreshRow(int rowIndex);
+    void readSlave3Register7();
     
     /**
-     * @brief 读取从机3的寄存器7
+     * @brief 获取电压流式统计引擎
+     * @return 统计引擎指针
      */
-    void readSlave3Register7();
+    VoltageStatistics *voltageStatistics() const;
+    
+    /**
+     * @brief 获取电压触发捕获引擎
+     * @return 触发捕获引擎指针
+     */
+    TriggerCapture *triggerCapture() const;
     
     /**
      * @brief 切换到波形图页面
@@ -124,12 +189,65 @@ public:
      */
     void switchToMainPage();
     
+    /**
+     * @brief 切换到指定页面并开始计时
+     * @param page 目标页面
+     */
+    void switchToPage(QWidget *page);
+    
     /**
      * @brief 清空指定行的数据
      * @param rowIndex 行索引
      */
     void clearRow(int rowIndex);
     
+    /**
+     * @brief 运行或停止负载曲线
+     */
+    void toggleLoadProfile();
+    
+    /**
+     * @brief 启动或停止闭环稳压
+     */
+    void toggleRegulator();
+    
+    /**
+     * @brief 把当前整柜状态保存为预设
+     * @details 输入名称后捕获快照并写入预设文件，同名预设被替换
+     */
+    void savePreset();
+    
+    /**
+     * @brief 把整柜切换到下拉框中选择的预设
+     */
+    void recallPreset();
+    
+    /**
+     * @brief 按预设集合重建预设下拉框
+     * @param current 重建后选中的预设名称
+     */
+    void refreshPresetCombo(const QString &current = QString());
+    
+    /**
+     * @brief 提交整柜分配求解
+     * @param commit 求解完成后是否下发（否则只显示预览）
+     * @details 在后台线程求解，新目标到达时放弃尚未完成的旧求解
+     */
+    void requestDistribution(bool commit);
+    
+    /**
+     * @brief 短时间保留某行寄存器的本地状态
+     * @param rowIndex 行索引
+     * @details 由曲线或调节器写入后调用，避免刷新读到写入前的旧值
+     */
+    void holdRowRegisters(int rowIndex);
+    
+    /**
+     * @brief 重新加载负载柜配置（寄存器映射）
+     * @details 不重新连接总线；负载曲线或闭环稳压运行中时不加载
+     */
+    void reloadLoadBankConfig();
+    
     /**
      * @brief 暂停刷新定时器
      */
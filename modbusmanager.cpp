@@ -13,6 +13,36 @@
 // 初始化静态单例实例
 ModbusManager* ModbusManager::m_instance = nullptr;
 
+constexpr int ModbusManager::SETTLE_DELAY_MS;
+constexpr int ModbusManager::RECONNECT_INITIAL_DELAY_MS;
+constexpr int ModbusManager::RECONNECT_MAX_DELAY_MS;
+
+/**
+ * @brief 输出Modbus协议异常的详细信息
+ * @param reply 出错的应答
+ */
+static void logModbusException(QModbusReply *reply)
+{
+    if (reply->error() != QModbusDevice::ProtocolError || !reply->rawResult().isException()) {
+        return;
+    }
+    
+    int exceptionCode = reply->rawResult().exceptionCode();
+    qDebug() << "Modbus异常代码:" << exceptionCode;
+    switch (exceptionCode) {
+        case 1: qDebug() << "异常说明: ILLEGAL FUNCTION (不支持的功能码)"; break;
+        case 2: qDebug() << "异常说明: ILLEGAL DATA ADDRESS (无效的寄存器地址)"; break;
+        case 3: qDebug() << "异常说明: ILLEGAL DATA VALUE (无效的寄存器值)"; break;
+        case 4: qDebug() << "异常说明: SERVER DEVICE FAILURE (设备故障)"; break;
+        case 5: qDebug() << "异常说明: ACKNOWLEDGE (确认，但需要时间)"; break;
+        case 6: qDebug() << "异常说明: SERVER DEVICE BUSY (设备忙)"; break;
+        case 7: qDebug() << "异常说明: MEMORY PARITY ERROR (内存校验错误)"; break;
+        case 8: qDebug() << "异常说明: GATEWAY PATH UNAVAILABLE (网关路径不可用)"; break;
+        case 9: qDebug() << "异常说明: GATEWAY TARGET FAILED (网关目标失败)"; break;
+        default: qDebug() << "异常说明: 未知异常"; break;
+    }
+}
+
 /**
  * @brief ModbusManager构造函数
  * @param parent 父对象指针
@@ -23,6 +53,16 @@ ModbusManager::ModbusManager(QObject *parent) : QObject(parent)
     COM = new QSerialPort();
     m_serialPortOpen = false;
     m_modbusStable = false;
+    m_requestInFlight = false;
+    m_requestSerial = 0;
+    m_baudRate = 9600;
+    m_autoReconnect = false;
+    m_reconnecting = false;
+    m_reconnectAttempt = 0;
+    m_reconnectDelayMs = RECONNECT_INITIAL_DELAY_MS;
+    m_reconnectTimer = new QTimer(this);
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &ModbusManager::attemptReconnect);
 }
 
 /**
@@ -54,7 +94,11 @@ ModbusManager* ModbusManager::instance()
  */
 bool ModbusManager::initModbus(const QString &portName, int baudRate)
 {
-    // 如果Modbus已经连接，先断开
+    // 如果Modbus已经连接，先断开（主动断开不触发自动重连）
+    m_autoReconnect = false;
+    m_reconnecting = false;
+    m_reconnectTimer->stop();
+    abortPendingRequests();
     if (modbusMaster) {
         if (modbusMaster->state() == QModbusDevice::ConnectedState) {
             modbusMaster->disconnectDevice();
@@ -76,21 +120,10 @@ bool ModbusManager::initModbus(const QString &portName, int baudRate)
         COM->close();
     }
     
-    // 创建Modbus主站实例
-    modbusMaster = new QModbusRtuSerialMaster();
-    
-    // 配置Modbus连接参数
-    modbusMaster->setConnectionParameter(QModbusDevice::SerialPortNameParameter, QVariant(portName));
-    modbusMaster->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, QVariant(baudRate));
-    modbusMaster->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QVariant(QSerialPort::Data8));
-    modbusMaster->setConnectionParameter(QModbusDevice::SerialParityParameter, QVariant(QSerialPort::NoParity));
-    modbusMaster->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QVariant(QSerialPort::OneStop));
-    
-    // 设置超时时间（毫秒）- 增加到500ms以提高稳定性
-    modbusMaster->setTimeout(400);
-    
-    // 设置重试次数 - 增加到2次重试
-    modbusMaster->setNumberOfRetries(1);
+    // 创建并配置Modbus主站实例
+    m_portName = portName;
+    m_baudRate = baudRate;
+    modbusMaster = createSerialMaster();
     
     // 建立Modbus连接
     if (!modbusMaster->connectDevice()) {
@@ -109,12 +142,14 @@ bool ModbusManager::initModbus(const QString &portName, int baudRate)
         qDebug() << "Modbus连接成功 - 端口:" << portName << ", 波特率:" << baudRate;
         // 重置连接稳定标志
         m_modbusStable = false;
-        // 延迟2秒后标记连接稳定，给设备足够的初始化时间
-        QTimer::singleShot(500, this, [this]() {
+        // 延迟后标记连接稳定，给设备足够的初始化时间
+        QTimer::singleShot(SETTLE_DELAY_MS, this, [this]() {
             m_modbusStable = true;
             qDebug() << "Modbus连接已稳定，可以开始正常通信";
         });
         m_serialPortOpen = true;
+        m_autoReconnect = true;
+        watchConnection(modbusMaster);
         return true;
     } else {
         qDebug() << "Modbus连接超时 - 最终状态:" << modbusMaster->state();
@@ -124,12 +159,181 @@ bool ModbusManager::initModbus(const QString &portName, int baudRate)
     }
 }
 
+/**
+ * @brief 按保存的串口参数创建RTU主站
+ * @return 新的主站对象（未连接）
+ */
+QModbusClient *ModbusManager::createSerialMaster() const
+{
+    QModbusClient *client = new QModbusRtuSerialMaster();
+    
+    // 配置Modbus连接参数
+    client->setConnectionParameter(QModbusDevice::SerialPortNameParameter, QVariant(m_portName));
+    client->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, QVariant(m_baudRate));
+    client->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, QVariant(QSerialPort::Data8));
+    client->setConnectionParameter(QModbusDevice::SerialParityParameter, QVariant(QSerialPort::NoParity));
+    client->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, QVariant(QSerialPort::OneStop));
+    
+    // 设置超时时间（毫秒）- 增加到500ms以提高稳定性
+    client->setTimeout(400);
+    
+    // 设置重试次数 - 增加到2次重试
+    client->setNumberOfRetries(1);
+    return client;
+}
+
+/**
+ * @brief 监视主站的错误与状态变化
+ * @param client 主站对象
+ * @details 适配器被拔出时串口报告资源错误，主站随之报告ConnectionError并进入未连接状态
+ */
+void ModbusManager::watchConnection(QModbusClient *client)
+{
+    connect(client, &QModbusDevice::errorOccurred, this, [this, client](QModbusDevice::Error error) {
+        if (client == modbusMaster && error == QModbusDevice::ConnectionError) {
+            handleConnectionLost(client->errorString());
+        }
+    });
+    connect(client, &QModbusDevice::stateChanged, this, [this, client](QModbusDevice::State state) {
+        if (client == modbusMaster && state == QModbusDevice::UnconnectedState) {
+            handleConnectionLost("串口已关闭");
+        }
+    });
+}
+
+/**
+ * @brief 串口意外断开的处理函数
+ * @param reason 断开原因
+ * @details 主站在其自身的信号中，只能延迟删除；排队请求全部以失败回调，之后的请求在恢复前立即失败
+ */
+void ModbusManager::handleConnectionLost(const QString &reason)
+{
+    if (!m_autoReconnect || m_reconnecting) {
+        return;
+    }
+    qWarning() << "Modbus连接意外断开:" << reason << "- 开始自动重连 端口:" << m_portName;
+    
+    m_reconnecting = true;
+    m_modbusStable = false;
+    QModbusClient *lost = modbusMaster;
+    modbusMaster = nullptr;
+    lost->disconnect(this);
+    lost->deleteLater();
+    abortPendingRequests();
+    
+    m_reconnectAttempt = 0;
+    m_reconnectDelayMs = RECONNECT_INITIAL_DELAY_MS;
+    m_reconnectTimer->start(m_reconnectDelayMs);
+    emit connectionLost();
+}
+
+/**
+ * @brief 尝试一次重连
+ * @details RTU主站打开串口是同步的，connectDevice返回后即可判断结果，不需要等待；
+ *          成功后等待设备就绪再发出connectionRestored
+ */
+void ModbusManager::attemptReconnect()
+{
+    if (!m_reconnecting) {
+        return;
+    }
+    ++m_reconnectAttempt;
+    
+    QModbusClient *client = createSerialMaster();
+    if (!client->connectDevice() || client->state() != QModbusDevice::ConnectedState) {
+        const QString error = client->errorString();
+        delete client;
+        
+        m_reconnectDelayMs = qMin(m_reconnectDelayMs * 2, RECONNECT_MAX_DELAY_MS);
+        qDebug() << "Modbus重连失败 - 第" << m_reconnectAttempt << "次:" << error
+                 << "，" << m_reconnectDelayMs << "ms后重试";
+        m_reconnectTimer->start(m_reconnectDelayMs);
+        emit reconnectScheduled(m_reconnectAttempt, m_reconnectDelayMs);
+        return;
+    }
+    
+    modbusMaster = client;
+    m_reconnecting = false;
+    watchConnection(client);
+    qDebug() << "Modbus重连成功 - 端口:" << m_portName << "尝试次数:" << m_reconnectAttempt;
+    
+    QTimer::singleShot(SETTLE_DELAY_MS, client, [this, client]() {
+        if (client != modbusMaster) return;
+        m_modbusStable = true;
+        emit connectionRestored();
+    });
+}
+
+/**
+ * @brief 是否正在自动重连
+ * @return 是否正在重连
+ */
+bool ModbusManager::isReconnecting() const
+{
+    return m_reconnecting;
+}
+
+/**
+ * @brief 立即尝试重连
+ * @param portName 新的串口名称，为空时沿用原端口
+ */
+void ModbusManager::reconnectNow(const QString &portName)
+{
+    if (!m_reconnecting) {
+        return;
+    }
+    if (!portName.isEmpty() && portName != m_portName) {
+        qDebug() << "重连端口变更:" << m_portName << "->" << portName;
+        m_portName = portName;
+        COM->setPortName(portName);
+    }
+    m_reconnectDelayMs = RECONNECT_INITIAL_DELAY_MS;
+    m_reconnectTimer->stop();
+    attemptReconnect();
+}
+
+/**
+ * @brief 使用已连接的Modbus客户端代替串口主站
+ * @param client 已处于连接状态的客户端，所有权转移给ModbusManager
+ * @return 是否接管成功
+ */
+bool ModbusManager::attachClient(QModbusClient *client)
+{
+    m_autoReconnect = false;
+    m_reconnecting = false;
+    m_reconnectTimer->stop();
+    abortPendingRequests();
+    if (modbusMaster) {
+        if (modbusMaster->state() == QModbusDevice::ConnectedState) {
+            modbusMaster->disconnectDevice();
+        }
+        delete modbusMaster;
+        modbusMaster = nullptr;
+    }
+
+    if (!client || client->state() != QModbusDevice::ConnectedState) {
+        qDebug() << "接管Modbus客户端失败: 客户端未连接";
+        delete client;
+        m_serialPortOpen = false;
+        m_modbusStable = false;
+        return false;
+    }
+
+    client->setParent(nullptr);
+    modbusMaster = client;
+    m_serialPortOpen = true;
+    m_modbusStable = true;
+    qDebug() << "已接管Modbus客户端";
+    return true;
+}
+
 /**
  * @brief 写入寄存器数据
  * @param address 寄存器地址
  * @param value   要写入的值
+ * @param priority 请求优先级
  */
-void ModbusManager::writeRegister(int address, int value)
+void ModbusManager::writeRegister(int address, int value, RequestPriority priority)
 {
     // 检查Modbus连接状态
     if (!modbusMaster) {
@@ -150,60 +354,54 @@ void ModbusManager::writeRegister(int address, int value)
     
     qDebug() << "尝试写入寄存器 - 地址:" << address << "值:" << value;
     
-    // 创建写寄存器请求单元
-    QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, address, 1);
-    writeUnit.setValue(0, value);
-    
-    // 发送写请求并处理响应
-    if (auto *reply = modbusMaster->sendWriteRequest(writeUnit, 1)) {
-        if (!reply->isFinished()) {
-            connect(reply, &QModbusReply::finished, modbusMaster, [reply, address, value]() {
-                if (reply->error() != QModbusDevice::NoError) {
-                    qDebug() << "写入失败 - 地址:" << address << "值:" << value 
-                             << "错误:" << reply->errorString() 
-                             << "错误代码:" << reply->error();
+    enqueue(priority, [this, address, value](bool send) {
+        if (!send || !isConnected()) {
+            qDebug() << "写入失败: 请求已取消或Modbus连接已断开 - 地址:" << address;
+            trackReply(nullptr);
+            return;
+        }
+        
+        // 创建写寄存器请求单元
+        QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, address, 1);
+        writeUnit.setValue(0, value);
+    
+        // 发送写请求并处理响应
+        QModbusReply *reply = modbusMaster->sendWriteRequest(writeUnit, m_busMap.controlSlave);
+        trackReply(reply);
+    
+        if (reply) {
+            if (!reply->isFinished()) {
+                connect(reply, &QModbusReply::finished, modbusMaster, [reply, address, value]() {
+                    if (reply->error() != QModbusDevice::NoError) {
+                        qDebug() << "写入失败 - 地址:" << address << "值:" << value 
+                                 << "错误:" << reply->errorString() 
+                                 << "错误代码:" << reply->error();
                     
-                    // 详细输出Modbus异常代码
-                    if (reply->error() == QModbusDevice::ProtocolError) {
-                        auto modbusReply = qobject_cast<QModbusReply*>(reply);
-                        if (modbusReply && modbusReply->rawResult().isException()) {
-                            int exceptionCode = modbusReply->rawResult().exceptionCode();
-                            qDebug() << "Modbus异常代码:" << exceptionCode;
-                            switch (exceptionCode) {
-                                case 1: qDebug() << "异常说明: ILLEGAL FUNCTION (不支持的功能码)"; break;
-                                case 2: qDebug() << "异常说明: ILLEGAL DATA ADDRESS (无效的寄存器地址)"; break;
-                                case 3: qDebug() << "异常说明: ILLEGAL DATA VALUE (无效的寄存器值)"; break;
-                                case 4: qDebug() << "异常说明: SERVER DEVICE FAILURE (设备故障)"; break;
-                                case 5: qDebug() << "异常说明: ACKNOWLEDGE (确认，但需要时间)"; break;
-                                case 6: qDebug() << "异常说明: SERVER DEVICE BUSY (设备忙)"; break;
-                                case 7: qDebug() << "异常说明: MEMORY PARITY ERROR (内存校验错误)"; break;
-                                case 8: qDebug() << "异常说明: GATEWAY PATH UNAVAILABLE (网关路径不可用)"; break;
-                                case 9: qDebug() << "异常说明: GATEWAY TARGET FAILED (网关目标失败)"; break;
-                                default: qDebug() << "异常说明: 未知异常"; break;
-                            }
-                        }
+                        // 详细输出Modbus异常代码
+                        logModbusException(reply);
+                    } else {
+                        qDebug() << "写入成功 - 地址:" << address << "值:" << value;
                     }
-                } else {
-                    qDebug() << "写入成功 - 地址:" << address << "值:" << value;
-                }
+                    reply->deleteLater();
+                });
+            } else {
+                qDebug() << "写入失败 - 地址:" << address << "值:" << value << "请求立即完成但无响应";
                 reply->deleteLater();
-            });
+            }
         } else {
-            qDebug() << "写入失败 - 地址:" << address << "值:" << value << "请求立即完成但无响应";
-            reply->deleteLater();
+            qDebug() << "写入请求发送失败 - 地址:" << address << "值:" << value 
+                     << "错误:" << modbusMaster->errorString();
         }
-    } else {
-        qDebug() << "写入请求发送失败 - 地址:" << address << "值:" << value 
-                 << "错误:" << modbusMaster->errorString();
-    }
+    });
 }
 
 /**
  * @brief 读取寄存器数据
  * @param address 寄存器地址
  * @param callback 读取完成后的回调函数
+ * @param priority 请求优先级
  */
-void ModbusManager::readRegister(int address, std::function<void(int)> callback)
+void ModbusManager::readRegister(int address, std::function<void(int)> callback, RequestPriority priority)
 {
     // 检查Modbus连接状态
     if (!modbusMaster) {
@@ -227,64 +425,194 @@ void ModbusManager::readRegister(int address, std::function<void(int)> callback)
     
     qDebug() << "尝试读取寄存器 - 地址:" << address;
     
-    // 创建读寄存器请求单元
-    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, address, 1);
-    
-    // 发送读请求并处理响应
-    if (auto *reply = modbusMaster->sendReadRequest(readUnit, 1)) {
-        if (!reply->isFinished()) {
-            connect(reply, &QModbusReply::finished, this, [reply, address, callback]() {
-                if (reply->error() != QModbusDevice::NoError) {
-                    qDebug() << "读取失败 - 地址:" << address 
-                             << "错误:" << reply->errorString() 
-                             << "错误代码:" << reply->error();
+    enqueue(priority, [this, address, callback](bool send) {
+        if (!send || !isConnected()) {
+            qDebug() << "读取失败: 请求已取消或Modbus连接已断开 - 地址:" << address;
+            callback(-1);
+            trackReply(nullptr);
+            return;
+        }
+        
+        // 创建读寄存器请求单元
+        QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, address, 1);
+    
+        // 发送读请求并处理响应
+        QModbusReply *reply = modbusMaster->sendReadRequest(readUnit, m_busMap.controlSlave);
+        trackReply(reply);
+    
+        if (reply) {
+            if (!reply->isFinished()) {
+                connect(reply, &QModbusReply::finished, this, [reply, address, callback]() {
+                    if (reply->error() != QModbusDevice::NoError) {
+                        qDebug() << "读取失败 - 地址:" << address 
+                                 << "错误:" << reply->errorString() 
+                                 << "错误代码:" << reply->error();
                     
-                    // 详细输出Modbus异常代码
-                    if (reply->error() == QModbusDevice::ProtocolError) {
-                        auto modbusReply = qobject_cast<QModbusReply*>(reply);
-                        if (modbusReply && modbusReply->rawResult().isException()) {
-                            int exceptionCode = modbusReply->rawResult().exceptionCode();
-                            qDebug() << "Modbus异常代码:" << exceptionCode;
-                            switch (exceptionCode) {
-                                case 1: qDebug() << "异常说明: ILLEGAL FUNCTION (不支持的功能码)"; break;
-                                case 2: qDebug() << "异常说明: ILLEGAL DATA ADDRESS (无效的寄存器地址)"; break;
-                                case 3: qDebug() << "异常说明: ILLEGAL DATA VALUE (无效的寄存器值)"; break;
-                                case 4: qDebug() << "异常说明: SERVER DEVICE FAILURE (设备故障)"; break;
-                                case 5: qDebug() << "异常说明: ACKNOWLEDGE (确认，但需要时间)"; break;
-                                case 6: qDebug() << "异常说明: SERVER DEVICE BUSY (设备忙)"; break;
-                                case 7: qDebug() << "异常说明: MEMORY PARITY ERROR (内存校验错误)"; break;
-                                case 8: qDebug() << "异常说明: GATEWAY PATH UNAVAILABLE (网关路径不可用)"; break;
-                                case 9: qDebug() << "异常说明: GATEWAY TARGET FAILED (网关目标失败)"; break;
-                                default: qDebug() << "异常说明: 未知异常"; break;
-                            }
-                        }
+                        // 详细输出Modbus异常代码
+                        logModbusException(reply);
+                        callback(-1);
+                    } else {
+                        QModbusDataUnit result = reply->result();
+                        int value = result.value(0);
+                        qDebug() << "读取成功 - 地址:" << address << "值:" << value;
+                        callback(value);
                     }
-                    callback(-1);
-                } else {
-                    QModbusDataUnit result = reply->result();
-                    int value = result.value(0);
-                    qDebug() << "读取成功 - 地址:" << address << "值:" << value;
-                    callback(value);
-                }
+                    reply->deleteLater();
+                });
+            } else {
+                qDebug() << "读取失败 - 地址:" << address << "请求立即完成但无响应";
                 reply->deleteLater();
-            });
+                callback(-1);
+            }
         } else {
-            qDebug() << "读取失败 - 地址:" << address << "请求立即完成但无响应";
-            reply->deleteLater();
+            qDebug() << "读取请求发送失败 - 地址:" << address 
+                     << "错误:" << modbusMaster->errorString();
             callback(-1);
         }
-    } else {
-        qDebug() << "读取请求发送失败 - 地址:" << address 
-                 << "错误:" << modbusMaster->errorString();
-        callback(-1);
+    });
+}
+
+/**
+ * @brief 读取一段连续的寄存器
+ * @param startAddress 起始寄存器地址
+ * @param count 寄存器数量（1-125）
+ * @param callback 读取完成后的回调函数，失败时参数为空数组
+ * @param priority 请求优先级
+ */
+void ModbusManager::readRegisters(int startAddress, int count, std::function<void(QVector<int>)> callback,
+                                  RequestPriority priority)
+{
+    if (!modbusMaster || modbusMaster->state() != QModbusDevice::ConnectedState) {
+        qDebug() << "批量读取失败: Modbus未连接";
+        callback(QVector<int>());
+        return;
+    }
+    
+    // 验证地址范围，单次读取保持寄存器最多125个
+    if (startAddress < 0 || count < 1 || count > MAX_READ_COUNT || startAddress + count - 1 > 65535) {
+        qDebug() << "批量读取失败: 寄存器范围" << startAddress << "+" << count << "无效";
+        callback(QVector<int>());
+        return;
+    }
+    
+    enqueue(priority, [this, startAddress, count, callback](bool send) {
+        if (!send || !isConnected()) {
+            callback(QVector<int>());
+            trackReply(nullptr);
+            return;
+        }
+        
+        QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, startAddress, count);
+    
+        QModbusReply *reply = modbusMaster->sendReadRequest(readUnit, m_busMap.controlSlave);
+        trackReply(reply);
+    
+        if (reply) {
+            if (!reply->isFinished()) {
+                connect(reply, &QModbusReply::finished, this, [reply, startAddress, count, callback]() {
+                    QVector<int> values;
+                    if (reply->error() != QModbusDevice::NoError) {
+                        qDebug() << "批量读取失败 - 起始地址:" << startAddress << "数量:" << count
+                                 << "错误:" << reply->errorString();
+                        logModbusException(reply);
+                    } else {
+                        QModbusDataUnit result = reply->result();
+                        values.reserve(static_cast<int>(result.valueCount()));
+                        for (int i = 0; i < static_cast<int>(result.valueCount()); ++i) {
+                            values.append(result.value(i));
+                        }
+                    }
+                    reply->deleteLater();
+                    callback(values);
+                });
+            } else {
+                qDebug() << "批量读取失败 - 起始地址:" << startAddress << "请求立即完成但无响应";
+                reply->deleteLater();
+                callback(QVector<int>());
+            }
+        } else {
+            qDebug() << "批量读取请求发送失败 - 起始地址:" << startAddress
+                     << "错误:" << modbusMaster->errorString();
+            callback(QVector<int>());
+        }
+    });
+}
+
+/**
+ * @brief 写入一段连续的寄存器
+ * @param startAddress 起始寄存器地址
+ * @param values 各寄存器的值
+ * @param callback 写入完成后的回调函数，可为空
+ * @param priority 请求优先级
+ */
+void ModbusManager::writeRegisters(int startAddress, const QVector<int> &values, std::function<void(bool)> callback,
+                                   RequestPriority priority)
+{
+    auto finish = [callback](bool ok) {
+        if (callback) callback(ok);
+    };
+    
+    if (!modbusMaster || modbusMaster->state() != QModbusDevice::ConnectedState) {
+        qDebug() << "批量写入失败: Modbus未连接";
+        finish(false);
+        return;
     }
+    
+    const int count = values.size();
+    if (startAddress < 0 || count < 1 || count > MAX_WRITE_COUNT || startAddress + count - 1 > 65535) {
+        qDebug() << "批量写入失败: 寄存器范围" << startAddress << "+" << count << "无效";
+        finish(false);
+        return;
+    }
+    
+    enqueue(priority, [this, startAddress, values, count, finish](bool send) {
+        if (!send || !isConnected()) {
+            finish(false);
+            trackReply(nullptr);
+            return;
+        }
+        
+        QModbusDataUnit writeUnit(QModbusDataUnit::HoldingRegisters, startAddress, count);
+        for (int i = 0; i < count; ++i) {
+            writeUnit.setValue(i, static_cast<quint16>(values[i]));
+        }
+    
+        qDebug() << "尝试批量写入寄存器 - 起始地址:" << startAddress << "值:" << values;
+    
+        QModbusReply *reply = modbusMaster->sendWriteRequest(writeUnit, m_busMap.controlSlave);
+        trackReply(reply);
+    
+        if (reply) {
+            if (!reply->isFinished()) {
+                connect(reply, &QModbusReply::finished, this, [reply, startAddress, count, finish]() {
+                    bool ok = reply->error() == QModbusDevice::NoError;
+                    if (!ok) {
+                        qDebug() << "批量写入失败 - 起始地址:" << startAddress << "数量:" << count
+                                 << "错误:" << reply->errorString();
+                        logModbusException(reply);
+                    }
+                    reply->deleteLater();
+                    finish(ok);
+                });
+            } else {
+                qDebug() << "批量写入失败 - 起始地址:" << startAddress << "请求立即完成但无响应";
+                reply->deleteLater();
+                finish(false);
+            }
+        } else {
+            qDebug() << "批量写入请求发送失败 - 起始地址:" << startAddress
+                     << "错误:" << modbusMaster->errorString();
+            finish(false);
+        }
+    });
 }
 
 /**
- * @brief 读取从站3的寄存器7（电压数据）
+ * @brief 读取电压寄存器（默认为从站3的寄存器7）
  * @param callback 读取完成后的回调函数
+ * @param priority 请求优先级
  */
-void ModbusManager::readSlave3Register7(std::function<void(int)> callback)
+void ModbusManager::readSlave3Register7(std::function<void(int)> callback, RequestPriority priority)
 {
     // 检查Modbus连接状态
     if (!modbusMaster) {
@@ -303,31 +631,65 @@ void ModbusManager::readSlave3Register7(std::function<void(int)> callback)
         return;
     }
     
-    QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, 7, 1);
+    // 入队时确定从站和地址，热加载只影响之后的请求
+    const int slave = m_busMap.voltageSlave;
+    const int address = m_busMap.voltageAddress;
+    enqueue(priority, [this, callback, slave, address](bool send) {
+        if (!send || !isConnected()) {
+            callback(-1);
+            trackReply(nullptr);
+            return;
+        }
+        
+        QModbusDataUnit readUnit(QModbusDataUnit::HoldingRegisters, address, 1);
     
-    if (auto *reply = modbusMaster->sendReadRequest(readUnit, 3)) {
-        if (!reply->isFinished()) {
-            connect(reply, &QModbusReply::finished, this, [reply, callback]() {
-                if (reply->error() != QModbusDevice::NoError) {
-                    reply->deleteLater();
-                    callback(-1);
-                    return;
-                }
+        QModbusReply *reply = modbusMaster->sendReadRequest(readUnit, slave);
+        trackReply(reply);
+    
+        if (reply) {
+            if (!reply->isFinished()) {
+                connect(reply, &QModbusReply::finished, this, [reply, callback]() {
+                    if (reply->error() != QModbusDevice::NoError) {
+                        reply->deleteLater();
+                        callback(-1);
+                        return;
+                    }
                 
-                QModbusDataUnit result = reply->result();
-                int value = result.value(0);
+                    QModbusDataUnit result = reply->result();
+                    int value = result.value(0);
                 
-                callback(value);
+                    callback(value);
                 
+                    reply->deleteLater();
+                });
+            } else {
                 reply->deleteLater();
-            });
+                callback(-1);
+            }
         } else {
-            reply->deleteLater();
             callback(-1);
         }
-    } else {
-        callback(-1);
-    }
+    });
+}
+
+/**
+ * @brief 设置总线映射
+ * @param map 总线映射
+ */
+void ModbusManager::setBusMap(const BusMap &map)
+{
+    m_busMap = map;
+    qDebug() << "总线映射已更新 - 继电器从站:" << map.controlSlave << "电压从站:" << map.voltageSlave
+             << "电压寄存器:" << map.voltageAddress << "比例:" << map.voltageScale;
+}
+
+/**
+ * @brief 获取总线映射
+ * @return 总线映射
+ */
+const BusMap &ModbusManager::busMap() const
+{
+    return m_busMap;
 }
 
 /**
@@ -335,6 +697,11 @@ void ModbusManager::readSlave3Register7(std::function<void(int)> callback)
  */
 void ModbusManager::closeModbus()
 {
+    // 主动关闭：停止自动重连，之后的状态变化不视为意外断开
+    m_autoReconnect = false;
+    m_reconnecting = false;
+    m_reconnectTimer->stop();
+    
     // 关闭Modbus连接
     if (modbusMaster && modbusMaster->state() == QModbusDevice::ConnectedState) {
         modbusMaster->disconnectDevice();
@@ -349,9 +716,91 @@ void ModbusManager::closeModbus()
     m_serialPortOpen = false;
     m_modbusStable = false;
     
+    abortPendingRequests();
+    
     qDebug() << "Modbus连接已关闭";
 }
 
+/**
+ * @brief 将请求加入对应优先级的队列
+ * @param priority 请求优先级
+ * @param job 发出请求的函数
+ */
+void ModbusManager::enqueue(RequestPriority priority, RequestJob job)
+{
+    if (priority == ControlPriority) {
+        m_controlQueue.enqueue(job);
+    } else {
+        m_normalQueue.enqueue(job);
+    }
+    dispatchNext();
+}
+
+/**
+ * @brief 跟踪刚发出的请求
+ * @param reply 请求应答，发送失败时为nullptr
+ * @details 应答对象在完成前被销毁（例如设备被删除）时同样释放总线，序号保证只释放一次
+ */
+void ModbusManager::trackReply(QModbusReply *reply)
+{
+    const quint64 serial = m_requestSerial;
+    if (reply && !reply->isFinished()) {
+        connect(reply, &QModbusReply::finished, this, [this, serial]() { finishRequest(serial); });
+        connect(reply, &QObject::destroyed, this, [this, serial]() { finishRequest(serial); });
+    } else {
+        // 未能发出或立即完成：在事件循环中释放总线，避免在请求函数内递归发出下一个请求
+        QTimer::singleShot(0, this, [this, serial]() { finishRequest(serial); });
+    }
+}
+
+/**
+ * @brief 当前请求结束，调度下一个请求
+ * @param serial 请求序号
+ */
+void ModbusManager::finishRequest(quint64 serial)
+{
+    if (!m_requestInFlight || serial != m_requestSerial) {
+        return;
+    }
+    m_requestInFlight = false;
+    dispatchNext();
+}
+
+/**
+ * @brief 总线空闲时发出队首请求，控制队列优先
+ */
+void ModbusManager::dispatchNext()
+{
+    if (m_requestInFlight) {
+        return;
+    }
+    QQueue<RequestJob> &queue = m_controlQueue.isEmpty() ? m_normalQueue : m_controlQueue;
+    if (queue.isEmpty()) {
+        return;
+    }
+    
+    RequestJob job = queue.dequeue();
+    m_requestInFlight = true;
+    ++m_requestSerial;
+    job(true);
+}
+
+/**
+ * @brief 丢弃在途请求并以失败回调全部排队请求
+ */
+void ModbusManager::abortPendingRequests()
+{
+    ++m_requestSerial;
+    m_requestInFlight = false;
+    
+    QList<RequestJob> jobs = m_controlQueue + m_normalQueue;
+    m_controlQueue.clear();
+    m_normalQueue.clear();
+    for (const RequestJob &job : jobs) {
+        job(false);
+    }
+}
+
 /**
  * @brief 获取Modbus连接状态
  * @return 是否连接
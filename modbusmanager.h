@@ -10,18 +10,35 @@
 #include <QObject>
 #include <QModbusRtuSerialMaster>
 #include <QSerialPort>
+#include <QQueue>
+#include <QTimer>
+#include <QVector>
 #include <functional>
 
+#include "loadbankconfig.h"
+
 /**
  * @class ModbusManager
  * @brief Modbus通信管理类
- * @details 负责Modbus RTU串行通信的初始化、读写寄存器、连接状态管理等功能，使用单例模式
+ * @details 负责Modbus RTU串行通信的初始化、读写寄存器、连接状态管理等功能，使用单例模式。
+ *          RTU总线同一时刻只能有一个事务，所有请求先进入按优先级划分的队列，上一个应答返回后再发出下一个；
+ *          控制优先级的请求（闭环调节）总是排在普通请求（界面刷新、波形采集）之前。
+ *          串口意外断开（如USB-RS485适配器掉线）时按指数退避自动重连，重连成功后发出connectionRestored
  */
 class ModbusManager : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @enum RequestPriority
+     * @brief 总线请求优先级
+     */
+    enum RequestPriority {
+        NormalPriority,     // 普通请求：界面操作、周期刷新、波形采集
+        ControlPriority     // 控制请求：闭环调节的测量与输出，优先占用总线
+    };
+
     /**
      * @brief 构造函数
      * @param parent 父对象指针
@@ -40,27 +57,76 @@ public:
      * @return 初始化是否成功
      */
     bool initModbus(const QString &portName, int baudRate = 9600);
+
+    /**
+     * @brief 使用已连接的Modbus客户端代替串口主站
+     * @param client 已处于连接状态的客户端（例如测试中连接到进程内模拟从站的TCP客户端），所有权转移给ModbusManager
+     * @return 是否接管成功，失败时client被删除
+     * @details 请求排队、优先级和回调与串口主站完全相同，用于在没有硬件时运行端到端基准
+     */
+    bool attachClient(QModbusClient *client);
     
     /**
      * @brief 写入寄存器数据
      * @param address 寄存器地址
      * @param value 要写入的值
+     * @param priority 请求优先级
      */
-    void writeRegister(int address, int value);
+    void writeRegister(int address, int value, RequestPriority priority = NormalPriority);
     
     /**
      * @brief 读取寄存器数据
      * @param address 寄存器地址
      * @param callback 回调函数，用于处理读取结果
+     * @param priority 请求优先级
      */
-    void readRegister(int address, std::function<void(int)> callback);
+    void readRegister(int address, std::function<void(int)> callback, RequestPriority priority = NormalPriority);
     
     /**
-     * @brief 读取从站3的寄存器7（电压数据）
-     * @param callback 回调函数，用于处理读取结果
+     * @brief 读取一段连续的寄存器（功能码03，一次事务）
+     * @param startAddress 起始寄存器地址
+     * @param count 寄存器数量，不超过MAX_READ_COUNT
+     * @param callback 回调函数，参数为各寄存器的值，失败时为空数组
+     * @param priority 请求优先级
      */
-    void readSlave3Register7(std::function<void(int)> callback);
+    void readRegisters(int startAddress, int count, std::function<void(QVector<int>)> callback,
+                       RequestPriority priority = NormalPriority);
     
+    /**
+     * @brief 写入一段连续的寄存器（功能码16，一次事务）
+     * @param startAddress 起始寄存器地址
+     * @param values 各寄存器的值，数量不超过MAX_WRITE_COUNT
+     * @param callback 回调函数，参数为是否写入成功，可为空
+     * @param priority 请求优先级
+     */
+    void writeRegisters(int startAddress, const QVector<int> &values, std::function<void(bool)> callback = nullptr,
+                        RequestPriority priority = NormalPriority);
+    
+    static constexpr int MAX_READ_COUNT = 125;  // 单次读取保持寄存器的最大数量
+    static constexpr int MAX_WRITE_COUNT = 123; // 单次写入保持寄存器的最大数量
+    static constexpr int SETTLE_DELAY_MS = 500;                 // 连接建立后等待设备就绪的时间
+    static constexpr int RECONNECT_INITIAL_DELAY_MS = 250;      // 断开后第一次重连的延迟
+    static constexpr int RECONNECT_MAX_DELAY_MS = 5000;         // 重连退避的最大延迟
+    
+    /**
+     * @brief 读取电压寄存器（默认为从站3的寄存器7，由总线映射决定）
+     * @param callback 回调函数，参数为寄存器原始值，失败时为-1；乘以busMap().voltageScale得到电压
+     * @param priority 请求优先级
+     */
+    void readSlave3Register7(std::function<void(int)> callback, RequestPriority priority = NormalPriority);
+    
+    /**
+     * @brief 设置总线映射
+     * @param map 继电器从站、电压寄存器等，对之后发出的请求生效，不需要重新连接
+     */
+    void setBusMap(const BusMap &map);
+
+    /**
+     * @brief 获取总线映射
+     * @return 总线映射
+     */
+    const BusMap &busMap() const;
+
     /**
      * @brief 关闭Modbus连接
      */
@@ -77,6 +143,18 @@ public:
      * @return 连接是否稳定
      */
     bool isStable() const;
+
+    /**
+     * @brief 是否正在自动重连
+     * @return 串口意外断开且尚未恢复时为true
+     */
+    bool isReconnecting() const;
+
+    /**
+     * @brief 立即尝试重连，并把退避延迟恢复为初始值
+     * @param portName 新的串口名称（适配器重新插入后端口名称可能变化），为空时沿用原端口
+     */
+    void reconnectNow(const QString &portName = QString());
     
     /**
      * @brief 静态实例获取方法
@@ -84,12 +162,101 @@ public:
      */
     static ModbusManager* instance();
 
+signals:
+    /**
+     * @brief 串口意外断开，已开始自动重连
+     */
+    void connectionLost();
+
+    /**
+     * @brief 一次重连失败，已安排下一次重连
+     * @param attempt 已尝试的次数
+     * @param delayMs 距下一次重连的时间（毫秒）
+     */
+    void reconnectScheduled(int attempt, int delayMs);
+
+    /**
+     * @brief 自动重连成功且连接已稳定，可以重新同步状态
+     */
+    void connectionRestored();
+
 private:
-    QModbusRtuSerialMaster *modbusMaster;  // Modbus RTU主站对象
+    /**
+     * @brief 排队的总线请求，参数为是否允许发出（取消时为false，请求应直接以失败回调）
+     */
+    using RequestJob = std::function<void(bool)>;
+
+    /**
+     * @brief 将请求加入对应优先级的队列，总线空闲时立即发出
+     * @param priority 请求优先级
+     * @param job 发出请求的函数
+     */
+    void enqueue(RequestPriority priority, RequestJob job);
+
+    /**
+     * @brief 跟踪刚发出的请求，应答完成（或请求未能发出）后释放总线
+     * @param reply 请求应答，发送失败时为nullptr
+     */
+    void trackReply(QModbusReply *reply);
+
+    /**
+     * @brief 当前请求结束，调度下一个请求
+     * @param serial 请求序号，过期的序号被忽略
+     */
+    void finishRequest(quint64 serial);
+
+    /**
+     * @brief 总线空闲时发出队首请求
+     */
+    void dispatchNext();
+
+    /**
+     * @brief 丢弃在途请求并以失败回调全部排队请求（断开连接时调用）
+     */
+    void abortPendingRequests();
+
+    /**
+     * @brief 按保存的串口参数创建RTU主站（未连接）
+     * @return 新的主站对象
+     */
+    QModbusClient *createSerialMaster() const;
+
+    /**
+     * @brief 监视主站的错误与状态变化，用于发现串口意外断开
+     * @param client 主站对象
+     */
+    void watchConnection(QModbusClient *client);
+
+    /**
+     * @brief 串口意外断开的处理函数：释放主站、取消全部请求并开始重连
+     * @param reason 断开原因
+     */
+    void handleConnectionLost(const QString &reason);
+
+    /**
+     * @brief 尝试一次重连，失败时按指数退避安排下一次
+     */
+    void attemptReconnect();
+
+    QModbusClient *modbusMaster;           // Modbus主站对象（通常为RTU串口主站）
     QSerialPort *COM;                      // 串口对象
     bool m_serialPortOpen;                 // 串口状态标志
     bool m_modbusStable;                   // Modbus连接稳定标志
     
+    QQueue<RequestJob> m_controlQueue;     // 控制优先级请求队列
+    QQueue<RequestJob> m_normalQueue;      // 普通优先级请求队列
+    bool m_requestInFlight;                // 总线上是否有未完成的事务
+    quint64 m_requestSerial;               // 在途请求序号
+    BusMap m_busMap;                       // 总线映射（从站地址、电压寄存器）
+
+    QString m_portName;                    // 串口名称（重连时使用）
+    int m_baudRate;                        // 波特率（重连时使用）
+    bool m_autoReconnect;                  // 断开时是否自动重连（由initModbus打开、closeModbus关闭）
+    bool m_reconnecting;                   // 是否正在自动重连
+    int m_reconnectAttempt;                // 本轮重连已尝试的次数
+    int m_reconnectDelayMs;                // 下一次重连的退避延迟
+    QTimer *m_reconnectTimer;              // 重连定时器
+    
     static ModbusManager* m_instance;      // 静态单例实例
 };
 
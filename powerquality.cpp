@@ -0,0 +1,295 @@
+/**
+ * @file powerquality.cpp
+ * @brief 电能质量事件检测实现文件
+ * @details 包含PowerQualityEvent和PowerQualityDetector类的实现
+ */
+
+#include "powerquality.h"
+#include <QDebug>
+#include <algorithm>
+
+constexpr int PowerQualityDetector::DEFAULT_MAX_EVENTS;
+
+/**
+ * @brief 获取类型名称
+ * @param type 事件类型
+ * @return 类型名称
+ */
+QString PowerQualityEvent::typeName(Type type)
+{
+    switch (type) {
+        case Sag: return "暂降";
+        case Swell: return "暂升";
+        case Interruption: return "中断";
+        case TypeCount: break;
+    }
+    return QString();
+}
+
+/**
+ * @brief 生成事件描述文本
+ * @return 描述文本
+ */
+QString PowerQualityEvent::description() const
+{
+    return QString("#%1 %2 %3 V 持续 %4 s @ %5 s")
+            .arg(id)
+            .arg(typeName(type))
+            .arg(extreme, 0, 'f', 1)
+            .arg(durationMs / 1000.0, 0, 'f', 2)
+            .arg(startMs / 1000.0, 0, 'f', 1);
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+PowerQualityDetector::PowerQualityDetector(QObject *parent)
+    : QObject(parent)
+    , m_sagLevel(0.0)
+    , m_swellLevel(0.0)
+    , m_interruptionLevel(0.0)
+    , m_sagExitLevel(0.0)
+    , m_swellExitLevel(0.0)
+    , m_phase(Idle)
+    , m_sampleCount(0)
+    , m_maxEvents(DEFAULT_MAX_EVENTS)
+    , m_nextEventId(1)
+{
+    m_typeCounts.fill(0);
+    setConfig(PowerQualityConfig());
+}
+
+/**
+ * @brief 设置检测配置
+ * @param config 检测配置
+ * @details 门限预先换算为电压，每个样本只做比较。已确认的事件已经分配了编号，
+ *          在最后一个越限样本处结束并写入日志，保持日志编号连续；未确认的候选事件直接放弃
+ */
+void PowerQualityDetector::setConfig(const PowerQualityConfig &config)
+{
+    if (m_phase == Active) {
+        qDebug() << "电能质量检测配置已变更，在最后一个越限样本处结束进行中的事件";
+        finish(m_current.endMs);
+    }
+    m_phase = Idle;
+
+    m_config = config;
+    m_config.hysteresis = qMax(0.0, m_config.hysteresis);
+    m_config.minDurationMs = qMax(0, m_config.minDurationMs);
+
+    m_sagLevel = m_config.nominal * m_config.sagThreshold;
+    m_swellLevel = m_config.nominal * m_config.swellThreshold;
+    m_interruptionLevel = m_config.nominal * m_config.interruptionThreshold;
+    m_sagExitLevel = m_sagLevel + m_config.nominal * m_config.hysteresis;
+    m_swellExitLevel = m_swellLevel - m_config.nominal * m_config.hysteresis;
+}
+
+/**
+ * @brief 获取检测配置
+ * @return 检测配置
+ */
+PowerQualityConfig PowerQualityDetector::config() const
+{
+    return m_config;
+}
+
+/**
+ * @brief 按进入门限判断样本所属的事件类型
+ * @param voltage 电压
+ * @return 事件类型，正常时返回TypeCount
+ */
+PowerQualityEvent::Type PowerQualityDetector::classify(double voltage) const
+{
+    if (voltage < m_interruptionLevel) return PowerQualityEvent::Interruption;
+    if (voltage < m_sagLevel) return PowerQualityEvent::Sag;
+    if (voltage > m_swellLevel) return PowerQualityEvent::Swell;
+    return PowerQualityEvent::TypeCount;
+}
+
+/**
+ * @brief 输入一个样本
+ * @param voltage 电压（V）
+ * @param timestampMs 单调时间戳（毫秒）
+ * @details 事件进行中时先判断是否恢复（越过回差）或直接跳到相反方向的越限，
+ *          结束后同一样本再按进入门限判断是否开始新的候选事件
+ */
+void PowerQualityDetector::addSample(double voltage, qint64 timestampMs)
+{
+    const quint64 sample = m_sampleCount++;
+
+    if (m_phase != Idle) {
+        const bool swell = m_current.type == PowerQualityEvent::Swell;
+        const bool recovered = swell ? voltage <= m_swellExitLevel : voltage >= m_sagExitLevel;
+        const bool reversed = swell ? voltage < m_sagLevel : voltage > m_swellLevel;
+
+        if (!recovered && !reversed) {
+            if (swell) {
+                m_current.extreme = qMax(m_current.extreme, voltage);
+            } else {
+                m_current.extreme = qMin(m_current.extreme, voltage);
+                if (voltage < m_interruptionLevel) m_current.type = PowerQualityEvent::Interruption;
+            }
+            m_current.endMs = timestampMs;
+            m_current.durationMs = timestampMs - m_current.startMs;
+            m_current.lastSample = sample;
+            if (m_phase == Pending && m_current.durationMs >= m_config.minDurationMs) {
+                confirm();
+            }
+            return;
+        }
+
+        finish(timestampMs);
+    }
+
+    const PowerQualityEvent::Type type = classify(voltage);
+    if (type == PowerQualityEvent::TypeCount) {
+        return;
+    }
+
+    m_current = PowerQualityEvent();
+    m_current.type = type;
+    m_current.startMs = timestampMs;
+    m_current.endMs = timestampMs;
+    m_current.extreme = voltage;
+    m_current.firstSample = sample;
+    m_current.lastSample = sample;
+    m_phase = Pending;
+    if (m_config.minDurationMs == 0) {
+        confirm();
+    }
+}
+
+/**
+ * @brief 确认候选事件
+ */
+void PowerQualityDetector::confirm()
+{
+    m_phase = Active;
+    m_current.id = m_nextEventId++;
+    emit eventStarted(m_current);
+}
+
+/**
+ * @brief 结束当前事件
+ * @param timestampMs 恢复样本的时刻
+ * @details 持续时间计到恢复样本：低速轮询时单个越限样本也代表越限持续了一个采样周期
+ */
+void PowerQualityDetector::finish(qint64 timestampMs)
+{
+    m_current.endMs = timestampMs;
+    m_current.durationMs = timestampMs - m_current.startMs;
+
+    if (m_phase == Pending) {
+        m_phase = Idle;
+        if (m_current.durationMs < m_config.minDurationMs) {
+            return;
+        }
+        confirm();
+    }
+    m_phase = Idle;
+
+    m_events.append(m_current);
+    if (m_events.size() > m_maxEvents) {
+        m_events.remove(0, m_events.size() - m_maxEvents);
+    }
+    m_typeCounts[m_current.type]++;
+    qDebug() << "电能质量事件 -" << m_current.description();
+    emit eventFinished(m_current);
+}
+
+/**
+ * @brief 已输入的样本数
+ * @return 样本数
+ */
+quint64 PowerQualityDetector::sampleCount() const
+{
+    return m_sampleCount;
+}
+
+/**
+ * @brief 获取进行中的已确认事件
+ * @param event 输出事件
+ * @return 是否有进行中的已确认事件
+ */
+bool PowerQualityDetector::activeEvent(PowerQualityEvent *event) const
+{
+    if (m_phase != Active) return false;
+    if (event) *event = m_current;
+    return true;
+}
+
+/**
+ * @brief 获取事件日志
+ * @return 已结束的事件
+ */
+const QVector<PowerQualityEvent> &PowerQualityDetector::events() const
+{
+    return m_events;
+}
+
+/**
+ * @brief 按编号查找事件
+ * @param id 事件编号
+ * @param event 输出事件
+ * @return 日志中是否有该事件
+ * @details 日志中的编号连续，下标即编号与第一个事件编号之差
+ */
+bool PowerQualityDetector::findEvent(int id, PowerQualityEvent *event) const
+{
+    if (m_events.isEmpty()) return false;
+    const int index = id - m_events.first().id;
+    if (index < 0 || index >= m_events.size()) return false;
+    if (event) *event = m_events[index];
+    return true;
+}
+
+/**
+ * @brief 查找与时间段重叠的事件
+ * @param fromMs 起始时刻
+ * @param toMs 结束时刻
+ * @return 按编号升序的事件
+ * @details 事件互不重叠且按时间先后写入，开始和结束时刻都单调递增，可二分查找第一个结束晚于fromMs的事件
+ */
+QVector<PowerQualityEvent> PowerQualityDetector::eventsBetween(qint64 fromMs, qint64 toMs) const
+{
+    auto it = std::upper_bound(m_events.constBegin(), m_events.constEnd(), fromMs,
+                               [](qint64 t, const PowerQualityEvent &e) { return t < e.endMs; });
+    QVector<PowerQualityEvent> result;
+    for (; it != m_events.constEnd() && it->startMs < toMs; ++it) {
+        result.append(*it);
+    }
+    return result;
+}
+
+/**
+ * @brief 各类型累计事件数
+ * @param type 事件类型
+ * @return 累计事件数
+ */
+int PowerQualityDetector::eventCount(PowerQualityEvent::Type type) const
+{
+    if (type < 0 || type >= PowerQualityEvent::TypeCount) return 0;
+    return m_typeCounts[type];
+}
+
+/**
+ * @brief 设置保留的事件数上限
+ * @param maxEvents 事件数上限
+ */
+void PowerQualityDetector::setMaxEvents(int maxEvents)
+{
+    m_maxEvents = qMax(1, maxEvents);
+    if (m_events.size() > m_maxEvents) {
+        m_events.remove(0, m_events.size() - m_maxEvents);
+    }
+}
+
+/**
+ * @brief 清除事件日志和累计事件数
+ */
+void PowerQualityDetector::clearEvents()
+{
+    m_events.clear();
+    m_typeCounts.fill(0);
+}
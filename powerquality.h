@@ -0,0 +1,222 @@
+/**
+ * @file powerquality.h
+ * @brief 电能质量事件检测定义文件
+ * @details 包含PowerQualityConfig、PowerQualityEvent和PowerQualityDetector的声明，
+ *          在电压采样流上检测电压暂降、暂升和中断，记录每个事件的起止时刻、极值和持续时间
+ */
+
+#ifndef POWERQUALITY_H
+#define POWERQUALITY_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QMetaType>
+#include <array>
+
+/**
+ * @struct PowerQualityConfig
+ * @brief 事件检测配置
+ * @details 门限和回差均为额定电压的比例
+ */
+struct PowerQualityConfig
+{
+    double nominal = 230.0;             // 额定电压（V）
+    double sagThreshold = 0.90;         // 低于该比例为暂降
+    double swellThreshold = 1.10;       // 高于该比例为暂升
+    double interruptionThreshold = 0.10;    // 暂降期间低于该比例即记为中断
+    double hysteresis = 0.02;           // 回差：暂降须回升到sagThreshold + hysteresis以上才结束，暂升同理
+    int minDurationMs = 100;            // 最短持续时间，更短的越限不记为事件
+};
+
+/**
+ * @struct PowerQualityEvent
+ * @brief 一个电能质量事件
+ */
+struct PowerQualityEvent
+{
+    /**
+     * @brief 事件类型
+     */
+    enum Type {
+        Sag,            // 暂降
+        Swell,          // 暂升
+        Interruption,   // 中断
+        TypeCount
+    };
+
+    int id = 0;                 // 事件编号，从1开始连续递增
+    Type type = Sag;            // 事件类型
+    qint64 startMs = 0;         // 开始时刻（第一个越限样本，单调时间戳）
+    qint64 endMs = 0;           // 结束时刻（第一个恢复样本），进行中的事件为最近一个样本的时刻
+    qint64 durationMs = 0;      // 持续时间
+    double extreme = 0.0;       // 极值：暂降和中断为最低电压，暂升为最高电压
+    quint64 firstSample = 0;    // 第一个越限样本的序号（检测器收到的第几个样本，从0开始）
+    quint64 lastSample = 0;     // 最后一个越限样本的序号
+
+    /**
+     * @brief 获取类型名称
+     * @param type 事件类型
+     * @return 类型名称
+     */
+    static QString typeName(Type type);
+
+    /**
+     * @brief 生成事件描述文本
+     * @return 描述文本，例如"#3 暂降 198.4 V 持续 0.35 s @ 125.0 s"
+     */
+    QString description() const;
+};
+
+Q_DECLARE_METATYPE(PowerQualityEvent)
+
+/**
+ * @class PowerQualityDetector
+ * @brief 电能质量事件检测器
+ * @details 每个样本只做常数次比较，可在最高轮询频率下运行。越限样本开始一个候选事件，
+ *          持续时间达到minDurationMs后确认并发出eventStarted，恢复到回差以外时结束并写入事件日志；
+ *          未达到最短持续时间即恢复的候选事件被丢弃。暂降中跌破中断门限的事件记为中断。
+ *          事件日志按编号连续存放，按编号查找为常数时间，按时间段查找为二分查找
+ */
+class PowerQualityDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_MAX_EVENTS = 1000;     // 默认保留的事件数
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit PowerQualityDetector(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置检测配置
+     * @param config 检测配置，进行中的已确认事件先结束并记入日志，未确认的候选事件放弃
+     */
+    void setConfig(const PowerQualityConfig &config);
+
+    /**
+     * @brief 获取检测配置
+     * @return 检测配置
+     */
+    PowerQualityConfig config() const;
+
+    /**
+     * @brief 输入一个样本
+     * @param voltage 电压（V）
+     * @param timestampMs 单调时间戳（毫秒）
+     */
+    void addSample(double voltage, qint64 timestampMs);
+
+    /**
+     * @brief 已输入的样本数
+     * @return 样本数，即下一个样本的序号
+     */
+    quint64 sampleCount() const;
+
+    /**
+     * @brief 获取进行中的已确认事件
+     * @param event 输出事件，可为nullptr
+     * @return 是否有进行中的已确认事件
+     */
+    bool activeEvent(PowerQualityEvent *event) const;
+
+    /**
+     * @brief 获取事件日志
+     * @return 已结束的事件（按编号升序）
+     */
+    const QVector<PowerQualityEvent> &events() const;
+
+    /**
+     * @brief 按编号查找事件
+     * @param id 事件编号
+     * @param event 输出事件
+     * @return 日志中是否有该事件
+     */
+    bool findEvent(int id, PowerQualityEvent *event) const;
+
+    /**
+     * @brief 查找与时间段重叠的事件
+     * @param fromMs 起始时刻（含）
+     * @param toMs 结束时刻（不含）
+     * @return 按编号升序的事件
+     */
+    QVector<PowerQualityEvent> eventsBetween(qint64 fromMs, qint64 toMs) const;
+
+    /**
+     * @brief 各类型累计事件数
+     * @param type 事件类型
+     * @return 累计事件数，不因日志上限而减少
+     */
+    int eventCount(PowerQualityEvent::Type type) const;
+
+    /**
+     * @brief 设置保留的事件数上限
+     * @param maxEvents 事件数上限，超出时丢弃最旧的事件
+     */
+    void setMaxEvents(int maxEvents);
+
+    /**
+     * @brief 清除事件日志和累计事件数
+     */
+    void clearEvents();
+
+signals:
+    /**
+     * @brief 事件确认信号
+     * @param event 进行中的事件（endMs、durationMs和极值为确认时的值）
+     */
+    void eventStarted(const PowerQualityEvent &event);
+
+    /**
+     * @brief 事件结束信号
+     * @param event 已写入日志的事件
+     */
+    void eventFinished(const PowerQualityEvent &event);
+
+private:
+    /**
+     * @brief 检测器阶段
+     */
+    enum Phase {
+        Idle,           // 电压正常
+        Pending,        // 候选事件，尚未达到最短持续时间
+        Active          // 已确认的事件
+    };
+
+    /**
+     * @brief 按进入门限判断样本所属的事件类型
+     * @param voltage 电压
+     * @return 事件类型，正常时返回TypeCount
+     */
+    PowerQualityEvent::Type classify(double voltage) const;
+
+    /**
+     * @brief 确认候选事件
+     */
+    void confirm();
+
+    /**
+     * @brief 结束当前事件
+     * @param timestampMs 恢复样本的时刻
+     */
+    void finish(qint64 timestampMs);
+
+    PowerQualityConfig m_config;
+    double m_sagLevel;                  // 暂降进入电压
+    double m_swellLevel;                // 暂升进入电压
+    double m_interruptionLevel;         // 中断电压
+    double m_sagExitLevel;              // 暂降结束电压
+    double m_swellExitLevel;            // 暂升结束电压
+    Phase m_phase;
+    PowerQualityEvent m_current;        // 候选或进行中的事件
+    quint64 m_sampleCount;              // 已输入的样本数
+    QVector<PowerQualityEvent> m_events;    // 事件日志
+    std::array<int, PowerQualityEvent::TypeCount> m_typeCounts;    // 各类型累计事件数
+    int m_maxEvents;                    // 事件数上限
+    int m_nextEventId;                  // 下一个事件编号
+};
+
+#endif // POWERQUALITY_H
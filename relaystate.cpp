@@ -0,0 +1,49 @@
+/**
+ * @file relaystate.cpp
+ * @brief 继电器状态位图实现文件
+ * @details 包含RelaySumTable的实现
+ */
+
+#include "relaystate.h"
+
+constexpr int RelayState::MAX_STEPS;
+constexpr int RelayState::DEFAULT_FIRST_BIT;
+constexpr int RelayState::DEFAULT_FIELD_WIDTH;
+
+/**
+ * @brief 构造档位之和表
+ * @param stepUnits 各档位值（0.1为单位）
+ * @details 每个字节的表按 sum[b] = sum[b & (b-1)] + 最低置位档位值 递推，每项一次加法
+ */
+RelaySumTable::RelaySumTable(const QVector<int> &stepUnits)
+{
+    const int stepCount = qMin(stepUnits.size(), RelayState::MAX_STEPS);
+    const int byteCount = (stepCount + 7) / 8;
+
+    m_byteSums.fill(0, byteCount * 256);
+    for (int k = 0; k < byteCount; ++k) {
+        int *sums = m_byteSums.data() + k * 256;
+        for (int b = 1; b < 256; ++b) {
+            int lowest = qCountTrailingZeroBits(static_cast<quint32>(b));
+            int step = k * 8 + lowest;
+            sums[b] = sums[b & (b - 1)] + (step < stepCount ? stepUnits[step] : 0);
+        }
+    }
+}
+
+/**
+ * @brief 计算状态对应的档位之和
+ * @param state 继电器状态
+ * @return 档位之和（0.1为单位）
+ */
+int RelaySumTable::units(RelayState state) const
+{
+    const int byteCount = m_byteSums.size() / 256;
+    quint64 bits = state.bits();
+
+    int sum = 0;
+    for (int k = 0; k < byteCount && bits; ++k, bits >>= 8) {
+        sum += m_byteSums[k * 256 + static_cast<int>(bits & 0xFF)];
+    }
+    return sum;
+}
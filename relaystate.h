@@ -0,0 +1,162 @@
+/**
+ * @file relaystate.h
+ * @brief 继电器状态位图定义文件
+ * @details 包含RelayState与RelaySumTable的声明。RelayState用一个64位整数保存一行全部档位的通断状态，
+ *          提供编译期可求值的寄存器位字段编解码（LoadBankRow按连续档位段调用）和档位计数；
+ *          RelaySumTable按字节预先计算档位之和，求当前总和只需每字节一次查表
+ */
+
+#ifndef RELAYSTATE_H
+#define RELAYSTATE_H
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <QVector>
+#include <array>
+
+/**
+ * @class RelayState
+ * @brief 一行继电器的通断状态位图
+ * @details 第i位对应第i个档位，最多64档
+ */
+class RelayState
+{
+public:
+    static constexpr int MAX_STEPS = 64;            // 位图宽度
+    static constexpr int DEFAULT_FIRST_BIT = 8;     // 默认布局中第0档所在的寄存器位
+    static constexpr int DEFAULT_FIELD_WIDTH = 8;   // 默认布局中每个寄存器容纳的档位数
+
+    constexpr RelayState() : m_bits(0) {}
+
+    /**
+     * @brief 由位掩码构造
+     * @param bits 位掩码
+     */
+    constexpr explicit RelayState(quint64 bits) : m_bits(bits) {}
+
+    /**
+     * @brief 获取位掩码
+     * @return 位掩码
+     */
+    constexpr quint64 bits() const { return m_bits; }
+
+    /**
+     * @brief 获取某档位是否闭合
+     * @param step 档位序号
+     * @return 是否闭合
+     */
+    constexpr bool test(int step) const { return (m_bits >> step) & 0x01; }
+
+    /**
+     * @brief 设置某档位的通断
+     * @param step 档位序号
+     * @param on 是否闭合
+     */
+    constexpr void set(int step, bool on)
+    {
+        if (on) {
+            m_bits |= Q_UINT64_C(1) << step;
+        } else {
+            m_bits &= ~(Q_UINT64_C(1) << step);
+        }
+    }
+
+    /**
+     * @brief 翻转某档位
+     * @param step 档位序号
+     */
+    constexpr void toggle(int step) { m_bits ^= Q_UINT64_C(1) << step; }
+
+    /**
+     * @brief 断开全部档位
+     */
+    constexpr void clear() { m_bits = 0; }
+
+    /**
+     * @brief 获取闭合的档位数
+     * @return 闭合档位数
+     */
+    int count() const { return static_cast<int>(qPopulationCount(bits())); }
+
+    /**
+     * @brief 获取与另一状态相比发生变化的档位
+     * @param other 另一状态
+     * @return 变化档位的位图
+     */
+    constexpr RelayState changedFrom(RelayState other) const { return RelayState(m_bits ^ other.m_bits); }
+
+    constexpr bool operator==(RelayState other) const { return m_bits == other.m_bits; }
+    constexpr bool operator!=(RelayState other) const { return m_bits != other.m_bits; }
+
+    /**
+     * @brief 将连续的若干档位编码到寄存器位字段
+     * @param registerValue 寄存器原值，字段以外的位保持不变
+     * @param firstStep 字段中第一个档位的序号
+     * @param firstBit 字段在寄存器中的起始位
+     * @param width 字段宽度（档位数）
+     * @return 新的寄存器值
+     */
+    constexpr quint16 encodeField(quint16 registerValue, int firstStep = 0,
+                                  int firstBit = DEFAULT_FIRST_BIT, int width = DEFAULT_FIELD_WIDTH) const
+    {
+        const quint16 fieldMask = static_cast<quint16>(((1u << width) - 1) << firstBit);
+        const quint16 field = static_cast<quint16>(((m_bits >> firstStep) & ((1u << width) - 1)) << firstBit);
+        return static_cast<quint16>((registerValue & ~fieldMask) | field);
+    }
+
+    /**
+     * @brief 从寄存器位字段解码连续的若干档位
+     * @param registerValue 寄存器值
+     * @param firstStep 字段中第一个档位的序号
+     * @param firstBit 字段在寄存器中的起始位
+     * @param width 字段宽度（档位数）
+     * @return 更新后的状态，字段以外的档位保持不变
+     */
+    constexpr RelayState decodeField(quint16 registerValue, int firstStep = 0,
+                                     int firstBit = DEFAULT_FIRST_BIT, int width = DEFAULT_FIELD_WIDTH) const
+    {
+        const quint64 stepMask = static_cast<quint64>((1u << width) - 1) << firstStep;
+        const quint64 steps = static_cast<quint64>((registerValue >> firstBit) & ((1u << width) - 1)) << firstStep;
+        return RelayState((m_bits & ~stepMask) | steps);
+    }
+
+private:
+    quint64 m_bits;     // 档位位图
+};
+
+static_assert(sizeof(RelayState) == sizeof(quint64), "RelayState应与位掩码大小相同");
+static_assert(RelayState(0x81).encodeField(0x00FF) == 0x81FF, "默认布局：第0档在第8位，低8位保持不变");
+static_assert(RelayState().decodeField(0x8100).bits() == 0x81, "默认布局解码");
+
+constexpr int RELAY_ROW_COUNT = 9;                                  // 负载柜行数
+using RelayStateBank = std::array<RelayState, RELAY_ROW_COUNT>;     // 全部行的状态，连续存放
+
+/**
+ * @class RelaySumTable
+ * @brief 按字节预计算的档位之和表
+ * @details 把位图分为若干字节，每字节预先计算256种组合的档位之和；
+ *          默认8档时只有一个字节，求和即一次查表
+ */
+class RelaySumTable
+{
+public:
+    RelaySumTable() = default;
+
+    /**
+     * @brief 构造档位之和表
+     * @param stepUnits 各档位值（0.1为单位），最多64档
+     */
+    explicit RelaySumTable(const QVector<int> &stepUnits);
+
+    /**
+     * @brief 计算状态对应的档位之和
+     * @param state 继电器状态
+     * @return 档位之和（0.1为单位）
+     */
+    int units(RelayState state) const;
+
+private:
+    QVector<int> m_byteSums;    // 第k字节的256种组合之和存放在[k*256, k*256+255]
+};
+
+#endif // RELAYSTATE_H
@@ -0,0 +1,484 @@
+/**
+ * @file rolluparchive.cpp
+ * @brief 多分辨率汇总归档实现文件
+ * @details 包含RollupRecord和RollupArchive类的实现
+ */
+
+#include "rolluparchive.h"
+#include <QDir>
+#include <QRegularExpression>
+#include <QDebug>
+#include <cstring>
+
+constexpr qint64 RollupArchive::RAW_PERIOD_MS;
+constexpr qint64 RollupArchive::FLUSH_INTERVAL_MS;
+
+namespace
+{
+    constexpr quint32 MAGIC = 0x4152424C;       // 'LBRA'
+    constexpr quint32 VERSION = 1;
+
+    /**
+     * @struct DiskHeader
+     * @brief 层级文件头部
+     */
+    struct DiskHeader
+    {
+        quint32 magic;
+        quint32 version;
+        qint64 periodMs;
+        quint32 capacity;
+        quint32 recordSize;
+        quint64 reserved;
+    };
+
+    /**
+     * @struct DiskRecord
+     * @brief 层级文件中的一条记录
+     */
+    struct DiskRecord
+    {
+        qint64 startMs;
+        double min;
+        double max;
+        double mean;
+        quint32 count;
+        quint32 reserved;
+    };
+
+    static_assert(sizeof(DiskHeader) == 32, "头部大小与布局说明一致");
+    static_assert(sizeof(DiskRecord) == 40, "记录大小与布局说明一致");
+
+    /**
+     * @brief 记录在文件中的偏移
+     * @param slot 记录序号
+     * @return 字节偏移
+     */
+    inline qint64 slotOffset(quint32 slot)
+    {
+        return qint64(sizeof(DiskHeader)) + qint64(slot) * qint64(sizeof(DiskRecord));
+    }
+}
+
+/**
+ * @brief 加入一个样本
+ * @param value 样本值
+ */
+void RollupRecord::add(double value)
+{
+    if (count == 0) {
+        min = max = mean = value;
+    } else {
+        min = qMin(min, value);
+        max = qMax(max, value);
+        mean += (value - mean) / (count + 1);
+    }
+    ++count;
+}
+
+/**
+ * @brief 合并另一段汇总
+ * @param other 另一段汇总
+ */
+void RollupRecord::merge(const RollupRecord &other)
+{
+    if (other.count == 0) return;
+    if (count == 0) {
+        const qint64 start = startMs;
+        *this = other;
+        startMs = start;
+        return;
+    }
+    min = qMin(min, other.min);
+    max = qMax(max, other.max);
+    const double total = double(count) + double(other.count);
+    mean = (mean * count + other.mean * other.count) / total;
+    count += other.count;
+}
+
+/**
+ * @brief 默认层级
+ * @return 按记录时长升序的层级
+ */
+QVector<RollupTier> RollupArchive::defaultTiers()
+{
+    const qint64 hour = 3600LL * 1000;
+    const qint64 day = 24 * hour;
+    return {
+        {"raw", RAW_PERIOD_MS, hour},
+        {"1s", 1000, 2 * day},
+        {"1m", 60 * 1000, 90 * day},
+        {"1h", hour, 5 * 365 * day},
+    };
+}
+
+/**
+ * @brief 构造函数
+ */
+RollupArchive::RollupArchive()
+    : m_open(false)
+{
+}
+
+/**
+ * @brief 析构函数，写入未结束的当前记录
+ */
+RollupArchive::~RollupArchive()
+{
+    close();
+}
+
+/**
+ * @brief 打开归档目录
+ * @param directory 归档目录
+ * @param tiers 层级
+ * @param errorString 失败时的错误描述
+ * @return 是否打开成功
+ */
+bool RollupArchive::open(const QString &directory, const QVector<RollupTier> &tiers, QString *errorString)
+{
+    close();
+
+    if (tiers.isEmpty()) {
+        if (errorString) *errorString = "未配置归档层级";
+        return false;
+    }
+    for (int i = 0; i < tiers.size(); ++i) {
+        if (tiers[i].periodMs <= 0 || tiers[i].retentionMs < tiers[i].periodMs
+                || (i > 0 && tiers[i].periodMs <= tiers[i - 1].periodMs)) {
+            if (errorString) *errorString = QString("归档层级%1无效").arg(tiers[i].name);
+            return false;
+        }
+    }
+    if (!QDir().mkpath(directory)) {
+        if (errorString) *errorString = QString("无法创建归档目录 %1").arg(directory);
+        return false;
+    }
+
+    m_directory = directory;
+    m_tiers = tiers;
+    m_open = true;
+    qDebug() << "汇总归档已打开:" << directory << "层级数:" << tiers.size();
+    return true;
+}
+
+/**
+ * @brief 写入全部未结束的当前记录并关闭文件
+ */
+void RollupArchive::close()
+{
+    if (!m_open) return;
+    flush();
+    m_channels.clear();
+    m_channelIndex.clear();
+    m_open = false;
+}
+
+/**
+ * @brief 是否已打开
+ * @return 是否已打开
+ */
+bool RollupArchive::isOpen() const
+{
+    return m_open;
+}
+
+/**
+ * @brief 获取层级
+ * @return 层级
+ */
+const QVector<RollupTier> &RollupArchive::tiers() const
+{
+    return m_tiers;
+}
+
+/**
+ * @brief 打开（必要时创建）一个通道的层级文件
+ * @param name 通道名称
+ * @param errorString 失败时的错误描述
+ * @return 通道句柄，失败时返回-1
+ */
+int RollupArchive::channel(const QString &name, QString *errorString)
+{
+    if (!m_open) {
+        if (errorString) *errorString = "归档未打开";
+        return -1;
+    }
+    auto it = m_channelIndex.constFind(name);
+    if (it != m_channelIndex.constEnd()) return it.value();
+
+    static const QRegularExpression validName("^[A-Za-z0-9_-]+$");
+    if (!validName.match(name).hasMatch()) {
+        if (errorString) *errorString = QString("通道名称无效: %1").arg(name);
+        return -1;
+    }
+
+    std::unique_ptr<Channel> channel(new Channel);
+    channel->name = name;
+    const QDir dir(m_directory);
+    for (const RollupTier &tierConfig : m_tiers) {
+        std::unique_ptr<TierFile> tier(new TierFile);
+        tier->periodMs = tierConfig.periodMs;
+        tier->capacity = quint32((tierConfig.retentionMs + tierConfig.periodMs - 1) / tierConfig.periodMs);
+        if (!openTierFile(*tier, dir.filePath(QString("%1.%2").arg(name, tierConfig.name)), errorString)) {
+            return -1;
+        }
+        channel->tiers.push_back(std::move(tier));
+    }
+
+    const int index = int(m_channels.size());
+    m_channels.push_back(std::move(channel));
+    m_channelIndex.insert(name, index);
+    return index;
+}
+
+/**
+ * @brief 查找已打开的通道
+ * @param name 通道名称
+ * @return 通道句柄，未打开时返回-1
+ */
+int RollupArchive::findChannel(const QString &name) const
+{
+    return m_channelIndex.value(name, -1);
+}
+
+/**
+ * @brief 加入一个样本
+ * @param channel 通道句柄
+ * @param value 样本值
+ * @param timestampMs 采样时刻（UTC毫秒）
+ * @details 跨过记录边界时写出上一条记录；进程启动后每个层级的第一条记录先与文件中同一时段的记录合并，
+ *          重启不会覆盖重启前已写入的部分汇总
+ */
+void RollupArchive::addSample(int channel, double value, qint64 timestampMs)
+{
+    if (channel < 0 || channel >= int(m_channels.size()) || timestampMs < 0) return;
+    Channel &c = *m_channels[channel];
+
+    for (const std::unique_ptr<TierFile> &tierPointer : c.tiers) {
+        TierFile &tier = *tierPointer;
+        RollupRecord &current = tier.current;
+        const qint64 startMs = timestampMs - timestampMs % tier.periodMs;
+
+        if (current.count > 0 && startMs > current.startMs) {
+            writeRecord(tier, current);
+            current = RollupRecord();
+        }
+        if (current.count == 0) {
+            current.startMs = startMs;
+            if (!tier.resumed) {
+                tier.resumed = true;
+                readRecord(tier, startMs, &current);
+            }
+        }
+        current.add(value);
+    }
+
+    if (timestampMs - c.lastFlushMs >= FLUSH_INTERVAL_MS) {
+        c.lastFlushMs = timestampMs;
+        for (const std::unique_ptr<TierFile> &tier : c.tiers) {
+            if (tier->current.count > 0) writeRecord(*tier, tier->current);
+            tier->file.flush();
+        }
+    }
+}
+
+/**
+ * @brief 写入全部未结束的当前记录
+ */
+void RollupArchive::flush()
+{
+    for (const std::unique_ptr<Channel> &channel : m_channels) {
+        for (const std::unique_ptr<TierFile> &tier : channel->tiers) {
+            if (tier->current.count > 0) writeRecord(*tier, tier->current);
+            tier->file.flush();
+        }
+    }
+}
+
+/**
+ * @brief 选择满足分辨率要求的最粗层级
+ * @param resolutionMs 请求的分辨率
+ * @return 层级下标
+ */
+int RollupArchive::tierForResolution(qint64 resolutionMs) const
+{
+    int index = 0;
+    for (int i = 1; i < m_tiers.size(); ++i) {
+        if (m_tiers[i].periodMs <= resolutionMs) index = i;
+    }
+    return index;
+}
+
+/**
+ * @brief 查询一段时间的汇总
+ * @param channel 通道句柄
+ * @param fromMs 起始时刻（含）
+ * @param toMs 结束时刻（不含）
+ * @param resolutionMs 请求的分辨率
+ * @param tierIndex 输出实际读取的层级
+ * @return 按时间升序的非空汇总
+ * @details 所选层级中对应时段的记录在文件中连续（最多在文件末尾折返一次），至多两次读取；
+ *          尚未写出的当前记录直接取内存中的值
+ */
+QVector<RollupRecord> RollupArchive::query(int channel, qint64 fromMs, qint64 toMs, qint64 resolutionMs, int *tierIndex)
+{
+    QVector<RollupRecord> result;
+    if (channel < 0 || channel >= int(m_channels.size()) || toMs <= fromMs) return result;
+
+    const int index = tierForResolution(resolutionMs);
+    if (tierIndex) *tierIndex = index;
+    TierFile &tier = *m_channels[channel]->tiers[index];
+    const qint64 periodMs = tier.periodMs;
+    const qint64 bucketMs = qMax(resolutionMs, periodMs);
+
+    // 超出保留期限的部分已被覆盖，只读取最近一圈
+    const qint64 lastStart = (toMs - 1) - (toMs - 1) % periodMs;
+    qint64 firstStart = qMax<qint64>(0, fromMs - fromMs % periodMs);
+    firstStart = qMax(firstStart, lastStart - qint64(tier.capacity - 1) * periodMs);
+    if (firstStart > lastStart) return result;
+    const quint32 total = quint32((lastStart - firstStart) / periodMs + 1);
+
+    const quint32 firstSlot = quint32((firstStart / periodMs) % tier.capacity);
+    const quint32 headCount = qMin(total, tier.capacity - firstSlot);
+    QByteArray bytes = readSlots(tier, firstSlot, headCount);
+    if (headCount < total) {
+        bytes += readSlots(tier, 0, total - headCount);
+    }
+
+    const int available = bytes.size() / int(sizeof(DiskRecord));
+    for (quint32 i = 0; i < total; ++i) {
+        const qint64 expectedStart = firstStart + qint64(i) * periodMs;
+
+        RollupRecord record;
+        if (tier.current.count > 0 && tier.current.startMs == expectedStart) {
+            record = tier.current;
+        } else if (int(i) < available) {
+            DiskRecord disk;
+            std::memcpy(&disk, bytes.constData() + i * sizeof(DiskRecord), sizeof(DiskRecord));
+            if (disk.startMs != expectedStart || disk.count == 0) continue;
+            record.startMs = disk.startMs;
+            record.min = disk.min;
+            record.max = disk.max;
+            record.mean = disk.mean;
+            record.count = disk.count;
+        } else {
+            continue;
+        }
+
+        if (bucketMs == periodMs) {
+            result.append(record);
+            continue;
+        }
+        const qint64 bucketStart = record.startMs - record.startMs % bucketMs;
+        if (result.isEmpty() || result.last().startMs != bucketStart) {
+            RollupRecord bucket;
+            bucket.startMs = bucketStart;
+            result.append(bucket);
+        }
+        result.last().merge(record);
+    }
+    return result;
+}
+
+/**
+ * @brief 打开或创建层级文件，布局不符时重建
+ * @param tier 层级文件
+ * @param path 文件路径
+ * @param errorString 失败时的错误描述
+ * @return 是否成功
+ */
+bool RollupArchive::openTierFile(TierFile &tier, const QString &path, QString *errorString)
+{
+    tier.file.setFileName(path);
+    if (!tier.file.open(QIODevice::ReadWrite)) {
+        if (errorString) *errorString = QString("无法打开归档文件 %1: %2").arg(path, tier.file.errorString());
+        return false;
+    }
+
+    const qint64 expectedSize = slotOffset(tier.capacity);
+    DiskHeader header;
+    bool valid = tier.file.size() == expectedSize
+            && tier.file.read(reinterpret_cast<char *>(&header), sizeof(header)) == qint64(sizeof(header))
+            && header.magic == MAGIC && header.version == VERSION && header.periodMs == tier.periodMs
+            && header.capacity == tier.capacity && header.recordSize == sizeof(DiskRecord);
+    if (valid) return true;
+
+    // 新文件，或层级的记录时长、保留期限已修改：旧记录无法按新布局寻址，重建
+    if (tier.file.size() > 0) {
+        qWarning() << "归档文件布局与配置不符，重建:" << path;
+    }
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.periodMs = tier.periodMs;
+    header.capacity = tier.capacity;
+    header.recordSize = sizeof(DiskRecord);
+    // 扩展出的部分全为0，即空记录；支持稀疏文件的文件系统上不占用实际空间
+    if (!tier.file.resize(0) || !tier.file.seek(0)
+            || tier.file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))
+            || !tier.file.resize(expectedSize)) {
+        if (errorString) *errorString = QString("无法初始化归档文件 %1: %2").arg(path, tier.file.errorString());
+        tier.file.close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取一段连续记录
+ * @param tier 层级文件
+ * @param firstSlot 起始记录序号
+ * @param count 记录数
+ * @return 记录的原始字节
+ */
+QByteArray RollupArchive::readSlots(TierFile &tier, quint32 firstSlot, quint32 count)
+{
+    if (count == 0 || !tier.file.seek(slotOffset(firstSlot))) return QByteArray();
+    return tier.file.read(qint64(count) * qint64(sizeof(DiskRecord)));
+}
+
+/**
+ * @brief 读取起始时刻为startMs的记录
+ * @param tier 层级文件
+ * @param startMs 起始时刻
+ * @param record 输出记录，文件中没有该时段的记录时不修改
+ * @return 文件中是否有该时段的记录
+ */
+bool RollupArchive::readRecord(TierFile &tier, qint64 startMs, RollupRecord *record)
+{
+    const QByteArray bytes = readSlots(tier, quint32((startMs / tier.periodMs) % tier.capacity), 1);
+    if (bytes.size() != int(sizeof(DiskRecord))) return false;
+
+    DiskRecord disk;
+    std::memcpy(&disk, bytes.constData(), sizeof(disk));
+    if (disk.startMs != startMs || disk.count == 0) return false;
+    record->startMs = disk.startMs;
+    record->min = disk.min;
+    record->max = disk.max;
+    record->mean = disk.mean;
+    record->count = disk.count;
+    return true;
+}
+
+/**
+ * @brief 写入一条记录
+ * @param tier 层级文件
+ * @param record 记录
+ */
+void RollupArchive::writeRecord(TierFile &tier, const RollupRecord &record)
+{
+    DiskRecord disk;
+    disk.startMs = record.startMs;
+    disk.min = record.min;
+    disk.max = record.max;
+    disk.mean = record.mean;
+    disk.count = record.count;
+    disk.reserved = 0;
+
+    const quint32 slot = quint32((record.startMs / tier.periodMs) % tier.capacity);
+    if (!tier.file.seek(slotOffset(slot))
+            || tier.file.write(reinterpret_cast<const char *>(&disk), sizeof(disk)) != qint64(sizeof(disk))) {
+        qWarning() << "归档记录写入失败:" << tier.file.fileName() << tier.file.errorString();
+    }
+}
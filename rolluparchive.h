@@ -0,0 +1,238 @@
+/**
+ * @file rolluparchive.h
+ * @brief 多分辨率汇总归档定义文件
+ * @details 包含RollupRecord、RollupTier和RollupArchive的声明。
+ *          每个通道（电压、各行负载）按若干分辨率层级汇总为定长记录（最小、最大、均值、样本数），
+ *          每个层级一个文件，文件按时间直接寻址、循环覆盖，文件大小即保留期限，无需清理过期数据
+ *
+ * 层级文件布局（版本1，所有整数为本机字节序）：
+ * @code
+ * 偏移 0   quint32 magic          'LBRA'
+ * 偏移 4   quint32 version        1
+ * 偏移 8   qint64  periodMs       每条记录覆盖的时长
+ * 偏移 16  quint32 capacity       记录数 = 保留期限 / periodMs
+ * 偏移 20  quint32 recordSize     每条记录的字节数（40）
+ * 偏移 24  8字节保留
+ * 偏移 32  记录数组，每条 {qint64 startMs, double min, double max, double mean, quint32 count, quint32 保留}
+ * @endcode
+ * 起始时刻为t（UTC毫秒，按periodMs对齐）的记录位于第 (t / periodMs) % capacity 条；
+ * 读取时记录的startMs与期望值不符即视为空（从未写入或已超过保留期限被覆盖前的旧数据）。
+ */
+
+#ifndef ROLLUPARCHIVE_H
+#define ROLLUPARCHIVE_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+/**
+ * @struct RollupRecord
+ * @brief 一段时间内的汇总
+ */
+struct RollupRecord
+{
+    qint64 startMs = 0;     // 起始时刻（UTC毫秒）
+    double min = 0.0;       // 最小值
+    double max = 0.0;       // 最大值
+    double mean = 0.0;      // 均值
+    quint32 count = 0;      // 样本数，0表示空记录
+
+    /**
+     * @brief 加入一个样本
+     * @param value 样本值
+     */
+    void add(double value);
+
+    /**
+     * @brief 合并另一段汇总
+     * @param other 另一段汇总
+     */
+    void merge(const RollupRecord &other);
+};
+
+/**
+ * @struct RollupTier
+ * @brief 一个分辨率层级
+ */
+struct RollupTier
+{
+    QString name;               // 层级名称，作为文件扩展名
+    qint64 periodMs = 1000;     // 每条记录覆盖的时长
+    qint64 retentionMs = 0;     // 保留期限
+};
+
+/**
+ * @class RollupArchive
+ * @brief 多分辨率汇总归档
+ * @details 每个样本只更新各层级内存中的当前记录，跨过记录边界时写入一条定长记录；
+ *          查询按请求的分辨率选择满足要求的最粗层级，只读取该层级文件中对应的连续记录
+ */
+class RollupArchive
+{
+public:
+    static constexpr qint64 RAW_PERIOD_MS = 50;             // 原始层级的记录时长：20Hz采样时每条记录即一个样本
+    static constexpr qint64 FLUSH_INTERVAL_MS = 60000;      // 未结束的当前记录写入文件的间隔，异常退出最多丢失该时长
+
+    /**
+     * @brief 默认层级：原始数据保留1小时，1秒汇总保留2天，1分钟汇总保留90天，1小时汇总保留5年
+     * @return 按记录时长升序的层级
+     */
+    static QVector<RollupTier> defaultTiers();
+
+    /**
+     * @brief 构造函数
+     */
+    RollupArchive();
+
+    /**
+     * @brief 析构函数，写入未结束的当前记录
+     */
+    ~RollupArchive();
+
+    RollupArchive(const RollupArchive &) = delete;
+    RollupArchive &operator=(const RollupArchive &) = delete;
+
+    /**
+     * @brief 打开归档目录
+     * @param directory 归档目录，不存在时创建
+     * @param tiers 层级，按记录时长升序
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否打开成功
+     */
+    bool open(const QString &directory, const QVector<RollupTier> &tiers = defaultTiers(), QString *errorString = nullptr);
+
+    /**
+     * @brief 写入全部未结束的当前记录并关闭文件
+     */
+    void close();
+
+    /**
+     * @brief 是否已打开
+     * @return 是否已打开
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief 获取层级
+     * @return 按记录时长升序的层级
+     */
+    const QVector<RollupTier> &tiers() const;
+
+    /**
+     * @brief 打开（必要时创建）一个通道的层级文件
+     * @param name 通道名称，作为文件名
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 通道句柄，失败时返回-1
+     */
+    int channel(const QString &name, QString *errorString = nullptr);
+
+    /**
+     * @brief 查找已打开的通道
+     * @param name 通道名称
+     * @return 通道句柄，未打开时返回-1
+     */
+    int findChannel(const QString &name) const;
+
+    /**
+     * @brief 加入一个样本
+     * @param channel 通道句柄
+     * @param value 样本值
+     * @param timestampMs 采样时刻（UTC毫秒）
+     * @details 时刻早于当前记录（系统时钟回拨）时计入当前记录
+     */
+    void addSample(int channel, double value, qint64 timestampMs);
+
+    /**
+     * @brief 写入全部未结束的当前记录
+     */
+    void flush();
+
+    /**
+     * @brief 选择满足分辨率要求的最粗层级
+     * @param resolutionMs 请求的分辨率
+     * @return 记录时长不超过resolutionMs的最粗层级；都不满足时返回最细层级
+     */
+    int tierForResolution(qint64 resolutionMs) const;
+
+    /**
+     * @brief 查询一段时间的汇总
+     * @param channel 通道句柄
+     * @param fromMs 起始时刻（UTC毫秒，含）
+     * @param toMs 结束时刻（UTC毫秒，不含）
+     * @param resolutionMs 请求的分辨率，结果按该时长对齐合并（不细于所选层级）
+     * @param tierIndex 输出实际读取的层级，可为nullptr
+     * @return 按时间升序的非空汇总
+     */
+    QVector<RollupRecord> query(int channel, qint64 fromMs, qint64 toMs, qint64 resolutionMs, int *tierIndex = nullptr);
+
+private:
+    /**
+     * @struct TierFile
+     * @brief 一个通道的一个层级
+     */
+    struct TierFile
+    {
+        QFile file;                 // 层级文件
+        qint64 periodMs = 0;        // 记录时长
+        quint32 capacity = 0;       // 记录数
+        RollupRecord current;       // 未结束的当前记录
+        bool resumed = false;       // 当前记录是否已与文件中同一时段的记录（上次运行写入）合并
+    };
+
+    /**
+     * @struct Channel
+     * @brief 一个通道
+     */
+    struct Channel
+    {
+        QString name;
+        std::vector<std::unique_ptr<TierFile>> tiers;
+        qint64 lastFlushMs = 0;     // 上次写入当前记录的时刻
+    };
+
+    /**
+     * @brief 打开或创建层级文件，布局不符时重建
+     * @param tier 层级文件
+     * @param path 文件路径
+     * @param errorString 失败时的错误描述
+     * @return 是否成功
+     */
+    static bool openTierFile(TierFile &tier, const QString &path, QString *errorString);
+
+    /**
+     * @brief 读取一段连续记录
+     * @param tier 层级文件
+     * @param firstSlot 起始记录序号
+     * @param count 记录数（不跨越文件末尾）
+     * @return 记录的原始字节
+     */
+    static QByteArray readSlots(TierFile &tier, quint32 firstSlot, quint32 count);
+
+    /**
+     * @brief 读取起始时刻为startMs的记录
+     * @param tier 层级文件
+     * @param startMs 起始时刻
+     * @param record 输出记录
+     * @return 文件中是否有该时段的记录
+     */
+    static bool readRecord(TierFile &tier, qint64 startMs, RollupRecord *record);
+
+    /**
+     * @brief 写入一条记录
+     * @param tier 层级文件
+     * @param record 记录
+     */
+    static void writeRecord(TierFile &tier, const RollupRecord &record);
+
+    QString m_directory;                            // 归档目录
+    QVector<RollupTier> m_tiers;                    // 层级
+    std::vector<std::unique_ptr<Channel>> m_channels;   // 已打开的通道
+    QHash<QString, int> m_channelIndex;             // 通道名称 -> 句柄
+    bool m_open;                                    // 是否已打开
+};
+
+#endif // ROLLUPARCHIVE_H
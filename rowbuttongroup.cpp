@@ -10,10 +10,11 @@
 #include "mainwindow.h"
 #include "modbusmanager.h"
 #include "styles.h"
+#include "loadsolver.h"
 #include <QDebug>
 #include <QTimer>
+#include <QStyle>
 #include <QLocale>
-#include <limits.h>
 
 /**
  * @brief 构造函数
@@ -21,7 +22,7 @@
  * @details 初始化成员变量，创建编辑计时器并设置信号槽连接
  */
 RowButtonGroup::RowButtonGroup(QObject *parent)
-    : QObject(parent), lineEdit(nullptr), m_isUpdating(false), isEditing(false)
+    : QObject(parent), state(nullptr), lineEdit(nullptr), model(nullptr), solverMode(LoadSolver::MinStepTable::MinimumSteps), m_isUpdating(false), isEditing(false)
 {
     recentlyChangedRegisters.clear();
     
@@ -35,41 +36,36 @@ RowButtonGroup::RowButtonGroup(QObject *parent)
 
 /**
  * @brief 初始化行按钮组
- * @param btn0_1 0.1按钮
- * @param btn0_2 0.2按钮
- * @param btn0_2_2 第二个0.2按钮
- * @param btn0_5 0.5按钮
- * @param btn1 1.0按钮
- * @param btn2 2.0按钮
- * @param btn2_2 第二个2.0按钮
- * @param btn5 5.0按钮
+ * @param buttons 档位按钮数组（可少于档位数，多出的档位只能通过文本框设置）
  * @param lineEdit 显示总和的文本框
  * @param mainWindow 主窗口指针
  * @param rowIndex 行索引
- * @param address Modbus寄存器地址
- * @details 初始化按钮列表、对应数值、按钮状态，并连接信号槽
+ * @param model 负载柜数据模型，持有本行的状态和档位配置
+ * @details 初始化按钮列表、对应数值，生成最少档位查找表，连接信号槽，并订阅模型中本行的状态变化
  */
-void RowButtonGroup::initialize(QPushButton *btn0_1, QPushButton *btn0_2, QPushButton *btn0_2_2,
-                               QPushButton *btn0_5, QPushButton *btn1, QPushButton *btn2,
-                               QPushButton *btn2_2, QPushButton *btn5, QLineEdit *lineEdit, MainWindow *mainWindow, int rowIndex, int address)
+void RowButtonGroup::initialize(const QVector<QPushButton*> &buttons, QLineEdit *lineEdit, MainWindow *mainWindow,
+                               int rowIndex, LoadBankModel *model)
 {
-    buttons = {btn0_1, btn0_2, btn0_2_2, btn0_5, btn1, btn2, btn2_2, btn5};
-
-    values = {0.1, 0.2, 0.2, 0.5, 1.0, 2.0, 2.0, 5.0};
-
-    states.resize(buttons.size(), false);
-
+    this->buttons = buttons;
+    this->model = model;
     this->lineEdit = lineEdit;
     this->mainWindow = mainWindow;
     this->rowIndex = rowIndex;
-    this->registerAddress = address;
+
+    applyRowConfig();
 
     for (int i = 0; i < buttons.size(); ++i) {
+        buttons[i]->setProperty(Styles::STEP_BUTTON_PROPERTY, true);
+        buttons[i]->setProperty(Styles::SELECTED_PROPERTY, false);
         connect(buttons[i], &QPushButton::clicked, this, &RowButtonGroup::onButtonClicked);
     }
+    appliedState = RelayState();
 
     connect(lineEdit, &QLineEdit::textChanged, this, &RowButtonGroup::onLineEditTextChanged);
 
+    connect(model, &LoadBankModel::rowStateChanged, this, &RowButtonGroup::onModelRowStateChanged);
+    connect(model, &LoadBankModel::modelReset, this, &RowButtonGroup::onModelReset);
+
     connect(lineEdit, &QLineEdit::selectionChanged, this, [this, rowIndex]() {
         isEditing = true;
         editTimer->start(2000);
@@ -89,8 +85,7 @@ void RowButtonGroup::initialize(QPushButton *btn0_1, QPushButton *btn0_2, QPushB
 
 /**
  * @brief 按钮点击事件处理函数
- * @details 处理按钮点击事件，切换按钮状态，更新UI和显示，并将状态写入Modbus寄存器
- *          仅处理第一行按钮(rowIndex == 0)，使用寄存器高8位存储按钮状态
+ * @details 处理按钮点击事件，切换按钮状态，更新UI和显示，并通过模型将状态写入Modbus寄存器
  */
 void RowButtonGroup::onButtonClicked()
 {
@@ -104,75 +99,128 @@ void RowButtonGroup::onButtonClicked()
     int index = buttons.indexOf(button);
     qDebug() << "按钮索引:" << index << "按钮数量:" << buttons.size();
     
-    if (index != -1 && index < 8) {
-        states[index] = !states[index];
-        applyButtonStatesToUI();
-        updateSumDisplay();
+    if (index != -1 && index < values.size()) {
+        RelayState next = *state;
+        next.toggle(index);
+        model->setRowState(rowIndex, next);
         
-        qDebug() << "按钮状态更新成功 - rowIndex:" << rowIndex << "registerAddress:" << registerAddress;
+        qDebug() << "按钮状态更新成功 - rowIndex:" << rowIndex << "准备写入寄存器" << registerAddresses;
         
-        if (rowIndex == 0) {
-                qDebug() << "正在处理第一行按钮，准备写入寄存器" << registerAddress;
-                
-                mainWindow->pauseRefreshTimer();
-                
-                int registerValue = 0;
-                for (int i = 0; i < 8; ++i) {
-                    registerValue |= (states[i] ? 1 : 0) << (8 + i);
-                }
-                
-                recentlyChangedRegisters.insert(registerAddress);
-                
-                qDebug() << "按钮状态编码完成，准备读取寄存器低8位 - registerValue:" << registerValue;
-                
-                if (!ModbusManager::instance()->isStable()) {
-                    qDebug() << "Modbus连接尚未稳定，等待后再尝试操作";
-                    recentlyChangedRegisters.remove(registerAddress);
-                    mainWindow->resumeRefreshTimer();
-                    return;
-                }
-                
-                ModbusManager::instance()->readRegister(registerAddress, [this, registerValue](int lowValue) {
-                    qDebug() << "读取寄存器回调 - lowValue:" << lowValue << "registerValue:" << registerValue;
-                    if (lowValue != -1) {
-                        int newValue = (lowValue & 0x00FF) | (registerValue & 0xFF00);
-                        
-                        qDebug() << "准备写入寄存器 - 地址:" << registerAddress << "新值:" << newValue;
-                        
-                        ModbusManager::instance()->writeRegister(registerAddress, newValue);
-                        
-                        recentlyChangedRegisters.remove(registerAddress);
-                        qDebug() << "清理缓冲区 - registerAddress:" << registerAddress;
-                        
-                        this->mainWindow->resumeRefreshTimer();
-                    } else {
-                        qDebug() << "读取寄存器失败，lowValue为-1";
-                        recentlyChangedRegisters.remove(registerAddress);
-                        this->mainWindow->resumeRefreshTimer();
-                    }
-                });
-        } else {
-            qDebug() << "行" << rowIndex << "的按钮点击暂未实现";
+        mainWindow->pauseRefreshTimer();
+        
+        for (int address : registerAddresses) {
+            recentlyChangedRegisters.insert(address);
         }
+        
+        // 连接未稳定时写入会失败，模型保留本行意图，待重新同步后补发
+        writeStatesToRegisters([this]() {
+            recentlyChangedRegisters.clear();
+            qDebug() << "清理缓冲区 - registerAddresses:" << registerAddresses;
+            
+            this->mainWindow->resumeRefreshTimer();
+        }, Q_UINT64_C(1) << index);
     } else {
         qDebug() << "按钮索引无效或超出范围 - index:" << index;
     }
 }
 
+/**
+ * @brief 将当前按钮状态写入寄存器
+ * @param onFinished 全部寄存器处理完成后的回调，可为空
+ * @param changedMask 状态发生变化的档位位掩码，不含变化档位的寄存器不会被写入
+ * @details 通过模型提交本行当前状态：模型基于寄存器缓存只替换属于档位的位，保留其余位（如低8位）不变，
+ *          并记录写入意图，总线断开或写入失败时由重新同步补发
+ */
+void RowButtonGroup::writeStatesToRegisters(std::function<void()> onFinished, quint64 changedMask)
+{
+    RowCommit commit;
+    commit.row = rowIndex;
+    commit.mask = stateMask();
+    commit.changedMask = changedMask;
+
+    qDebug() << "行" << rowIndex << "提交按钮状态 - 档位位:" << commit.mask << "变化位:" << changedMask;
+
+    model->commitRows({commit}, ModbusManager::NormalPriority, [this, onFinished](bool ok) {
+        if (!ok) {
+            qDebug() << "行" << rowIndex << "寄存器写入失败，待重新同步后补发";
+        }
+        if (onFinished) onFinished();
+    });
+}
+
+/**
+ * @brief 获取当前按钮状态的位掩码
+ * @return 位掩码，第i位对应第i个档位
+ */
+quint64 RowButtonGroup::stateMask() const
+{
+    return state->bits();
+}
+
+/**
+ * @brief 从模型读取本行的档位配置
+ * @details 初始化和配置热加载时调用
+ */
+void RowButtonGroup::applyRowConfig()
+{
+    rowConfig = model->config().row(rowIndex);
+
+    values.clear();
+    for (const LoadStep &step : rowConfig.steps) {
+        values.append(step.value);
+    }
+
+    state = model->rowState(rowIndex);
+    solver = LoadSolver::MinStepTable(rowConfig.stepUnits());
+
+    if (buttons.size() < values.size()) {
+        qDebug() << "行" << rowIndex << "档位数" << values.size() << "多于按钮数" << buttons.size()
+                 << "，多出的档位仅能通过文本框设置";
+    }
+
+    registerAddresses = rowConfig.registerAddresses();
+    registerAddress = registerAddresses.isEmpty() ? -1 : registerAddresses.first();
+}
+
+/**
+ * @brief 模型重新加载配置的处理函数
+ * @details 档位定义和寄存器位置可能已变化，重建本行的求解表并刷新显示
+ */
+void RowButtonGroup::onModelReset()
+{
+    applyRowConfig();
+    recentlyChangedRegisters.clear();
+
+    m_isUpdating = true;
+    applyButtonStatesToUI();
+    updateSumDisplay();
+    m_isUpdating = false;
+}
+
+/**
+ * @brief 模型中某行状态变化的处理函数
+ * @param row 行索引
+ * @details 只处理本行；本组自身正在更新时（如文本框求解过程中）跳过，避免覆盖用户正在输入的文本
+ */
+void RowButtonGroup::onModelRowStateChanged(int row)
+{
+    if (row != rowIndex || m_isUpdating) return;
+    
+    m_isUpdating = true;
+    applyButtonStatesToUI();
+    updateSumDisplay();
+    m_isUpdating = false;
+}
+
 /**
  * @brief 更新总和显示
- * @details 计算所有选中按钮的数值总和，并更新到文本框中显示
+ * @details 通过档位之和表查出选中档位的总和，并更新到文本框中显示
  */
 void RowButtonGroup::updateSumDisplay()
 {
     if (!lineEdit) return;
 
-    double sum = 0.0;
-    for (int i = 0; i < states.size(); ++i) {
-        if (states[i]) {
-            sum += values[i];
-        }
-    }
+    double sum = static_cast<double>(model->rowUnits(rowIndex)) / LoadSolver::UNITS_PER_VALUE;
 
     bool wasUpdating = m_isUpdating;
     
@@ -181,31 +229,42 @@ void RowButtonGroup::updateSumDisplay()
     QLocale locale;
     locale.setNumberOptions(QLocale::OmitGroupSeparator);
     
-    lineEdit->setText(locale.toString(sum, 'f', 1));
+    QString text = locale.toString(sum, 'f', 1);
+    if (lineEdit->text() != text) {
+        lineEdit->setText(text);
+    }
     
     m_isUpdating = wasUpdating;
 }
 
 /**
  * @brief 应用按钮状态到UI
- * @details 根据按钮状态设置按钮的样式，选中的按钮使用选中样式，未选中的按钮使用未选中样式
+ * @details 与上次应用到界面的状态比较，只修改状态发生翻转的按钮的selected属性并重新polish，
+ *          状态未变化时不触碰任何按钮
  */
 void RowButtonGroup::applyButtonStatesToUI()
 {
-    for (int i = 0; i < buttons.size(); ++i) {
-        if (states[i]) {
-            buttons[i]->setStyleSheet(Styles::BUTTON_SELECTED_STYLE);
-        } else {
-            buttons[i]->setStyleSheet(Styles::BUTTON_UNSELECTED_STYLE);
-        }
+    quint64 changed = state->changedFrom(appliedState).bits();
+    
+    while (changed) {
+        int i = qCountTrailingZeroBits(changed);
+        changed &= changed - 1;
+        if (i >= buttons.size()) break;
+        
+        QPushButton *button = buttons[i];
+        button->setProperty(Styles::SELECTED_PROPERTY, state->test(i));
+        button->style()->unpolish(button);
+        button->style()->polish(button);
     }
+    
+    appliedState = *state;
 }
 
 /**
  * @brief 文本框内容变化事件处理函数
  * @param text 文本框的新内容
- * @details 处理文本框输入事件，根据输入的数值自动选择对应的按钮组合，并将结果写入Modbus寄存器
- *          仅处理第一行(rowIndex == 0)，支持0.0-10.0的数值范围
+ * @details 处理文本框输入事件，根据输入的数值自动选择对应的按钮组合，并将结果写入Modbus寄存器，
+ *          支持0.0到全部档位之和的数值范围
  */
 void RowButtonGroup::onLineEditTextChanged(const QString &text)
 {
@@ -217,16 +276,14 @@ void RowButtonGroup::onLineEditTextChanged(const QString &text)
 
     if (m_isUpdating || !lineEdit) return;
 
-    if (rowIndex != 0) {
-        qDebug() << "行" << rowIndex << "的文本编辑暂未实现";
-        return;
-    }
-
     QLocale locale;
     bool ok;
     double sum = locale.toDouble(text, &ok);
+    double maxSum = static_cast<double>(solver.maxUnits()) / LoadSolver::UNITS_PER_VALUE;
 
-    if (ok && sum >= 0.0 && sum <= 10.0) {
+    if (ok && sum >= 0.0 && sum <= maxSum) {
+        quint64 previousMask = stateMask();
+        
         m_isUpdating = true;
         
         solveButtonStates(sum);
@@ -235,20 +292,18 @@ void RowButtonGroup::onLineEditTextChanged(const QString &text)
         
         m_isUpdating = false;
         
-        int registerValue = 0;
-        for (int i = 0; i < 8; ++i) {
-            registerValue |= (states[i] ? 1 : 0) << (8 + i);
+        quint64 changedMask = previousMask ^ stateMask();
+        if (changedMask == 0) {
+            solverMetrics.skippedWrites++;
+            qDebug() << "行" << rowIndex << "继电器状态未变化，跳过寄存器写入";
+            return;
         }
         
-        recentlyChangedRegisters.insert(registerAddress);
+        for (int address : registerAddresses) {
+            recentlyChangedRegisters.insert(address);
+        }
         
-        ModbusManager::instance()->readRegister(registerAddress, [this, registerValue](int lowValue) {
-            if (lowValue != -1) {
-                int newValue = (lowValue & 0x00FF) | (registerValue & 0xFF00);
-                
-                ModbusManager::instance()->writeRegister(registerAddress, newValue);
-            }
-        });
+        writeStatesToRegisters(nullptr, changedMask);
         
         QTimer::singleShot(2000, this, [this]() {
             recentlyChangedRegisters.clear();
@@ -257,21 +312,17 @@ void RowButtonGroup::onLineEditTextChanged(const QString &text)
     else if (text.isEmpty()) {
         m_isUpdating = true;
         
-        states.fill(false);
+        model->setRowState(rowIndex, RelayState());
         
         applyButtonStatesToUI();
         
         m_isUpdating = false;
         
-        recentlyChangedRegisters.insert(registerAddress);
+        for (int address : registerAddresses) {
+            recentlyChangedRegisters.insert(address);
+        }
         
-        ModbusManager::instance()->readRegister(registerAddress, [this](int lowValue) {
-            if (lowValue != -1) {
-                int newValue = (lowValue & 0x00FF) | 0x0000;
-                
-                ModbusManager::instance()->writeRegister(registerAddress, newValue);
-            }
-        });
+        writeStatesToRegisters(nullptr);
         
         QTimer::singleShot(2000, this, [this]() {
             recentlyChangedRegisters.clear();
@@ -282,61 +333,43 @@ void RowButtonGroup::onLineEditTextChanged(const QString &text)
 /**
  * @brief 求解按钮组合
  * @param targetSum 目标总和
- * @details 使用递归回溯法求解最小组合，使得选中的按钮数值总和等于目标值
+ * @details 在查找表中求出满足目标值的组合（默认8档使用编译期查找表，其他档位配置使用加载时动态规划生成的查找表），
+ *          MinimumToggles模式下优先保留当前已闭合的继电器。目标值按0.1四舍五入，不可达时清空所有按钮
  */
 void RowButtonGroup::solveButtonStates(double targetSum)
 {
-    QVector<int> intValues;
-    for (double v : values) {
-        intValues.append(static_cast<int>(v * 10));
-    }
+    const int targetUnits = LoadSolver::toUnits(targetSum);
+    const quint64 previousMask = stateMask();
 
-    int target = static_cast<int>(targetSum * 10);
-    
-    QVector<bool> bestUsed;
-    int bestCount = INT_MAX;
-
-    QVector<bool> used(values.size(), false);
-    solveCombinations(target, intValues, 0, used, bestUsed, bestCount);
+    quint64 mask = 0;
+    if (!solver.solve(solverMode, targetUnits, previousMask, &mask)) {
+        model->setRowState(rowIndex, RelayState());
+        return;
+    }
 
-    if (bestCount != INT_MAX) {
-        states = bestUsed;
-    } else {
-        states.fill(false);
+    // 统计继电器动作次数，以及相对最少档位解节省的动作次数
+    int toggles = RelayState(mask).changedFrom(RelayState(previousMask)).count();
+    solverMetrics.solveCount++;
+    solverMetrics.relayOperations += toggles;
+    if (solverMode == LoadSolver::MinStepTable::MinimumToggles) {
+        quint64 minStepMask = 0;
+        solver.solve(targetUnits, &minStepMask);
+        int saved = RelayState(minStepMask).changedFrom(RelayState(previousMask)).count() - toggles;
+        solverMetrics.relayOperationsSaved += saved;
+        if (saved > 0) {
+            qDebug() << "行" << rowIndex << "最少切换求解节省继电器动作" << saved << "次，累计节省"
+                     << solverMetrics.relayOperationsSaved << "次";
+        }
     }
+
+    model->setRowState(rowIndex, RelayState(mask));
 }
 
 /**
- * @brief 递归求解组合
- * @param target 目标值(放大10倍的整数值)
- * @param values 按钮数值数组(放大10倍的整数值)
- * @param index 当前处理的索引
- * @param used 当前使用状态
- * @param bestUsed 最优解使用状态
- * @param bestCount 最优解按钮数量
- * @details 递归回溯算法，尝试所有可能的按钮组合，找到按钮数量最少的组合
+ * @brief 设置求解模式
+ * @param mode 求解模式
  */
-void RowButtonGroup::solveCombinations(int target, const QVector<int> &values, int index, QVector<bool> &used, QVector<bool> &bestUsed, int &bestCount)
+void RowButtonGroup::setSolverMode(LoadSolver::MinStepTable::Mode mode)
 {
-    if (target == 0) {
-        int currentCount = 0;
-        for (bool b : used) {
-            if (b) currentCount++;
-        }
-        
-        if (currentCount < bestCount) {
-            bestCount = currentCount;
-            bestUsed = used;
-        }
-        return;
-    }
-
-    if (index >= values.size() || target < 0) {
-        return;
-    }
-
-    used[index] = true;
-    solveCombinations(target - values[index], values, index + 1, used, bestUsed, bestCount);
-    used[index] = false;
-    solveCombinations(target, values, index + 1, used, bestUsed, bestCount);
+    solverMode = mode;
 }
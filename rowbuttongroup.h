@@ -12,9 +12,28 @@
 #include <QLineEdit>
 #include <QVector>
 #include <QTimer>
+#include <QSet>
+#include <functional>
+
+#include "loadbankconfig.h"
+#include "loadsolver.h"
+#include "relaystate.h"
+#include "loadbankmodel.h"
 
 class MainWindow;
 
+/**
+ * @struct SolverMetrics
+ * @brief 求解与继电器动作统计
+ */
+struct SolverMetrics
+{
+    quint64 solveCount = 0;             // 求解次数
+    quint64 relayOperations = 0;        // 继电器动作总次数
+    qint64 relayOperationsSaved = 0;    // 相对最少档位解节省的继电器动作次数
+    quint64 skippedWrites = 0;          // 因状态未变化而跳过的寄存器写入次数
+};
+
 /**
  * @class RowButtonGroup
  * @brief 行按钮组管理类
@@ -33,33 +52,47 @@ public:
 
     /**
      * @brief 初始化行按钮组
-     * @param btn0_1 0.1按钮
-     * @param btn0_2 0.2按钮
-     * @param btn0_2_2 0.2-2按钮
-     * @param btn0_5 0.5按钮
-     * @param btn1 1按钮
-     * @param btn2 2按钮
-     * @param btn2_2 2-2按钮
-     * @param btn5 5按钮
+     * @param buttons 档位按钮数组
      * @param lineEdit 文本框
      * @param mainWindow 主窗口指针
      * @param rowIndex 行索引
-     * @param address 寄存器地址
+     * @param model 负载柜数据模型（持有本行的状态和档位配置）
      */
-    void initialize(QPushButton *btn0_1, QPushButton *btn0_2, QPushButton *btn0_2_2,
-                   QPushButton *btn0_5, QPushButton *btn1, QPushButton *btn2,
-                   QPushButton *btn2_2, QPushButton *btn5, QLineEdit *lineEdit, MainWindow *mainWindow, int rowIndex, int address);
+    void initialize(const QVector<QPushButton*> &buttons, QLineEdit *lineEdit, MainWindow *mainWindow,
+                   int rowIndex, LoadBankModel *model);
 
 public:
-    QVector<bool> states;                   // 按钮状态数组
+    const RelayState *state;                // 按钮状态位图（指向模型中的共享状态数组，通过模型修改）
     QLineEdit *lineEdit;                    // 文本框指针
     QSet<int> recentlyChangedRegisters;     // 跟踪最近修改的寄存器地址
-    int registerAddress;                    // 寄存器地址
+    int registerAddress;                    // 第一个寄存器地址
+    QVector<int> registerAddresses;         // 本行涉及的全部寄存器地址
     
     /**
      * @brief 将按钮状态应用到UI
      */
     void applyButtonStatesToUI(); 
+    
+    /**
+     * @brief 将当前按钮状态通过模型写入寄存器（保留非档位位，记录写入意图）
+     * @param onFinished 全部寄存器处理完成后的回调，可为空
+     * @param changedMask 状态发生变化的档位位掩码，默认写入全部寄存器
+     */
+    void writeStatesToRegisters(std::function<void()> onFinished, quint64 changedMask = ~Q_UINT64_C(0));
+    
+    /**
+     * @brief 设置求解模式
+     * @param mode MinimumSteps为档位最少，MinimumToggles为相对当前状态切换最少
+     */
+    void setSolverMode(LoadSolver::MinStepTable::Mode mode);
+    
+    SolverMetrics solverMetrics;            // 求解与继电器动作统计
+    
+    /**
+     * @brief 获取当前按钮状态的位掩码
+     * @return 位掩码
+     */
+    quint64 stateMask() const;
 
 private slots:
     /**
@@ -72,28 +105,38 @@ private slots:
      * @param text 新的文本内容
      */
     void onLineEditTextChanged(const QString &text);
+    
+    /**
+     * @brief 模型中某行状态变化的处理函数
+     * @param row 行索引
+     */
+    void onModelRowStateChanged(int row);
+
+    /**
+     * @brief 模型重新加载配置的处理函数
+     */
+    void onModelReset();
 
 private:
     QVector<QPushButton*> buttons;          // 按钮数组
     QVector<double> values;                 // 按钮对应的值数组
     MainWindow *mainWindow;                 // 主窗口指针
+    LoadBankModel *model;                   // 负载柜数据模型
+    LoadBankRow rowConfig;                  // 本行档位配置
+    LoadSolver::MinStepTable solver;        // 最少档位查找表
+    LoadSolver::MinStepTable::Mode solverMode;  // 求解模式
+    RelayState appliedState;                // 上次应用到按钮样式的状态
+
+    /**
+     * @brief 从模型读取本行的档位配置
+     */
+    void applyRowConfig();
 
     /**
      * @brief 根据目标和值求解按钮状态
      * @param targetSum 目标和值
      */
     void solveButtonStates(double targetSum);
-    
-    /**
-     * @brief 求解组合问题
-     * @param target 目标值
-     * @param values 可用值数组
-     * @param index 当前索引
-     * @param used 当前使用状态
-     * @param bestUsed 最佳使用状态
-     * @param bestCount 最佳使用数量
-     */
-    void solveCombinations(int target, const QVector<int> &values, int index, QVector<bool> &used, QVector<bool> &bestUsed, int &bestCount);
 
 public:
     bool m_isUpdating;                      // 是否正在更新
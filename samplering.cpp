@@ -0,0 +1,289 @@
+/**
+ * @file samplering.cpp
+ * @brief 共享内存电压样本环形缓冲区实现文件
+ * @details 包含SampleRingWriter和SampleRingReader类的实现
+ */
+
+#include "samplering.h"
+#include <QtMath>
+#include <QDebug>
+#include <new>
+
+using namespace SampleRingLayout;
+
+constexpr quint32 SampleRingWriter::DEFAULT_CAPACITY;
+
+/**
+ * @brief 构造函数
+ */
+SampleRingWriter::SampleRingWriter()
+    : m_header(nullptr)
+    , m_slots(nullptr)
+    , m_mask(0)
+{
+}
+
+/**
+ * @brief 析构函数，分离共享内存
+ */
+SampleRingWriter::~SampleRingWriter()
+{
+    if (m_memory.isAttached()) {
+        m_memory.detach();
+    }
+}
+
+/**
+ * @brief 创建共享内存并初始化头部
+ * @param key 共享内存键
+ * @param capacity 槽位数，向上取整为2的幂
+ * @param clockEpochMs 时间戳为0时对应的UTC毫秒数
+ * @param errorString 失败时的错误描述
+ * @return 是否创建成功
+ */
+bool SampleRingWriter::create(const QString &key, quint32 capacity, qint64 clockEpochMs, QString *errorString)
+{
+    if (m_memory.isAttached()) {
+        m_memory.detach();
+    }
+    m_header = nullptr;
+    m_slots = nullptr;
+
+    const quint32 slotCount = qNextPowerOfTwo(qMax<quint32>(capacity, 2) - 1);
+    const int size = byteSize(slotCount);
+
+    m_memory.setKey(key);
+    if (!m_memory.create(size)) {
+        // 上次异常退出残留的共享内存：没有其他进程映射时，映射后分离即被系统回收
+        if (m_memory.error() == QSharedMemory::AlreadyExists && m_memory.attach()) {
+            m_memory.detach();
+        }
+        if (!m_memory.create(size)) {
+            if (errorString) *errorString = m_memory.errorString();
+            qWarning() << "样本共享内存创建失败:" << key << m_memory.errorString();
+            return false;
+        }
+    }
+
+    char *base = static_cast<char *>(m_memory.data());
+    Slot *slotArray = reinterpret_cast<Slot *>(base + sizeof(Header));
+    for (quint32 i = 0; i < slotCount; ++i) {
+        Slot *slot = new (slotArray + i) Slot;
+        slot->marker.store(0, std::memory_order_relaxed);
+        slot->timestampMs.store(0, std::memory_order_relaxed);
+        slot->value.store(0.0, std::memory_order_relaxed);
+    }
+
+    Header *header = new (base) Header;
+    header->version = VERSION;
+    header->capacity = slotCount;
+    header->slotSize = sizeof(Slot);
+    header->clockEpochMs = clockEpochMs;
+    header->published.store(0, std::memory_order_relaxed);
+    // magic最后写入：读者看到magic时其余字段已初始化完毕
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = MAGIC;
+
+    m_header = header;
+    m_slots = slotArray;
+    m_mask = slotCount - 1;
+    qDebug() << "样本共享内存已创建:" << m_memory.nativeKey() << "槽位数" << slotCount;
+    return true;
+}
+
+/**
+ * @brief 是否已创建
+ * @return 共享内存是否可写
+ */
+bool SampleRingWriter::isValid() const
+{
+    return m_header != nullptr;
+}
+
+/**
+ * @brief 发布一个样本
+ * @param value 电压（V）
+ * @param timestampMs 单调时间戳（毫秒）
+ */
+void SampleRingWriter::publish(double value, qint64 timestampMs)
+{
+    if (!m_header) return;
+
+    // 只有一个写者，发布计数不需要读-改-写原子操作
+    const quint64 sequence = m_header->published.load(std::memory_order_relaxed);
+    Slot &slot = m_slots[sequence & m_mask];
+
+    slot.marker.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestampMs.store(timestampMs, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.marker.store(2 * sequence + 2, std::memory_order_release);
+
+    m_header->published.store(sequence + 1, std::memory_order_release);
+}
+
+/**
+ * @brief 平台相关的共享内存名称
+ * @return 非Qt进程打开共享内存时使用的名称
+ */
+QString SampleRingWriter::nativeKey() const
+{
+    return m_memory.nativeKey();
+}
+
+/**
+ * @brief 构造函数
+ */
+SampleRingReader::SampleRingReader()
+    : m_header(nullptr)
+    , m_slots(nullptr)
+    , m_mask(0)
+    , m_cursor(0)
+{
+}
+
+/**
+ * @brief 析构函数，分离共享内存
+ */
+SampleRingReader::~SampleRingReader()
+{
+    if (m_memory.isAttached()) {
+        m_memory.detach();
+    }
+}
+
+/**
+ * @brief 以只读方式映射共享内存
+ * @param key 共享内存键
+ * @param errorString 失败时的错误描述
+ * @return 是否映射成功且布局版本匹配
+ */
+bool SampleRingReader::attach(const QString &key, QString *errorString)
+{
+    auto fail = [this, errorString](const QString &message) {
+        if (m_memory.isAttached()) m_memory.detach();
+        m_header = nullptr;
+        m_slots = nullptr;
+        if (errorString) *errorString = message;
+        return false;
+    };
+
+    if (m_memory.isAttached()) {
+        m_memory.detach();
+    }
+    m_memory.setKey(key);
+    if (!m_memory.attach(QSharedMemory::ReadOnly)) {
+        return fail(m_memory.errorString());
+    }
+    if (m_memory.size() < int(sizeof(Header))) {
+        return fail("共享内存过小");
+    }
+
+    const char *base = static_cast<const char *>(m_memory.constData());
+    const Header *header = reinterpret_cast<const Header *>(base);
+    if (header->magic != MAGIC) {
+        return fail("共享内存尚未初始化或不是样本缓冲区");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->version != VERSION || header->slotSize != sizeof(Slot)) {
+        return fail(QString("样本缓冲区版本不匹配：%1").arg(int(header->version)));
+    }
+    if (header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0
+            || m_memory.size() < byteSize(header->capacity)) {
+        return fail("样本缓冲区头部无效");
+    }
+
+    m_header = header;
+    m_slots = reinterpret_cast<const Slot *>(base + sizeof(Header));
+    m_mask = header->capacity - 1;
+    m_cursor = header->published.load(std::memory_order_acquire);
+    return true;
+}
+
+/**
+ * @brief 是否已映射
+ * @return 是否可读
+ */
+bool SampleRingReader::isValid() const
+{
+    return m_header != nullptr;
+}
+
+/**
+ * @brief 时间戳为0时对应的UTC毫秒数
+ * @return UTC毫秒数
+ */
+qint64 SampleRingReader::clockEpochMs() const
+{
+    return m_header ? m_header->clockEpochMs : 0;
+}
+
+/**
+ * @brief 读取游标
+ * @return 下一个要读取的样本序号
+ */
+quint64 SampleRingReader::cursor() const
+{
+    return m_cursor;
+}
+
+/**
+ * @brief 设置读取游标
+ * @param sequence 下一个要读取的样本序号
+ */
+void SampleRingReader::seek(quint64 sequence)
+{
+    if (!m_header) return;
+    const quint64 published = m_header->published.load(std::memory_order_acquire);
+    const quint64 oldest = published > m_mask + 1 ? published - (m_mask + 1) : 0;
+    m_cursor = qBound(oldest, sequence, published);
+}
+
+/**
+ * @brief 读取游标之后的全部新样本
+ * @param callback 每个样本调用一次
+ * @param lost 因落后被覆盖而跳过的样本数
+ * @return 读取的样本数
+ * @details 直接读取共享内存中的槽位，每个样本只读一次marker前后两次校验，不加锁
+ */
+int SampleRingReader::readNew(const std::function<void(const RingSample &)> &callback, quint64 *lost)
+{
+    if (lost) *lost = 0;
+    if (!m_header) return 0;
+
+    const quint64 published = m_header->published.load(std::memory_order_acquire);
+    const quint64 capacity = m_mask + 1;
+    quint64 skipped = 0;
+
+    // 落后超过一圈的部分已全部被覆盖
+    if (published - m_cursor > capacity) {
+        skipped += published - capacity - m_cursor;
+        m_cursor = published - capacity;
+    }
+
+    int count = 0;
+    for (; m_cursor < published; ++m_cursor) {
+        const Slot &slot = m_slots[m_cursor & m_mask];
+        const quint64 expected = 2 * m_cursor + 2;
+
+        if (slot.marker.load(std::memory_order_acquire) != expected) {
+            ++skipped;
+            continue;
+        }
+        RingSample sample;
+        sample.sequence = m_cursor;
+        sample.timestampMs = slot.timestampMs.load(std::memory_order_relaxed);
+        sample.value = slot.value.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.marker.load(std::memory_order_relaxed) != expected) {
+            ++skipped;
+            continue;
+        }
+
+        callback(sample);
+        ++count;
+    }
+
+    if (lost) *lost = skipped;
+    return count;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file samplering.h
+ * @brief 共享内存电压样本环形缓冲区定义文件
+ * @details 包含SampleRingLayout、SampleRingWriter和SampleRingReader的声明。
+ *          单生产者、多消费者、无锁：主程序写入，其他本地进程映射同一块共享内存后直接读取新样本，
+ *          不经过套接字，也不复制整段窗口
+ *
+ * 共享内存布局（版本1，所有整数为本机字节序）：
+ * @code
+ * 偏移 0   quint32 magic          'LBSR'
+ * 偏移 4   quint32 version        1
+ * 偏移 8   quint32 capacity       槽位数，2的幂
+ * 偏移 12  quint32 slotSize       每个槽位的字节数（24）
+ * 偏移 16  qint64  clockEpochMs   时间戳为0时对应的UTC毫秒数
+ * 偏移 24  atomic<quint64> published   已发布的样本数，即下一个样本的序号
+ * 偏移 64  槽位数组，每槽 {atomic<quint64> marker, atomic<qint64> timestampMs, atomic<double> value}
+ * @endcode
+ * 序号为s的样本位于第 s & (capacity-1) 个槽位。写入时marker先置为2s+1，写完数据后置为2s+2；
+ * 读者读数据前后各读一次marker，两次都等于2s+2才说明读到的是完整的第s个样本，否则已被覆盖。
+ */
+
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include <QSharedMemory>
+#include <QString>
+#include <atomic>
+#include <functional>
+
+/**
+ * @namespace SampleRingLayout
+ * @brief 共享内存布局
+ */
+namespace SampleRingLayout
+{
+    constexpr quint32 MAGIC = 0x5253424C;       // 'LBSR'
+    constexpr quint32 VERSION = 1;
+    constexpr const char *DEFAULT_KEY = "loadbank-voltage-samples";
+
+    /**
+     * @struct Slot
+     * @brief 一个样本槽位
+     * @details 字段均为原子变量，读者与写者并发访问时没有数据竞争，被覆盖由marker检测
+     */
+    struct Slot
+    {
+        std::atomic<quint64> marker;        // 2s+1：正在写入第s个样本；2s+2：第s个样本已完整；0：空
+        std::atomic<qint64> timestampMs;    // 单调时间戳（毫秒）
+        std::atomic<double> value;          // 电压（V）
+    };
+
+    /**
+     * @struct Header
+     * @brief 缓冲区头部
+     */
+    struct Header
+    {
+        quint32 magic;
+        quint32 version;
+        quint32 capacity;
+        quint32 slotSize;
+        qint64 clockEpochMs;
+        std::atomic<quint64> published;
+        char padding[64 - 32];              // 槽位数组从新的缓存行开始，写者更新计数不影响读者读取槽位
+    };
+
+    static_assert(std::atomic<quint64>::is_always_lock_free, "共享内存中的原子变量必须无锁");
+    static_assert(std::atomic<double>::is_always_lock_free, "共享内存中的原子变量必须无锁");
+    static_assert(sizeof(Header) == 64, "头部占一个缓存行");
+    static_assert(sizeof(Slot) == 24, "槽位大小与布局说明一致");
+
+    /**
+     * @brief 计算共享内存大小
+     * @param capacity 槽位数
+     * @return 字节数
+     */
+    inline int byteSize(quint32 capacity)
+    {
+        return int(sizeof(Header) + capacity * sizeof(Slot));
+    }
+}
+
+/**
+ * @struct RingSample
+ * @brief 读者取到的一个样本
+ */
+struct RingSample
+{
+    quint64 sequence = 0;       // 序号，从0开始连续递增
+    qint64 timestampMs = 0;     // 单调时间戳（毫秒），加上clockEpochMs即为UTC时间
+    double value = 0.0;         // 电压（V）
+};
+
+/**
+ * @class SampleRingWriter
+ * @brief 共享内存环形缓冲区的写者（唯一生产者）
+ */
+class SampleRingWriter
+{
+public:
+    static constexpr quint32 DEFAULT_CAPACITY = 65536;  // 默认槽位数，20Hz采样约55分钟
+
+    /**
+     * @brief 构造函数
+     */
+    SampleRingWriter();
+
+    /**
+     * @brief 析构函数，分离共享内存
+     */
+    ~SampleRingWriter();
+
+    SampleRingWriter(const SampleRingWriter &) = delete;
+    SampleRingWriter &operator=(const SampleRingWriter &) = delete;
+
+    /**
+     * @brief 创建共享内存并初始化头部
+     * @param key 共享内存键
+     * @param capacity 槽位数，向上取整为2的幂
+     * @param clockEpochMs 时间戳为0时对应的UTC毫秒数
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否创建成功
+     */
+    bool create(const QString &key, quint32 capacity, qint64 clockEpochMs, QString *errorString = nullptr);
+
+    /**
+     * @brief 是否已创建
+     * @return 共享内存是否可写
+     */
+    bool isValid() const;
+
+    /**
+     * @brief 发布一个样本
+     * @param value 电压（V）
+     * @param timestampMs 单调时间戳（毫秒）
+     * @details 不加锁、不分配内存，只写一个槽位和发布计数
+     */
+    void publish(double value, qint64 timestampMs);
+
+    /**
+     * @brief 平台相关的共享内存名称
+     * @return 非Qt进程打开共享内存时使用的名称
+     */
+    QString nativeKey() const;
+
+private:
+    QSharedMemory m_memory;                 // 共享内存
+    SampleRingLayout::Header *m_header;     // 头部，未创建为nullptr
+    SampleRingLayout::Slot *m_slots;        // 槽位数组
+    quint64 m_mask;                         // 槽位索引掩码
+};
+
+/**
+ * @class SampleRingReader
+ * @brief 共享内存环形缓冲区的读者
+ * @details 每个读者自己维护读取游标，读者之间互不影响，也不会阻塞写者；
+ *          读者落后超过一圈时，被覆盖的样本计入丢失数后跳过
+ */
+class SampleRingReader
+{
+public:
+    /**
+     * @brief 构造函数
+     */
+    SampleRingReader();
+
+    /**
+     * @brief 析构函数，分离共享内存
+     */
+    ~SampleRingReader();
+
+    SampleRingReader(const SampleRingReader &) = delete;
+    SampleRingReader &operator=(const SampleRingReader &) = delete;
+
+    /**
+     * @brief 以只读方式映射共享内存
+     * @param key 共享内存键
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否映射成功且布局版本匹配
+     * @details 映射后游标位于最新样本之后，只读取此后发布的样本
+     */
+    bool attach(const QString &key = QString(SampleRingLayout::DEFAULT_KEY), QString *errorString = nullptr);
+
+    /**
+     * @brief 是否已映射
+     * @return 是否可读
+     */
+    bool isValid() const;
+
+    /**
+     * @brief 时间戳为0时对应的UTC毫秒数
+     * @return UTC毫秒数
+     */
+    qint64 clockEpochMs() const;
+
+    /**
+     * @brief 读取游标
+     * @return 下一个要读取的样本序号
+     */
+    quint64 cursor() const;
+
+    /**
+     * @brief 设置读取游标
+     * @param sequence 下一个要读取的样本序号，早于缓冲区中最旧样本时从最旧样本开始
+     */
+    void seek(quint64 sequence);
+
+    /**
+     * @brief 读取游标之后的全部新样本
+     * @param callback 每个样本调用一次
+     * @param lost 因落后被覆盖而跳过的样本数，可为nullptr
+     * @return 读取的样本数
+     */
+    int readNew(const std::function<void(const RingSample &)> &callback, quint64 *lost = nullptr);
+
+private:
+    QSharedMemory m_memory;                         // 共享内存
+    const SampleRingLayout::Header *m_header;       // 头部，未映射为nullptr
+    const SampleRingLayout::Slot *m_slots;          // 槽位数组
+    quint64 m_mask;                                 // 槽位索引掩码
+    quint64 m_cursor;                               // 下一个要读取的样本序号
+};
+
+#endif // SAMPLERING_H
@@ -0,0 +1,229 @@
+/**
+ * @file serialportwatcher.cpp
+ * @brief 串口后台发现实现文件
+ * @details 包含SerialPortEntry、SerialPortScanner和SerialPortWatcher类的实现
+ */
+
+#include "serialportwatcher.h"
+#include <QSerialPortInfo>
+#include <QFileSystemWatcher>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QDebug>
+
+constexpr int SerialPortScanner::SETTLE_DELAY_MS;
+constexpr int SerialPortScanner::POLL_INTERVAL_MS;
+
+/**
+ * @brief 生成下拉框提示文字
+ * @return 描述、VID:PID和串行号
+ */
+QString SerialPortEntry::toolTip() const
+{
+    QStringList parts;
+    if (!description.isEmpty()) parts << description;
+    if (hasUsbIds) {
+        parts << QString("%1:%2").arg(vendorId, 4, 16, QChar('0')).arg(productId, 4, 16, QChar('0'));
+    }
+    if (!serialNumber.isEmpty()) parts << QString("S/N %1").arg(serialNumber);
+    return parts.join("  ");
+}
+
+/**
+ * @brief 元数据是否相同
+ * @param other 另一个串口
+ * @return 是否相同
+ */
+bool SerialPortEntry::operator==(const SerialPortEntry &other) const
+{
+    return portName == other.portName
+        && systemLocation == other.systemLocation
+        && description == other.description
+        && manufacturer == other.manufacturer
+        && serialNumber == other.serialNumber
+        && hasUsbIds == other.hasUsbIds
+        && vendorId == other.vendorId
+        && productId == other.productId;
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+SerialPortScanner::SerialPortScanner(QObject *parent)
+    : QObject(parent)
+    , m_deviceWatcher(nullptr)
+    , m_settleTimer(nullptr)
+    , m_pollTimer(nullptr)
+{
+}
+
+/**
+ * @brief 在扫描线程中创建监视器并执行首次扫描
+ * @details 监视器和定时器必须在扫描线程中创建，其事件才在扫描线程处理
+ */
+void SerialPortScanner::start()
+{
+    m_settleTimer = new QTimer(this);
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(SETTLE_DELAY_MS);
+    connect(m_settleTimer, &QTimer::timeout, this, &SerialPortScanner::scan);
+
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(POLL_INTERVAL_MS);
+    connect(m_pollTimer, &QTimer::timeout, this, &SerialPortScanner::scan);
+
+    m_deviceWatcher = new QFileSystemWatcher(this);
+    connect(m_deviceWatcher, &QFileSystemWatcher::directoryChanged, m_settleTimer, qOverload<>(&QTimer::start));
+
+    if (watchDeviceDirectories()) {
+        qDebug() << "串口热插拔监视:" << m_deviceWatcher->directories();
+    } else {
+        m_pollTimer->start();
+        qDebug() << "串口热插拔监视不可用，每" << POLL_INTERVAL_MS << "ms扫描一次";
+    }
+
+    scan();
+}
+
+/**
+ * @brief 监视设备目录
+ * @return 是否至少监视了一个目录
+ * @details udev新增或移除ttyUSB/ttyACM节点时/dev目录变化；/dev/serial/by-id在第一个USB串口出现时才创建，
+ *          因此每次扫描后都尝试补充监视
+ */
+bool SerialPortScanner::watchDeviceDirectories()
+{
+#if defined(Q_OS_UNIX)
+    static const char *const directories[] = {"/dev", "/dev/serial/by-id"};
+    const QStringList watched = m_deviceWatcher->directories();
+    for (const char *directory : directories) {
+        const QString path = QString::fromLatin1(directory);
+        if (!watched.contains(path) && QDir(path).exists()) {
+            m_deviceWatcher->addPath(path);
+        }
+    }
+    return !m_deviceWatcher->directories().isEmpty();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 立即重新扫描
+ * @details 与上次结果比较：消失的端口发出portRemoved，新出现或元数据变化的端口发出portAdded
+ */
+void SerialPortScanner::scan()
+{
+    QElapsedTimer clock;
+    clock.start();
+
+    QHash<QString, SerialPortEntry> current;
+    const QList<QSerialPortInfo> infos = QSerialPortInfo::availablePorts();
+    current.reserve(infos.size());
+    for (const QSerialPortInfo &info : infos) {
+        SerialPortEntry entry;
+        entry.portName = info.portName();
+        entry.systemLocation = info.systemLocation();
+        entry.description = info.description();
+        entry.manufacturer = info.manufacturer();
+        entry.serialNumber = info.serialNumber();
+        entry.hasUsbIds = info.hasVendorIdentifier() && info.hasProductIdentifier();
+        if (entry.hasUsbIds) {
+            entry.vendorId = info.vendorIdentifier();
+            entry.productId = info.productIdentifier();
+        }
+        current.insert(entry.portName, entry);
+    }
+
+    for (auto it = m_ports.constBegin(); it != m_ports.constEnd(); ++it) {
+        if (!current.contains(it.key())) {
+            emit portRemoved(it.key());
+        }
+    }
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        auto previous = m_ports.constFind(it.key());
+        if (previous == m_ports.constEnd() || previous.value() != it.value()) {
+            emit portAdded(it.value());
+        }
+    }
+    m_ports.swap(current);
+
+    if (m_deviceWatcher && !m_pollTimer->isActive()) {
+        watchDeviceDirectories();
+    }
+    emit scanFinished(m_ports.size(), clock.elapsed());
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ * @details 启动扫描线程并执行首次扫描，结果以portAdded逐个送达
+ */
+SerialPortWatcher::SerialPortWatcher(QObject *parent)
+    : QObject(parent)
+    , m_scanner(new SerialPortScanner())
+{
+    qRegisterMetaType<SerialPortEntry>();
+
+    m_scanner->moveToThread(&m_thread);
+    // 扫描器的定时器和监视器属于扫描线程，须在扫描线程结束时于该线程内销毁
+    connect(&m_thread, &QThread::finished, m_scanner, &QObject::deleteLater);
+    connect(m_scanner, &SerialPortScanner::portAdded, this, [this](const SerialPortEntry &entry) {
+        m_ports.insert(entry.portName, entry);
+        emit portAdded(entry);
+    });
+    connect(m_scanner, &SerialPortScanner::portRemoved, this, [this](const QString &portName) {
+        m_ports.remove(portName);
+        emit portRemoved(portName);
+    });
+    connect(m_scanner, &SerialPortScanner::scanFinished, this, [](int portCount, qint64 elapsedMs) {
+        qDebug() << "串口扫描完成 - 找到" << portCount << "个可用串口，耗时" << elapsedMs << "ms";
+    });
+
+    m_thread.setObjectName("SerialPortScanner");
+    m_thread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(m_scanner, &SerialPortScanner::start, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 析构函数，停止扫描线程
+ */
+SerialPortWatcher::~SerialPortWatcher()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+/**
+ * @brief 请求重新扫描（异步，立即返回）
+ */
+void SerialPortWatcher::rescan()
+{
+    QMetaObject::invokeMethod(m_scanner, &SerialPortScanner::scan, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 当前已知的串口
+ * @return 端口名称 -> 串口信息
+ */
+const QHash<QString, SerialPortEntry> &SerialPortWatcher::ports() const
+{
+    return m_ports;
+}
+
+/**
+ * @brief 按串行号查找串口
+ * @param serialNumber USB串行号
+ * @return 端口名称，找不到或串行号为空时返回空字符串
+ */
+QString SerialPortWatcher::portForSerialNumber(const QString &serialNumber) const
+{
+    if (serialNumber.isEmpty()) return QString();
+    for (auto it = m_ports.constBegin(); it != m_ports.constEnd(); ++it) {
+        if (it.value().serialNumber == serialNumber) {
+            return it.key();
+        }
+    }
+    return QString();
+}
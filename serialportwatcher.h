@@ -0,0 +1,179 @@
+/**
+ * @file serialportwatcher.h
+ * @brief 串口后台发现定义文件
+ * @details 包含SerialPortEntry、SerialPortScanner和SerialPortWatcher的声明。
+ *          串口枚举在后台线程执行，设备节点变化（热插拔）时自动重新扫描，
+ *          界面只接收增量的新增/移除事件，不在GUI线程调用QSerialPortInfo::availablePorts()
+ */
+
+#ifndef SERIALPORTWATCHER_H
+#define SERIALPORTWATCHER_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QMetaType>
+
+class QFileSystemWatcher;
+
+/**
+ * @struct SerialPortEntry
+ * @brief 一个串口的缓存信息
+ */
+struct SerialPortEntry
+{
+    QString portName;           // 端口名称（COM3、ttyUSB0）
+    QString systemLocation;     // 系统路径（/dev/ttyUSB0）
+    QString description;        // 描述
+    QString manufacturer;       // 厂商
+    QString serialNumber;       // USB串行号，非USB适配器为空
+    quint16 vendorId = 0;       // USB厂商ID，hasUsbIds为false时无效
+    quint16 productId = 0;      // USB产品ID，hasUsbIds为false时无效
+    bool hasUsbIds = false;     // 是否有VID/PID
+
+    /**
+     * @brief 生成下拉框提示文字
+     * @return 描述、VID:PID和串行号
+     */
+    QString toolTip() const;
+
+    /**
+     * @brief 元数据是否相同
+     * @param other 另一个串口
+     * @return 是否相同
+     */
+    bool operator==(const SerialPortEntry &other) const;
+    bool operator!=(const SerialPortEntry &other) const { return !(*this == other); }
+};
+
+Q_DECLARE_METATYPE(SerialPortEntry)
+
+/**
+ * @class SerialPortScanner
+ * @brief 后台线程中的串口扫描器
+ * @details 位于扫描线程：枚举串口、与上次结果比较，只发出变化部分；
+ *          Linux下监视/dev与/dev/serial/by-id目录，设备插拔时延迟合并后扫描，
+ *          其他平台或目录不可监视时按固定周期扫描
+ */
+class SerialPortScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int SETTLE_DELAY_MS = 250;     // 目录变化后延迟扫描，合并udev创建节点与符号链接的多次变化
+    static constexpr int POLL_INTERVAL_MS = 2000;   // 无法监视设备目录时的轮询周期
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit SerialPortScanner(QObject *parent = nullptr);
+
+public slots:
+    /**
+     * @brief 在扫描线程中创建监视器并执行首次扫描
+     */
+    void start();
+
+    /**
+     * @brief 立即重新扫描
+     */
+    void scan();
+
+signals:
+    /**
+     * @brief 出现新串口，或已有串口的元数据变化
+     * @param entry 串口信息
+     */
+    void portAdded(const SerialPortEntry &entry);
+
+    /**
+     * @brief 串口被移除
+     * @param portName 端口名称
+     */
+    void portRemoved(const QString &portName);
+
+    /**
+     * @brief 一次扫描完成
+     * @param portCount 当前串口数
+     * @param elapsedMs 扫描耗时（毫秒）
+     */
+    void scanFinished(int portCount, qint64 elapsedMs);
+
+private:
+    /**
+     * @brief 监视设备目录
+     * @return 是否至少监视了一个目录
+     */
+    bool watchDeviceDirectories();
+
+    QFileSystemWatcher *m_deviceWatcher;            // 设备目录监视器
+    QTimer *m_settleTimer;                          // 目录变化后的延迟扫描定时器
+    QTimer *m_pollTimer;                            // 轮询定时器
+    QHash<QString, SerialPortEntry> m_ports;        // 上次扫描结果：端口名称 -> 串口信息
+};
+
+/**
+ * @class SerialPortWatcher
+ * @brief 串口后台发现
+ * @details 在GUI线程使用：扫描器在独立线程运行，变化通过排队连接送回；
+ *          本对象同步维护一份端口缓存，可随时查询而不触发枚举
+ */
+class SerialPortWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     * @details 启动扫描线程并执行首次扫描，结果以portAdded逐个送达
+     */
+    explicit SerialPortWatcher(QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数，停止扫描线程
+     */
+    ~SerialPortWatcher();
+
+    /**
+     * @brief 请求重新扫描（异步，立即返回）
+     */
+    void rescan();
+
+    /**
+     * @brief 当前已知的串口
+     * @return 端口名称 -> 串口信息
+     */
+    const QHash<QString, SerialPortEntry> &ports() const;
+
+    /**
+     * @brief 按串行号查找串口
+     * @param serialNumber USB串行号
+     * @return 端口名称，找不到或串行号为空时返回空字符串
+     */
+    QString portForSerialNumber(const QString &serialNumber) const;
+
+signals:
+    /**
+     * @brief 出现新串口，或已有串口的元数据变化
+     * @param entry 串口信息
+     */
+    void portAdded(const SerialPortEntry &entry);
+
+    /**
+     * @brief 串口被移除
+     * @param portName 端口名称
+     */
+    void portRemoved(const QString &portName);
+
+private:
+    QThread m_thread;                               // 扫描线程
+    SerialPortScanner *m_scanner;                   // 扫描器（位于扫描线程）
+    QHash<QString, SerialPortEntry> m_ports;        // GUI线程端口缓存
+};
+
+#endif // SERIALPORTWATCHER_H
@@ -0,0 +1,289 @@
+/**
+ * @file signalfilter.cpp
+ * @brief 采样滤波实现文件
+ * @details 包含MedianFilter、EmaFilter、KalmanFilter和FilterPipeline类的实现
+ */
+
+#include "signalfilter.h"
+#include <QStringList>
+#include <algorithm>
+
+constexpr int MedianFilter::MAX_WINDOW;
+constexpr const char *FilterPipeline::DEFAULT_VOLTAGE_SPEC;
+
+/**
+ * @brief 构造函数
+ * @param window 窗口大小
+ */
+MedianFilter::MedianFilter(int window)
+    : m_head(0)
+    , m_count(0)
+{
+    window = qBound(1, window | 0x01, MAX_WINDOW);
+    m_ring.resize(window);
+    m_sorted.resize(window);
+}
+
+/**
+ * @brief 处理一个样本
+ * @param value 输入值
+ * @return 窗口内的中值
+ */
+double MedianFilter::process(double value)
+{
+    double *begin = m_sorted.data();
+    const int window = m_ring.size();
+
+    // 窗口已满：从有序数组中删除最旧的值
+    if (m_count == window) {
+        double *oldest = std::lower_bound(begin, begin + m_count, m_ring[m_head]);
+        std::copy(oldest + 1, begin + m_count, oldest);
+        --m_count;
+    }
+
+    // 插入新值并保持有序
+    double *position = std::upper_bound(begin, begin + m_count, value);
+    std::copy_backward(position, begin + m_count, begin + m_count + 1);
+    *position = value;
+    ++m_count;
+
+    m_ring[m_head] = value;
+    m_head = (m_head + 1) % window;
+
+    if (m_count % 2 == 1) {
+        return begin[m_count / 2];
+    }
+    return (begin[m_count / 2 - 1] + begin[m_count / 2]) * 0.5;
+}
+
+/**
+ * @brief 清除状态
+ */
+void MedianFilter::reset()
+{
+    m_head = 0;
+    m_count = 0;
+}
+
+/**
+ * @brief 获取本级的描述
+ * @return 描述文本
+ */
+QString MedianFilter::spec() const
+{
+    return QString("median:%1").arg(m_ring.size());
+}
+
+/**
+ * @brief 构造函数
+ * @param alpha 平滑系数
+ */
+EmaFilter::EmaFilter(double alpha)
+    : m_alpha(qBound(1e-6, alpha, 1.0))
+    , m_value(0.0)
+    , m_initialized(false)
+{
+}
+
+/**
+ * @brief 处理一个样本
+ * @param value 输入值
+ * @return 平均值，第一个样本原样输出
+ */
+double EmaFilter::process(double value)
+{
+    if (!m_initialized) {
+        m_value = value;
+        m_initialized = true;
+    } else {
+        m_value += m_alpha * (value - m_value);
+    }
+    return m_value;
+}
+
+/**
+ * @brief 清除状态
+ */
+void EmaFilter::reset()
+{
+    m_initialized = false;
+}
+
+/**
+ * @brief 获取本级的描述
+ * @return 描述文本
+ */
+QString EmaFilter::spec() const
+{
+    return QString("ema:%1").arg(m_alpha);
+}
+
+/**
+ * @brief 构造函数
+ * @param processNoise 过程噪声方差
+ * @param measurementNoise 测量噪声方差
+ */
+KalmanFilter::KalmanFilter(double processNoise, double measurementNoise)
+    : m_q(qMax(0.0, processNoise))
+    , m_r(qMax(1e-12, measurementNoise))
+    , m_estimate(0.0)
+    , m_errorVariance(0.0)
+    , m_initialized(false)
+{
+}
+
+/**
+ * @brief 处理一个样本
+ * @param value 测量值
+ * @return 估计值，第一个样本原样输出（误差方差取测量噪声）
+ */
+double KalmanFilter::process(double value)
+{
+    if (!m_initialized) {
+        m_estimate = value;
+        m_errorVariance = m_r;
+        m_initialized = true;
+        return m_estimate;
+    }
+
+    m_errorVariance += m_q;
+    const double gain = m_errorVariance / (m_errorVariance + m_r);
+    m_estimate += gain * (value - m_estimate);
+    m_errorVariance *= 1.0 - gain;
+    return m_estimate;
+}
+
+/**
+ * @brief 清除状态
+ */
+void KalmanFilter::reset()
+{
+    m_initialized = false;
+}
+
+/**
+ * @brief 获取本级的描述
+ * @return 描述文本
+ */
+QString KalmanFilter::spec() const
+{
+    return QString("kalman:%1:%2").arg(m_q).arg(m_r);
+}
+
+/**
+ * @brief 构造函数
+ */
+FilterPipeline::FilterPipeline()
+{
+}
+
+/**
+ * @brief 按描述重建滤波链
+ * @param spec 滤波链描述
+ * @param errorString 失败时的错误描述
+ * @return 是否成功
+ */
+bool FilterPipeline::setSpec(const QString &spec, QString *errorString)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) *errorString = message;
+        return false;
+    };
+
+    std::vector<std::unique_ptr<SampleFilter>> stages;
+    const QStringList items = spec.split(',', Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        const QStringList parts = item.trimmed().split(':');
+        const QString kind = parts[0].toLower();
+        QVector<double> params;
+        for (int i = 1; i < parts.size(); ++i) {
+            bool ok = false;
+            params.append(parts[i].toDouble(&ok));
+            if (!ok) return fail(QString("滤波参数无效: %1").arg(item));
+        }
+
+        if (kind == "none" && params.isEmpty()) {
+            continue;
+        } else if (kind == "median" && params.size() == 1) {
+            const int window = int(params[0]);
+            if (window != params[0] || window < 1 || window > MedianFilter::MAX_WINDOW || window % 2 == 0) {
+                return fail(QString("中值窗口须为1-%1的奇数: %2").arg(MedianFilter::MAX_WINDOW).arg(item));
+            }
+            stages.push_back(std::make_unique<MedianFilter>(window));
+        } else if (kind == "ema" && params.size() == 1) {
+            if (params[0] <= 0.0 || params[0] > 1.0) {
+                return fail(QString("EMA系数须在(0, 1]内: %1").arg(item));
+            }
+            stages.push_back(std::make_unique<EmaFilter>(params[0]));
+        } else if (kind == "kalman" && params.size() == 2) {
+            if (params[0] < 0.0 || params[1] <= 0.0) {
+                return fail(QString("卡尔曼噪声方差无效: %1").arg(item));
+            }
+            stages.push_back(std::make_unique<KalmanFilter>(params[0], params[1]));
+        } else {
+            return fail(QString("未知的滤波器: %1").arg(item));
+        }
+    }
+
+    m_stages.swap(stages);
+    return true;
+}
+
+/**
+ * @brief 获取滤波链描述
+ * @return 描述文本
+ */
+QString FilterPipeline::spec() const
+{
+    if (m_stages.empty()) {
+        return "none";
+    }
+    QStringList parts;
+    for (const std::unique_ptr<SampleFilter> &stage : m_stages) {
+        parts << stage->spec();
+    }
+    return parts.join(',');
+}
+
+/**
+ * @brief 末尾追加一级滤波器
+ * @param filter 滤波器
+ */
+void FilterPipeline::append(std::unique_ptr<SampleFilter> filter)
+{
+    if (filter) {
+        m_stages.push_back(std::move(filter));
+    }
+}
+
+/**
+ * @brief 处理一个样本
+ * @param value 原始值
+ * @return 滤波值
+ */
+double FilterPipeline::process(double value)
+{
+    for (const std::unique_ptr<SampleFilter> &stage : m_stages) {
+        value = stage->process(value);
+    }
+    return value;
+}
+
+/**
+ * @brief 清除各级状态
+ */
+void FilterPipeline::reset()
+{
+    for (const std::unique_ptr<SampleFilter> &stage : m_stages) {
+        stage->reset();
+    }
+}
+
+/**
+ * @brief 是否为空滤波链
+ * @return 是否没有任何一级
+ */
+bool FilterPipeline::isEmpty() const
+{
+    return m_stages.empty();
+}
@@ -0,0 +1,194 @@
+/**
+ * @file signalfilter.h
+ * @brief 采样滤波定义文件
+ * @details 包含SampleFilter及其实现（滑动中值、指数移动平均、一维卡尔曼）和FilterPipeline的声明。
+ *          滤波位于采集与使用者之间：原始值和滤波值同时提供，由各使用者选择；
+ *          滤波器状态在构造时一次分配，处理样本时不分配内存
+ *
+ * 滤波链描述格式（逗号分隔，按顺序串联）：
+ * @code
+ * median:5           滑动中值，窗口为奇数，1-31
+ * ema:0.3            指数移动平均，系数0-1（1为不滤波）
+ * kalman:0.01:1.0    一维卡尔曼，过程噪声方差:测量噪声方差
+ * none               不滤波（空字符串同）
+ * @endcode
+ * 例如 "median:5,ema:0.3" 先去除尖峰再平滑量化台阶。
+ */
+
+#ifndef SIGNALFILTER_H
+#define SIGNALFILTER_H
+
+#include <QString>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+/**
+ * @class SampleFilter
+ * @brief 单级滤波器接口
+ */
+class SampleFilter
+{
+public:
+    virtual ~SampleFilter() = default;
+
+    /**
+     * @brief 处理一个样本
+     * @param value 输入值
+     * @return 滤波值
+     */
+    virtual double process(double value) = 0;
+
+    /**
+     * @brief 清除状态，下一个样本重新初始化
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief 获取本级的描述
+     * @return 与滤波链描述格式相同的文本
+     */
+    virtual QString spec() const = 0;
+};
+
+/**
+ * @class MedianFilter
+ * @brief 滑动中值滤波
+ * @details 环形缓冲区保存到达顺序，另一个数组保持窗口内的值有序；
+ *          每个样本从有序数组删除最旧的值并插入新值，开销与窗口大小成正比。
+ *          窗口未满时输出已有样本的中值
+ */
+class MedianFilter : public SampleFilter
+{
+public:
+    static constexpr int MAX_WINDOW = 31;
+
+    /**
+     * @brief 构造函数
+     * @param window 窗口大小，取奇数并限制在1-MAX_WINDOW
+     */
+    explicit MedianFilter(int window);
+
+    double process(double value) override;
+    void reset() override;
+    QString spec() const override;
+
+private:
+    QVector<double> m_ring;     // 按到达顺序的样本
+    QVector<double> m_sorted;   // 有序样本，前m_count个有效
+    int m_head;                 // 下一个写入位置（窗口满时即最旧样本）
+    int m_count;                // 有效样本数
+};
+
+/**
+ * @class EmaFilter
+ * @brief 指数移动平均
+ */
+class EmaFilter : public SampleFilter
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param alpha 平滑系数，限制在(0, 1]
+     */
+    explicit EmaFilter(double alpha);
+
+    double process(double value) override;
+    void reset() override;
+    QString spec() const override;
+
+private:
+    double m_alpha;
+    double m_value;
+    bool m_initialized;
+};
+
+/**
+ * @class KalmanFilter
+ * @brief 一维卡尔曼滤波（随机游走模型）
+ * @details 状态为电压本身：预测时误差方差增加过程噪声q，更新时按增益k = p / (p + r)修正。
+ *          q越小越平滑、跟随阶跃越慢
+ */
+class KalmanFilter : public SampleFilter
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param processNoise 过程噪声方差q
+     * @param measurementNoise 测量噪声方差r
+     */
+    KalmanFilter(double processNoise, double measurementNoise);
+
+    double process(double value) override;
+    void reset() override;
+    QString spec() const override;
+
+private:
+    double m_q;
+    double m_r;
+    double m_estimate;
+    double m_errorVariance;
+    bool m_initialized;
+};
+
+/**
+ * @class FilterPipeline
+ * @brief 一个通道的滤波链
+ * @details 各级按顺序串联；没有任何一级时直接输出原始值
+ */
+class FilterPipeline
+{
+public:
+    static constexpr const char *DEFAULT_VOLTAGE_SPEC = "median:3,ema:0.5";    // 电压默认滤波：去除单点尖峰，平滑量化台阶
+
+    /**
+     * @brief 构造函数，创建空滤波链
+     */
+    FilterPipeline();
+
+    FilterPipeline(FilterPipeline &&) = default;
+    FilterPipeline &operator=(FilterPipeline &&) = default;
+
+    /**
+     * @brief 按描述重建滤波链
+     * @param spec 滤波链描述
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否成功，失败时原滤波链保持不变
+     */
+    bool setSpec(const QString &spec, QString *errorString = nullptr);
+
+    /**
+     * @brief 获取滤波链描述
+     * @return 描述文本，空滤波链为"none"
+     */
+    QString spec() const;
+
+    /**
+     * @brief 末尾追加一级滤波器
+     * @param filter 滤波器
+     */
+    void append(std::unique_ptr<SampleFilter> filter);
+
+    /**
+     * @brief 处理一个样本
+     * @param value 原始值
+     * @return 滤波值
+     */
+    double process(double value);
+
+    /**
+     * @brief 清除各级状态（例如重新连接后，避免与断开前的数据混合）
+     */
+    void reset();
+
+    /**
+     * @brief 是否为空滤波链
+     * @return 是否没有任何一级
+     */
+    bool isEmpty() const;
+
+private:
+    std::vector<std::unique_ptr<SampleFilter>> m_stages;
+};
+
+#endif // SIGNALFILTER_H
@@ -17,27 +17,34 @@
 namespace Styles
 {
     /**
-     * @brief 选中状态按钮样式
-     * @details 定义按钮被选中时的外观，包括背景色、文字颜色、字体大小等
+     * @brief 档位按钮标识属性名
+     * @details 档位按钮在初始化时设置该动态属性为true，样式表据此匹配档位按钮
      */
-    const QString BUTTON_SELECTED_STYLE = 
-        "background-color: #707d98; "
-        "color: #ebecef; "
-        "font-weight: bold; "
-        "font-size: 20px; "
-        "border-radius: 5px; "
-        "border: none;";
+    const char *const STEP_BUTTON_PROPERTY = "stepButton";
+
+    /**
+     * @brief 档位按钮选中状态属性名
+     * @details 切换选中状态只需修改该动态属性并重新polish，无需重新解析样式表
+     */
+    const char *const SELECTED_PROPERTY = "selected";
 
     /**
-     * @brief 未选中状态按钮样式
-     * @details 定义按钮未被选中时的外观，包括背景色、文字颜色、字体大小等
+     * @brief 档位按钮样式
+     * @details 按selected动态属性区分选中与未选中外观，随中央部件样式表一次性加载
      */
-    const QString BUTTON_UNSELECTED_STYLE = 
+    const QString STEP_BUTTON_STYLE = 
+        "QPushButton[stepButton=\"true\"] { "
         "background-color: #ebecef; "
         "color: #707d98; "
         "font-size: 20px; "
         "border-radius: 5px; "
-        "border: none;";
+        "border: none; "
+        "} "
+        "QPushButton[stepButton=\"true\"][selected=\"true\"] { "
+        "background-color: #707d98; "
+        "color: #ebecef; "
+        "font-weight: bold; "
+        "}";
 
     /**
      * @brief 窗口背景样式
@@ -1,4 +1,4 @@
-QT       += core gui serialport serialbus charts
+QT       += core gui serialport serialbus charts network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -13,13 +13,51 @@ SOURCES += \
     mainwindow.cpp \
     rowbuttongroup.cpp \
     modbusmanager.cpp \
-    waveformchart.cpp
+    waveformchart.cpp \
+    voltagestatistics.cpp \
+    triggercapture.cpp \
+    loadsolver.cpp \
+    loadbankconfig.cpp \
+    relaystate.cpp \
+    loadbankmodel.cpp \
+    loadprofile.cpp \
+    loadsequencer.cpp \
+    voltageregulator.cpp \
+    headlessservice.cpp \
+    automationserver.cpp \
+    samplering.cpp \
+    serialportwatcher.cpp \
+    rolluparchive.cpp \
+    energyaccounting.cpp \
+    powerquality.cpp \
+    signalfilter.cpp \
+    bankpreset.cpp \
+    banksolver.cpp
 
 HEADERS += \
     mainwindow.h \
     rowbuttongroup.h \
     modbusmanager.h \
-    waveformchart.h
+    waveformchart.h \
+    voltagestatistics.h \
+    triggercapture.h \
+    loadsolver.h \
+    loadbankconfig.h \
+    relaystate.h \
+    loadbankmodel.h \
+    loadprofile.h \
+    loadsequencer.h \
+    voltageregulator.h \
+    headlessservice.h \
+    automationserver.h \
+    samplering.h \
+    serialportwatcher.h \
+    rolluparchive.h \
+    energyaccounting.h \
+    powerquality.h \
+    signalfilter.h \
+    bankpreset.h \
+    banksolver.h
 
 FORMS += \
     mainwindow.ui
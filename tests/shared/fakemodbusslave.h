@@ -0,0 +1,131 @@
+/**
+ * @file fakemodbusslave.h
+ * @brief 测试用进程内模拟Modbus TCP从站
+ * @details 供需要经由ModbusManager收发请求的测试共用，只包含头文件，由各测试工程的HEADERS交给moc处理
+ */
+
+#ifndef FAKEMODBUSSLAVE_H
+#define FAKEMODBUSSLAVE_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QHash>
+#include <QByteArray>
+
+/**
+ * @class FakeModbusSlave
+ * @brief 进程内模拟Modbus TCP从站
+ * @details 只实现本程序使用的功能码03、06、16；每个从站地址（单元标识）有独立的寄存器表
+ */
+class FakeModbusSlave : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakeModbusSlave(QObject *parent = nullptr) : QObject(parent)
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { serve(socket); });
+                connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+                    m_buffers.remove(socket);
+                    socket->deleteLater();
+                });
+            }
+        });
+    }
+
+    bool listen() { return m_server.listen(QHostAddress::LocalHost, 0); }
+    quint16 port() const { return m_server.serverPort(); }
+
+    void setRegister(int unit, int address, quint16 value) { m_registers[unit][address] = value; }
+    quint16 registerValue(int unit, int address) const { return m_registers.value(unit).value(address, 0); }
+    int writeRequests() const { return m_writeRequests; }
+
+private:
+    /**
+     * @brief 处理缓冲区中的全部完整请求（MBAP头7字节 + PDU）
+     * @param socket 客户端连接
+     */
+    void serve(QTcpSocket *socket)
+    {
+        QByteArray &buffer = m_buffers[socket];
+        buffer.append(socket->readAll());
+
+        while (buffer.size() >= 8) {
+            const int length = (quint8(buffer[4]) << 8) | quint8(buffer[5]);
+            if (buffer.size() < 6 + length) break;
+
+            const QByteArray header = buffer.left(6);
+            const quint8 unit = quint8(buffer[6]);
+            const QByteArray pdu = buffer.mid(7, length - 1);
+            buffer.remove(0, 6 + length);
+
+            const QByteArray response = process(unit, pdu);
+            QByteArray frame = header;
+            frame[4] = char((response.size() + 1) >> 8);
+            frame[5] = char((response.size() + 1) & 0xFF);
+            frame.append(char(unit));
+            frame.append(response);
+            socket->write(frame);
+        }
+    }
+
+    static quint16 word(const QByteArray &data, int offset)
+    {
+        return quint16((quint8(data[offset]) << 8) | quint8(data[offset + 1]));
+    }
+
+    static void appendWord(QByteArray &data, quint16 value)
+    {
+        data.append(char(value >> 8));
+        data.append(char(value & 0xFF));
+    }
+
+    /**
+     * @brief 处理一个PDU
+     * @param unit 从站地址
+     * @param pdu 请求PDU
+     * @return 应答PDU
+     */
+    QByteArray process(quint8 unit, const QByteArray &pdu)
+    {
+        const quint8 function = quint8(pdu.value(0));
+        QByteArray response;
+        response.append(char(function));
+
+        if (function == 0x03 && pdu.size() >= 5) {
+            const quint16 start = word(pdu, 1);
+            const quint16 count = word(pdu, 3);
+            response.append(char(count * 2));
+            for (int i = 0; i < count; ++i) {
+                appendWord(response, registerValue(unit, start + i));
+            }
+        } else if (function == 0x06 && pdu.size() >= 5) {
+            ++m_writeRequests;
+            setRegister(unit, word(pdu, 1), word(pdu, 3));
+            response = pdu.left(5);
+        } else if (function == 0x10 && pdu.size() >= 6) {
+            ++m_writeRequests;
+            const quint16 start = word(pdu, 1);
+            const quint16 count = word(pdu, 3);
+            for (int i = 0; i < count && 6 + 2 * i + 1 < pdu.size(); ++i) {
+                setRegister(unit, start + i, word(pdu, 6 + 2 * i));
+            }
+            response = pdu.left(5);
+        } else {
+            response[0] = char(function | 0x80);
+            response.append(char(0x01));    // ILLEGAL FUNCTION
+        }
+        return response;
+    }
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    QHash<int, QHash<int, quint16>> m_registers;
+    int m_writeRequests = 0;
+};
+
+#endif // FAKEMODBUSSLAVE_H
@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_loadsolver \
+    tst_hotpaths \
+    tst_rolluparchive \
+    tst_energyaccounting \
+    tst_powerquality \
+    tst_signalfilter \
+    tst_samplering \
+    tst_banksolver \
+    tst_voltagestatistics \
+    tst_triggercapture \
+    tst_resync \
+    tst_bankpreset
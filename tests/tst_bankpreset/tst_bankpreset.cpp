@@ -0,0 +1,240 @@
+/**
+ * @file tst_bankpreset.cpp
+ * @brief 整柜快照与预设测试
+ * @details 经由ModbusManager和进程内模拟从站，验证切换到快照时的最少写事务、跳过寄存器的条件和快照校验，
+ *          以及预设文件的保存、加载、同名替换和无效文件的拒绝
+ */
+
+#include <QtTest>
+#include <QModbusTcpClient>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "relaystate.h"
+#include "loadbankconfig.h"
+#include "loadbankmodel.h"
+#include "bankpreset.h"
+#include "modbusmanager.h"
+#include "fakemodbusslave.h"
+
+class TestBankPreset : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void snapshotRecallMinimalWrites();
+    void presetStoreRoundTrip();
+
+private:
+    /**
+     * @brief 批量刷新一次
+     * @return 是否成功
+     */
+    bool refresh();
+
+    FakeModbusSlave *m_slave = nullptr;
+    LoadBankModel *m_model = nullptr;
+};
+
+/**
+ * @brief 启动模拟从站并让ModbusManager通过TCP客户端连接到它
+ */
+void TestBankPreset::initTestCase()
+{
+    m_slave = new FakeModbusSlave(this);
+    QVERIFY(m_slave->listen());
+
+    QModbusTcpClient *client = new QModbusTcpClient;
+    client->setConnectionParameter(QModbusDevice::NetworkAddressParameter, "127.0.0.1");
+    client->setConnectionParameter(QModbusDevice::NetworkPortParameter, m_slave->port());
+    client->setTimeout(1000);
+    client->setNumberOfRetries(0);
+    QVERIFY(client->connectDevice());
+    QTRY_COMPARE(client->state(), QModbusDevice::ConnectedState);
+    QVERIFY(ModbusManager::instance()->attachClient(client));
+
+    m_model = new LoadBankModel(this);
+    m_model->setConfig(LoadBankConfig::applicationConfig(QString(), RELAY_ROW_COUNT));
+}
+
+/**
+ * @brief 断开ModbusManager
+ */
+void TestBankPreset::cleanupTestCase()
+{
+    ModbusManager::instance()->closeModbus();
+}
+
+/**
+ * @brief 批量刷新一次
+ * @return 是否在超时前成功
+ */
+bool TestBankPreset::refresh()
+{
+    QSignalSpy refreshed(m_model, &LoadBankModel::refreshFinished);
+    m_model->refresh();
+    return refreshed.wait(1000) && refreshed.at(0).at(0).toBool();
+}
+
+/**
+ * @brief 切换到快照时跳过已确认为目标值的寄存器，连续地址合并为一次写事务，低字节一并恢复
+ */
+void TestBankPreset::snapshotRecallMinimalWrites()
+{
+    const QVector<int> addresses = {REGISTER_ADDRESS_ROW0, REGISTER_ADDRESS_ROW1, REGISTER_ADDRESS_ROW2,
+                                    REGISTER_ADDRESS_ROW3, REGISTER_ADDRESS_ROW4, REGISTER_ADDRESS_ROW5,
+                                    REGISTER_ADDRESS_ROW6, REGISTER_ADDRESS_ROW7, REGISTER_ADDRESS_ROW8};
+    for (int address : addresses) {
+        m_slave->setRegister(1, address, 0x0000);
+    }
+    m_slave->setRegister(1, REGISTER_ADDRESS_ROW3, 0x01A5);
+    QVERIFY(refresh());
+    QCOMPARE(m_model->pendingIntentCount(), 0);
+
+    BankSnapshot snapshot;
+    QVERIFY(m_model->captureSnapshot(&snapshot));
+    QCOMPARE(int(snapshot.rowBits.size()), RELAY_ROW_COUNT);
+    QCOMPARE(snapshot.registers.value(REGISTER_ADDRESS_ROW3), quint16(0x01A5));
+    QCOMPARE(snapshot.rowBits[3], quint64(0x01));
+
+    // 第2-5行地址连续（第5行只改低字节），第7行单独：两次写事务
+    BankSnapshot target = snapshot;
+    target.registers[REGISTER_ADDRESS_ROW2] = 0x0300;
+    target.registers[REGISTER_ADDRESS_ROW3] = 0x80A5;
+    target.registers[REGISTER_ADDRESS_ROW4] = 0xFF00;
+    target.registers[REGISTER_ADDRESS_ROW5] = 0x0011;
+    target.registers[REGISTER_ADDRESS_ROW7] = 0x0500;
+    target.rowBits[2] = 0x03;
+    target.rowBits[3] = 0x80;
+    target.rowBits[4] = 0xFF;
+    target.rowBits[7] = 0x05;
+    QVERIFY(m_model->checkSnapshot(target));
+
+    const int writesBefore = m_slave->writeRequests();
+    int callbacks = 0;
+    bool committed = false;
+    QVERIFY(m_model->commitSnapshot(target, ModbusManager::ControlPriority, [&](bool ok) {
+        ++callbacks;
+        committed = ok;
+    }));
+    for (int row = 0; row < RELAY_ROW_COUNT; ++row) {
+        QCOMPARE(m_model->rowState(row)->bits(), target.rowBits[row]);
+    }
+    QTRY_COMPARE(callbacks, 1);
+    QVERIFY(committed);
+    QCOMPARE(m_slave->writeRequests() - writesBefore, 2);
+    for (int address : addresses) {
+        QCOMPARE(m_slave->registerValue(1, address), target.registers.value(address));
+    }
+
+    // 已处于目标状态：不发出任何写请求
+    callbacks = 0;
+    QVERIFY(m_model->commitSnapshot(target, ModbusManager::ControlPriority, [&](bool ok) {
+        ++callbacks;
+        committed = ok;
+    }));
+    QCOMPARE(callbacks, 1);
+    QVERIFY(committed);
+    QCOMPARE(m_slave->writeRequests() - writesBefore, 2);
+
+    // 写入尚未应答的寄存器缓存未确认：即使缓存值已等于目标也重新写入
+    RowCommit commit;
+    commit.row = 7;
+    commit.mask = 0x00;
+    commit.changedMask = target.rowBits[7];
+    m_model->commitRows({commit}, ModbusManager::ControlPriority);
+    commit.mask = target.rowBits[7];
+    m_model->commitRows({commit}, ModbusManager::ControlPriority);
+    callbacks = 0;
+    QVERIFY(m_model->commitSnapshot(target, ModbusManager::ControlPriority, [&](bool ok) {
+        ++callbacks;
+        committed = ok;
+    }));
+    QTRY_COMPARE(callbacks, 1);
+    QVERIFY(committed);
+    QCOMPARE(m_slave->writeRequests() - writesBefore, 5);
+    QCOMPARE(m_slave->registerValue(1, REGISTER_ADDRESS_ROW7), target.registers.value(REGISTER_ADDRESS_ROW7));
+
+    // 与配置不一致的快照不写入
+    BankSnapshot mismatched = target;
+    mismatched.rowBits[4] = 0x0F;
+    QString errorString;
+    QVERIFY(!m_model->commitSnapshot(mismatched, ModbusManager::ControlPriority, nullptr, &errorString));
+    QVERIFY(!errorString.isEmpty());
+    mismatched = target;
+    mismatched.registers.remove(REGISTER_ADDRESS_ROW0);
+    QVERIFY(!m_model->checkSnapshot(mismatched));
+    QCOMPARE(m_slave->writeRequests() - writesBefore, 5);
+}
+
+/**
+ * @brief 预设保存后重新加载内容不变，同名（不区分大小写）替换，无效文件加载失败且原有预设保持不变
+ */
+void TestBankPreset::presetStoreRoundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("presets.json");
+
+    BankPresetStore store;
+    QVERIFY(store.loadFromFile(path));
+    QVERIFY(store.names().isEmpty());
+
+    BankPreset full;
+    full.name = "full";
+    full.snapshot.rowBits = {0xFF, Q_UINT64_C(0x8000000000000001)};
+    full.snapshot.registers = {{REGISTER_ADDRESS_ROW0, 0xFF00}, {REGISTER_ADDRESS_ROW1, 0xFF5A}};
+    BankPreset half;
+    half.name = "半载";
+    half.snapshot.rowBits = {0x0F, 0x00};
+    half.snapshot.registers = {{REGISTER_ADDRESS_ROW0, 0x0F00}, {REGISTER_ADDRESS_ROW1, 0x005A}};
+    store.insert(full);
+    store.insert(half);
+
+    // 同名不区分大小写：替换原预设，位置不变
+    full.name = "FULL";
+    full.snapshot.registers[REGISTER_ADDRESS_ROW1] = 0xFFA5;
+    store.insert(full);
+    QCOMPARE(store.names(), QStringList({"FULL", "半载"}));
+    QVERIFY(store.save());
+
+    BankPresetStore loaded;
+    QVERIFY(loaded.loadFromFile(path));
+    QCOMPARE(loaded.names(), QStringList({"FULL", "半载"}));
+    BankPreset preset;
+    QVERIFY(loaded.find("Full", &preset));
+    QCOMPARE(preset.snapshot.rowBits, full.snapshot.rowBits);
+    QCOMPARE(preset.snapshot.registers, full.snapshot.registers);
+    QVERIFY(loaded.find("半载", &preset));
+    QCOMPARE(preset.snapshot.registers, half.snapshot.registers);
+    QVERIFY(loaded.remove("full"));
+    QVERIFY(!loaded.find("FULL", nullptr));
+    QVERIFY(!loaded.remove("full"));
+
+    auto writeFile = [&path](const QByteArray &content) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(content);
+    };
+    const QList<QByteArray> invalid = {
+        R"({"presets":[{"name":"a","rows":["zz"],"registers":{}}]})",
+        R"({"presets":[{"name":"a","rows":["ff"],"registers":{"50":65536}}]})",
+        R"({"presets":[{"name":"a","rows":["ff"],"registers":{"50":-1}}]})",
+        R"({"presets":[{"name":"a","rows":["ff"],"registers":{"x":1}}]})",
+        R"({"presets":[{"rows":["ff"],"registers":{}}]})",
+        R"({"presets":[)",
+    };
+    for (const QByteArray &content : invalid) {
+        writeFile(content);
+        QString errorString;
+        QVERIFY2(!store.loadFromFile(path, &errorString), content.constData());
+        QVERIFY(!errorString.isEmpty());
+        QCOMPARE(store.names(), QStringList({"FULL", "半载"}));
+    }
+}
+
+QTEST_MAIN(TestBankPreset)
+
+#include "tst_bankpreset.moc"
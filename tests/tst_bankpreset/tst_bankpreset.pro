@@ -0,0 +1,26 @@
+QT       += testlib serialbus serialport network
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_bankpreset
+
+INCLUDEPATH += ../.. ../shared
+
+SOURCES += \
+    tst_bankpreset.cpp \
+    ../../loadsolver.cpp \
+    ../../relaystate.cpp \
+    ../../loadbankconfig.cpp \
+    ../../loadbankmodel.cpp \
+    ../../bankpreset.cpp \
+    ../../modbusmanager.cpp
+
+HEADERS += \
+    ../../loadsolver.h \
+    ../../relaystate.h \
+    ../../loadbankconfig.h \
+    ../../loadbankmodel.h \
+    ../../bankpreset.h \
+    ../../modbusmanager.h \
+    ../shared/fakemodbusslave.h
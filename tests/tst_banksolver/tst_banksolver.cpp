@@ -0,0 +1,276 @@
+/**
+ * @file tst_banksolver.cpp
+ * @brief 整柜负载分配测试
+ * @details 对照穷举验证最少切换的分配，验证上限、锁定行、不可达目标取最近值、三相平衡容差，
+ *          以及后台求解只送达最新请求的结果
+ */
+
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QFile>
+#include <algorithm>
+
+#include "banksolver.h"
+#include "loadbankconfig.h"
+#include "loadbankmodel.h"
+
+class TestBankSolver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void matchesExhaustiveSearch();
+    void limitsAndLockedRows();
+    void phaseBalance();
+    void requestFromModel();
+    void distributorDeliversLatest();
+    void nineRowBalanced();
+
+private:
+    static BankSolverRow makeRow(int row, const QVector<int> &stepUnits, quint64 currentMask, int phase = -1);
+};
+
+BankSolverRow TestBankSolver::makeRow(int row, const QVector<int> &stepUnits, quint64 currentMask, int phase)
+{
+    BankSolverRow result;
+    result.row = row;
+    result.stepUnits = stepUnits;
+    result.currentMask = currentMask;
+    result.phase = phase;
+    return result;
+}
+
+void TestBankSolver::initTestCase()
+{
+    qRegisterMetaType<BankSolveResult>("BankSolveResult");
+}
+
+void TestBankSolver::matchesExhaustiveSearch()
+{
+    const QVector<int> steps = {10, 20, 30, 50, 100, 200, 300, 500};
+    QRandomGenerator generator(20240501);
+    for (int round = 0; round < 20; ++round) {
+        BankSolveRequest request;
+        request.rows.append(makeRow(0, steps, generator.bounded(256)));
+        request.rows.append(makeRow(1, steps, generator.bounded(256)));
+        request.targetUnits = generator.bounded(2500);
+
+        // 穷举两行全部组合：先取最接近目标（距离相同取较小者），再取最少切换，再取最少档位
+        int bestTotal = -1;
+        int bestToggles = 0;
+        int bestSteps = 0;
+        for (int a = 0; a < 256; ++a) {
+            for (int b = 0; b < 256; ++b) {
+                int total = 0;
+                for (int i = 0; i < steps.size(); ++i) {
+                    if (a & (1 << i)) total += steps[i];
+                    if (b & (1 << i)) total += steps[i];
+                }
+                const int toggles = qPopulationCount(quint32(a ^ request.rows[0].currentMask))
+                                    + qPopulationCount(quint32(b ^ request.rows[1].currentMask));
+                const int stepCount = qPopulationCount(quint32(a)) + qPopulationCount(quint32(b));
+                const int distance = qAbs(total - request.targetUnits);
+                const int bestDistance = qAbs(bestTotal - request.targetUnits);
+                if (bestTotal < 0 || distance < bestDistance
+                    || (distance == bestDistance && total < bestTotal)
+                    || (total == bestTotal && (toggles < bestToggles
+                                               || (toggles == bestToggles && stepCount < bestSteps)))) {
+                    bestTotal = total;
+                    bestToggles = toggles;
+                    bestSteps = stepCount;
+                }
+            }
+        }
+
+        const BankSolveResult result = BankSolver::solve(request);
+        QVERIFY2(result.ok, qPrintable(result.errorString));
+        QCOMPARE(result.achievedUnits, bestTotal);
+        QCOMPARE(result.toggles, bestToggles);
+        QCOMPARE(result.steps, bestSteps);
+        QCOMPARE(result.rowUnits[0] + result.rowUnits[1], result.achievedUnits);
+    }
+}
+
+void TestBankSolver::limitsAndLockedRows()
+{
+    const QVector<int> steps = {10, 20, 40, 80};
+
+    BankSolveRequest request;
+    request.rows.append(makeRow(2, steps, 0));
+    request.rows.append(makeRow(5, steps, 0));
+    request.rows.append(makeRow(8, steps, 0x5));
+    request.rows[0].maxUnits = 60;
+    request.rows[2].locked = true;
+
+    // 锁定行保持50，上限行最多60，另一行最多150：260可达
+    request.targetUnits = 260;
+    BankSolveResult result = BankSolver::solve(request);
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 260);
+    QCOMPARE(result.rows, QVector<int>({2, 5, 8}));
+    QCOMPARE(result.rowUnits, QVector<int>({60, 150, 50}));
+    QCOMPARE(result.masks[2], quint64(0x5));
+
+    // 超出可达范围时取最大可达值
+    request.targetUnits = 400;
+    result = BankSolver::solve(request);
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 260);
+
+    // 低于锁定行的值时取最小可达值
+    request.targetUnits = 0;
+    result = BankSolver::solve(request);
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 50);
+    QCOMPARE(result.toggles, 0);
+
+    request.rows.clear();
+    result = BankSolver::solve(request);
+    QVERIFY(!result.ok);
+    QVERIFY(!result.errorString.isEmpty());
+}
+
+void TestBankSolver::phaseBalance()
+{
+    const QVector<int> steps = {10, 20, 40, 80, 160};
+
+    // 当前A相全开、B/C相全关：不要求平衡时切换最少的分配全部落在A相
+    BankSolveRequest request;
+    request.rows.append(makeRow(0, steps, 0x1F, 0));
+    request.rows.append(makeRow(1, steps, 0, 1));
+    request.rows.append(makeRow(2, steps, 0, 2));
+    request.targetUnits = 300;
+
+    BankSolveResult result = BankSolver::solve(request);
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 300);
+    QCOMPARE(result.phaseUnits[0], 300);
+
+    request.phaseToleranceUnits = 10;
+    result = BankSolver::solve(request);
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 300);
+    const int low = qMin(result.phaseUnits[0], qMin(result.phaseUnits[1], result.phaseUnits[2]));
+    const int high = qMax(result.phaseUnits[0], qMax(result.phaseUnits[1], result.phaseUnits[2]));
+    QVERIFY(high - low <= 10);
+    QCOMPARE(result.phaseUnits[0] + result.phaseUnits[1] + result.phaseUnits[2], 300);
+
+    // B相上限20时其余两相不超过30
+    request.rows[1].maxUnits = 20;
+    result = BankSolver::solve(request);
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 80);
+    QVERIFY(result.phaseUnits[1] <= 20);
+}
+
+void TestBankSolver::requestFromModel()
+{
+    LoadBankModel model;
+    model.setConfig(LoadBankConfig::applicationConfig(QString(), RELAY_ROW_COUNT));
+
+    // 默认配置每三行一种单位循环，同一单位的行依次接A/B/C相
+    const BankSolveRequest request = BankSolver::requestFromModel(&model, 1000, "kw",
+                                                                  BankDistributor::DEFAULT_PHASE_TOLERANCE_UNITS);
+    QCOMPARE(request.rows.size(), 3);
+    QCOMPARE(request.rows[0].row, 0);
+    QCOMPARE(request.rows[1].row, 3);
+    QCOMPARE(request.rows[2].row, 6);
+    QCOMPARE(request.rows[0].phase, 0);
+    QCOMPARE(request.rows[1].phase, 1);
+    QCOMPARE(request.rows[2].phase, 2);
+    QCOMPARE(request.rows[0].currentMask, quint64(0));
+
+    const BankSolveResult result = BankSolver::solve(request);
+    QVERIFY2(result.ok, qPrintable(result.errorString));
+    const int changedRows = std::count_if(result.masks.cbegin(), result.masks.cend(),
+                                         [](quint64 mask) { return mask != 0; });
+    QCOMPARE(result.commits(&model).size(), changedRows);
+    QVERIFY(!result.description().isEmpty());
+
+    // 配置中的phase、maxValue和locked传到请求中；锁定行的分配值保持为当前值
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath("loadbank.json"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(R"({"rows": [
+        {"name": "R1", "unit": "KW", "phase": 1, "maxValue": 3.0, "registers": [50], "steps": [0.1, 0.2, 0.5, 1, 2]},
+        {"name": "R2", "unit": "KW", "phase": 2, "locked": true, "registers": [1], "steps": [0.1, 0.2, 0.5, 1, 2]},
+        {"name": "L1", "unit": "Kvar", "registers": [2], "steps": [1, 2]}
+    ]})");
+    file.close();
+    LoadBankConfig config;
+    QString error;
+    QVERIFY2(config.loadFromFile(file.fileName(), &error), qPrintable(error));
+    model.setConfig(config);
+
+    const BankSolveRequest fileRequest = BankSolver::requestFromModel(&model, 50, "KW", -1);
+    QCOMPARE(fileRequest.rows.size(), 2);
+    QCOMPARE(fileRequest.rows[0].maxUnits, 30);
+    QCOMPARE(fileRequest.rows[0].phase, 0);
+    QVERIFY(!fileRequest.rows[0].locked);
+    QCOMPARE(fileRequest.rows[1].phase, 1);
+    QVERIFY(fileRequest.rows[1].locked);
+
+    const BankSolveResult fileResult = BankSolver::solve(fileRequest);
+    QVERIFY(fileResult.ok);
+    QCOMPARE(fileResult.rowUnits, QVector<int>({30, 0}));
+}
+
+void TestBankSolver::distributorDeliversLatest()
+{
+    BankDistributor distributor;
+    QSignalSpy spy(&distributor, &BankDistributor::solved);
+
+    BankSolveRequest request;
+    for (int r = 0; r < 9; ++r) {
+        request.rows.append(makeRow(r, {10, 20, 30, 50, 100, 200, 300, 500}, 0, r % 3));
+    }
+    request.phaseToleranceUnits = 10;
+
+    quint64 generation = 0;
+    for (int target = 100; target <= 1000; target += 100) {
+        request.targetUnits = target;
+        generation = distributor.submit(request);
+    }
+    QVERIFY(distributor.isBusy());
+
+    QTRY_COMPARE(spy.count(), 1);
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!distributor.isBusy());
+
+    const BankSolveResult result = spy.at(0).at(0).value<BankSolveResult>();
+    QCOMPARE(result.generation, generation);
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 1000);
+
+    // 放弃后不再送达
+    distributor.submit(request);
+    distributor.cancel();
+    QTest::qWait(50);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!distributor.isBusy());
+}
+
+void TestBankSolver::nineRowBalanced()
+{
+    BankSolveRequest request;
+    for (int r = 0; r < 9; ++r) {
+        request.rows.append(makeRow(r, {10, 20, 30, 50, 100, 200, 300, 500}, r % 2 ? 0x0F : 0, r % 3));
+    }
+    request.phaseToleranceUnits = BankDistributor::DEFAULT_PHASE_TOLERANCE_UNITS;
+    request.targetUnits = 7770;
+
+    BankSolveResult result;
+    QBENCHMARK {
+        result = BankSolver::solve(request);
+    }
+    QVERIFY(result.ok);
+    QCOMPARE(result.achievedUnits, 7770);
+}
+
+QTEST_MAIN(TestBankSolver)
+
+#include "tst_banksolver.moc"
@@ -0,0 +1,27 @@
+QT       += testlib widgets charts serialbus serialport network
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_banksolver
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_banksolver.cpp \
+    ../../banksolver.cpp \
+    ../../loadsolver.cpp \
+    ../../relaystate.cpp \
+    ../../loadbankconfig.cpp \
+    ../../loadbankmodel.cpp \
+    ../../modbusmanager.cpp \
+    ../../waveformchart.cpp
+
+HEADERS += \
+    ../../banksolver.h \
+    ../../loadsolver.h \
+    ../../relaystate.h \
+    ../../loadbankconfig.h \
+    ../../loadbankmodel.h \
+    ../../modbusmanager.h \
+    ../../waveformchart.h
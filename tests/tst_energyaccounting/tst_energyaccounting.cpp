@@ -0,0 +1,175 @@
+/**
+ * @file tst_energyaccounting.cpp
+ * @brief 电能与继电器动作统计测试
+ * @details 验证电压变化时的梯形积分、数据缺失段不计入、首次同步前后及重新加载配置后的动作计数，
+ *          以及检查点保存后恢复计数
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <memory>
+
+#include "energyaccounting.h"
+#include "loadbankconfig.h"
+#include "loadbankmodel.h"
+#include "loadsolver.h"
+
+class TestEnergyAccounting : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void trapezoidIntegration();
+    void gapIsNotIntegrated();
+    void operationsCountedAfterSync();
+    void checkpointRestoresCounters();
+
+private:
+    /**
+     * @brief 从BASE_MS开始每10秒加入一个电压样本
+     * @param accounting 统计对象
+     * @param voltages 各样本的电压
+     */
+    static void feed(EnergyAccounting &accounting, const QVector<double> &voltages);
+
+    // 远大于测试实际耗时，使样本时间戳晚于状态变化时记录的积分节点
+    static constexpr qint64 BASE_MS = 1000000;
+    static constexpr qint64 SAMPLE_MS = 10000;
+
+    LoadBankModel *m_model = nullptr;
+    QElapsedTimer m_clock;
+    std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+constexpr qint64 TestEnergyAccounting::BASE_MS;
+constexpr qint64 TestEnergyAccounting::SAMPLE_MS;
+
+void TestEnergyAccounting::feed(EnergyAccounting &accounting, const QVector<double> &voltages)
+{
+    for (int i = 0; i < voltages.size(); ++i) {
+        accounting.addVoltageSample(voltages[i], BASE_MS + i * SAMPLE_MS);
+    }
+}
+
+void TestEnergyAccounting::init()
+{
+    m_model = new LoadBankModel(this);
+    m_model->setConfig(LoadBankConfig::applicationConfig(QString(), RELAY_ROW_COUNT));
+    m_clock.start();
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void TestEnergyAccounting::cleanup()
+{
+    delete m_model;
+    m_model = nullptr;
+}
+
+void TestEnergyAccounting::trapezoidIntegration()
+{
+    EnergyAccounting accounting(m_model, m_clock);
+    m_model->setRowState(0, RelayState(0x10));      // 1.0
+    QCOMPARE(m_model->rowUnits(0), LoadSolver::UNITS_PER_VALUE);
+
+    // 额定电压下1小时，再在10秒内线性降到0：1 + 0.5×10/3600
+    QVector<double> voltages(361, 230.0);
+    voltages.append(0.0);
+    feed(accounting, voltages);
+
+    const RowAccount account = accounting.accounts()[0];
+    const double expected = 1.0 + 0.5 * 10.0 / 3600.0;
+    QVERIFY(qAbs(account.energy - expected) < 1e-9);
+    QVERIFY(qAbs(accounting.totals().value(account.unit) - expected) < 1e-9);
+
+    // 功率与电压的平方成正比
+    EnergyAccounting half(m_model, m_clock);
+    feed(half, QVector<double>(361, 115.0));
+    QVERIFY(qAbs(half.accounts()[0].energy - 0.25) < 1e-9);
+}
+
+void TestEnergyAccounting::gapIsNotIntegrated()
+{
+    EnergyAccounting accounting(m_model, m_clock);
+    m_model->setRowState(0, RelayState(0x10));
+
+    accounting.addVoltageSample(230.0, BASE_MS);
+    accounting.addVoltageSample(230.0, BASE_MS + 3600);
+    accounting.addVoltageSample(230.0, BASE_MS + 3600 + EnergyAccounting::MAX_GAP_MS + 1);
+    QVERIFY(qAbs(accounting.accounts()[0].energy - 0.001) < 1e-12);
+
+    // 乱序样本被忽略
+    accounting.addVoltageSample(230.0, BASE_MS);
+    QVERIFY(qAbs(accounting.accounts()[0].energy - 0.001) < 1e-12);
+}
+
+void TestEnergyAccounting::operationsCountedAfterSync()
+{
+    EnergyAccounting accounting(m_model, m_clock);
+
+    // 首次同步前读回的状态只作为基准
+    m_model->setRowState(1, RelayState(0x01));
+    QCOMPARE(accounting.accounts()[1].steps[0].operations, quint64(0));
+
+    emit m_model->refreshFinished(true);
+    m_model->setRowState(1, RelayState(0x03));
+    QTest::qWait(20);
+    m_model->setRowState(1, RelayState(0x00));
+
+    const RowAccount account = accounting.accounts()[1];
+    QCOMPARE(account.steps[0].operations, quint64(1));
+    QCOMPARE(account.steps[1].operations, quint64(2));
+    QCOMPARE(account.steps[2].operations, quint64(0));
+    QVERIFY(account.steps[1].onTimeMs >= 20);
+    QVERIFY(account.steps[0].onTimeMs >= account.steps[1].onTimeMs);
+
+    // 已断开的档位不再累计接通时间
+    const qint64 onTimeMs = account.steps[0].onTimeMs;
+    QTest::qWait(20);
+    QCOMPARE(accounting.accounts()[1].steps[0].onTimeMs, onTimeMs);
+
+    // 重新加载配置时各行状态清零，之后首次刷新读回的状态同样只作为基准
+    m_model->setRowState(1, RelayState(0x01));
+    QCOMPARE(accounting.accounts()[1].steps[0].operations, quint64(2));
+    const LoadBankConfig config = m_model->config();
+    m_model->setConfig(config);
+    m_model->setRowState(1, RelayState(0x01));
+    QCOMPARE(accounting.accounts()[1].steps[0].operations, quint64(2));
+
+    emit m_model->refreshFinished(true);
+    m_model->setRowState(1, RelayState(0x00));
+    QCOMPARE(accounting.accounts()[1].steps[0].operations, quint64(3));
+}
+
+void TestEnergyAccounting::checkpointRestoresCounters()
+{
+    const QString path = m_dir->filePath("energy.json");
+    RowAccount saved;
+    {
+        EnergyAccounting accounting(m_model, m_clock);
+        QVERIFY(accounting.setCheckpointPath(path));
+        emit m_model->refreshFinished(true);
+        m_model->setRowState(0, RelayState(0x10));
+        feed(accounting, QVector<double>(37, 230.0));
+        m_model->setRowState(0, RelayState(0x00));
+        QString error;
+        QVERIFY2(accounting.checkpoint(&error), qPrintable(error));
+        saved = accounting.accounts()[0];
+    }
+    QVERIFY(QFile::exists(path));
+    QVERIFY(qAbs(saved.energy - 0.1) < 1e-9);
+
+    EnergyAccounting restored(m_model, m_clock);
+    QVERIFY(restored.setCheckpointPath(path));
+    const RowAccount account = restored.accounts()[0];
+    QCOMPARE(account.name, saved.name);
+    QVERIFY(qAbs(account.energy - saved.energy) < 1e-9);
+    QCOMPARE(account.steps[4].operations, quint64(2));
+    QCOMPARE(account.steps[4].onTimeMs, saved.steps[4].onTimeMs);
+}
+
+QTEST_MAIN(TestEnergyAccounting)
+
+#include "tst_energyaccounting.moc"
@@ -0,0 +1,27 @@
+QT       += testlib widgets charts serialbus serialport network
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_energyaccounting
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_energyaccounting.cpp \
+    ../../energyaccounting.cpp \
+    ../../loadsolver.cpp \
+    ../../relaystate.cpp \
+    ../../loadbankconfig.cpp \
+    ../../loadbankmodel.cpp \
+    ../../modbusmanager.cpp \
+    ../../waveformchart.cpp
+
+HEADERS += \
+    ../../energyaccounting.h \
+    ../../loadsolver.h \
+    ../../relaystate.h \
+    ../../loadbankconfig.h \
+    ../../loadbankmodel.h \
+    ../../modbusmanager.h \
+    ../../waveformchart.h
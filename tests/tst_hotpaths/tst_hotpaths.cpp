@@ -0,0 +1,347 @@
+/**
+ * @file tst_hotpaths.cpp
+ * @brief 热点路径基准与长时间浸泡测试
+ * @details 覆盖档位求解（RowButtonGroup::solveButtonStates的核心路径）、寄存器位字段编解码、
+ *          不同窗口大小下的波形数据更新，以及经由ModbusManager和模拟从站的完整轮询周期。
+ *          模拟从站（tests/shared/fakemodbusslave.h）是进程内的Modbus TCP从站，按从站地址分别保存寄存器，不需要串口硬件。
+ *
+ * 设置环境变量 LOADBANK_SOAK_SECONDS=<秒数> 后 soakPollCycle 持续轮询指定时长，
+ * 输出轮询延迟的百分位数和常驻内存增长；未设置时跳过。
+ */
+
+#include <QtTest>
+#include <QModbusTcpClient>
+#include <QWidget>
+#include <QEventLoop>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <algorithm>
+#include <memory>
+
+#include "loadsolver.h"
+#include "relaystate.h"
+#include "loadbankconfig.h"
+#include "loadbankmodel.h"
+#include "modbusmanager.h"
+#include "waveformchart.h"
+#include "fakemodbusslave.h"
+
+/**
+ * @brief 当前进程的常驻内存
+ * @return 字节数，没有/proc/self/status的平台返回-1
+ * @details 读取VmRSS行（单位kB），不依赖平台头文件，其他平台上仍可编译
+ */
+static qint64 residentBytes()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    const QList<QByteArray> lines = status.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("VmRSS:")) {
+            const QList<QByteArray> fields = line.simplified().split(' ');
+            if (fields.size() > 1) return fields[1].toLongLong() * 1024;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 取已排序样本的百分位数
+ * @param sorted 已排序的样本
+ * @param percent 百分位（0-100）
+ * @return 百分位数
+ */
+static qint64 percentile(const QVector<qint64> &sorted, double percent)
+{
+    if (sorted.isEmpty()) return 0;
+    const int index = qBound(0, int(percent / 100.0 * (sorted.size() - 1) + 0.5), sorted.size() - 1);
+    return sorted[index];
+}
+
+class TestHotPaths : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void solveButtonStates_data();
+    void solveButtonStates();
+    void encodeRegisters();
+    void decodeRegisters();
+    void waveformUpdate_data();
+    void waveformUpdate();
+    void pollCycleThroughput();
+    void soakPollCycle();
+
+private:
+    /**
+     * @brief 让ModbusManager通过TCP客户端连接到模拟从站
+     */
+    void attachToSlave();
+
+    /**
+     * @brief 执行一次完整轮询：批量刷新各行寄存器并读取电压
+     * @param timeoutMs 超时时间
+     * @return 是否在超时前全部成功
+     */
+    bool pollCycle(int timeoutMs = 1000);
+
+    FakeModbusSlave *m_slave = nullptr;
+    LoadBankModel *m_model = nullptr;
+};
+
+/**
+ * @brief 启动模拟从站并让ModbusManager连接到它
+ */
+void TestHotPaths::initTestCase()
+{
+    m_slave = new FakeModbusSlave(this);
+    QVERIFY(m_slave->listen());
+    m_slave->setRegister(3, 7, 2300);     // 从站3寄存器7：230.0 V
+
+    attachToSlave();
+    QVERIFY(ModbusManager::instance()->isConnected());
+
+    m_model = new LoadBankModel(this);
+    m_model->setConfig(LoadBankConfig::applicationConfig(QString(), RELAY_ROW_COUNT));
+}
+
+/**
+ * @brief 让ModbusManager通过TCP客户端连接到模拟从站
+ */
+void TestHotPaths::attachToSlave()
+{
+    QModbusTcpClient *client = new QModbusTcpClient;
+    client->setConnectionParameter(QModbusDevice::NetworkAddressParameter, "127.0.0.1");
+    client->setConnectionParameter(QModbusDevice::NetworkPortParameter, m_slave->port());
+    client->setTimeout(1000);
+    client->setNumberOfRetries(0);
+    QVERIFY(client->connectDevice());
+    QTRY_COMPARE(client->state(), QModbusDevice::ConnectedState);
+    QVERIFY(ModbusManager::instance()->attachClient(client));
+}
+
+/**
+ * @brief 断开ModbusManager
+ */
+void TestHotPaths::cleanupTestCase()
+{
+    ModbusManager::instance()->closeModbus();
+}
+
+/**
+ * @brief 求解模式
+ */
+void TestHotPaths::solveButtonStates_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("minimumSteps") << int(LoadSolver::MinStepTable::MinimumSteps);
+    QTest::newRow("minimumToggles") << int(LoadSolver::MinStepTable::MinimumToggles);
+}
+
+/**
+ * @brief 基准：输入目标值后求解并更新模型中的行状态（不含界面和总线写入）
+ */
+void TestHotPaths::solveButtonStates()
+{
+    QFETCH(int, mode);
+    const LoadSolver::MinStepTable table(m_model->config().row(0).stepUnits());
+    const auto solverMode = static_cast<LoadSolver::MinStepTable::Mode>(mode);
+
+    QBENCHMARK {
+        for (int units = 0; units <= table.maxUnits(); ++units) {
+            quint64 mask = 0;
+            if (table.solve(solverMode, units, m_model->rowState(0)->bits(), &mask)) {
+                m_model->setRowState(0, RelayState(mask));
+            }
+        }
+    }
+    QCOMPARE(m_model->rowUnits(0), table.maxUnits());
+}
+
+/**
+ * @brief 基准：全部行的状态编码为寄存器位字段
+ */
+void TestHotPaths::encodeRegisters()
+{
+    const LoadBankConfig &config = m_model->config();
+    quint32 checksum = 0;
+
+    QBENCHMARK {
+        for (quint64 mask = 0; mask < 256; ++mask) {
+            for (int row = 0; row < config.rowCount(); ++row) {
+                for (const RegisterField &field : config.row(row).encode(mask)) {
+                    checksum += field.value;
+                }
+            }
+        }
+    }
+    QVERIFY(checksum != 0);
+}
+
+/**
+ * @brief 基准：寄存器读数解码为各行状态，并验证编解码互逆
+ */
+void TestHotPaths::decodeRegisters()
+{
+    const LoadBankConfig &config = m_model->config();
+    for (quint64 mask = 0; mask < 256; ++mask) {
+        for (const RegisterField &field : config.row(0).encode(mask)) {
+            QCOMPARE(config.row(0).decode(field.address, field.value, 0), mask);
+        }
+    }
+
+    quint64 checksum = 0;
+    QBENCHMARK {
+        for (int value = 0; value < 0x10000; value += 0x100) {
+            for (int row = 0; row < config.rowCount(); ++row) {
+                const LoadBankRow &rowConfig = config.row(row);
+                for (int address : rowConfig.registerAddresses()) {
+                    checksum += rowConfig.decode(address, quint16(value), 0);
+                }
+            }
+        }
+    }
+    QVERIFY(checksum != 0);
+}
+
+/**
+ * @brief 波形窗口大小
+ */
+void TestHotPaths::waveformUpdate_data()
+{
+    QTest::addColumn<int>("windowSize");
+
+    QTest::newRow("50") << 50;
+    QTest::newRow("500") << 500;
+    QTest::newRow("5000") << 5000;
+}
+
+/**
+ * @brief 基准：窗口已满时追加一个样本（含图表序列重建和回到事件循环后的合并通知）
+ * @details 合并通知由零延时定时器发出，QBENCHMARK内没有事件循环，每次追加后显式处理事件，
+ *          否则待通知缓存无限增长，测得的是向量追加而不是稳态路径
+ */
+void TestHotPaths::waveformUpdate()
+{
+    QFETCH(int, windowSize);
+
+    QWidget page;
+    QWidget container(&page);
+    container.setGeometry(0, 0, 800, 600);
+    WaveformChart chart;
+    chart.initVoltageWaveform(&container, &page);
+    chart.setMaxDataPoints(windowSize);
+    for (int i = 0; i < windowSize; ++i) {
+        chart.updateWaveformData(230.0 + (i % 10) * 0.1);
+    }
+    QCoreApplication::processEvents();
+
+    int i = 0;
+    QBENCHMARK {
+        chart.updateWaveformData(230.0 + (i++ % 10) * 0.1);
+        QCoreApplication::processEvents();
+    }
+    QCOMPARE(chart.snapshot().samples.size(), windowSize);
+}
+
+/**
+ * @brief 执行一次完整轮询
+ * @param timeoutMs 超时时间
+ * @return 是否在超时前全部成功
+ * @details 回调可能晚于超时到达，状态放在共享对象中，超时返回后迟到的回调只修改共享对象
+ */
+bool TestHotPaths::pollCycle(int timeoutMs)
+{
+    struct PollState
+    {
+        int pending = 2;
+        bool ok = true;
+        QEventLoop *loop = nullptr;
+    };
+    auto state = std::make_shared<PollState>();
+    auto done = [state](bool success) {
+        state->ok = state->ok && success;
+        if (--state->pending == 0 && state->loop) state->loop->quit();
+    };
+
+    QEventLoop loop;
+    state->loop = &loop;
+    QMetaObject::Connection refreshConnection = connect(m_model, &LoadBankModel::refreshFinished, this, done);
+    m_model->refresh();
+    ModbusManager::instance()->readSlave3Register7([done](int value) { done(value == 2300); });
+    QTimer::singleShot(timeoutMs, &loop, &QEventLoop::quit);
+    if (state->pending > 0) loop.exec();
+
+    state->loop = nullptr;
+    disconnect(refreshConnection);
+    return state->ok && state->pending == 0;
+}
+
+/**
+ * @brief 基准：完整轮询周期的吞吐量
+ */
+void TestHotPaths::pollCycleThroughput()
+{
+    m_slave->setRegister(1, REGISTER_ADDRESS_ROW1, 0x0300);
+    QVERIFY(pollCycle());
+    QCOMPARE(m_model->rowState(1)->bits(), quint64(0x03));
+
+    QBENCHMARK {
+        QVERIFY(pollCycle());
+    }
+}
+
+/**
+ * @brief 浸泡测试：持续轮询，输出延迟百分位数和内存增长
+ */
+void TestHotPaths::soakPollCycle()
+{
+    const int seconds = qEnvironmentVariableIntValue("LOADBANK_SOAK_SECONDS");
+    if (seconds <= 0) {
+        QSKIP("设置LOADBANK_SOAK_SECONDS以运行浸泡测试");
+    }
+
+    QWidget page;
+    QWidget container(&page);
+    container.setGeometry(0, 0, 800, 600);
+    WaveformChart chart;
+    chart.initVoltageWaveform(&container, &page);
+
+    QVector<qint64> latenciesUs;
+    int failures = 0;
+    const qint64 startBytes = residentBytes();
+    QElapsedTimer total;
+    QElapsedTimer cycle;
+    total.start();
+
+    while (total.elapsed() < seconds * 1000LL) {
+        cycle.start();
+        const bool ok = pollCycle();
+        chart.updateWaveformData(230.0);
+        latenciesUs.append(cycle.nsecsElapsed() / 1000);
+        if (!ok) ++failures;
+    }
+
+    const qint64 endBytes = residentBytes();
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    qInfo().noquote() << QString("浸泡 %1 s：%2 次轮询，失败 %3 次，%4 次/秒")
+                         .arg(seconds).arg(latenciesUs.size()).arg(failures)
+                         .arg(latenciesUs.size() * 1000.0 / total.elapsed(), 0, 'f', 1);
+    qInfo().noquote() << QString("轮询延迟 p50 %1 us，p95 %2 us，p99 %3 us，最大 %4 us")
+                         .arg(percentile(latenciesUs, 50)).arg(percentile(latenciesUs, 95))
+                         .arg(percentile(latenciesUs, 99)).arg(latenciesUs.isEmpty() ? 0 : latenciesUs.last());
+    if (startBytes >= 0 && endBytes >= 0) {
+        qInfo().noquote() << QString("常驻内存 %1 KB -> %2 KB（增长 %3 KB）")
+                             .arg(startBytes / 1024).arg(endBytes / 1024).arg((endBytes - startBytes) / 1024);
+    }
+
+    QCOMPARE(failures, 0);
+}
+
+QTEST_MAIN(TestHotPaths)
+
+#include "tst_hotpaths.moc"
@@ -0,0 +1,26 @@
+QT       += testlib widgets charts serialbus serialport network
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_hotpaths
+
+INCLUDEPATH += ../.. ../shared
+
+SOURCES += \
+    tst_hotpaths.cpp \
+    ../../loadsolver.cpp \
+    ../../relaystate.cpp \
+    ../../loadbankconfig.cpp \
+    ../../loadbankmodel.cpp \
+    ../../modbusmanager.cpp \
+    ../../waveformchart.cpp
+
+HEADERS += \
+    ../../loadsolver.h \
+    ../../relaystate.h \
+    ../../loadbankconfig.h \
+    ../../loadbankmodel.h \
+    ../../modbusmanager.h \
+    ../../waveformchart.h \
+    ../shared/fakemodbusslave.h
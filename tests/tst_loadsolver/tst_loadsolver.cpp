@@ -0,0 +1,282 @@
+/**
+ * @file tst_loadsolver.cpp
+ * @brief 负载档位求解测试与基准
+ * @details 验证编译期查找表与原递归回溯求解结果一致，并对比两者的求解耗时
+ */
+
+#include <QtTest>
+#include <QVector>
+#include <limits.h>
+
+#include "loadsolver.h"
+
+/**
+ * @brief 原RowButtonGroup::solveCombinations的递归回溯实现，作为正确性和性能的参照
+ */
+static void solveCombinationsReference(int target, const QVector<int> &values, int index,
+                                       QVector<bool> &used, QVector<bool> &bestUsed, int &bestCount)
+{
+    if (target == 0) {
+        int currentCount = 0;
+        for (bool b : used) {
+            if (b) currentCount++;
+        }
+
+        if (currentCount < bestCount) {
+            bestCount = currentCount;
+            bestUsed = used;
+        }
+        return;
+    }
+
+    if (index >= values.size() || target < 0) {
+        return;
+    }
+
+    used[index] = true;
+    solveCombinationsReference(target - values[index], values, index + 1, used, bestUsed, bestCount);
+    used[index] = false;
+    solveCombinationsReference(target, values, index + 1, used, bestUsed, bestCount);
+}
+
+/**
+ * @brief 原RowButtonGroup::solveButtonStates的求解流程（每次重建整数档位数组）
+ * @param targetSum 目标总和
+ * @return 继电器位掩码，无解时返回LoadSolver::NO_SOLUTION
+ */
+static int solveButtonStatesReference(double targetSum)
+{
+    const QVector<double> values = {0.1, 0.2, 0.2, 0.5, 1.0, 2.0, 2.0, 5.0};
+
+    QVector<int> intValues;
+    for (double v : values) {
+        intValues.append(static_cast<int>(v * 10));
+    }
+
+    int target = LoadSolver::toUnits(targetSum);
+
+    QVector<bool> bestUsed;
+    int bestCount = INT_MAX;
+
+    QVector<bool> used(values.size(), false);
+    solveCombinationsReference(target, intValues, 0, used, bestUsed, bestCount);
+
+    if (bestCount == INT_MAX) {
+        return LoadSolver::NO_SOLUTION;
+    }
+
+    int mask = 0;
+    for (int i = 0; i < bestUsed.size(); ++i) {
+        if (bestUsed[i]) mask |= 1 << i;
+    }
+    return mask;
+}
+
+class TestLoadSolver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tableMatchesReference();
+    void outOfRangeHasNoSolution();
+    void roundsToNearestStep();
+    void benchmarkReference();
+    void benchmarkLookup();
+    void dynamicTableMatchesExhaustive();
+    void benchmarkDynamicTable64Steps();
+    void minTogglesMatchesExhaustive_data();
+    void minTogglesMatchesExhaustive();
+    void minTogglesAddsSingleStep();
+};
+
+/**
+ * @brief 查找表与递归回溯在全部可达目标上的结果一致
+ */
+void TestLoadSolver::tableMatchesReference()
+{
+    for (int units = 0; units <= LoadSolver::MAX_TARGET_UNITS; ++units) {
+        double target = units / 10.0;
+        QCOMPARE(LoadSolver::solveMinSteps(LoadSolver::toUnits(target)), solveButtonStatesReference(target));
+    }
+}
+
+/**
+ * @brief 超出范围的目标值无解
+ */
+void TestLoadSolver::outOfRangeHasNoSolution()
+{
+    QCOMPARE(LoadSolver::solveMinSteps(-1), LoadSolver::NO_SOLUTION);
+    QCOMPARE(LoadSolver::solveMinSteps(LoadSolver::MAX_TARGET_UNITS + 1), LoadSolver::NO_SOLUTION);
+}
+
+/**
+ * @brief 目标值按0.1四舍五入（2.3 * 10 截断会得到22）
+ */
+void TestLoadSolver::roundsToNearestStep()
+{
+    QCOMPARE(LoadSolver::toUnits(2.3), 23);
+    QCOMPARE(LoadSolver::maskUnits(LoadSolver::solveMinSteps(LoadSolver::toUnits(2.3))), 23);
+}
+
+/**
+ * @brief 基准：递归回溯求解全部目标值
+ */
+void TestLoadSolver::benchmarkReference()
+{
+    int checksum = 0;
+    QBENCHMARK {
+        for (int units = 0; units <= LoadSolver::MAX_TARGET_UNITS; ++units) {
+            checksum += solveButtonStatesReference(units / 10.0);
+        }
+    }
+    QVERIFY(checksum != 0);
+}
+
+/**
+ * @brief 基准：查找表求解全部目标值
+ */
+void TestLoadSolver::benchmarkLookup()
+{
+    int checksum = 0;
+    QBENCHMARK {
+        for (int units = 0; units <= LoadSolver::MAX_TARGET_UNITS; ++units) {
+            checksum += LoadSolver::solveMinSteps(LoadSolver::toUnits(units / 10.0));
+        }
+    }
+    QVERIFY(checksum != 0);
+}
+
+/**
+ * @brief 动态规划查找表与穷举结果的档位数一致
+ */
+void TestLoadSolver::dynamicTableMatchesExhaustive()
+{
+    const QVector<int> stepUnits = {5, 5, 10, 10, 20, 20, 50, 50, 100, 100, 200, 3};
+    LoadSolver::MinStepTable table(stepUnits);
+
+    for (int target = 0; target <= table.maxUnits(); ++target) {
+        int bestCount = INT_MAX;
+        for (int mask = 0; mask < (1 << stepUnits.size()); ++mask) {
+            int sum = 0;
+            for (int i = 0; i < stepUnits.size(); ++i) {
+                if (mask & (1 << i)) sum += stepUnits[i];
+            }
+            if (sum == target) bestCount = qMin(bestCount, qPopulationCount(static_cast<quint32>(mask)));
+        }
+
+        quint64 mask = 0;
+        bool reachable = table.solve(target, &mask);
+        QCOMPARE(reachable, bestCount != INT_MAX);
+        if (!reachable) continue;
+
+        int sum = 0;
+        for (int i = 0; i < stepUnits.size(); ++i) {
+            if (mask & (Q_UINT64_C(1) << i)) sum += stepUnits[i];
+        }
+        QCOMPARE(sum, target);
+        QCOMPARE(qPopulationCount(mask), bestCount);
+    }
+}
+
+/**
+ * @brief 基准：64档负载柜生成查找表（配置加载时一次性开销）
+ */
+void TestLoadSolver::benchmarkDynamicTable64Steps()
+{
+    QVector<int> stepUnits;
+    for (int bank = 0; bank < 8; ++bank) {
+        for (int units : LoadSolver::STEP_UNITS) {
+            stepUnits.append(units * (bank + 1));
+        }
+    }
+
+    int maxUnits = 0;
+    QBENCHMARK {
+        LoadSolver::MinStepTable table(stepUnits);
+        maxUnits = table.maxUnits();
+    }
+    QVERIFY(maxUnits > 0);
+}
+
+/**
+ * @brief 最少切换求解的测试数据：默认8档（枚举路径）与自定义档位（动态规划路径）
+ */
+void TestLoadSolver::minTogglesMatchesExhaustive_data()
+{
+    QTest::addColumn<QVector<int>>("stepUnits");
+
+    QTest::newRow("default") << QVector<int>(LoadSolver::STEP_UNITS.begin(), LoadSolver::STEP_UNITS.end());
+    QTest::newRow("custom") << QVector<int>{5, 5, 10, 10, 20, 20, 50, 3, 7};
+}
+
+/**
+ * @brief 最少切换求解与穷举结果的切换次数和档位数一致
+ */
+void TestLoadSolver::minTogglesMatchesExhaustive()
+{
+    QFETCH(QVector<int>, stepUnits);
+    LoadSolver::MinStepTable table(stepUnits);
+    const int combinations = 1 << stepUnits.size();
+
+    QVector<int> sums(combinations, 0);
+    for (int mask = 0; mask < combinations; ++mask) {
+        for (int i = 0; i < stepUnits.size(); ++i) {
+            if (mask & (1 << i)) sums[mask] += stepUnits[i];
+        }
+    }
+
+    for (int current = 0; current < combinations; current += 7) {
+        for (int target = 0; target <= table.maxUnits(); ++target) {
+            int bestCost = INT_MAX;
+            for (int mask = 0; mask < combinations; ++mask) {
+                if (sums[mask] != target) continue;
+                int cost = qPopulationCount(static_cast<quint32>(mask ^ current)) * (stepUnits.size() + 1)
+                         + qPopulationCount(static_cast<quint32>(mask));
+                bestCost = qMin(bestCost, cost);
+            }
+
+            quint64 mask = 0;
+            bool reachable = table.solveMinToggles(target, static_cast<quint64>(current), &mask);
+            QCOMPARE(reachable, bestCost != INT_MAX);
+            if (!reachable) continue;
+
+            QCOMPARE(sums[static_cast<int>(mask)], target);
+            int cost = qPopulationCount(mask ^ static_cast<quint64>(current)) * (stepUnits.size() + 1)
+                     + qPopulationCount(mask);
+            QCOMPARE(cost, bestCost);
+        }
+    }
+}
+
+/**
+ * @brief 目标只增加一个最小档位时，最少切换解只闭合一个继电器：
+ *        1.9调整到2.0时最少档位解换成单个2.0档（切换5个继电器），最少切换解只闭合0.1档
+ */
+void TestLoadSolver::minTogglesAddsSingleStep()
+{
+    LoadSolver::MinStepTable table;
+
+    const quint64 current = 0x1E;   // 0.2 + 0.2 + 0.5 + 1.0
+    QCOMPARE(LoadSolver::maskUnits(static_cast<int>(current)), LoadSolver::toUnits(1.9));
+
+    quint64 minSteps = 0;
+    QVERIFY(table.solve(LoadSolver::MinStepTable::MinimumSteps, LoadSolver::toUnits(2.0), current, &minSteps));
+    quint64 minToggles = 0;
+    QVERIFY(table.solve(LoadSolver::MinStepTable::MinimumToggles, LoadSolver::toUnits(2.0), current, &minToggles));
+
+    QCOMPARE(qPopulationCount(minSteps), 1);
+    QCOMPARE(qPopulationCount(minSteps ^ current), 5);
+    QCOMPARE(minToggles, quint64(0x1F));
+    QCOMPARE(qPopulationCount(minToggles ^ current), 1);
+
+    // 从3.0的最少档位解调整到3.1同样只需闭合一个继电器
+    quint64 from = 0;
+    QVERIFY(table.solve(LoadSolver::toUnits(3.0), &from));
+    QVERIFY(table.solve(LoadSolver::MinStepTable::MinimumToggles, LoadSolver::toUnits(3.1), from, &minToggles));
+    QCOMPARE(qPopulationCount(minToggles ^ from), 1);
+    QCOMPARE(minToggles & from, from);
+}
+
+QTEST_APPLESS_MAIN(TestLoadSolver)
+
+#include "tst_loadsolver.moc"
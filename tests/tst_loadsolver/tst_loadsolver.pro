@@ -0,0 +1,16 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_loadsolver
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_loadsolver.cpp \
+    ../../loadsolver.cpp
+
+HEADERS += \
+    ../../loadsolver.h
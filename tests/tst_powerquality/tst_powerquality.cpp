@@ -0,0 +1,153 @@
+/**
+ * @file tst_powerquality.cpp
+ * @brief 电能质量事件检测测试
+ * @details 验证暂降的起止时刻、极值与回差，最短持续时间，暂降升级为中断和直接反转为暂升，以及事件日志的编号与时间段查找（修改配置后编号仍连续）
+ */
+
+#include <QtTest>
+#include <QSignalSpy>
+
+#include "powerquality.h"
+
+class TestPowerQuality : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sagWithHysteresis();
+    void minimumDuration();
+    void interruptionThenSwell();
+    void eventLogIndex();
+    void configChangeKeepsIdsConsecutive();
+
+private:
+    /**
+     * @brief 按固定周期输入样本
+     * @param detector 检测器
+     * @param voltages 各样本的电压
+     * @param startMs 第一个样本的时刻
+     * @param periodMs 采样周期
+     */
+    static void feed(PowerQualityDetector &detector, const QVector<double> &voltages,
+                     qint64 startMs = 0, qint64 periodMs = 50);
+};
+
+void TestPowerQuality::feed(PowerQualityDetector &detector, const QVector<double> &voltages,
+                            qint64 startMs, qint64 periodMs)
+{
+    for (int i = 0; i < voltages.size(); ++i) {
+        detector.addSample(voltages[i], startMs + i * periodMs);
+    }
+}
+
+void TestPowerQuality::sagWithHysteresis()
+{
+    PowerQualityDetector detector;
+    QSignalSpy started(&detector, &PowerQualityDetector::eventStarted);
+    QSignalSpy finished(&detector, &PowerQualityDetector::eventFinished);
+
+    // 209 V已回到暂降门限207 V以上，但未超过回差211.6 V，事件继续
+    feed(detector, {230, 230, 230, 230, 200, 195, 205, 209, 212, 230});
+
+    QCOMPARE(started.count(), 1);
+    QCOMPARE(finished.count(), 1);
+    const PowerQualityEvent event = finished.first().first().value<PowerQualityEvent>();
+    QCOMPARE(event.id, 1);
+    QCOMPARE(event.type, PowerQualityEvent::Sag);
+    QCOMPARE(event.startMs, qint64(200));
+    QCOMPARE(event.endMs, qint64(400));
+    QCOMPARE(event.durationMs, qint64(200));
+    QCOMPARE(event.extreme, 195.0);
+    QCOMPARE(event.firstSample, quint64(4));
+    QCOMPARE(event.lastSample, quint64(7));
+    QVERIFY(!detector.activeEvent(nullptr));
+}
+
+void TestPowerQuality::minimumDuration()
+{
+    PowerQualityDetector detector;
+    feed(detector, {230, 200, 230, 260, 230});
+    QVERIFY(detector.events().isEmpty());
+
+    // 1秒轮询时单个越限样本代表越限持续了一个采样周期
+    feed(detector, {230, 200, 230}, 1000, 1000);
+    QCOMPARE(detector.events().size(), 1);
+    QCOMPARE(detector.events().first().durationMs, qint64(1000));
+}
+
+void TestPowerQuality::interruptionThenSwell()
+{
+    PowerQualityDetector detector;
+    feed(detector, {230, 150, 10, 150, 260, 265, 230});
+
+    QCOMPARE(detector.events().size(), 2);
+    const PowerQualityEvent dip = detector.events()[0];
+    QCOMPARE(dip.type, PowerQualityEvent::Interruption);
+    QCOMPARE(dip.extreme, 10.0);
+    QCOMPARE(dip.durationMs, qint64(150));
+
+    const PowerQualityEvent swell = detector.events()[1];
+    QCOMPARE(swell.type, PowerQualityEvent::Swell);
+    QCOMPARE(swell.startMs, qint64(200));
+    QCOMPARE(swell.extreme, 265.0);
+    QCOMPARE(detector.eventCount(PowerQualityEvent::Interruption), 1);
+    QCOMPARE(detector.eventCount(PowerQualityEvent::Swell), 1);
+    QCOMPARE(detector.eventCount(PowerQualityEvent::Sag), 0);
+}
+
+void TestPowerQuality::eventLogIndex()
+{
+    PowerQualityDetector detector;
+    detector.setMaxEvents(3);
+
+    // 每秒一个持续200ms的暂降
+    for (int i = 0; i < 5; ++i) {
+        feed(detector, {230, 200, 200, 200, 200, 230}, i * 1000);
+    }
+    QCOMPARE(detector.events().size(), 3);
+    QCOMPARE(detector.eventCount(PowerQualityEvent::Sag), 5);
+
+    PowerQualityEvent event;
+    QVERIFY(!detector.findEvent(2, &event));
+    QVERIFY(detector.findEvent(4, &event));
+    QCOMPARE(event.startMs, qint64(3050));
+
+    const QVector<PowerQualityEvent> overlapping = detector.eventsBetween(3100, 4100);
+    QCOMPARE(overlapping.size(), 2);
+    QCOMPARE(overlapping[0].id, 4);
+    QCOMPARE(overlapping[1].id, 5);
+    QVERIFY(detector.eventsBetween(3300, 4000).isEmpty());
+}
+
+void TestPowerQuality::configChangeKeepsIdsConsecutive()
+{
+    PowerQualityDetector detector;
+    QSignalSpy finished(&detector, &PowerQualityDetector::eventFinished);
+
+    // 暂降已确认（编号1）时修改配置：事件在最后一个越限样本处结束并记入日志
+    feed(detector, {230, 200, 200, 200, 200});
+    PowerQualityEvent event;
+    QVERIFY(detector.activeEvent(&event));
+    QCOMPARE(event.id, 1);
+    detector.setConfig(PowerQualityConfig());
+    QVERIFY(!detector.activeEvent(nullptr));
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(detector.events().size(), 1);
+    QCOMPARE(detector.events().first().endMs, qint64(200));
+
+    // 未确认的候选事件直接放弃，不占用编号
+    feed(detector, {230, 200}, 1000);
+    detector.setConfig(PowerQualityConfig());
+    feed(detector, {230, 200, 200, 200, 200, 230}, 2000);
+
+    QCOMPARE(detector.events().size(), 2);
+    QVERIFY(detector.findEvent(1, &event));
+    QCOMPARE(event.startMs, qint64(50));
+    QVERIFY(detector.findEvent(2, &event));
+    QCOMPARE(event.startMs, qint64(2050));
+    QVERIFY(!detector.findEvent(3, &event));
+}
+
+QTEST_MAIN(TestPowerQuality)
+
+#include "tst_powerquality.moc"
@@ -0,0 +1,16 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_powerquality
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_powerquality.cpp \
+    ../../powerquality.cpp
+
+HEADERS += \
+    ../../powerquality.h
@@ -0,0 +1,115 @@
+/**
+ * @file tst_resync.cpp
+ * @brief 断线恢复后的重新同步测试
+ * @details 经由ModbusManager和进程内模拟从站，验证总线断开期间的提交保留为待下发意图，
+ *          恢复连接并重新同步后按读到的硬件状态只写入变化的档位
+ */
+
+#include <QtTest>
+#include <QModbusTcpClient>
+
+#include "relaystate.h"
+#include "loadbankconfig.h"
+#include "loadbankmodel.h"
+#include "modbusmanager.h"
+#include "fakemodbusslave.h"
+
+class TestResync : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void resyncReappliesIntents();
+
+private:
+    /**
+     * @brief 让ModbusManager通过TCP客户端连接到模拟从站
+     */
+    void attachToSlave();
+
+    FakeModbusSlave *m_slave = nullptr;
+    LoadBankModel *m_model = nullptr;
+};
+
+/**
+ * @brief 启动模拟从站，让ModbusManager连接到它并完成一次刷新
+ */
+void TestResync::initTestCase()
+{
+    m_slave = new FakeModbusSlave(this);
+    QVERIFY(m_slave->listen());
+
+    attachToSlave();
+    QVERIFY(ModbusManager::instance()->isConnected());
+
+    m_model = new LoadBankModel(this);
+    m_model->setConfig(LoadBankConfig::applicationConfig(QString(), RELAY_ROW_COUNT));
+
+    QSignalSpy refreshed(m_model, &LoadBankModel::refreshFinished);
+    m_model->refresh();
+    QTRY_COMPARE(refreshed.count(), 1);
+    QVERIFY(refreshed.at(0).at(0).toBool());
+}
+
+/**
+ * @brief 让ModbusManager通过TCP客户端连接到模拟从站
+ */
+void TestResync::attachToSlave()
+{
+    QModbusTcpClient *client = new QModbusTcpClient;
+    client->setConnectionParameter(QModbusDevice::NetworkAddressParameter, "127.0.0.1");
+    client->setConnectionParameter(QModbusDevice::NetworkPortParameter, m_slave->port());
+    client->setTimeout(1000);
+    client->setNumberOfRetries(0);
+    QVERIFY(client->connectDevice());
+    QTRY_COMPARE(client->state(), QModbusDevice::ConnectedState);
+    QVERIFY(ModbusManager::instance()->attachClient(client));
+}
+
+/**
+ * @brief 断开ModbusManager
+ */
+void TestResync::cleanupTestCase()
+{
+    ModbusManager::instance()->closeModbus();
+}
+
+/**
+ * @brief 断开期间的提交在恢复后按读到的硬件状态重新下发
+ */
+void TestResync::resyncReappliesIntents()
+{
+    ModbusManager::instance()->closeModbus();
+
+    // 断开期间提交：写入失败，目标状态保留为待下发意图，失败写入的寄存器缓存失效
+    const quint64 intent = 0x05;
+    RowCommit commit;
+    commit.row = 2;
+    commit.mask = intent;
+    commit.changedMask = intent ^ m_model->rowState(2)->bits();
+    bool committed = true;
+    m_model->commitRows({commit}, ModbusManager::NormalPriority, [&committed](bool ok) { committed = ok; });
+    QVERIFY(!committed);
+    QCOMPARE(m_model->pendingIntentCount(), 1);
+    QCOMPARE(m_model->rowState(2)->bits(), intent);
+    QVERIFY(!m_model->registerValue(REGISTER_ADDRESS_ROW2, nullptr));
+
+    // 恢复时硬件处于另一状态：重新同步应读回硬件状态，再只写入变化的档位
+    m_slave->setRegister(1, REGISTER_ADDRESS_ROW2, 0x0300);
+    attachToSlave();
+    QSignalSpy resynchronized(m_model, &LoadBankModel::resynchronized);
+    m_model->resynchronize();
+    QTRY_COMPARE(resynchronized.count(), 1);
+    QCOMPARE(resynchronized.at(0).at(0).toBool(), true);
+    QCOMPARE(resynchronized.at(0).at(1).toInt(), 1);
+
+    QTRY_COMPARE(m_model->pendingIntentCount(), 0);
+    QCOMPARE(m_slave->registerValue(1, REGISTER_ADDRESS_ROW2), quint16(intent << 8));
+    QCOMPARE(m_model->rowState(2)->bits(), intent);
+}
+
+QTEST_MAIN(TestResync)
+
+#include "tst_resync.moc"
@@ -0,0 +1,24 @@
+QT       += testlib serialbus serialport network
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_resync
+
+INCLUDEPATH += ../.. ../shared
+
+SOURCES += \
+    tst_resync.cpp \
+    ../../loadsolver.cpp \
+    ../../relaystate.cpp \
+    ../../loadbankconfig.cpp \
+    ../../loadbankmodel.cpp \
+    ../../modbusmanager.cpp
+
+HEADERS += \
+    ../../loadsolver.h \
+    ../../relaystate.h \
+    ../../loadbankconfig.h \
+    ../../loadbankmodel.h \
+    ../../modbusmanager.h \
+    ../shared/fakemodbusslave.h
@@ -0,0 +1,179 @@
+/**
+ * @file tst_rolluparchive.cpp
+ * @brief 多分辨率汇总归档测试
+ * @details 验证各层级的汇总值、按分辨率选择层级与合并、保留期限、重启后续写同一时段，以及层级配置变化时重建文件
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "rolluparchive.h"
+
+class TestRollupArchive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void rollupValues();
+    void queryUsesCoarsestTier();
+    void retentionExpiresOldRecords();
+    void reopenResumesCurrentRecord();
+    void tierChangeRebuildsFile();
+
+private:
+    /**
+     * @brief 测试层级：100ms保留1秒，1秒保留10秒，10秒保留100秒
+     * @return 层级
+     */
+    static QVector<RollupTier> testTiers();
+
+    /**
+     * @brief 从T0开始每100ms写入一个样本，第i个样本的值为i
+     * @param archive 归档
+     * @param channel 通道句柄
+     * @param count 样本数
+     */
+    static void feed(RollupArchive &archive, int channel, int count);
+
+    static constexpr qint64 T0 = 1700000000000LL;   // 按全部层级对齐的起始时刻
+    std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+constexpr qint64 TestRollupArchive::T0;
+
+QVector<RollupTier> TestRollupArchive::testTiers()
+{
+    return {
+        {"raw", 100, 1000},
+        {"1s", 1000, 10000},
+        {"10s", 10000, 100000},
+    };
+}
+
+void TestRollupArchive::feed(RollupArchive &archive, int channel, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        archive.addSample(channel, i, T0 + i * 100);
+    }
+}
+
+void TestRollupArchive::init()
+{
+    m_dir.reset(new QTemporaryDir);
+    QVERIFY(m_dir->isValid());
+}
+
+void TestRollupArchive::rollupValues()
+{
+    RollupArchive archive;
+    QVERIFY(archive.open(m_dir->path(), testTiers()));
+    const int channel = archive.channel("voltage");
+    QVERIFY(channel >= 0);
+    feed(archive, channel, 100);
+
+    int tier = -1;
+    const QVector<RollupRecord> seconds = archive.query(channel, T0, T0 + 10000, 1000, &tier);
+    QCOMPARE(tier, 1);
+    QCOMPARE(seconds.size(), 10);
+    for (int s = 0; s < seconds.size(); ++s) {
+        QCOMPARE(seconds[s].startMs, T0 + s * 1000);
+        QCOMPARE(seconds[s].count, quint32(10));
+        QCOMPARE(seconds[s].min, double(s * 10));
+        QCOMPARE(seconds[s].max, double(s * 10 + 9));
+        QCOMPARE(seconds[s].mean, s * 10 + 4.5);
+    }
+
+    // 尚未结束的10秒记录直接取内存中的值
+    const QVector<RollupRecord> whole = archive.query(channel, T0, T0 + 10000, 10000, &tier);
+    QCOMPARE(tier, 2);
+    QCOMPARE(whole.size(), 1);
+    QCOMPARE(whole[0].count, quint32(100));
+    QCOMPARE(whole[0].mean, 49.5);
+}
+
+void TestRollupArchive::queryUsesCoarsestTier()
+{
+    RollupArchive archive;
+    QVERIFY(archive.open(m_dir->path(), testTiers()));
+    const int channel = archive.channel("voltage");
+    feed(archive, channel, 100);
+
+    QCOMPARE(archive.tierForResolution(50), 0);
+    QCOMPARE(archive.tierForResolution(100), 0);
+    QCOMPARE(archive.tierForResolution(999), 0);
+    QCOMPARE(archive.tierForResolution(5000), 1);
+    QCOMPARE(archive.tierForResolution(60000), 2);
+
+    // 5秒分辨率读取1秒层级，每5条合并为一条
+    int tier = -1;
+    const QVector<RollupRecord> merged = archive.query(channel, T0, T0 + 10000, 5000, &tier);
+    QCOMPARE(tier, 1);
+    QCOMPARE(merged.size(), 2);
+    QCOMPARE(merged[0].startMs, T0);
+    QCOMPARE(merged[0].count, quint32(50));
+    QCOMPARE(merged[0].min, 0.0);
+    QCOMPARE(merged[0].max, 49.0);
+    QCOMPARE(merged[1].startMs, T0 + 5000);
+    QCOMPARE(merged[1].mean, 74.5);
+}
+
+void TestRollupArchive::retentionExpiresOldRecords()
+{
+    RollupArchive archive;
+    QVERIFY(archive.open(m_dir->path(), testTiers()));
+    const int channel = archive.channel("voltage");
+    feed(archive, channel, 150);
+
+    // 原始层级只保留最近1秒：10秒前的记录已被覆盖
+    QVERIFY(archive.query(channel, T0, T0 + 1000, 100).isEmpty());
+    const QVector<RollupRecord> recent = archive.query(channel, T0 + 14000, T0 + 15000, 100);
+    QCOMPARE(recent.size(), 10);
+    QCOMPARE(recent.first().min, 140.0);
+
+    // 1秒层级保留10秒
+    QVERIFY(archive.query(channel, T0, T0 + 4000, 1000).isEmpty());
+    QCOMPARE(archive.query(channel, T0 + 5000, T0 + 15000, 1000).size(), 10);
+}
+
+void TestRollupArchive::reopenResumesCurrentRecord()
+{
+    {
+        RollupArchive archive;
+        QVERIFY(archive.open(m_dir->path(), testTiers()));
+        feed(archive, archive.channel("voltage"), 50);
+    }
+
+    RollupArchive archive;
+    QVERIFY(archive.open(m_dir->path(), testTiers()));
+    const int channel = archive.channel("voltage");
+    archive.addSample(channel, 1000.0, T0 + 5000);
+
+    const QVector<RollupRecord> whole = archive.query(channel, T0, T0 + 10000, 10000);
+    QCOMPARE(whole.size(), 1);
+    QCOMPARE(whole[0].count, quint32(51));
+    QCOMPARE(whole[0].min, 0.0);
+    QCOMPARE(whole[0].max, 1000.0);
+}
+
+void TestRollupArchive::tierChangeRebuildsFile()
+{
+    {
+        RollupArchive archive;
+        QVERIFY(archive.open(m_dir->path(), testTiers()));
+        feed(archive, archive.channel("voltage"), 50);
+    }
+
+    QVector<RollupTier> tiers = testTiers();
+    tiers[2].retentionMs = 200000;
+    RollupArchive archive;
+    QVERIFY(archive.open(m_dir->path(), tiers));
+    const int channel = archive.channel("voltage");
+    QVERIFY(channel >= 0);
+    QVERIFY(archive.query(channel, T0, T0 + 10000, 10000).isEmpty());
+    QCOMPARE(archive.query(channel, T0, T0 + 10000, 1000).size(), 5);
+}
+
+QTEST_MAIN(TestRollupArchive)
+
+#include "tst_rolluparchive.moc"
@@ -0,0 +1,16 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_rolluparchive
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_rolluparchive.cpp \
+    ../../rolluparchive.cpp
+
+HEADERS += \
+    ../../rolluparchive.h
@@ -0,0 +1,195 @@
+/**
+ * @file tst_samplering.cpp
+ * @brief 共享内存电压样本环形缓冲区测试
+ * @details 验证发布后读取新样本、落后超过一圈时的丢失计数、游标定位的范围限制、
+ *          正在写入的槽位被跳过，以及写者并发覆盖时读者不会取到不完整的样本
+ */
+
+#include <QtTest>
+#include <QSharedMemory>
+#include <atomic>
+#include <thread>
+
+#include "samplering.h"
+
+class TestSampleRing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void publishAndReadNew();
+    void wraparoundCountsLost();
+    void seekClampsToRetainedRange();
+    void writingSlotIsSkipped();
+    void concurrentWriterNeverTears();
+
+private:
+    static QString uniqueKey();
+};
+
+/**
+ * @brief 每个测试使用独立的共享内存键，避免与运行中的程序或其他测试冲突
+ */
+QString TestSampleRing::uniqueKey()
+{
+    return QString("tst-samplering-%1-%2").arg(QCoreApplication::applicationPid()).arg(QTest::currentTestFunction());
+}
+
+void TestSampleRing::publishAndReadNew()
+{
+    SampleRingWriter writer;
+    QVERIFY(writer.create(uniqueKey(), 5, 1700000000000));
+
+    SampleRingReader reader;
+    QString error;
+    QVERIFY(!reader.attach(uniqueKey() + "-missing", &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!reader.isValid());
+
+    // 映射前发布的样本不读取
+    writer.publish(229.0, 10);
+    QVERIFY(reader.attach(uniqueKey()));
+    QCOMPARE(reader.clockEpochMs(), qint64(1700000000000));
+    QCOMPARE(reader.cursor(), quint64(1));
+
+    QVector<RingSample> samples;
+    auto collect = [&samples](const RingSample &sample) { samples.append(sample); };
+    quint64 lost = 99;
+    QCOMPARE(reader.readNew(collect, &lost), 0);
+    QCOMPARE(lost, quint64(0));
+
+    for (int i = 0; i < 5; ++i) {
+        writer.publish(230.0 + i, 100 + i);
+    }
+    QCOMPARE(reader.readNew(collect, &lost), 5);
+    QCOMPARE(lost, quint64(0));
+    for (int i = 0; i < 5; ++i) {
+        QCOMPARE(samples[i].sequence, quint64(1 + i));
+        QCOMPARE(samples[i].timestampMs, qint64(100 + i));
+        QCOMPARE(samples[i].value, 230.0 + i);
+    }
+    QCOMPARE(reader.cursor(), quint64(6));
+    QCOMPARE(reader.readNew(collect), 0);
+}
+
+void TestSampleRing::wraparoundCountsLost()
+{
+    SampleRingWriter writer;
+    QVERIFY(writer.create(uniqueKey(), 8, 0));
+    SampleRingReader reader;
+    QVERIFY(reader.attach(uniqueKey()));
+
+    // 容量8，落后20个样本：只剩最新的8个，其余12个计入丢失
+    for (int i = 0; i < 20; ++i) {
+        writer.publish(i, i);
+    }
+    QVector<quint64> sequences;
+    quint64 lost = 0;
+    QCOMPARE(reader.readNew([&sequences](const RingSample &sample) { sequences.append(sample.sequence); }, &lost), 8);
+    QCOMPARE(lost, quint64(12));
+    QCOMPARE(sequences.first(), quint64(12));
+    QCOMPARE(sequences.last(), quint64(19));
+
+    // 追上之后不再丢失
+    writer.publish(20.0, 20);
+    QCOMPARE(reader.readNew([](const RingSample &) {}, &lost), 1);
+    QCOMPARE(lost, quint64(0));
+}
+
+void TestSampleRing::seekClampsToRetainedRange()
+{
+    SampleRingWriter writer;
+    QVERIFY(writer.create(uniqueKey(), 8, 0));
+    SampleRingReader reader;
+    QVERIFY(reader.attach(uniqueKey()));
+    for (int i = 0; i < 20; ++i) {
+        writer.publish(i, i);
+    }
+
+    reader.seek(0);
+    QCOMPARE(reader.cursor(), quint64(12));
+    reader.seek(100);
+    QCOMPARE(reader.cursor(), quint64(20));
+
+    reader.seek(15);
+    QVector<double> values;
+    quint64 lost = 0;
+    QCOMPARE(reader.readNew([&values](const RingSample &sample) { values.append(sample.value); }, &lost), 5);
+    QCOMPARE(lost, quint64(0));
+    QCOMPARE(values, QVector<double>({15, 16, 17, 18, 19}));
+}
+
+void TestSampleRing::writingSlotIsSkipped()
+{
+    SampleRingWriter writer;
+    QVERIFY(writer.create(uniqueKey(), 8, 0));
+    SampleRingReader reader;
+    QVERIFY(reader.attach(uniqueKey()));
+    for (int i = 0; i < 3; ++i) {
+        writer.publish(i, i);
+    }
+
+    // 另开一个可写映射，把第1个样本的marker改为“正在写入”（2s+1），模拟读到写者写到一半的槽位
+    QSharedMemory memory(uniqueKey());
+    QVERIFY(memory.attach());
+    auto *slots = reinterpret_cast<SampleRingLayout::Slot *>(static_cast<char *>(memory.data())
+                                                              + sizeof(SampleRingLayout::Header));
+    slots[1].marker.store(2 * 1 + 1);
+
+    QVector<quint64> sequences;
+    quint64 lost = 0;
+    QCOMPARE(reader.readNew([&sequences](const RingSample &sample) { sequences.append(sample.sequence); }, &lost), 2);
+    QCOMPARE(lost, quint64(1));
+    QCOMPARE(sequences, QVector<quint64>({0, 2}));
+    memory.detach();
+}
+
+void TestSampleRing::concurrentWriterNeverTears()
+{
+    constexpr quint64 TOTAL = 200000;
+
+    // 容量很小，写者持续覆盖读者正在读取的槽位，迫使读者走校验失败的路径
+    SampleRingWriter writer;
+    QVERIFY(writer.create(uniqueKey(), 4, 0));
+    SampleRingReader reader;
+    QVERIFY(reader.attach(uniqueKey()));
+
+    std::atomic<bool> done(false);
+    std::thread producer([&writer, &done]() {
+        for (quint64 s = 0; s < TOTAL; ++s) {
+            writer.publish(s * 0.5, static_cast<qint64>(s));
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    quint64 delivered = 0;
+    quint64 lostTotal = 0;
+    quint64 lastSequence = 0;
+    bool first = true;
+    bool consistent = true;
+    auto check = [&](const RingSample &sample) {
+        // 时间戳和电压都由序号决定，取到不完整或被覆盖的样本时会不一致
+        if (sample.timestampMs != qint64(sample.sequence) || sample.value != sample.sequence * 0.5
+                || (!first && sample.sequence <= lastSequence)) {
+            consistent = false;
+        }
+        first = false;
+        lastSequence = sample.sequence;
+    };
+    for (bool finished = false; !finished;) {
+        finished = done.load(std::memory_order_acquire);
+        quint64 lost = 0;
+        delivered += reader.readNew(check, &lost);
+        lostTotal += lost;
+    }
+    producer.join();
+
+    QVERIFY(consistent);
+    QVERIFY(delivered > 0);
+    QCOMPARE(delivered + lostTotal, TOTAL);
+    QCOMPARE(reader.cursor(), TOTAL);
+}
+
+QTEST_APPLESS_MAIN(TestSampleRing)
+
+#include "tst_samplering.moc"
@@ -0,0 +1,16 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_samplering
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_samplering.cpp \
+    ../../samplering.cpp
+
+HEADERS += \
+    ../../samplering.h
@@ -0,0 +1,92 @@
+/**
+ * @file tst_signalfilter.cpp
+ * @brief 采样滤波测试
+ * @details 验证滑动中值去除尖峰、EMA阶跃响应、卡尔曼收敛，以及滤波链描述的解析、失败时保持原链和重置
+ */
+
+#include <QtTest>
+
+#include "signalfilter.h"
+
+class TestSignalFilter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void medianRemovesSpike();
+    void emaStepResponse();
+    void kalmanConverges();
+    void pipelineSpec();
+};
+
+void TestSignalFilter::medianRemovesSpike()
+{
+    MedianFilter filter(3);
+    const QVector<double> input = {230, 230, 260, 230, 231, 229, 200, 230};
+    const QVector<double> expected = {230, 230, 230, 230, 231, 230, 229, 229};
+    for (int i = 0; i < input.size(); ++i) {
+        QCOMPARE(filter.process(input[i]), expected[i]);
+    }
+
+    // 窗口未满时取已有样本的中值
+    MedianFilter partial(5);
+    QCOMPARE(partial.process(1.0), 1.0);
+    QCOMPARE(partial.process(3.0), 2.0);
+    QCOMPARE(partial.process(2.0), 2.0);
+}
+
+void TestSignalFilter::emaStepResponse()
+{
+    EmaFilter filter(0.5);
+    QCOMPARE(filter.process(0.0), 0.0);
+    QCOMPARE(filter.process(10.0), 5.0);
+    QCOMPARE(filter.process(10.0), 7.5);
+    QCOMPARE(filter.process(10.0), 8.75);
+
+    filter.reset();
+    QCOMPARE(filter.process(100.0), 100.0);
+}
+
+void TestSignalFilter::kalmanConverges()
+{
+    KalmanFilter filter(1e-4, 1.0);
+    double estimate = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        estimate = filter.process(i % 2 ? 231.0 : 229.0);
+    }
+    QVERIFY(qAbs(estimate - 230.0) < 0.2);
+}
+
+void TestSignalFilter::pipelineSpec()
+{
+    FilterPipeline pipeline;
+    QVERIFY(pipeline.isEmpty());
+    QCOMPARE(pipeline.process(231.5), 231.5);
+
+    QVERIFY(pipeline.setSpec("median:5, ema:0.3"));
+    QCOMPARE(pipeline.spec(), QString("median:5,ema:0.3"));
+    QVERIFY(pipeline.setSpec(FilterPipeline::DEFAULT_VOLTAGE_SPEC));
+    QCOMPARE(pipeline.spec(), QString(FilterPipeline::DEFAULT_VOLTAGE_SPEC));
+
+    QString error;
+    QVERIFY(!pipeline.setSpec("median:4", &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!pipeline.setSpec("ema:0.3,lowpass:2"));
+    QVERIFY(!pipeline.setSpec("kalman:0.1"));
+    QCOMPARE(pipeline.spec(), QString(FilterPipeline::DEFAULT_VOLTAGE_SPEC));
+
+    // median:3,ema:0.5：尖峰被中值去除，EMA只平滑剩余的台阶
+    QCOMPARE(pipeline.process(230.0), 230.0);
+    QCOMPARE(pipeline.process(230.0), 230.0);
+    QCOMPARE(pipeline.process(300.0), 230.0);
+    pipeline.reset();
+    QCOMPARE(pipeline.process(220.0), 220.0);
+
+    QVERIFY(pipeline.setSpec("none"));
+    QVERIFY(pipeline.isEmpty());
+    QCOMPARE(pipeline.spec(), QString("none"));
+}
+
+QTEST_MAIN(TestSignalFilter)
+
+#include "tst_signalfilter.moc"
@@ -0,0 +1,16 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_signalfilter
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_signalfilter.cpp \
+    ../../signalfilter.cpp
+
+HEADERS += \
+    ../../signalfilter.h
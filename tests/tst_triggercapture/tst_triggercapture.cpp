@@ -0,0 +1,268 @@
+/**
+ * @file tst_triggercapture.cpp
+ * @brief 触发捕获测试
+ * @details 在合成波形上验证各触发模式的检测、电平条件的锁存、预触发和后触发窗口的内容与相对时间，
+ *          以及撤防、自动重新布防、捕获中变更配置和快照数量上限
+ */
+
+#include <QtTest>
+
+#include "triggercapture.h"
+
+class TestTriggerCapture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void windowExitPrePostWindow();
+    void levelConditionLatches();
+    void edgeSlopes();
+    void thresholdAndRate();
+    void armingAndRearm();
+    void configChangeAbandonsCapture();
+    void eventLimit();
+
+private:
+    static void feed(TriggerCapture *capture, const QVector<double> &values,
+                     qint64 startMs = 0, int intervalMs = 10);
+};
+
+/**
+ * @brief 按固定间隔输入一段合成波形
+ */
+void TestTriggerCapture::feed(TriggerCapture *capture, const QVector<double> &values,
+                              qint64 startMs, int intervalMs)
+{
+    for (int i = 0; i < values.size(); ++i) {
+        capture->addSample(values[i], startMs + i * intervalMs);
+    }
+}
+
+void TestTriggerCapture::windowExitPrePostWindow()
+{
+    TriggerCapture capture;
+    TriggerConfig config;
+    config.preTriggerSamples = 3;
+    config.postTriggerSamples = 2;
+    capture.setConfig(config);
+    capture.arm();
+
+    QVector<CapturedEvent> delivered;
+    connect(&capture, &TriggerCapture::eventCaptured, this,
+            [&delivered](const CapturedEvent &event) { delivered.append(event); });
+
+    // 第5个样本（50 ms）越出上限，后触发采集两个样本后冻结
+    feed(&capture, {230, 231, 232, 233, 234, 260, 235, 236, 237, 238});
+    QCOMPARE(delivered.size(), 1);
+    QCOMPARE(capture.state(), TriggerCapture::Armed);
+
+    const CapturedEvent &event = delivered.first();
+    QCOMPARE(event.id, 1);
+    QCOMPARE(event.triggerTimestampMs, qint64(50));
+    QCOMPARE(event.triggerValue, 260.0);
+    QCOMPARE(event.mode, TriggerConfig::WindowExit);
+    QCOMPARE(event.description(), QString("#1 窗口越限 260.0 V @ 0.1 s"));
+
+    // 预触发只保留最近3个样本，x为相对触发点的秒数
+    const QVector<QPointF> expected = {
+        {-0.03, 232}, {-0.02, 233}, {-0.01, 234}, {0.0, 260}, {0.01, 235}, {0.02, 236}
+    };
+    QCOMPARE(event.points.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QVERIFY(qAbs(event.points[i].x() - expected[i].x()) < 1e-9);
+        QCOMPARE(event.points[i].y(), expected[i].y());
+    }
+    QCOMPARE(capture.capturedEvents().size(), 1);
+
+    // 预触发缓冲区未满时只拷贝已有样本；无后触发时触发点即冻结
+    config.preTriggerSamples = 5;
+    config.postTriggerSamples = 0;
+    capture.setConfig(config);
+    feed(&capture, {230, 200}, 1000);
+    QCOMPARE(delivered.size(), 2);
+    QCOMPARE(delivered.last().id, 2);
+    QCOMPARE(delivered.last().points.size(), 2);
+    QCOMPARE(delivered.last().points.last(), QPointF(0.0, 200));
+}
+
+void TestTriggerCapture::levelConditionLatches()
+{
+    TriggerCapture capture;
+    TriggerConfig config;
+    config.preTriggerSamples = 0;
+    config.postTriggerSamples = 1;
+    capture.setConfig(config);
+    capture.arm();
+
+    // 持续越限只触发一次，回到窗口内后再次越限才重新触发
+    feed(&capture, {230, 260, 261, 262, 263, 264});
+    QCOMPARE(capture.capturedEvents().size(), 1);
+    QCOMPARE(capture.capturedEvents().first().points.size(), 2);
+
+    feed(&capture, {230, 200, 199}, 100);
+    QCOMPARE(capture.capturedEvents().size(), 2);
+    QCOMPARE(capture.capturedEvents().last().triggerValue, 200.0);
+    QCOMPARE(capture.capturedEvents().last().triggerTimestampMs, qint64(110));
+}
+
+void TestTriggerCapture::edgeSlopes()
+{
+    TriggerConfig config;
+    config.mode = TriggerConfig::Edge;
+    config.level = 230.0;
+    config.preTriggerSamples = 1;
+    config.postTriggerSamples = 1;
+    const QVector<double> wave = {220, 225, 235, 240, 225, 220, 235, 240};
+
+    // 上升沿出现在20 ms和60 ms
+    TriggerCapture rising;
+    config.slope = TriggerConfig::Rising;
+    rising.setConfig(config);
+    rising.arm();
+    feed(&rising, wave);
+    QCOMPARE(rising.capturedEvents().size(), 2);
+    QCOMPARE(rising.capturedEvents()[0].triggerTimestampMs, qint64(20));
+    QCOMPARE(rising.capturedEvents()[1].triggerTimestampMs, qint64(60));
+    QCOMPARE(rising.capturedEvents()[0].points,
+             QVector<QPointF>({{-0.01, 225}, {0.0, 235}, {0.01, 240}}));
+
+    // 下降沿出现在40 ms
+    TriggerCapture falling;
+    config.slope = TriggerConfig::Falling;
+    falling.setConfig(config);
+    falling.arm();
+    feed(&falling, wave);
+    QCOMPARE(falling.capturedEvents().size(), 1);
+    QCOMPARE(falling.capturedEvents()[0].triggerValue, 225.0);
+
+    TriggerCapture both;
+    config.slope = TriggerConfig::Both;
+    both.setConfig(config);
+    both.arm();
+    feed(&both, wave);
+    QCOMPARE(both.capturedEvents().size(), 3);
+}
+
+void TestTriggerCapture::thresholdAndRate()
+{
+    TriggerConfig config;
+    config.preTriggerSamples = 0;
+    config.postTriggerSamples = 0;
+
+    TriggerCapture threshold;
+    config.mode = TriggerConfig::Threshold;
+    config.slope = TriggerConfig::Falling;
+    config.level = 210.0;
+    threshold.setConfig(config);
+    threshold.arm();
+    feed(&threshold, {230, 220, 210, 205, 215, 209});
+    QCOMPARE(threshold.capturedEvents().size(), 2);
+    QCOMPARE(threshold.capturedEvents()[0].triggerValue, 210.0);
+    QCOMPARE(threshold.capturedEvents()[1].triggerValue, 209.0);
+
+    // 100 ms间隔：0.5 V为5 V/s不触发，2 V为20 V/s触发
+    TriggerCapture rate;
+    config.mode = TriggerConfig::RateOfChange;
+    config.slope = TriggerConfig::Both;
+    config.rateLimit = 10.0;
+    rate.setConfig(config);
+    rate.arm();
+    feed(&rate, {230.0, 230.5, 231.0, 229.0, 229.5}, 0, 100);
+    QCOMPARE(rate.capturedEvents().size(), 1);
+    QCOMPARE(rate.capturedEvents()[0].triggerTimestampMs, qint64(300));
+    QCOMPARE(rate.capturedEvents()[0].mode, TriggerConfig::RateOfChange);
+
+    // 时间戳不前进时不计算变化率
+    rate.addSample(260.0, 400);
+    rate.addSample(200.0, 400);
+    QCOMPARE(rate.capturedEvents().size(), 1);
+}
+
+void TestTriggerCapture::armingAndRearm()
+{
+    TriggerCapture capture;
+    QCOMPARE(capture.state(), TriggerCapture::Disarmed);
+
+    TriggerConfig config;
+    config.preTriggerSamples = 2;
+    config.postTriggerSamples = 1;
+    config.autoRearm = false;
+    capture.setConfig(config);
+
+    // 未布防时不触发，但预触发缓冲区照常记录
+    feed(&capture, {230, 260, 230});
+    QVERIFY(capture.capturedEvents().isEmpty());
+
+    capture.arm();
+    QCOMPARE(capture.state(), TriggerCapture::Armed);
+    capture.addSample(260.0, 30);
+    QCOMPARE(capture.state(), TriggerCapture::Capturing);
+    capture.addSample(230.0, 40);
+    QCOMPARE(capture.capturedEvents().size(), 1);
+    QCOMPARE(capture.capturedEvents()[0].points,
+             QVector<QPointF>({{-0.02, 260}, {-0.01, 230}, {0.0, 260}, {0.01, 230}}));
+
+    // 不自动重新布防
+    QCOMPARE(capture.state(), TriggerCapture::Disarmed);
+    feed(&capture, {260, 230}, 50);
+    QCOMPARE(capture.capturedEvents().size(), 1);
+
+    capture.arm();
+    capture.addSample(260.0, 100);
+    capture.disarm();
+    QCOMPARE(capture.state(), TriggerCapture::Disarmed);
+    feed(&capture, {230, 230}, 110);
+    QCOMPARE(capture.capturedEvents().size(), 1);
+
+    capture.clearCapturedEvents();
+    QVERIFY(capture.capturedEvents().isEmpty());
+}
+
+void TestTriggerCapture::configChangeAbandonsCapture()
+{
+    TriggerCapture capture;
+    TriggerConfig config;
+    config.preTriggerSamples = 2;
+    config.postTriggerSamples = 5;
+    capture.setConfig(config);
+    capture.arm();
+
+    feed(&capture, {230, 231, 260, 232});
+    QCOMPARE(capture.state(), TriggerCapture::Capturing);
+
+    // 变更配置后放弃捕获并清空预触发缓冲区
+    config.postTriggerSamples = 1;
+    capture.setConfig(config);
+    QCOMPARE(capture.state(), TriggerCapture::Armed);
+    QCOMPARE(capture.config().postTriggerSamples, 1);
+
+    feed(&capture, {233, 200, 234}, 100);
+    QCOMPARE(capture.capturedEvents().size(), 1);
+    const CapturedEvent &event = capture.capturedEvents().first();
+    QCOMPARE(event.id, 2);
+    QCOMPARE(event.points, QVector<QPointF>({{-0.01, 233}, {0.0, 200}, {0.01, 234}}));
+}
+
+void TestTriggerCapture::eventLimit()
+{
+    TriggerCapture capture;
+    TriggerConfig config;
+    config.preTriggerSamples = 0;
+    config.postTriggerSamples = 0;
+    capture.setConfig(config);
+    capture.setMaxCapturedEvents(2);
+    capture.arm();
+
+    feed(&capture, {260, 230, 260, 230, 260, 230});
+    QCOMPARE(capture.capturedEvents().size(), 2);
+    QCOMPARE(capture.capturedEvents()[0].id, 2);
+    QCOMPARE(capture.capturedEvents()[1].id, 3);
+
+    capture.setMaxCapturedEvents(1);
+    QCOMPARE(capture.capturedEvents().size(), 1);
+    QCOMPARE(capture.capturedEvents()[0].id, 3);
+}
+
+QTEST_MAIN(TestTriggerCapture)
+
+#include "tst_triggercapture.moc"
@@ -0,0 +1,16 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_triggercapture
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_triggercapture.cpp \
+    ../../triggercapture.cpp
+
+HEADERS += \
+    ../../triggercapture.h
@@ -0,0 +1,179 @@
+/**
+ * @file tst_voltagestatistics.cpp
+ * @brief 电压流式统计测试
+ * @details 在已知输入上验证窗口均值、RMS、标准差、最值和百分位数，验证样本按时间过期、
+ *          缓冲区满时淘汰最旧样本，以及增量结果与逐窗口直接计算一致和全程累计
+ */
+
+#include <QtTest>
+#include <QtMath>
+#include <algorithm>
+
+#include "voltagestatistics.h"
+
+class TestVoltageStatistics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void knownWindowValues();
+    void samplesExpire();
+    void capacityBound();
+    void matchesDirectComputation();
+    void lifetimeSummary();
+};
+
+void TestVoltageStatistics::knownWindowValues()
+{
+    SlidingWindowStats window(1000, 100);
+    const StatisticsSummary empty = window.summary();
+    QCOMPARE(empty.count, 0);
+    QCOMPARE(empty.mean, 0.0);
+    QCOMPARE(window.percentile(0.5), 0.0);
+
+    for (int i = 1; i <= 5; ++i) {
+        window.addSample(i, i * 100);
+    }
+
+    // 1..5：均值3，总体方差2，平方均值11
+    const StatisticsSummary s = window.summary();
+    QCOMPARE(s.windowMs, 1000);
+    QCOMPARE(s.count, 5);
+    QCOMPARE(s.mean, 3.0);
+    QCOMPARE(s.stdDev, qSqrt(2.0));
+    QCOMPARE(s.rms, qSqrt(11.0));
+    QCOMPARE(s.min, 1.0);
+    QCOMPARE(s.max, 5.0);
+
+    // 百分位取第 floor(fraction * (n - 1)) 个样本
+    QCOMPARE(s.p5, 1.0);
+    QCOMPARE(s.p50, 3.0);
+    QCOMPARE(s.p95, 4.0);
+    QCOMPARE(window.percentile(1.0), 5.0);
+    QCOMPARE(window.percentile(-1.0), 1.0);
+
+    window.clear();
+    QCOMPARE(window.count(), 0);
+    QCOMPARE(window.summary().max, 0.0);
+}
+
+void TestVoltageStatistics::samplesExpire()
+{
+    SlidingWindowStats window(1000, 100);
+    window.addSample(100.0, 0);
+    window.addSample(200.0, 100);
+    window.addSample(230.0, 900);
+    QCOMPARE(window.count(), 3);
+    QCOMPARE(window.summary().max, 200.0);
+
+    // 时间戳不晚于 now - windowMs 的样本过期，最值随之更新
+    window.addSample(231.0, 1000);
+    QCOMPARE(window.count(), 3);
+    QCOMPARE(window.summary().min, 200.0);
+
+    window.addSample(229.0, 1100);
+    const StatisticsSummary s = window.summary();
+    QCOMPARE(s.count, 3);
+    QCOMPARE(s.min, 229.0);
+    QCOMPARE(s.max, 231.0);
+    QCOMPARE(s.mean, 230.0);
+    QCOMPARE(s.p50, 230.0);
+}
+
+void TestVoltageStatistics::capacityBound()
+{
+    // 容量为 1000 / 100 = 10，采样快于预期时淘汰最旧样本
+    SlidingWindowStats window(1000, 100);
+    for (int i = 0; i < 20; ++i) {
+        window.addSample(i, i);
+    }
+    const StatisticsSummary s = window.summary();
+    QCOMPARE(s.count, 10);
+    QCOMPARE(s.min, 10.0);
+    QCOMPARE(s.max, 19.0);
+    QCOMPARE(s.mean, 14.5);
+    QCOMPARE(s.p50, 14.0);
+}
+
+void TestVoltageStatistics::matchesDirectComputation()
+{
+    SlidingWindowStats window(2000, 100);
+    QVector<QPair<qint64, double>> samples;
+    qint64 now = 0;
+    for (int i = 0; i < 500; ++i) {
+        now += 100 + (i * 37) % 150;
+        const double value = qRound((230.0 + 8.0 * qSin(i * 0.3) + (i % 7) * 0.4) * 10.0) / 10.0;
+        window.addSample(value, now);
+        samples.append(qMakePair(now, value));
+
+        // 直接对窗口内样本求值
+        QVector<double> inWindow;
+        for (const auto &sample : samples) {
+            if (sample.first > now - 2000) inWindow.append(sample.second);
+        }
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        for (double v : inWindow) {
+            sum += v;
+            sumSquares += v * v;
+        }
+        const double mean = sum / inWindow.size();
+        double m2 = 0.0;
+        for (double v : inWindow) {
+            m2 += (v - mean) * (v - mean);
+        }
+        std::sort(inWindow.begin(), inWindow.end());
+
+        const StatisticsSummary s = window.summary();
+        QCOMPARE(s.count, int(inWindow.size()));
+        QVERIFY(qAbs(s.mean - mean) < 1e-9);
+        QVERIFY(qAbs(s.stdDev - qSqrt(m2 / inWindow.size())) < 1e-6);
+        QVERIFY(qAbs(s.rms - qSqrt(sumSquares / inWindow.size())) < 1e-6);
+        QCOMPARE(s.min, inWindow.first());
+        QCOMPARE(s.max, inWindow.last());
+        const int rank = static_cast<int>(0.5 * (inWindow.size() - 1));
+        QVERIFY(qAbs(s.p50 - inWindow[rank]) < SlidingWindowStats::HISTOGRAM_RESOLUTION / 2);
+    }
+}
+
+void TestVoltageStatistics::lifetimeSummary()
+{
+    VoltageStatistics statistics;
+    QCOMPARE(statistics.windowCount(), 3);
+
+    statistics.setWindows({1000, 5000});
+    QCOMPARE(statistics.windowCount(), 2);
+
+    QSignalSpy spy(&statistics, &VoltageStatistics::statisticsUpdated);
+    const QVector<double> values = {220.0, 240.0, 230.0, 210.0};
+    for (int i = 0; i < values.size(); ++i) {
+        statistics.addSample(values[i], i * 1000);
+    }
+    QCOMPARE(int(spy.count()), int(values.size()));
+
+    // 短窗口只剩最后一个样本，长窗口与全程一致
+    QCOMPARE(statistics.summary(0).count, 1);
+    QCOMPARE(statistics.summary(0).mean, 210.0);
+    QCOMPARE(statistics.summary(1).count, 4);
+
+    const StatisticsSummary lifetime = statistics.lifetimeSummary();
+    QCOMPARE(lifetime.count, 4);
+    QCOMPARE(lifetime.mean, 225.0);
+    QCOMPARE(lifetime.stdDev, qSqrt(125.0));
+    QCOMPARE(lifetime.min, 210.0);
+    QCOMPARE(lifetime.max, 240.0);
+    QCOMPARE(lifetime.p50, 0.0);
+    QCOMPARE(statistics.summary(1).mean, lifetime.mean);
+
+    QTest::ignoreMessage(QtWarningMsg, "统计窗口索引无效: 2");
+    QCOMPARE(statistics.summary(2).count, 0);
+
+    statistics.clear();
+    QCOMPARE(statistics.lifetimeSummary().count, 0);
+    QCOMPARE(statistics.summary(1).count, 0);
+    QVERIFY(statistics.formatSummaries().contains("暂无数据"));
+}
+
+QTEST_MAIN(TestVoltageStatistics)
+
+#include "tst_voltagestatistics.moc"
@@ -0,0 +1,16 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_voltagestatistics
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_voltagestatistics.cpp \
+    ../../voltagestatistics.cpp
+
+HEADERS += \
+    ../../voltagestatistics.h
@@ -0,0 +1,271 @@
+/**
+ * @file triggercapture.cpp
+ * @brief 触发捕获类实现文件
+ * @details 包含TriggerCapture类的实现
+ */
+
+#include "triggercapture.h"
+#include <QDebug>
+
+/**
+ * @brief 生成事件描述文本
+ * @return 描述文本，例如"#3 窗口越限 207.5 V @ 125.0 s"
+ */
+QString CapturedEvent::description() const
+{
+    QString modeName;
+    switch (mode) {
+        case TriggerConfig::Threshold: modeName = "阈值"; break;
+        case TriggerConfig::Edge: modeName = "边沿"; break;
+        case TriggerConfig::WindowExit: modeName = "窗口越限"; break;
+        case TriggerConfig::RateOfChange: modeName = "变化率"; break;
+    }
+    return QString("#%1 %2 %3 V @ %4 s")
+            .arg(id)
+            .arg(modeName)
+            .arg(triggerValue, 0, 'f', 1)
+            .arg(triggerTimestampMs / 1000.0, 0, 'f', 1);
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ */
+TriggerCapture::TriggerCapture(QObject *parent)
+    : QObject(parent)
+    , m_state(Disarmed)
+    , m_preHead(0)
+    , m_preSize(0)
+    , m_hasPrevious(false)
+    , m_previous{0, 0.0}
+    , m_conditionLatched(false)
+    , m_postRemaining(0)
+    , m_maxEvents(20)
+    , m_nextEventId(1)
+{
+    setConfig(TriggerConfig());
+}
+
+/**
+ * @brief 设置触发配置
+ * @param config 触发配置
+ */
+void TriggerCapture::setConfig(const TriggerConfig &config)
+{
+    m_config = config;
+    m_config.preTriggerSamples = qMax(0, m_config.preTriggerSamples);
+    m_config.postTriggerSamples = qMax(0, m_config.postTriggerSamples);
+
+    m_preRing.resize(qMax(1, m_config.preTriggerSamples));
+    m_preHead = 0;
+    m_preSize = 0;
+    m_hasPrevious = false;
+    m_conditionLatched = false;
+
+    if (m_state == Capturing) {
+        qDebug() << "触发配置已变更，放弃正在进行的捕获";
+        m_state = Armed;
+    }
+}
+
+/**
+ * @brief 获取触发配置
+ * @return 触发配置
+ */
+TriggerConfig TriggerCapture::config() const
+{
+    return m_config;
+}
+
+/**
+ * @brief 布防触发器
+ */
+void TriggerCapture::arm()
+{
+    if (m_state == Disarmed) {
+        m_state = Armed;
+        m_conditionLatched = false;
+        qDebug() << "触发器已布防";
+    }
+}
+
+/**
+ * @brief 撤防触发器
+ */
+void TriggerCapture::disarm()
+{
+    m_state = Disarmed;
+    qDebug() << "触发器已撤防";
+}
+
+/**
+ * @brief 获取触发器状态
+ * @return 当前状态
+ */
+TriggerCapture::State TriggerCapture::state() const
+{
+    return m_state;
+}
+
+/**
+ * @brief 判断当前样本是否满足触发条件
+ * @param value 样本值
+ * @param timestampMs 单调时间戳（毫秒）
+ * @return 是否满足触发条件
+ */
+bool TriggerCapture::evaluate(double value, qint64 timestampMs) const
+{
+    switch (m_config.mode) {
+        case TriggerConfig::Threshold:
+            if (m_config.slope == TriggerConfig::Falling) {
+                return value <= m_config.level;
+            }
+            return value >= m_config.level;
+
+        case TriggerConfig::Edge: {
+            if (!m_hasPrevious) return false;
+            bool rising = m_previous.value < m_config.level && value >= m_config.level;
+            bool falling = m_previous.value > m_config.level && value <= m_config.level;
+            if (m_config.slope == TriggerConfig::Rising) return rising;
+            if (m_config.slope == TriggerConfig::Falling) return falling;
+            return rising || falling;
+        }
+
+        case TriggerConfig::WindowExit:
+            return value < m_config.windowLow || value > m_config.windowHigh;
+
+        case TriggerConfig::RateOfChange: {
+            if (!m_hasPrevious) return false;
+            qint64 dt = timestampMs - m_previous.timestampMs;
+            if (dt <= 0) return false;
+            double rate = (value - m_previous.value) * 1000.0 / dt;
+            if (m_config.slope == TriggerConfig::Rising) return rate >= m_config.rateLimit;
+            if (m_config.slope == TriggerConfig::Falling) return rate <= -m_config.rateLimit;
+            return qAbs(rate) >= m_config.rateLimit;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 输入一个样本
+ * @param value 样本值
+ * @param timestampMs 单调时间戳（毫秒）
+ */
+void TriggerCapture::addSample(double value, qint64 timestampMs)
+{
+    bool fired = evaluate(value, timestampMs);
+    bool triggeredNow = false;
+
+    if (m_conditionLatched) {
+        // 条件解除后才允许再次触发
+        if (!fired) m_conditionLatched = false;
+    } else if (fired && m_state == Armed) {
+        m_conditionLatched = true;
+        startCapture(value, timestampMs);
+        triggeredNow = true;
+    }
+
+    if (m_state == Capturing && !triggeredNow) {
+        appendCapturePoint(value, timestampMs);
+        m_postRemaining--;
+    }
+
+    if (m_state == Capturing && m_postRemaining <= 0) {
+        finishCapture();
+    }
+
+    // 写入预触发环形缓冲区
+    if (m_config.preTriggerSamples > 0) {
+        m_preRing[m_preHead] = Sample{timestampMs, value};
+        m_preHead = (m_preHead + 1) % m_preRing.size();
+        if (m_preSize < m_preRing.size()) m_preSize++;
+    }
+
+    m_previous = Sample{timestampMs, value};
+    m_hasPrevious = true;
+}
+
+/**
+ * @brief 开始捕获
+ * @param value 触发样本值
+ * @param timestampMs 触发时刻
+ * @details 按时间顺序拷贝预触发缓冲区并追加触发样本
+ */
+void TriggerCapture::startCapture(double value, qint64 timestampMs)
+{
+    m_current = CapturedEvent();
+    m_current.id = m_nextEventId++;
+    m_current.triggerTimestampMs = timestampMs;
+    m_current.triggerValue = value;
+    m_current.mode = m_config.mode;
+    m_current.points.reserve(m_preSize + 1 + m_config.postTriggerSamples);
+
+    int start = (m_preHead - m_preSize + m_preRing.size()) % m_preRing.size();
+    for (int i = 0; i < m_preSize; ++i) {
+        const Sample &sample = m_preRing[(start + i) % m_preRing.size()];
+        appendCapturePoint(sample.value, sample.timestampMs);
+    }
+    appendCapturePoint(value, timestampMs);
+
+    m_postRemaining = m_config.postTriggerSamples;
+    m_state = Capturing;
+
+    qDebug() << "触发捕获开始 -" << m_current.description();
+}
+
+/**
+ * @brief 向当前快照追加一个点
+ * @param value 样本值
+ * @param timestampMs 样本时刻
+ */
+void TriggerCapture::appendCapturePoint(double value, qint64 timestampMs)
+{
+    double relativeSeconds = (timestampMs - m_current.triggerTimestampMs) / 1000.0;
+    m_current.points.append(QPointF(relativeSeconds, value));
+}
+
+/**
+ * @brief 完成捕获，冻结快照
+ */
+void TriggerCapture::finishCapture()
+{
+    if (m_events.size() >= m_maxEvents) {
+        m_events.removeFirst();
+    }
+    m_events.append(m_current);
+
+    m_state = m_config.autoRearm ? Armed : Disarmed;
+
+    qDebug() << "触发捕获完成 -" << m_current.description() << "点数:" << m_current.points.size();
+    emit eventCaptured(m_events.last());
+}
+
+/**
+ * @brief 获取已捕获的事件
+ * @return 事件快照数组
+ */
+const QVector<CapturedEvent> &TriggerCapture::capturedEvents() const
+{
+    return m_events;
+}
+
+/**
+ * @brief 清除所有已捕获的事件
+ */
+void TriggerCapture::clearCapturedEvents()
+{
+    m_events.clear();
+}
+
+/**
+ * @brief 设置保留的快照数量上限
+ * @param maxEvents 快照数量上限
+ */
+void TriggerCapture::setMaxCapturedEvents(int maxEvents)
+{
+    m_maxEvents = qMax(1, maxEvents);
+    while (m_events.size() > m_maxEvents) {
+        m_events.removeFirst();
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file triggercapture.h
+ * @brief 触发捕获类定义文件
+ * @details 包含TriggerCapture类的声明，在采样流上实现类似示波器的触发：
+ *          阈值、边沿、窗口越限和变化率条件，带预触发环形缓冲区和后触发捕获长度
+ */
+
+#ifndef TRIGGERCAPTURE_H
+#define TRIGGERCAPTURE_H
+
+#include <QObject>
+#include <QVector>
+#include <QPointF>
+#include <QString>
+
+/**
+ * @struct TriggerConfig
+ * @brief 触发条件配置
+ */
+struct TriggerConfig
+{
+    /**
+     * @brief 触发模式
+     */
+    enum Mode {
+        Threshold,      // 电平条件：Rising为不低于电平，Falling为不高于电平
+        Edge,           // 边沿：相邻两个样本穿越电平
+        WindowExit,     // 窗口越限：样本离开[windowLow, windowHigh]
+        RateOfChange    // 变化率：相邻样本的斜率超过rateLimit（单位/秒）
+    };
+
+    /**
+     * @brief 触发方向
+     */
+    enum Slope {
+        Rising,         // 上升
+        Falling,        // 下降
+        Both            // 双向（Threshold模式下按Rising处理）
+    };
+
+    Mode mode = WindowExit;
+    Slope slope = Both;
+    double level = 230.0;           // 阈值/边沿电平
+    double windowLow = 207.0;       // 窗口下限（额定230V的90%）
+    double windowHigh = 253.0;      // 窗口上限（额定230V的110%）
+    double rateLimit = 10.0;        // 变化率门限（单位/秒）
+    int preTriggerSamples = 20;     // 预触发样本数
+    int postTriggerSamples = 30;    // 后触发样本数（含触发点之后的样本）
+    bool autoRearm = true;          // 捕获完成后自动重新布防
+};
+
+/**
+ * @struct CapturedEvent
+ * @brief 冻结的触发捕获快照
+ */
+struct CapturedEvent
+{
+    int id = 0;                     // 事件编号
+    qint64 triggerTimestampMs = 0;  // 触发时刻（单调时间戳，毫秒）
+    double triggerValue = 0.0;      // 触发样本值
+    TriggerConfig::Mode mode = TriggerConfig::WindowExit;  // 触发模式
+    QVector<QPointF> points;        // 快照数据，x为相对触发点的时间（秒）
+
+    /**
+     * @brief 生成事件描述文本
+     * @return 描述文本
+     */
+    QString description() const;
+};
+
+/**
+ * @class TriggerCapture
+ * @brief 触发捕获引擎
+ * @details 每个样本仅执行一次常数时间的条件判断和环形缓冲区写入；
+ *          触发后预触发缓冲区只在触发时刻拷贝一次，后触发样本直接追加到预分配的快照中。
+ *          电平类条件（Threshold、WindowExit）在条件解除前不会重复触发，避免持续越限时刷屏
+ */
+class TriggerCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 触发器状态
+     */
+    enum State {
+        Disarmed,       // 未布防
+        Armed,          // 已布防，等待触发
+        Capturing       // 已触发，正在采集后触发样本
+    };
+
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit TriggerCapture(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置触发配置
+     * @param config 触发配置，设置后预触发缓冲区清空，正在进行的捕获被放弃
+     */
+    void setConfig(const TriggerConfig &config);
+
+    /**
+     * @brief 获取触发配置
+     * @return 触发配置
+     */
+    TriggerConfig config() const;
+
+    /**
+     * @brief 布防触发器
+     */
+    void arm();
+
+    /**
+     * @brief 撤防触发器
+     */
+    void disarm();
+
+    /**
+     * @brief 获取触发器状态
+     * @return 当前状态
+     */
+    State state() const;
+
+    /**
+     * @brief 输入一个样本
+     * @param value 样本值
+     * @param timestampMs 单调时间戳（毫秒）
+     */
+    void addSample(double value, qint64 timestampMs);
+
+    /**
+     * @brief 获取已捕获的事件
+     * @return 事件快照数组（最旧的在前）
+     */
+    const QVector<CapturedEvent> &capturedEvents() const;
+
+    /**
+     * @brief 清除所有已捕获的事件
+     */
+    void clearCapturedEvents();
+
+    /**
+     * @brief 设置保留的快照数量上限
+     * @param maxEvents 快照数量上限
+     */
+    void setMaxCapturedEvents(int maxEvents);
+
+signals:
+    /**
+     * @brief 事件捕获完成信号
+     * @param event 冻结的事件快照
+     */
+    void eventCaptured(const CapturedEvent &event);
+
+private:
+    struct Sample
+    {
+        qint64 timestampMs;
+        double value;
+    };
+
+    bool evaluate(double value, qint64 timestampMs) const;
+    void startCapture(double value, qint64 timestampMs);
+    void finishCapture();
+    void appendCapturePoint(double value, qint64 timestampMs);
+
+private:
+    TriggerConfig m_config;
+    State m_state;
+    QVector<Sample> m_preRing;          // 预触发环形缓冲区
+    int m_preHead;                      // 下一个写入位置
+    int m_preSize;                      // 有效样本数
+    bool m_hasPrevious;                 // 是否已有上一个样本
+    Sample m_previous;                  // 上一个样本
+    bool m_conditionLatched;            // 电平条件已触发且尚未解除
+    int m_postRemaining;                // 剩余后触发样本数
+    CapturedEvent m_current;            // 正在采集的快照
+    QVector<CapturedEvent> m_events;    // 已冻结的快照
+    int m_maxEvents;                    // 快照数量上限
+    int m_nextEventId;                  // 下一个事件编号
+};
+
+#endif // TRIGGERCAPTURE_H
@@ -0,0 +1,391 @@
+/**
+ * @file voltageregulator.cpp
+ * @brief 闭环稳压调节器实现文件
+ * @details 包含VoltageRegulator类的实现
+ */
+
+#include "voltageregulator.h"
+#include "loadbankmodel.h"
+#include "modbusmanager.h"
+#include <QDebug>
+#include <QtMath>
+
+constexpr int VoltageRegulator::SUMMARY_INTERVAL_CYCLES;
+
+/**
+ * @brief 加入一个样本
+ * @param x 样本值
+ */
+void VoltageRegulator::RunningStats::add(double x)
+{
+    ++count;
+    double delta = x - mean;
+    mean += delta / count;
+    m2 += delta * (x - mean);
+    maxAbs = qMax(maxAbs, qAbs(x));
+}
+
+/**
+ * @brief 获取标准差
+ * @return 样本标准差，样本不足两个时为0
+ */
+double VoltageRegulator::RunningStats::stdDev() const
+{
+    return count > 1 ? qSqrt(m2 / (count - 1)) : 0.0;
+}
+
+/**
+ * @brief 构造函数
+ * @param model 负载柜数据模型
+ * @param parent 父对象指针
+ */
+VoltageRegulator::VoltageRegulator(LoadBankModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_maxUnits(0)
+    , m_running(false)
+    , m_measurementPending(false)
+    , m_runId(0)
+    , m_integral(0.0)
+    , m_lastError(0.0)
+    , m_lastMeasureNs(-1)
+    , m_appliedUnits(0)
+    , m_lastSwitchMs(-1)
+    , m_lastTickNs(-1)
+    , m_settleStartMs(0)
+    , m_inBandSinceMs(-1)
+    , m_settled(false)
+{
+    // 精确定时器：默认的粗精度定时器允许5%的误差，会直接表现为周期抖动
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &VoltageRegulator::onTick);
+}
+
+/**
+ * @brief 设置调节器参数
+ * @param config 调节器参数
+ */
+void VoltageRegulator::setConfig(const RegulatorConfig &config)
+{
+    const bool setpointChanged = !qFuzzyCompare(config.setpoint, m_config.setpoint);
+    m_config = config;
+    m_config.periodMs = qMax(1, m_config.periodMs);
+    m_config.maxUnitsPerCycle = qMax(1, m_config.maxUnitsPerCycle);
+
+    if (m_running) {
+        m_timer.setInterval(m_config.periodMs);
+        if (setpointChanged) {
+            setSetpoint(m_config.setpoint);
+        }
+    }
+}
+
+/**
+ * @brief 获取调节器参数
+ * @return 调节器参数
+ */
+const RegulatorConfig &VoltageRegulator::config() const
+{
+    return m_config;
+}
+
+/**
+ * @brief 修改设定值
+ * @param setpoint 目标电压（V）
+ */
+void VoltageRegulator::setSetpoint(double setpoint)
+{
+    m_config.setpoint = setpoint;
+    if (!m_running) return;
+
+    // 设定值阶跃：重新开始调节时间计时
+    m_settleStartMs = m_clock.elapsed();
+    m_inBandSinceMs = -1;
+    m_settled = false;
+    qDebug() << "闭环稳压设定值改为" << setpoint << "V";
+}
+
+/**
+ * @brief 开始调节
+ * @param errorString 失败时的错误描述
+ * @return 是否开始调节
+ */
+bool VoltageRegulator::start(QString *errorString)
+{
+    if (m_running) {
+        if (errorString) *errorString = "调节器已在运行";
+        return false;
+    }
+    if (!ModbusManager::instance()->isConnected()) {
+        if (errorString) *errorString = "Modbus未连接";
+        return false;
+    }
+
+    m_rows.clear();
+    m_solvers.clear();
+    m_maxUnits = 0;
+    const QVector<int> &rows = m_config.rows;
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        if (!rows.isEmpty() && !rows.contains(row)) continue;
+        LoadSolver::MinStepTable solver(m_model->config().row(row).stepUnits());
+        m_maxUnits += solver.maxUnits();
+        m_rows.append(row);
+        m_solvers.append(solver);
+    }
+    if (m_rows.isEmpty() || m_maxUnits == 0) {
+        if (errorString) *errorString = "没有可用于调节的负载行";
+        return false;
+    }
+
+    // 以当前负载为积分初值，启动时不产生输出跳变
+    m_appliedUnits = currentUnits();
+    m_integral = static_cast<double>(m_appliedUnits) / LoadSolver::UNITS_PER_VALUE;
+    m_lastError = 0.0;
+    m_lastMeasureNs = -1;
+    m_lastSwitchMs = -1;
+    m_lastTickNs = -1;
+    m_measurementPending = false;
+    m_stats = RegulatorStatistics();
+    m_periodJitter = RunningStats();
+    m_latency = RunningStats();
+
+    m_clock.start();
+    m_settleStartMs = 0;
+    m_inBandSinceMs = -1;
+    m_settled = false;
+
+    m_running = true;
+    ++m_runId;
+    m_timer.start(m_config.periodMs);
+
+    qDebug() << "闭环稳压开始 - 设定值:" << m_config.setpoint << "V 周期:" << m_config.periodMs << "ms 行:" << m_rows
+             << "负载上限:" << static_cast<double>(m_maxUnits) / LoadSolver::UNITS_PER_VALUE;
+    return true;
+}
+
+/**
+ * @brief 停止调节
+ */
+void VoltageRegulator::stop()
+{
+    if (!m_running) return;
+
+    m_running = false;
+    m_timer.stop();
+    ++m_runId;
+    logSummary();
+    emit stopped();
+}
+
+/**
+ * @brief 是否正在调节
+ * @return 是否正在调节
+ */
+bool VoltageRegulator::isRunning() const
+{
+    return m_running;
+}
+
+/**
+ * @brief 获取运行统计
+ * @return 运行统计
+ */
+RegulatorStatistics VoltageRegulator::statistics() const
+{
+    RegulatorStatistics stats = m_stats;
+    stats.periodJitterMeanMs = m_periodJitter.mean;
+    stats.periodJitterStdDevMs = m_periodJitter.stdDev();
+    stats.periodJitterMaxMs = m_periodJitter.maxAbs;
+    stats.latencyMeanMs = m_latency.mean;
+    stats.latencyMaxMs = m_latency.maxAbs;
+    return stats;
+}
+
+/**
+ * @brief 定时周期处理函数
+ * @details 上一周期的测量尚未返回时跳过本周期并计为超限，避免请求在总线队列中堆积
+ */
+void VoltageRegulator::onTick()
+{
+    const qint64 tickNs = m_clock.nsecsElapsed();
+    if (m_lastTickNs >= 0) {
+        m_periodJitter.add((tickNs - m_lastTickNs) / 1e6 - m_config.periodMs);
+    }
+    m_lastTickNs = tickNs;
+    ++m_stats.cycles;
+
+    if (m_stats.cycles % SUMMARY_INTERVAL_CYCLES == 0) {
+        logSummary();
+    }
+
+    if (m_measurementPending) {
+        ++m_stats.overruns;
+        return;
+    }
+
+    m_measurementPending = true;
+    const quint64 runId = m_runId;
+    ModbusManager::instance()->readSlave3Register7([this, runId, tickNs](int value) {
+        if (runId != m_runId) return;
+        m_measurementPending = false;
+        if (value == -1) {
+            ++m_stats.failedReads;
+            return;
+        }
+        m_latency.add((m_clock.nsecsElapsed() - tickNs) / 1e6);
+        runCycle(value * ModbusManager::instance()->busMap().voltageScale, tickNs);
+    }, ModbusManager::ControlPriority);
+}
+
+/**
+ * @brief 用一次测量执行控制计算并输出
+ * @param voltage 测量电压（V）
+ * @param tickNs 本周期触发时刻（纳秒）
+ */
+void VoltageRegulator::runCycle(double voltage, qint64 tickNs)
+{
+    const qint64 nowMs = tickNs / 1000000;
+    const double dt = m_lastMeasureNs >= 0 ? (tickNs - m_lastMeasureNs) / 1e9 : m_config.periodMs / 1000.0;
+    m_lastMeasureNs = tickNs;
+
+    // 电压偏高时增加负载；死区内误差视为0，积分项保持不变
+    double error = voltage - m_config.setpoint;
+    updateSettling(error, nowMs);
+    if (qAbs(error) < m_config.deadband) {
+        error = 0.0;
+    }
+
+    const double derivative = (error - m_lastError) / dt;
+    m_lastError = error;
+
+    const double maxValue = static_cast<double>(m_maxUnits) / LoadSolver::UNITS_PER_VALUE;
+    const double candidateIntegral = m_integral + m_config.ki * error * dt;
+    const double unclamped = m_config.kp * error + candidateIntegral + m_config.kd * derivative;
+    const double output = qBound(0.0, unclamped, maxValue);
+
+    // 条件积分抗饱和：输出饱和且误差继续推向饱和方向时不累积积分
+    const bool saturatedHigh = unclamped > maxValue && error > 0;
+    const bool saturatedLow = unclamped < 0.0 && error < 0;
+    if (!saturatedHigh && !saturatedLow) {
+        m_integral = candidateIntegral;
+    }
+    // 限速期间积分不超出输出范围，避免长时间限速后过冲
+    m_integral = qBound(0.0, m_integral, maxValue);
+
+    // 防抖：变化不足回差或距上次动作太近时不动作；动作时每次最多变化maxUnitsPerCycle
+    int targetUnits = LoadSolver::toUnits(output);
+    const int delta = targetUnits - m_appliedUnits;
+    const bool dwellElapsed = m_lastSwitchMs < 0 || nowMs - m_lastSwitchMs >= m_config.minSwitchIntervalMs;
+    if (delta != 0 && qAbs(delta) >= m_config.hysteresisUnits && dwellElapsed) {
+        targetUnits = m_appliedUnits + qBound(-m_config.maxUnitsPerCycle, delta, m_config.maxUnitsPerCycle);
+        m_appliedUnits = applyOutput(targetUnits);
+        m_lastSwitchMs = nowMs;
+    }
+
+    emit cycleCompleted(voltage, static_cast<double>(m_appliedUnits) / LoadSolver::UNITS_PER_VALUE);
+}
+
+/**
+ * @brief 更新调节时间判定
+ * @param error 当前误差（V）
+ * @param nowMs 当前时刻（毫秒）
+ */
+void VoltageRegulator::updateSettling(double error, qint64 nowMs)
+{
+    if (qAbs(error) > m_config.settleBand) {
+        if (m_settled) {
+            // 稳定后再次越出稳定带（负载扰动），从此刻重新计时
+            qDebug() << "闭环稳压越出稳定带，误差:" << error << "V";
+            m_settled = false;
+            m_settleStartMs = nowMs;
+        }
+        m_inBandSinceMs = -1;
+        return;
+    }
+
+    if (m_inBandSinceMs < 0) {
+        m_inBandSinceMs = nowMs;
+    }
+    if (!m_settled && nowMs - m_inBandSinceMs >= m_config.settleHoldMs) {
+        m_settled = true;
+        m_stats.settlingTimeMs = m_inBandSinceMs - m_settleStartMs;
+        qDebug() << "闭环稳压已稳定，调节时间:" << m_stats.settlingTimeMs << "ms";
+        emit settled(m_stats.settlingTimeMs);
+    }
+}
+
+/**
+ * @brief 把总负载按行顺序分配并写入
+ * @param targetUnits 总负载（0.1为单位）
+ * @return 实际投入的总负载（0.1为单位）
+ * @details 前面的行先填满；某行组合不出分到的值时取其下方最近的可达值，余量留给后面的行
+ */
+int VoltageRegulator::applyOutput(int targetUnits)
+{
+    QVector<RowCommit> commits;
+    int remaining = qBound(0, targetUnits, m_maxUnits);
+    int applied = 0;
+
+    for (int i = 0; i < m_rows.size(); ++i) {
+        const int row = m_rows[i];
+        const LoadSolver::MinStepTable &solver = m_solvers[i];
+        const quint64 current = m_model->rowState(row)->bits();
+
+        quint64 mask = 0;
+        int units = qMin(remaining, solver.maxUnits());
+        while (units > 0 && !solver.solve(LoadSolver::MinStepTable::MinimumToggles, units, current, &mask)) {
+            --units;
+        }
+        if (units == 0) mask = 0;
+        remaining -= units;
+        applied += units;
+
+        if (mask != current) {
+            RowCommit commit;
+            commit.row = row;
+            commit.mask = mask;
+            commit.changedMask = mask ^ current;
+            commits.append(commit);
+            m_stats.relayOperations += RelayState(commit.changedMask).count();
+        }
+    }
+
+    if (!commits.isEmpty()) {
+        for (const RowCommit &commit : commits) {
+            emit rowCommitted(commit.row);
+        }
+        ++m_stats.commits;
+        m_model->commitRows(commits, ModbusManager::ControlPriority, [](bool ok) {
+            if (!ok) qWarning() << "闭环稳压输出写入失败";
+        });
+    }
+    return applied;
+}
+
+/**
+ * @brief 当前投入的总负载
+ * @return 参与调节各行的档位之和（0.1为单位）
+ */
+int VoltageRegulator::currentUnits() const
+{
+    int units = 0;
+    for (int row : m_rows) {
+        units += m_model->rowUnits(row);
+    }
+    return units;
+}
+
+/**
+ * @brief 输出统计摘要
+ */
+void VoltageRegulator::logSummary() const
+{
+    const RegulatorStatistics stats = statistics();
+    qDebug().nospace() << "闭环稳压统计 - 周期:" << stats.cycles << " 超限:" << stats.overruns
+                       << " 测量失败:" << stats.failedReads << " 输出:" << stats.commits
+                       << " 继电器动作:" << stats.relayOperations
+                       << " 周期抖动(均值/标准差/最大, ms):" << stats.periodJitterMeanMs << "/"
+                       << stats.periodJitterStdDevMs << "/" << stats.periodJitterMaxMs
+                       << " 测量延迟(均值/最大, ms):" << stats.latencyMeanMs << "/" << stats.latencyMaxMs
+                       << " 调节时间(ms):" << stats.settlingTimeMs;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file voltageregulator.h
+ * @brief 闭环稳压调节器定义文件
+ * @details 包含RegulatorConfig、RegulatorStatistics和VoltageRegulator的声明。VoltageRegulator以固定周期读取电压，
+ *          用PID算出需要投入的负载，经死区、限速和最短动作间隔处理后用最少切换组合写入负载柜；
+ *          测量与输出均使用总线的控制优先级，统计周期抖动与调节时间
+ */
+
+#ifndef VOLTAGEREGULATOR_H
+#define VOLTAGEREGULATOR_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+
+#include "loadsolver.h"
+
+class LoadBankModel;
+
+/**
+ * @struct RegulatorConfig
+ * @brief 调节器参数
+ * @details 被控对象为发电机/电源：投入负载使电压下降。误差取测量值减设定值，电压偏高时增加负载
+ */
+struct RegulatorConfig
+{
+    double setpoint = 220.0;            // 目标电压（V）
+    double kp = 0.2;                    // 比例系数（负载值/V）
+    double ki = 0.5;                    // 积分系数（负载值/(V·s)）
+    double kd = 0.0;                    // 微分系数（负载值·s/V）
+    int periodMs = 100;                 // 控制周期，9600波特下一次读+一次写约需40ms
+    QVector<int> rows;                  // 参与调节的行，按顺序填充；为空时使用全部行
+    double deadband = 0.5;              // 误差死区（V），死区内不改变输出
+    int hysteresisUnits = 2;            // 输出变化不足该值（0.1为单位）时不动作
+    int minSwitchIntervalMs = 300;      // 两次继电器动作的最短间隔
+    int maxUnitsPerCycle = 10;          // 每次动作输出的最大变化量（0.1为单位）
+    double settleBand = 1.0;            // 稳定判定带（V）
+    int settleHoldMs = 2000;            // 在稳定带内持续该时间视为已稳定
+};
+
+/**
+ * @struct RegulatorStatistics
+ * @brief 调节器运行统计
+ */
+struct RegulatorStatistics
+{
+    qint64 cycles = 0;                  // 定时周期数
+    qint64 overruns = 0;                // 上一周期测量未返回而跳过的周期数
+    qint64 failedReads = 0;             // 测量失败次数
+    qint64 commits = 0;                 // 输出写入次数
+    qint64 relayOperations = 0;         // 继电器动作总数
+    double periodJitterMeanMs = 0.0;    // 实际周期与设定周期之差的均值
+    double periodJitterStdDevMs = 0.0;  // 实际周期与设定周期之差的标准差
+    double periodJitterMaxMs = 0.0;     // 实际周期与设定周期之差的最大绝对值
+    double latencyMeanMs = 0.0;         // 定时触发到测量返回的平均延迟
+    double latencyMaxMs = 0.0;          // 定时触发到测量返回的最大延迟
+    qint64 settlingTimeMs = -1;         // 最近一次调节时间（设定变化到进入并保持在稳定带），未稳定为-1
+};
+
+/**
+ * @class VoltageRegulator
+ * @brief 闭环稳压调节器
+ */
+class VoltageRegulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int SUMMARY_INTERVAL_CYCLES = 100;    // 每隔该周期数输出一次统计
+
+    /**
+     * @brief 构造函数
+     * @param model 负载柜数据模型
+     * @param parent 父对象指针
+     */
+    explicit VoltageRegulator(LoadBankModel *model, QObject *parent = nullptr);
+
+    /**
+     * @brief 设置调节器参数
+     * @param config 调节器参数，运行中设置时设定值变化会重新开始调节时间计时
+     */
+    void setConfig(const RegulatorConfig &config);
+
+    /**
+     * @brief 获取调节器参数
+     * @return 调节器参数
+     */
+    const RegulatorConfig &config() const;
+
+    /**
+     * @brief 修改设定值
+     * @param setpoint 目标电压（V）
+     */
+    void setSetpoint(double setpoint);
+
+    /**
+     * @brief 开始调节
+     * @param errorString 失败时的错误描述，可为nullptr
+     * @return 是否开始调节
+     * @details 以当前投入的负载为积分初值（无扰切换）
+     */
+    bool start(QString *errorString = nullptr);
+
+    /**
+     * @brief 停止调节，已投入的负载保持不变
+     */
+    void stop();
+
+    /**
+     * @brief 是否正在调节
+     * @return 是否正在调节
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief 获取运行统计
+     * @return 运行统计
+     */
+    RegulatorStatistics statistics() const;
+
+signals:
+    /**
+     * @brief 一个控制周期完成
+     * @param voltage 测量电压（V）
+     * @param outputValue 当前投入的负载值
+     */
+    void cycleCompleted(double voltage, double outputValue);
+
+    /**
+     * @brief 某行的状态已由调节器写入
+     * @param row 行索引
+     */
+    void rowCommitted(int row);
+
+    /**
+     * @brief 电压进入稳定带并保持
+     * @param settlingTimeMs 调节时间（毫秒）
+     */
+    void settled(qint64 settlingTimeMs);
+
+    /**
+     * @brief 调节已停止
+     */
+    void stopped();
+
+private slots:
+    /**
+     * @brief 定时周期处理函数：发出控制优先级的测量请求
+     */
+    void onTick();
+
+private:
+    /**
+     * @struct RunningStats
+     * @brief Welford累计统计
+     */
+    struct RunningStats
+    {
+        qint64 count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        double maxAbs = 0.0;
+
+        void add(double x);
+        double stdDev() const;
+    };
+
+    /**
+     * @brief 用一次测量执行控制计算并输出
+     * @param voltage 测量电压（V）
+     * @param tickNs 本周期触发时刻（纳秒）
+     */
+    void runCycle(double voltage, qint64 tickNs);
+
+    /**
+     * @brief 更新调节时间判定
+     * @param error 当前误差（V）
+     * @param nowMs 当前时刻（毫秒）
+     */
+    void updateSettling(double error, qint64 nowMs);
+
+    /**
+     * @brief 把总负载按行顺序分配并写入
+     * @param targetUnits 总负载（0.1为单位）
+     * @return 实际投入的总负载（0.1为单位）
+     */
+    int applyOutput(int targetUnits);
+
+    /**
+     * @brief 当前投入的总负载
+     * @return 参与调节各行的档位之和（0.1为单位）
+     */
+    int currentUnits() const;
+
+    /**
+     * @brief 输出统计摘要
+     */
+    void logSummary() const;
+
+    LoadBankModel *m_model;                         // 负载柜数据模型
+    RegulatorConfig m_config;                       // 调节器参数
+    QVector<int> m_rows;                            // 本次运行参与调节的行
+    QVector<LoadSolver::MinStepTable> m_solvers;    // 各调节行的求解器
+    int m_maxUnits;                                 // 参与调节各行的负载上限（0.1为单位）
+    QTimer m_timer;                                 // 控制周期定时器
+    QElapsedTimer m_clock;                          // 运行开始时启动的单调时钟
+    bool m_running;                                 // 是否正在调节
+    bool m_measurementPending;                      // 本周期测量是否尚未返回
+    quint64 m_runId;                                // 运行序号，用于丢弃上一次运行的迟到应答
+
+    double m_integral;                              // 积分项（负载值）
+    double m_lastError;                             // 上一周期误差
+    qint64 m_lastMeasureNs;                         // 上一次测量时刻，-1表示尚无
+    int m_appliedUnits;                             // 已投入的总负载（0.1为单位）
+    qint64 m_lastSwitchMs;                          // 上一次继电器动作时刻，-1表示尚无
+
+    qint64 m_lastTickNs;                            // 上一周期触发时刻
+    qint64 m_settleStartMs;                         // 调节时间计时起点
+    qint64 m_inBandSinceMs;                         // 进入稳定带的时刻，-1表示不在带内
+    bool m_settled;                                 // 是否已稳定
+
+    RegulatorStatistics m_stats;                    // 计数类统计
+    RunningStats m_periodJitter;                    // 周期抖动统计
+    RunningStats m_latency;                         // 测量延迟统计
+};
+
+#endif // VOLTAGEREGULATOR_H
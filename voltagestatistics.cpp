@@ -0,0 +1,364 @@
+/**
+ * @file voltagestatistics.cpp
+ * @brief 电压流式统计类实现文件
+ * @details 包含SlidingWindowStats与VoltageStatistics类的实现
+ */
+
+#include "voltagestatistics.h"
+#include <QtMath>
+#include <QDebug>
+#include <limits.h>
+
+constexpr double SlidingWindowStats::HISTOGRAM_MIN;
+constexpr double SlidingWindowStats::HISTOGRAM_MAX;
+constexpr double SlidingWindowStats::HISTOGRAM_RESOLUTION;
+
+/**
+ * @brief 构造函数
+ * @param windowMs 窗口长度（毫秒）
+ * @param minIntervalMs 预期的最小采样间隔（毫秒）
+ * @details 环形缓冲区和单调队列的容量均为 windowMs / minIntervalMs，
+ *          采样速率超出预期时最旧样本被提前淘汰，内存不会继续增长
+ */
+SlidingWindowStats::SlidingWindowStats(int windowMs, int minIntervalMs)
+    : m_windowMs(qMax(1, windowMs))
+    , m_head(0)
+    , m_size(0)
+    , m_firstSequence(0)
+    , m_mean(0.0)
+    , m_m2(0.0)
+    , m_minHead(0)
+    , m_minSize(0)
+    , m_maxHead(0)
+    , m_maxSize(0)
+{
+    int capacity = qMax(1, m_windowMs / qMax(1, minIntervalMs));
+    m_ring.resize(capacity);
+    m_minQueue.resize(capacity);
+    m_maxQueue.resize(capacity);
+
+    int binCount = static_cast<int>((HISTOGRAM_MAX - HISTOGRAM_MIN) / HISTOGRAM_RESOLUTION) + 1;
+    m_histogram.fill(0, binCount);
+}
+
+/**
+ * @brief 计算样本值所在的直方图区间
+ * @param value 样本值
+ * @return 区间索引，超出范围的值归入两端区间
+ */
+int SlidingWindowStats::binOf(double value) const
+{
+    int bin = qRound((value - HISTOGRAM_MIN) / HISTOGRAM_RESOLUTION);
+    return qBound(0, bin, m_histogram.size() - 1);
+}
+
+/**
+ * @brief 按序号访问环形缓冲区中的样本
+ * @param sequence 样本序号，必须位于窗口内
+ * @return 样本引用
+ */
+const SlidingWindowStats::Sample &SlidingWindowStats::sampleAt(quint64 sequence) const
+{
+    int offset = static_cast<int>(sequence - m_firstSequence);
+    return m_ring[(m_head + offset) % m_ring.size()];
+}
+
+/**
+ * @brief 加入一个样本并淘汰过期样本
+ * @param value 样本值
+ * @param timestampMs 单调时间戳（毫秒）
+ */
+void SlidingWindowStats::addSample(double value, qint64 timestampMs)
+{
+    // 淘汰超出时间窗口的样本
+    while (m_size > 0 && sampleAt(m_firstSequence).timestampMs <= timestampMs - m_windowMs) {
+        removeOldest();
+    }
+
+    // 缓冲区已满时淘汰最旧样本，保证内存有界
+    if (m_size == m_ring.size()) {
+        removeOldest();
+    }
+
+    const int capacity = m_ring.size();
+    const quint64 sequence = m_firstSequence + m_size;
+    const int bin = binOf(value);
+    m_ring[(m_head + m_size) % capacity] = Sample{timestampMs, value, bin};
+    m_size++;
+
+    // Welford增量更新
+    double delta = value - m_mean;
+    m_mean += delta / m_size;
+    m_m2 += delta * (value - m_mean);
+
+    // 维护最小值单调队列（队首为窗口最小值）
+    while (m_minSize > 0 && sampleAt(m_minQueue[(m_minHead + m_minSize - 1) % capacity]).value >= value) {
+        m_minSize--;
+    }
+    m_minQueue[(m_minHead + m_minSize) % capacity] = sequence;
+    m_minSize++;
+
+    // 维护最大值单调队列（队首为窗口最大值）
+    while (m_maxSize > 0 && sampleAt(m_maxQueue[(m_maxHead + m_maxSize - 1) % capacity]).value <= value) {
+        m_maxSize--;
+    }
+    m_maxQueue[(m_maxHead + m_maxSize) % capacity] = sequence;
+    m_maxSize++;
+
+    m_histogram[bin]++;
+}
+
+/**
+ * @brief 移除窗口内最旧的样本
+ * @details 执行Welford逆向更新，并同步维护单调队列与直方图
+ */
+void SlidingWindowStats::removeOldest()
+{
+    if (m_size == 0) return;
+
+    const int capacity = m_ring.size();
+    const Sample &oldest = m_ring[m_head];
+
+    if (m_size == 1) {
+        m_mean = 0.0;
+        m_m2 = 0.0;
+    } else {
+        double newMean = (m_mean * m_size - oldest.value) / (m_size - 1);
+        m_m2 -= (oldest.value - m_mean) * (oldest.value - newMean);
+        m_mean = newMean;
+        // 浮点误差可能使二阶矩略小于0
+        if (m_m2 < 0.0) m_m2 = 0.0;
+    }
+
+    if (m_minSize > 0 && m_minQueue[m_minHead] == m_firstSequence) {
+        m_minHead = (m_minHead + 1) % capacity;
+        m_minSize--;
+    }
+    if (m_maxSize > 0 && m_maxQueue[m_maxHead] == m_firstSequence) {
+        m_maxHead = (m_maxHead + 1) % capacity;
+        m_maxSize--;
+    }
+
+    m_histogram[oldest.bin]--;
+
+    m_head = (m_head + 1) % capacity;
+    m_size--;
+    m_firstSequence++;
+}
+
+/**
+ * @brief 清空窗口
+ */
+void SlidingWindowStats::clear()
+{
+    m_head = 0;
+    m_size = 0;
+    m_firstSequence = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_minHead = 0;
+    m_minSize = 0;
+    m_maxHead = 0;
+    m_maxSize = 0;
+    m_histogram.fill(0);
+}
+
+/**
+ * @brief 估计百分位数
+ * @param fraction 分位比例（0.0-1.0）
+ * @return 百分位数估计值
+ * @details 仅在最小值与最大值所在区间之间累加直方图，
+ *          电压稳定时只需扫描少量区间
+ */
+double SlidingWindowStats::percentile(double fraction) const
+{
+    if (m_size == 0) return 0.0;
+
+    fraction = qBound(0.0, fraction, 1.0);
+    const int lowBin = sampleAt(m_minQueue[m_minHead]).bin;
+    const int highBin = sampleAt(m_maxQueue[m_maxHead]).bin;
+
+    quint64 rank = static_cast<quint64>(fraction * (m_size - 1));
+    quint64 cumulative = 0;
+    for (int bin = lowBin; bin <= highBin; ++bin) {
+        cumulative += m_histogram[bin];
+        if (cumulative > rank) {
+            return HISTOGRAM_MIN + bin * HISTOGRAM_RESOLUTION;
+        }
+    }
+    return HISTOGRAM_MIN + highBin * HISTOGRAM_RESOLUTION;
+}
+
+/**
+ * @brief 获取窗口统计结果
+ * @return 统计结果
+ */
+StatisticsSummary SlidingWindowStats::summary() const
+{
+    StatisticsSummary result;
+    result.windowMs = m_windowMs;
+    result.count = m_size;
+    if (m_size == 0) return result;
+
+    double variance = m_m2 / m_size;
+    result.mean = m_mean;
+    result.stdDev = qSqrt(variance);
+    result.rms = qSqrt(m_mean * m_mean + variance);
+    result.min = sampleAt(m_minQueue[m_minHead]).value;
+    result.max = sampleAt(m_maxQueue[m_maxHead]).value;
+    result.p5 = percentile(0.05);
+    result.p50 = percentile(0.50);
+    result.p95 = percentile(0.95);
+    return result;
+}
+
+/**
+ * @brief 构造函数
+ * @param parent 父对象指针
+ * @details 默认建立10秒、1分钟和15分钟三个窗口
+ */
+VoltageStatistics::VoltageStatistics(QObject *parent)
+    : QObject(parent)
+    , m_lifetimeCount(0)
+    , m_lifetimeMean(0.0)
+    , m_lifetimeM2(0.0)
+    , m_lifetimeMin(0.0)
+    , m_lifetimeMax(0.0)
+{
+    setWindows({10 * 1000, 60 * 1000, 15 * 60 * 1000});
+}
+
+/**
+ * @brief 设置统计窗口
+ * @param windowsMs 各窗口长度（毫秒）
+ * @param minIntervalMs 预期的最小采样间隔（毫秒）
+ */
+void VoltageStatistics::setWindows(const QVector<int> &windowsMs, int minIntervalMs)
+{
+    m_windows.clear();
+    m_windows.reserve(windowsMs.size());
+    for (int windowMs : windowsMs) {
+        m_windows.append(SlidingWindowStats(windowMs, minIntervalMs));
+    }
+}
+
+/**
+ * @brief 加入一个电压样本
+ * @param voltage 电压值
+ * @param timestampMs 单调时间戳（毫秒）
+ */
+void VoltageStatistics::addSample(double voltage, qint64 timestampMs)
+{
+    for (SlidingWindowStats &window : m_windows) {
+        window.addSample(voltage, timestampMs);
+    }
+
+    // 全程Welford累计
+    m_lifetimeCount++;
+    double delta = voltage - m_lifetimeMean;
+    m_lifetimeMean += delta / m_lifetimeCount;
+    m_lifetimeM2 += delta * (voltage - m_lifetimeMean);
+    if (m_lifetimeCount == 1 || voltage < m_lifetimeMin) m_lifetimeMin = voltage;
+    if (m_lifetimeCount == 1 || voltage > m_lifetimeMax) m_lifetimeMax = voltage;
+
+    emit statisticsUpdated();
+}
+
+/**
+ * @brief 清空所有统计数据
+ */
+void VoltageStatistics::clear()
+{
+    for (SlidingWindowStats &window : m_windows) {
+        window.clear();
+    }
+    m_lifetimeCount = 0;
+    m_lifetimeMean = 0.0;
+    m_lifetimeM2 = 0.0;
+    m_lifetimeMin = 0.0;
+    m_lifetimeMax = 0.0;
+
+    emit statisticsUpdated();
+}
+
+/**
+ * @brief 获取窗口数量
+ * @return 窗口数量
+ */
+int VoltageStatistics::windowCount() const
+{
+    return m_windows.size();
+}
+
+/**
+ * @brief 获取指定窗口的统计结果
+ * @param index 窗口索引
+ * @return 统计结果，索引无效时返回空结果
+ */
+StatisticsSummary VoltageStatistics::summary(int index) const
+{
+    if (index < 0 || index >= m_windows.size()) {
+        qWarning() << "统计窗口索引无效:" << index;
+        return StatisticsSummary();
+    }
+    return m_windows[index].summary();
+}
+
+/**
+ * @brief 获取所有窗口的统计结果
+ * @return 统计结果数组
+ */
+QVector<StatisticsSummary> VoltageStatistics::summaries() const
+{
+    QVector<StatisticsSummary> result;
+    result.reserve(m_windows.size());
+    for (const SlidingWindowStats &window : m_windows) {
+        result.append(window.summary());
+    }
+    return result;
+}
+
+/**
+ * @brief 获取整个运行过程的统计结果
+ * @return 统计结果（百分位数字段为0）
+ */
+StatisticsSummary VoltageStatistics::lifetimeSummary() const
+{
+    StatisticsSummary result;
+    result.count = static_cast<int>(qMin<qint64>(m_lifetimeCount, INT_MAX));
+    if (m_lifetimeCount == 0) return result;
+
+    double variance = m_lifetimeM2 / m_lifetimeCount;
+    result.mean = m_lifetimeMean;
+    result.stdDev = qSqrt(variance);
+    result.rms = qSqrt(m_lifetimeMean * m_lifetimeMean + variance);
+    result.min = m_lifetimeMin;
+    result.max = m_lifetimeMax;
+    return result;
+}
+
+/**
+ * @brief 将所有窗口的统计结果格式化为显示文本
+ * @return 多行显示文本
+ */
+QString VoltageStatistics::formatSummaries() const
+{
+    QString text;
+    for (const StatisticsSummary &s : summaries()) {
+        QString title = s.windowMs >= 60000
+                ? QString("%1 分钟窗口").arg(s.windowMs / 60000)
+                : QString("%1 秒窗口").arg(s.windowMs / 1000);
+        text += QString("【%1】样本 %2\n").arg(title).arg(s.count);
+        if (s.count == 0) {
+            text += "暂无数据\n\n";
+            continue;
+        }
+        text += QString("均值: %1 V\n").arg(s.mean, 0, 'f', 2);
+        text += QString("RMS: %1 V\n").arg(s.rms, 0, 'f', 2);
+        text += QString("标准差: %1 V\n").arg(s.stdDev, 0, 'f', 3);
+        text += QString("最小/最大: %1 / %2 V\n").arg(s.min, 0, 'f', 1).arg(s.max, 0, 'f', 1);
+        text += QString("P5/P50/P95: %1 / %2 / %3 V\n\n")
+                .arg(s.p5, 0, 'f', 1).arg(s.p50, 0, 'f', 1).arg(s.p95, 0, 'f', 1);
+    }
+    return text.trimmed();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file voltagestatistics.h
+ * @brief 电压流式统计类定义文件
+ * @details 包含SlidingWindowStats与VoltageStatistics类的声明，
+ *          以增量方式计算多个时间窗口内的均值、RMS、标准差、最值和百分位数
+ */
+
+#ifndef VOLTAGESTATISTICS_H
+#define VOLTAGESTATISTICS_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+
+/**
+ * @struct StatisticsSummary
+ * @brief 单个时间窗口的统计结果
+ */
+struct StatisticsSummary
+{
+    int windowMs = 0;       // 窗口长度（毫秒）
+    int count = 0;          // 窗口内样本数
+    double mean = 0.0;      // 均值
+    double rms = 0.0;       // 均方根
+    double stdDev = 0.0;    // 标准差
+    double min = 0.0;       // 最小值
+    double max = 0.0;       // 最大值
+    double p5 = 0.0;        // 5%分位数
+    double p50 = 0.0;       // 中位数
+    double p95 = 0.0;       // 95%分位数
+};
+
+/**
+ * @class SlidingWindowStats
+ * @brief 单个滑动时间窗口的增量统计器
+ * @details 样本保存在固定容量的环形缓冲区中，进入和过期时分别执行Welford增/删更新；
+ *          最值由单调队列维护，百分位数由固定分辨率直方图（量化草图）给出。
+ *          每个样本的处理开销为常数，内存上限在构造时确定，与运行时长无关。
+ */
+class SlidingWindowStats
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param windowMs 窗口长度（毫秒）
+     * @param minIntervalMs 预期的最小采样间隔（毫秒），用于确定环形缓冲区容量
+     */
+    SlidingWindowStats(int windowMs = 10000, int minIntervalMs = 50);
+
+    /**
+     * @brief 加入一个样本并淘汰过期样本
+     * @param value 样本值
+     * @param timestampMs 单调时间戳（毫秒）
+     */
+    void addSample(double value, qint64 timestampMs);
+
+    /**
+     * @brief 清空窗口
+     */
+    void clear();
+
+    /**
+     * @brief 获取窗口统计结果
+     * @return 统计结果
+     */
+    StatisticsSummary summary() const;
+
+    /**
+     * @brief 估计百分位数
+     * @param fraction 分位比例（0.0-1.0）
+     * @return 百分位数估计值，窗口为空时返回0
+     */
+    double percentile(double fraction) const;
+
+    int windowMs() const { return m_windowMs; }
+    int count() const { return m_size; }
+
+    static constexpr double HISTOGRAM_MIN = 0.0;        // 直方图下限（V）
+    static constexpr double HISTOGRAM_MAX = 500.0;      // 直方图上限（V）
+    static constexpr double HISTOGRAM_RESOLUTION = 0.1; // 直方图分辨率，与电压寄存器量化一致
+
+private:
+    struct Sample
+    {
+        qint64 timestampMs;
+        double value;
+        int bin;
+    };
+
+    void removeOldest();
+    int binOf(double value) const;
+    const Sample &sampleAt(quint64 sequence) const;
+
+private:
+    int m_windowMs;
+    QVector<Sample> m_ring;         // 样本环形缓冲区
+    int m_head;                     // 最旧样本所在位置
+    int m_size;                     // 当前样本数
+    quint64 m_firstSequence;        // 最旧样本的序号
+    double m_mean;                  // Welford均值
+    double m_m2;                    // Welford二阶中心矩累计量
+    QVector<quint64> m_minQueue;    // 最小值单调队列（样本序号）
+    QVector<quint64> m_maxQueue;    // 最大值单调队列（样本序号）
+    int m_minHead;
+    int m_minSize;
+    int m_maxHead;
+    int m_maxSize;
+    QVector<quint32> m_histogram;   // 量化直方图
+};
+
+/**
+ * @class VoltageStatistics
+ * @brief 电压流式统计引擎
+ * @details 同时维护多个可配置的滑动窗口（默认10秒、1分钟、15分钟），
+ *          并对整个运行过程做Welford累计，供界面和其他模块查询
+ */
+class VoltageStatistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit VoltageStatistics(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置统计窗口
+     * @param windowsMs 各窗口长度（毫秒），设置后所有窗口清空
+     * @param minIntervalMs 预期的最小采样间隔（毫秒）
+     */
+    void setWindows(const QVector<int> &windowsMs, int minIntervalMs = 50);
+
+    /**
+     * @brief 加入一个电压样本
+     * @param voltage 电压值
+     * @param timestampMs 单调时间戳（毫秒）
+     */
+    void addSample(double voltage, qint64 timestampMs);
+
+    /**
+     * @brief 清空所有统计数据
+     */
+    void clear();
+
+    /**
+     * @brief 获取窗口数量
+     * @return 窗口数量
+     */
+    int windowCount() const;
+
+    /**
+     * @brief 获取指定窗口的统计结果
+     * @param index 窗口索引
+     * @return 统计结果
+     */
+    StatisticsSummary summary(int index) const;
+
+    /**
+     * @brief 获取所有窗口的统计结果
+     * @return 统计结果数组
+     */
+    QVector<StatisticsSummary> summaries() const;
+
+    /**
+     * @brief 获取整个运行过程的统计结果（不含百分位数）
+     * @return 统计结果
+     */
+    StatisticsSummary lifetimeSummary() const;
+
+    /**
+     * @brief 将所有窗口的统计结果格式化为显示文本
+     * @return 多行显示文本
+     */
+    QString formatSummaries() const;
+
+signals:
+    /**
+     * @brief 统计结果更新信号
+     */
+    void statisticsUpdated();
+
+private:
+    QVector<SlidingWindowStats> m_windows;  // 各滑动窗口
+    qint64 m_lifetimeCount;                 // 全程样本数
+    double m_lifetimeMean;                  // 全程Welford均值
+    double m_lifetimeM2;                    // 全程Welford二阶矩
+    double m_lifetimeMin;                   // 全程最小值
+    double m_lifetimeMax;                   // 全程最大值
+};
+
+#endif // VOLTAGESTATISTICS_H
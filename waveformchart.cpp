@@ -10,6 +10,7 @@
 #include <QMouseEvent>
 #include <QEvent>
 #include <QApplication>
+#include <algorithm>
 
 constexpr int WaveformChart::MAX_DATA_POINTS;
 
@@ -152,15 +153,22 @@ WaveformChart::WaveformChart(QObject *parent)
     : QObject(parent)
     , voltageChart(nullptr)
     , voltageSeries(nullptr)
+    , snapshotSeries(nullptr)
+    , eventSeries(nullptr)
     , chartView(nullptr)
     , waveformUpdateTimer(nullptr)
     , m_dataPointCount(0)
+    , m_maxDataPoints(MAX_DATA_POINTS)
     , m_currentTimeWindowStart(0.0)
     , m_updateInterval(1000)
     , m_yAxisMin(228.0)
     , m_yAxisMax(235.0)
     , m_title("电压实时波形图")
     , m_useAdaptiveRange(true)
+    , m_snapshotActive(false)
+    , m_paused(false)
+    , m_seriesStale(false)
+    , m_nextSequence(0)
 {
 }
 
@@ -226,11 +234,26 @@ void WaveformChart::setupWaveformChart(QWidget *chartContainer, QWidget *pageWid
     voltageSeries->setName("电压 (V)");
     voltageChart->addSeries(voltageSeries);
 
+    snapshotSeries = new QLineSeries();
+    snapshotSeries->setName("触发快照 (V)");
+    snapshotSeries->setVisible(false);
+    voltageChart->addSeries(snapshotSeries);
+    m_snapshotActive = false;
+
+    eventSeries = new QScatterSeries();
+    eventSeries->setName("电能质量事件");
+    eventSeries->setColor(Qt::red);
+    eventSeries->setBorderColor(Qt::red);
+    eventSeries->setMarkerSize(7.0);
+    voltageChart->addSeries(eventSeries);
+
     QValueAxis *axisX = new QValueAxis();
     axisX->setTitleText("时间 (s)");
-    axisX->setRange(0, MAX_DATA_POINTS);
+    axisX->setRange(0, m_maxDataPoints);
     voltageChart->addAxis(axisX, Qt::AlignBottom);
     voltageSeries->attachAxis(axisX);
+    snapshotSeries->attachAxis(axisX);
+    eventSeries->attachAxis(axisX);
 
     QValueAxis *axisY = new QValueAxis();
     axisY->setTitleText("电压 (V)");
@@ -239,6 +262,8 @@ void WaveformChart::setupWaveformChart(QWidget *chartContainer, QWidget *pageWid
     }
     voltageChart->addAxis(axisY, Qt::AlignLeft);
     voltageSeries->attachAxis(axisY);
+    snapshotSeries->attachAxis(axisY);
+    eventSeries->attachAxis(axisY);
 
     chartView = new CustomChartView(voltageChart);
     chartView->setRenderHint(QPainter::Antialiasing);
@@ -256,23 +281,93 @@ void WaveformChart::setupWaveformChart(QWidget *chartContainer, QWidget *pageWid
  * @param voltage 电压值
  */
 void WaveformChart::updateWaveformData(double voltage)
+{
+    updateWaveformData(voltage, voltage);
+}
+
+/**
+ * @brief 更新波形图数据
+ * @param voltage 曲线显示的电压值
+ * @param rawVoltage 未滤波的电压值
+ */
+void WaveformChart::updateWaveformData(double voltage, double rawVoltage)
 {
     // 添加新的电压数据点到数据列表
     voltageData.append(voltage);
+    m_rawData.append(rawVoltage);
     // 更新总数据点计数
     m_dataPointCount++;
 
     // 如果数据点数量超过最大值，移除最旧的数据点并移动时间窗口起始点
-    if (voltageData.size() > MAX_DATA_POINTS) {
+    if (voltageData.size() > m_maxDataPoints) {
         voltageData.removeFirst();
+        m_rawData.removeFirst();
         m_currentTimeWindowStart++;
     }
 
+    // 显示快照或暂停期间只缓存数据，退出快照或恢复时再统一刷新
+    if (!m_snapshotActive && !m_paused) {
+        refreshLiveSeries();
+    } else {
+        m_seriesStale = true;
+    }
+
+    // 新样本先缓存，回到事件循环后合并通知
+    if (m_pendingSamples.isEmpty()) {
+        QTimer::singleShot(0, this, &WaveformChart::flushPendingSamples);
+    }
+    m_pendingSamples.append(voltage);
+    m_nextSequence++;
+}
+
+/**
+ * @brief 发出待通知的新样本
+ */
+void WaveformChart::flushPendingSamples()
+{
+    if (m_pendingSamples.isEmpty()) {
+        return;
+    }
+
+    // 交换出待通知缓存，排队连接持有的副本与之后追加的样本互不影响
+    QVector<double> samples;
+    samples.swap(m_pendingSamples);
+    emit samplesAppended(m_nextSequence - samples.size(), samples);
+}
+
+/**
+ * @brief 获取实时波形数据的只读快照
+ * @return 窗口内的数据及第一个样本的序号
+ */
+WaveformSnapshot WaveformChart::snapshot() const
+{
+    WaveformSnapshot result;
+    result.firstSequence = m_nextSequence - voltageData.size();
+    result.samples = voltageData;
+    return result;
+}
+
+/**
+ * @brief 下一个样本的序号
+ * @return 已追加的样本总数
+ */
+quint64 WaveformChart::nextSequence() const
+{
+    return m_nextSequence;
+}
+
+/**
+ * @brief 将缓存的实时数据刷新到图表
+ */
+void WaveformChart::refreshLiveSeries()
+{
+    m_seriesStale = false;
+
     // 更新图表数据
     if (voltageSeries) {
         voltageSeries->clear();
 
-        double timeWindowEnd = m_currentTimeWindowStart + MAX_DATA_POINTS;
+        double timeWindowEnd = m_currentTimeWindowStart + m_maxDataPoints;
         // 重新添加所有数据点到序列，保持时间窗口的连续性
         for (int i = 0; i < voltageData.size(); ++i) {
             double time = m_currentTimeWindowStart + i;
@@ -282,11 +377,13 @@ void WaveformChart::updateWaveformData(double voltage)
         // 更新X轴范围，确保时间窗口正确显示
         QValueAxis *axisX = qobject_cast<QValueAxis*>(voltageChart->axisX(voltageSeries));
         if (axisX) {
-            double timeWindowEnd = m_currentTimeWindowStart + MAX_DATA_POINTS;
+            double timeWindowEnd = m_currentTimeWindowStart + m_maxDataPoints;
             axisX->setRange(m_currentTimeWindowStart, timeWindowEnd);
         }
     }
 
+    refreshEventSeries();
+
     // 如果使用自适应Y轴范围，根据数据自动调整Y轴显示范围
     if (m_useAdaptiveRange && !voltageData.isEmpty()) {
         double minVoltage = voltageData[0];
@@ -297,6 +394,12 @@ void WaveformChart::updateWaveformData(double voltage)
             if (v < minVoltage) minVoltage = v;
             if (v > maxVoltage) maxVoltage = v;
         }
+        // 事件标记画在原始值处，可能超出滤波曲线的范围
+        const QList<QPointF> markers = eventSeries ? eventSeries->points() : QList<QPointF>();
+        for (const QPointF &point : markers) {
+            minVoltage = qMin(minVoltage, point.y());
+            maxVoltage = qMax(maxVoltage, point.y());
+        }
 
         // 计算边距，确保图表显示时留有足够空间
         double margin = (maxVoltage - minVoltage) * 0.1;
@@ -313,9 +416,6 @@ void WaveformChart::updateWaveformData(double voltage)
             axisY->setRange(newMin, newMax);
         }
     }
-
-    // 发送数据更新信号
-    emit dataUpdated(voltageData);
 }
 
 /**
@@ -323,6 +423,11 @@ void WaveformChart::updateWaveformData(double voltage)
  */
 void WaveformChart::startWaveformUpdate()
 {
+    m_paused = false;
+    if (m_seriesStale && !m_snapshotActive) {
+        refreshLiveSeries();
+    }
+
     if (waveformUpdateTimer && !waveformUpdateTimer->isActive()) {
         waveformUpdateTimer->start();
         qDebug() << "波形图更新定时器已启动";
@@ -334,6 +439,8 @@ void WaveformChart::startWaveformUpdate()
  */
 void WaveformChart::stopWaveformUpdate()
 {
+    m_paused = true;
+
     if (waveformUpdateTimer && waveformUpdateTimer->isActive()) {
         waveformUpdateTimer->stop();
         qDebug() << "波形图更新定时器已停止";
@@ -346,19 +453,56 @@ void WaveformChart::stopWaveformUpdate()
 void WaveformChart::clearWaveformData()
 {
     voltageData.clear();
+    m_rawData.clear();
     m_dataPointCount = 0;
     m_currentTimeWindowStart = 0.0;
 
     if (voltageSeries) {
         voltageSeries->clear();
     }
+    if (eventSeries) {
+        eventSeries->clear();
+    }
 
     QValueAxis *axisX = qobject_cast<QValueAxis*>(voltageChart->axisX());
     if (axisX) {
-        axisX->setRange(0, MAX_DATA_POINTS);
+        axisX->setRange(0, m_maxDataPoints);
+    }
+}
+
+/**
+ * @brief 设置时间窗口内的最大数据点数
+ * @param count 最大数据点数
+ */
+void WaveformChart::setMaxDataPoints(int count)
+{
+    if (count <= 0) {
+        qWarning() << "波形图最大数据点数必须为正数";
+        return;
+    }
+
+    m_maxDataPoints = count;
+    while (voltageData.size() > m_maxDataPoints) {
+        voltageData.removeFirst();
+        m_rawData.removeFirst();
+        m_currentTimeWindowStart++;
+    }
+    if (!m_snapshotActive && !m_paused) {
+        refreshLiveSeries();
+    } else {
+        m_seriesStale = true;
     }
 }
 
+/**
+ * @brief 获取时间窗口内的最大数据点数
+ * @return 最大数据点数
+ */
+int WaveformChart::maxDataPoints() const
+{
+    return m_maxDataPoints;
+}
+
 /**
  * @brief 设置波形图更新间隔
  * @param interval 间隔时间（毫秒）
@@ -428,3 +572,145 @@ void WaveformChart::setTitle(const QString &title)
         voltageChart->setTitle(title);
     }
 }
+
+/**
+ * @brief 显示冻结的快照波形
+ * @param points 快照数据点
+ * @param name 快照名称
+ */
+void WaveformChart::showSnapshot(const QVector<QPointF> &points, const QString &name)
+{
+    if (!voltageChart || !snapshotSeries || points.isEmpty()) return;
+
+    m_snapshotActive = true;
+
+    voltageSeries->setVisible(false);
+    eventSeries->setVisible(false);
+    snapshotSeries->setName(name);
+    snapshotSeries->replace(points);
+    snapshotSeries->setVisible(true);
+
+    double minX = points.first().x();
+    double maxX = points.last().x();
+    double minY = points.first().y();
+    double maxY = points.first().y();
+    for (const QPointF &point : points) {
+        if (point.y() < minY) minY = point.y();
+        if (point.y() > maxY) maxY = point.y();
+    }
+    double margin = qMax((maxY - minY) * 0.1, 0.5);
+
+    QValueAxis *axisX = qobject_cast<QValueAxis*>(voltageChart->axisX(snapshotSeries));
+    if (axisX) {
+        axisX->setRange(minX, qMax(maxX, minX + 1.0));
+    }
+    QValueAxis *axisY = qobject_cast<QValueAxis*>(voltageChart->axisY(snapshotSeries));
+    if (axisY) {
+        axisY->setRange(minY - margin, maxY + margin);
+    }
+
+    qDebug() << "波形图显示快照:" << name;
+}
+
+/**
+ * @brief 退出快照显示，恢复实时波形
+ */
+void WaveformChart::showLiveWaveform()
+{
+    if (!m_snapshotActive) return;
+
+    m_snapshotActive = false;
+
+    if (snapshotSeries) {
+        snapshotSeries->setVisible(false);
+        snapshotSeries->clear();
+    }
+    if (voltageSeries) {
+        voltageSeries->setVisible(true);
+    }
+    if (eventSeries) {
+        eventSeries->setVisible(true);
+    }
+
+    QValueAxis *axisY = qobject_cast<QValueAxis*>(voltageChart->axisY(voltageSeries));
+    if (axisY && !m_useAdaptiveRange) {
+        axisY->setRange(m_yAxisMin, m_yAxisMax);
+    }
+
+    refreshLiveSeries();
+
+    qDebug() << "波形图恢复实时显示";
+}
+
+/**
+ * @brief 是否正在显示快照
+ * @return 是否正在显示快照
+ */
+bool WaveformChart::isShowingSnapshot() const
+{
+    return m_snapshotActive;
+}
+
+/**
+ * @brief 设置或更新一个事件标记
+ * @param id 标记编号
+ * @param firstSequence 事件第一个样本的序号
+ * @param lastSequence 事件最后一个样本的序号
+ */
+void WaveformChart::setEventMarker(int id, quint64 firstSequence, quint64 lastSequence)
+{
+    auto it = std::find_if(m_eventMarkers.begin(), m_eventMarkers.end(),
+                           [id](const EventMarker &marker) { return marker.id == id; });
+    if (it != m_eventMarkers.end()) {
+        it->firstSequence = firstSequence;
+        it->lastSequence = lastSequence;
+    } else {
+        m_eventMarkers.append(EventMarker{id, firstSequence, lastSequence});
+    }
+
+    if (!m_snapshotActive && !m_paused) {
+        refreshEventSeries();
+    } else {
+        m_seriesStale = true;
+    }
+}
+
+/**
+ * @brief 清除所有事件标记
+ */
+void WaveformChart::clearEventMarkers()
+{
+    m_eventMarkers.clear();
+    if (eventSeries) {
+        eventSeries->clear();
+    }
+}
+
+/**
+ * @brief 按事件标记重建散点序列
+ * @details 开销与窗口内被标记的样本数成正比，没有标记时不做任何事
+ */
+void WaveformChart::refreshEventSeries()
+{
+    if (!eventSeries || (m_eventMarkers.isEmpty() && eventSeries->count() == 0)) {
+        return;
+    }
+
+    const quint64 windowFirst = m_nextSequence - voltageData.size();
+    m_eventMarkers.erase(std::remove_if(m_eventMarkers.begin(), m_eventMarkers.end(),
+                                        [windowFirst](const EventMarker &marker) {
+                                            return marker.lastSequence < windowFirst;
+                                        }),
+                         m_eventMarkers.end());
+
+    QVector<QPointF> points;
+    for (const EventMarker &marker : m_eventMarkers) {
+        const quint64 first = qMax(marker.firstSequence, windowFirst);
+        const quint64 last = qMin(marker.lastSequence, m_nextSequence - 1);
+        for (quint64 sequence = first; sequence <= last && sequence < m_nextSequence; ++sequence) {
+            const int index = int(sequence - windowFirst);
+            points.append(QPointF(m_currentTimeWindowStart + index, m_rawData[index]));
+        }
+    }
+    eventSeries->replace(points);
+}
@@ -11,12 +11,26 @@
 #include <QWidget>
 #include <QChart>
 #include <QLineSeries>
+#include <QScatterSeries>
 #include <QChartView>
 #include <QValueAxis>
 #include <QVector>
 #include <QTimer>
 #include <QToolTip>
 #include <QPoint>
+#include <QPointF>
+
+/**
+ * @struct WaveformSnapshot
+ * @brief 实时波形数据的只读快照
+ * @details samples与WaveformChart内部缓冲区隐式共享，取快照不复制数据；
+ *          第i个样本的序号为firstSequence + i
+ */
+struct WaveformSnapshot
+{
+    quint64 firstSequence = 0;      // 第一个样本的序号
+    QVector<double> samples;        // 窗口内的电压数据
+};
 
 class CustomChartView : public QChartView
 {
@@ -44,6 +58,8 @@ class WaveformChart : public QObject
     Q_OBJECT
 
 public:
+    static constexpr int MAX_DATA_POINTS = 50;     // 默认时间窗口内的最大数据点数
+
     /**
      * @brief 构造函数
      * @param parent 父对象指针
@@ -69,12 +85,22 @@ public:
     void updateWaveformData(double voltage);
 
     /**
-     * @brief 启动波形图更新定时器
+     * @brief 更新波形图数据，曲线与事件标记分别使用滤波值和原始值
+     * @param voltage 曲线显示的电压值（通常为滤波值）
+     * @param rawVoltage 未滤波的电压值，事件标记画在该值处
+     * @details 滤波会抹平单个样本的越限，标记若画在曲线上会出现在约230 V处；画在原始值处才能看出越限幅度
+     */
+    void updateWaveformData(double voltage, double rawVoltage);
+
+    /**
+     * @brief 启动波形图更新定时器，恢复图表刷新
+     * @details 暂停期间缓存的数据在恢复时一次性刷新到图表
      */
     void startWaveformUpdate();
 
     /**
-     * @brief 停止波形图更新定时器
+     * @brief 停止波形图更新定时器，暂停图表刷新
+     * @details 暂停期间新数据只进入缓存，不重建图表序列（页面不可见时避免无用的重绘）
      */
     void stopWaveformUpdate();
 
@@ -83,6 +109,18 @@ public:
      */
     void clearWaveformData();
 
+    /**
+     * @brief 设置时间窗口内的最大数据点数
+     * @param count 最大数据点数，默认为MAX_DATA_POINTS
+     */
+    void setMaxDataPoints(int count);
+
+    /**
+     * @brief 获取时间窗口内的最大数据点数
+     * @return 最大数据点数
+     */
+    int maxDataPoints() const;
+
     /**
      * @brief 设置波形图更新间隔
      * @param interval 间隔时间（毫秒）
@@ -103,18 +141,67 @@ public:
      */
     int dataPointCount() const;
 
+    /**
+     * @brief 获取实时波形数据的只读快照
+     * @return 窗口内的数据及第一个样本的序号，与内部缓冲区隐式共享
+     * @details 快照可能已包含尚未通过samplesAppended通知的样本，
+     *          需要快照加增量的使用者应忽略序号小于快照末尾的通知样本
+     */
+    WaveformSnapshot snapshot() const;
+
+    /**
+     * @brief 下一个样本的序号
+     * @return 已追加的样本总数，清除数据后不归零
+     */
+    quint64 nextSequence() const;
+
     /**
      * @brief 设置波形图标题
      * @param title 标题文本
      */
     void setTitle(const QString &title);
 
+    /**
+     * @brief 显示冻结的快照波形
+     * @param points 快照数据点，x为相对触发点的时间（秒）
+     * @param name 快照名称
+     * @details 显示快照期间实时数据继续缓存，但不刷新到图表
+     */
+    void showSnapshot(const QVector<QPointF> &points, const QString &name);
+
+    /**
+     * @brief 退出快照显示，恢复实时波形
+     */
+    void showLiveWaveform();
+
+    /**
+     * @brief 是否正在显示快照
+     * @return 是否正在显示快照
+     */
+    bool isShowingSnapshot() const;
+
+    /**
+     * @brief 设置或更新一个事件标记
+     * @param id 标记编号，相同编号的标记被更新
+     * @param firstSequence 事件第一个样本的序号
+     * @param lastSequence 事件最后一个样本的序号，进行中的事件传入std::numeric_limits<quint64>::max()
+     * @details 标记范围内仍在窗口中的样本以红色散点叠加显示；移出窗口的标记自动删除
+     */
+    void setEventMarker(int id, quint64 firstSequence, quint64 lastSequence);
+
+    /**
+     * @brief 清除所有事件标记
+     */
+    void clearEventMarkers();
+
 signals:
     /**
-     * @brief 波形图数据更新信号
-     * @param voltageData 电压数据数组
+     * @brief 新样本通知
+     * @param firstSequence samples中第一个样本的序号
+     * @param samples 上次通知以来追加的样本
+     * @details 同一轮事件循环内追加的样本合并为一次通知，接收方的开销只与新样本数量有关
      */
-    void dataUpdated(const QVector<double> &voltageData);
+    void samplesAppended(quint64 firstSequence, const QVector<double> &samples);
 
 private:
     /**
@@ -124,20 +211,55 @@ private:
      */
     void setupWaveformChart(QWidget *chartContainer, QWidget *pageWidget);
 
+    /**
+     * @brief 将缓存的实时数据刷新到图表
+     */
+    void refreshLiveSeries();
+
+    /**
+     * @brief 发出待通知的新样本
+     */
+    void flushPendingSamples();
+
+    /**
+     * @brief 按事件标记重建散点序列，删除已移出窗口的标记
+     */
+    void refreshEventSeries();
+
 private:
+    /**
+     * @struct EventMarker
+     * @brief 事件标记的样本范围
+     */
+    struct EventMarker
+    {
+        int id;
+        quint64 firstSequence;
+        quint64 lastSequence;
+    };
+
     QChart *voltageChart;
     QLineSeries *voltageSeries;
+    QLineSeries *snapshotSeries;
+    QScatterSeries *eventSeries;
     QChartView *chartView;
     QTimer *waveformUpdateTimer;
     QVector<double> voltageData;
+    QVector<double> m_rawData;              // 与voltageData逐点对应的原始电压，事件标记画在原始值处
     int m_dataPointCount;
-    static constexpr int MAX_DATA_POINTS = 50;
+    int m_maxDataPoints;
     double m_currentTimeWindowStart;
     int m_updateInterval;
     double m_yAxisMin;
     double m_yAxisMax;
     QString m_title;
     bool m_useAdaptiveRange;
+    bool m_snapshotActive;
+    bool m_paused;              // 是否暂停图表刷新（页面不可见）
+    bool m_seriesStale;         // 暂停或显示快照期间是否有未刷新到图表的数据
+    quint64 m_nextSequence;             // 下一个样本的序号
+    QVector<double> m_pendingSamples;   // 尚未通知的新样本
+    QVector<EventMarker> m_eventMarkers;    // 事件标记
 };
 
 #endif // WAVEFORMCHART_H